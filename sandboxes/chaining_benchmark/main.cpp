@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
+
+#include <libslic3r/libslic3r.h>
+#include <libslic3r/Polyline.hpp>
+#include <libslic3r/ShortestPath.hpp>
+
+#include "libnest2d/tools/benchmark.h"
+
+// Measures chaining of a large number of short randomly placed and oriented polylines,
+// comparing the greedy chaining with the greedy chaining refined by 2-opt.
+
+const std::string USAGE_STR = {
+    "Usage: chaining_benchmark [num_polylines] [size_mm] [time_budget_s] [repeats]\n"
+    "       default 10000 polylines 2 mm long on a 250 mm square, unlimited 2-opt time budget, 3 runs"
+};
+
+static double travel_length(const Slic3r::Polylines &polylines)
+{
+    double length = 0.;
+    for (size_t i = 1; i < polylines.size(); ++ i)
+        length += (polylines[i].first_point() - polylines[i - 1].last_point()).cast<double>().norm();
+    return length;
+}
+
+int main(const int argc, const char *argv[])
+{
+    using namespace Slic3r;
+    using std::cout; using std::endl;
+
+    if (argc > 1 && (std::string(argv[1]) == "-h" || std::string(argv[1]) == "--help")) {
+        cout << USAGE_STR << endl;
+        return EXIT_SUCCESS;
+    }
+
+    const size_t num_polylines = argc > 1 ? size_t(std::max(2, atoi(argv[1]))) : 10000;
+    const double size          = argc > 2 ? std::max(10., atof(argv[2])) : 250.;
+    const double time_budget   = argc > 3 ? std::max(0., atof(argv[3])) : 0.;
+    const int    repeats       = argc > 4 ? std::max(1, atoi(argv[4])) : 3;
+
+    Polylines polylines;
+    {
+        std::mt19937 rng(0);
+        std::uniform_real_distribution<double> pos(0., size);
+        std::uniform_real_distribution<double> angle(0., 2. * PI);
+        polylines.reserve(num_polylines);
+        for (size_t i = 0; i < num_polylines; ++ i) {
+            Vec2d  a = { pos(rng), pos(rng) };
+            double alpha = angle(rng);
+            Vec2d  b = a + 2. * Vec2d(cos(alpha), sin(alpha));
+            polylines.emplace_back(Point::new_scale(a.x(), a.y()), Point::new_scale(b.x(), b.y()));
+        }
+    }
+
+    ChainingParams two_opt;
+    two_opt.refinement  = ChainingParams::Refinement::TwoOpt;
+    two_opt.time_budget = time_budget;
+
+    auto run = [&polylines, repeats](const char *name, const ChainingParams &params) {
+        Benchmark bench;
+        double time_total = 0.;
+        double time_min   = std::numeric_limits<double>::max();
+        double length     = 0.;
+        for (int i = 0; i < repeats; ++ i) {
+            bench.start();
+            Polylines chained = chain_polylines(polylines, nullptr, params);
+            bench.stop();
+            time_total += bench.getElapsedSec();
+            time_min    = std::min(time_min, bench.getElapsedSec());
+            length      = travel_length(chained);
+        }
+        cout << name << ": travel " << unscale<double>(length) << " mm, average " << time_total / repeats << " s, minimum " << time_min << " s over " << repeats << " runs" << endl;
+    };
+
+    cout << "Chaining " << polylines.size() << " polylines on a " << size << " mm square" << endl;
+    run("Greedy", ChainingParams());
+    run("Greedy + 2-opt", two_opt);
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,203 @@
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <libslic3r/ClipperUtils.hpp>
+#include <libslic3r/TriangleMesh.hpp>
+#include <libslic3r/TriangleMeshSlicer.hpp>
+#include <libslic3r/Format/OBJ.hpp>
+
+#include <boost/algorithm/string/predicate.hpp>
+
+#include "libnest2d/tools/benchmark.h"
+
+// Compares the ClipperUtils backends on the slices of a real model.
+// For each layer, a workload resembling the perimeter, infill and overhang detection of the slicer is executed.
+
+const std::string USAGE_STR = {
+    "Usage: clipper_benchmark model.stl|model.obj [layer_height_mm] [repeats]"
+};
+
+// Count the heap allocations to measure how much of the per call Clipper setup is amortized.
+static std::atomic<size_t> g_num_allocations { 0 };
+
+void* operator new(std::size_t size)
+{
+    ++ g_num_allocations;
+    if (void *ptr = std::malloc(size == 0 ? 1 : size))
+        return ptr;
+    throw std::bad_alloc();
+}
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+namespace Slic3r {
+
+struct WorkloadResult
+{
+    double time_offset      = 0.;
+    double time_boolean     = 0.;
+    double time_polylines   = 0.;
+    double time_islands     = 0.;
+    // Islands clipped one by one with the whole layer below, plain and index accelerated.
+    double time_clip_plain  = 0.;
+    double time_clip_indexed = 0.;
+    // Number of heap allocations per repeat.
+    size_t allocs_offset    = 0;
+    size_t allocs_boolean   = 0;
+    size_t allocs_polylines = 0;
+    size_t allocs_islands   = 0;
+    // Sum of the output areas / lengths, to compare the results of the backends.
+    double checksum_offset  = 0.;
+    double checksum_boolean = 0.;
+    double checksum_lines   = 0.;
+    double checksum_islands = 0.;
+    double checksum_clip_plain   = 0.;
+    double checksum_clip_indexed = 0.;
+};
+
+static Polylines hatch_lines(const BoundingBox &bbox, coord_t spacing)
+{
+    Polylines out;
+    for (coord_t x = bbox.min.x(); x <= bbox.max.x(); x += spacing)
+        out.push_back(Polyline{ { x, bbox.min.y() }, { x, bbox.max.y() } });
+    return out;
+}
+
+static WorkloadResult run_workload(const std::vector<ExPolygons> &layers, int repeats)
+{
+    const float perimeter_width = float(scale_(0.45));
+    WorkloadResult r;
+    Benchmark      b;
+    size_t         num_allocations;
+    for (int i = 0; i < repeats; ++ i) {
+        num_allocations = g_num_allocations;
+        b.start();
+        for (const ExPolygons &layer : layers) {
+            // Three perimeters followed by the infill area.
+            ExPolygons perimeter = offset_ex(layer, - 0.5f * perimeter_width);
+            for (int j = 0; j < 3 && ! perimeter.empty(); ++ j)
+                perimeter = offset2_ex(perimeter, - perimeter_width, 0.1f * perimeter_width);
+            r.checksum_offset += area(perimeter) + area(offset(layer, perimeter_width));
+        }
+        b.stop();
+        r.time_offset   += b.getElapsedSec();
+        r.allocs_offset += g_num_allocations - num_allocations;
+
+        num_allocations = g_num_allocations;
+        b.start();
+        for (size_t idx_layer = 1; idx_layer < layers.size(); ++ idx_layer) {
+            const ExPolygons &below = layers[idx_layer - 1];
+            const ExPolygons &above = layers[idx_layer];
+            r.checksum_boolean += area(diff_ex(above, below, ApplySafetyOffset::Yes));
+            r.checksum_boolean += area(intersection_ex(above, below));
+            r.checksum_boolean += area(union_ex(above, to_polygons(below)));
+        }
+        b.stop();
+        r.time_boolean   += b.getElapsedSec();
+        r.allocs_boolean += g_num_allocations - num_allocations;
+
+        num_allocations = g_num_allocations;
+        b.start();
+        for (const ExPolygons &layer : layers)
+            if (! layer.empty())
+                r.checksum_lines += total_length(intersection_pl(hatch_lines(get_extents(layer), coord_t(scale_(2.))), layer));
+        b.stop();
+        r.time_polylines   += b.getElapsedSec();
+        r.allocs_polylines += g_num_allocations - num_allocations;
+
+        // Many small operations island by island, as the perimeter generator does for the external perimeters.
+        num_allocations = g_num_allocations;
+        b.start();
+        for (const ExPolygons &layer : layers)
+            for (const ExPolygon &island : layer) {
+                r.checksum_islands += area(offset2_ex(island, - perimeter_width, 0.25f * perimeter_width));
+                r.checksum_islands += area(offset_ex(island, - 0.5f * perimeter_width));
+                r.checksum_islands += area(diff_ex(island, offset(island, - perimeter_width)));
+            }
+        b.stop();
+        r.time_islands   += b.getElapsedSec();
+        r.allocs_islands += g_num_allocations - num_allocations;
+
+        b.start();
+        for (size_t idx_layer = 1; idx_layer < layers.size(); ++ idx_layer)
+            for (const ExPolygon &island : layers[idx_layer])
+                r.checksum_clip_plain += area(diff_ex(island, layers[idx_layer - 1], ApplySafetyOffset::Yes));
+        b.stop();
+        r.time_clip_plain += b.getElapsedSec();
+
+        b.start();
+        for (size_t idx_layer = 1; idx_layer < layers.size(); ++ idx_layer)
+            for (const ExPolygon &island : layers[idx_layer])
+                r.checksum_clip_indexed += area(diff_ex_indexed(island, layers[idx_layer - 1], ApplySafetyOffset::Yes));
+        b.stop();
+        r.time_clip_indexed += b.getElapsedSec();
+    }
+    r.time_offset      /= repeats;
+    r.time_boolean     /= repeats;
+    r.time_polylines   /= repeats;
+    r.time_islands     /= repeats;
+    r.time_clip_plain   /= repeats;
+    r.time_clip_indexed /= repeats;
+    r.allocs_offset    /= repeats;
+    r.allocs_boolean   /= repeats;
+    r.allocs_polylines /= repeats;
+    r.allocs_islands   /= repeats;
+    return r;
+}
+
+} // namespace Slic3r
+
+int main(const int argc, const char *argv[])
+{
+    using namespace Slic3r;
+
+    if (argc < 2) {
+        std::cerr << USAGE_STR << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    TriangleMesh mesh;
+    if (boost::iends_with(argv[1], ".obj")) {
+        ObjInfo     obj_info;
+        std::string message;
+        if (! load_obj(argv[1], &mesh, obj_info, message)) {
+            std::cerr << "Failed to load " << argv[1] << ": " << message << std::endl;
+            return EXIT_FAILURE;
+        }
+    } else if (! mesh.ReadSTLFile(argv[1])) {
+        std::cerr << "Failed to load " << argv[1] << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    const float layer_height = argc > 2 ? std::stof(argv[2]) : 0.2f;
+    const int   repeats      = argc > 3 ? std::max(1, std::stoi(argv[3])) : 3;
+
+    BoundingBoxf3      bbox = mesh.bounding_box();
+    std::vector<float> zs;
+    for (float z = float(bbox.min.z()) + 0.5f * layer_height; z < bbox.max.z(); z += layer_height)
+        zs.emplace_back(z);
+    std::vector<ExPolygons> layers = slice_mesh_ex(mesh.its, zs);
+    std::cout << "Sliced " << layers.size() << " layers" << std::endl;
+
+    const std::pair<const char*, ClipperBackend> backends[] = {
+        { "ClipperLib", ClipperBackend::ClipperLib },
+        { "Clipper2",   ClipperBackend::Clipper2 }
+    };
+    for (const auto &[name, backend] : backends) {
+        set_clipper_backend(backend);
+        WorkloadResult r = run_workload(layers, repeats);
+        std::cout << name << std::endl
+                  << "\toffsets [s]: "   << r.time_offset    << "\tallocations: " << r.allocs_offset    << "\tchecksum: " << r.checksum_offset  << std::endl
+                  << "\tbooleans [s]: "  << r.time_boolean   << "\tallocations: " << r.allocs_boolean   << "\tchecksum: " << r.checksum_boolean << std::endl
+                  << "\tpolylines [s]: " << r.time_polylines << "\tallocations: " << r.allocs_polylines << "\tchecksum: " << r.checksum_lines   << std::endl
+                  << "\tislands [s]: "   << r.time_islands   << "\tallocations: " << r.allocs_islands   << "\tchecksum: " << r.checksum_islands << std::endl
+                  << "\tislands vs. layer below [s]: " << r.time_clip_plain   << "\tchecksum: " << r.checksum_clip_plain   << std::endl
+                  << "\tislands vs. layer below, indexed [s]: " << r.time_clip_indexed << "\tchecksum: " << r.checksum_clip_indexed << std::endl;
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,100 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+
+#include <libslic3r/libslic3r.h>
+#include <libslic3r/ExPolygon.hpp>
+#include <libslic3r/Surface.hpp>
+#include <libslic3r/Fill/FillBase.hpp>
+#include <libslic3r/Fill/FillCache.hpp>
+
+#include "libnest2d/tools/benchmark.h"
+
+// Measures the sparse infill of a large low density part.
+// Every layer is filled as one large island and a grid of small islands, like the infill of a large part
+// with holes and of a plate full of small parts, so that the pattern generation is exercised next to the clipping.
+
+const std::string USAGE_STR = {
+    "Usage: infill_benchmark [pattern] [size_mm] [density_percent] [layers] [repeats]\n"
+    "       pattern is a sparse_infill_pattern value, default gyroid, 250 mm, 15 %, 1000 layers of 0.2 mm, 3 runs"
+};
+
+int main(const int argc, const char *argv[])
+{
+    using namespace Slic3r;
+    using std::cout; using std::endl;
+
+    if (argc > 1 && (std::string(argv[1]) == "-h" || std::string(argv[1]) == "--help")) {
+        cout << USAGE_STR << endl;
+        return EXIT_SUCCESS;
+    }
+
+    const std::string pattern      = argc > 1 ? argv[1] : "gyroid";
+    const double      size         = argc > 2 ? std::max(10., atof(argv[2])) : 250.;
+    const double      density      = argc > 3 ? std::clamp(atof(argv[3]), 1., 100.) * 0.01 : 0.15;
+    const int         num_layers   = argc > 4 ? std::max(1, atoi(argv[4])) : 1000;
+    const int         repeats      = argc > 5 ? std::max(1, atoi(argv[5])) : 3;
+    const double      layer_height = 0.2;
+
+    std::unique_ptr<Fill> filler(Fill::new_from_type(pattern));
+    if (! filler) {
+        std::cerr << "Unknown infill pattern " << pattern << endl;
+        return EXIT_FAILURE;
+    }
+
+    ExPolygons islands;
+    {
+        // One large island with a hole.
+        Polygon contour = Polygon::new_scale({ { 0., 0. }, { size, 0. }, { size, size }, { 0., size } });
+        Polygon hole    = Polygon::new_scale({ { 0.25 * size, 0.25 * size }, { 0.25 * size, 0.5 * size }, { 0.5 * size, 0.5 * size }, { 0.5 * size, 0.25 * size } });
+        islands.emplace_back(std::move(contour), std::move(hole));
+        // A grid of small islands next to it.
+        const double island_size = 10.;
+        for (double y = 0.; y + island_size <= size; y += 2. * island_size)
+            for (double x = 0.; x + island_size <= 0.5 * size; x += 2. * island_size) {
+                Polygon square = Polygon::new_scale({ { 0., 0. }, { island_size, 0. }, { island_size, island_size }, { 0., island_size } });
+                square.translate(scaled<coord_t>(size + 10. + x), scaled<coord_t>(y));
+                islands.emplace_back(std::move(square));
+            }
+    }
+
+    // The caches of the pattern generators are owned by the PrintObject when slicing.
+    FillCache fill_cache;
+    filler->angle      = 0.f;
+    filler->spacing    = 0.45;
+    filler->fill_cache = &fill_cache;
+    filler->set_bounding_box(get_extents(islands));
+    FillParams params;
+    params.density     = float(density);
+    params.dont_adjust = true;
+
+    Benchmark bench;
+    double time_total = 0.;
+    double time_min   = std::numeric_limits<double>::max();
+    size_t num_points = 0;
+    for (int i = 0; i < repeats; ++ i) {
+        num_points = 0;
+        fill_cache.clear();
+        bench.start();
+        for (int layer_id = 0; layer_id < num_layers; ++ layer_id) {
+            filler->layer_id = layer_id;
+            filler->z        = layer_height * (layer_id + 1);
+            for (const ExPolygon &island : islands) {
+                Surface surface(stInternal, island);
+                for (const Polyline &polyline : filler->fill_surface(&surface, params))
+                    num_points += polyline.points.size();
+            }
+        }
+        bench.stop();
+        time_total += bench.getElapsedSec();
+        time_min    = std::min(time_min, bench.getElapsedSec());
+    }
+
+    cout << "Infill " << pattern << " of " << islands.size() << " islands, " << num_layers << " layers, density " << density * 100. << " %, " << num_points << " points" << endl;
+    cout << "Infill generation: average " << time_total / repeats << " s, minimum " << time_min << " s over " << repeats << " runs" << endl;
+
+    return EXIT_SUCCESS;
+}
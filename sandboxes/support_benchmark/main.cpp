@@ -0,0 +1,90 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string>
+
+#include <libslic3r/libslic3r.h>
+#include <libslic3r/Model.hpp>
+#include <libslic3r/Print.hpp>
+#include <libslic3r/PrintConfig.hpp>
+
+#include "libnest2d/tools/benchmark.h"
+
+// Measures the generation of the classic (normal / grid) support of a real model.
+// The model is sliced once, then the support is repeatedly invalidated and regenerated,
+// so that only the support generator is being timed.
+
+const std::string USAGE_STR = {
+    "Usage: support_benchmark model.stl|model.obj|model.3mf [support_type] [repeats]\n"
+    "       support_type is one of normal(auto), normal(manual), tree(auto), hybrid(auto), default normal(auto)"
+};
+
+int main(const int argc, const char *argv[])
+{
+    using namespace Slic3r;
+    using std::cout; using std::endl;
+
+    if (argc < 2) {
+        cout << USAGE_STR << endl;
+        return EXIT_SUCCESS;
+    }
+
+    const std::string support_type = argc > 2 ? argv[2] : "normal(auto)";
+    const int         repeats      = argc > 3 ? std::max(1, atoi(argv[3])) : 5;
+
+    DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+    Model model;
+    try {
+        model = Model::read_from_file(argv[1]);
+    } catch (const std::exception &ex) {
+        std::cerr << "Failed to load " << argv[1] << ": " << ex.what() << endl;
+        return EXIT_FAILURE;
+    }
+    model.add_default_instances();
+    model.center_instances_around_point(Vec2d(128., 128.));
+    for (ModelObject *mo : model.objects)
+        mo->ensure_on_bed();
+
+    config.set_deserialize_strict({
+        { "enable_support", "0" },
+        { "support_type",   support_type }
+    });
+
+    Print print;
+    print.set_status_silent();
+    for (ModelObject *mo : model.objects)
+        print.auto_assign_extruders(mo);
+
+    Benchmark bench;
+    // Slice, generate perimeters and infill without support.
+    bench.start();
+    print.apply(model, config);
+    print.process();
+    bench.stop();
+    cout << "Slicing without support: " << bench.getElapsedSec() << " s" << endl;
+
+    double time_total = 0.;
+    double time_min   = std::numeric_limits<double>::max();
+    size_t num_layers = 0;
+    for (int i = 0; i < repeats; ++ i) {
+        // Switching the support off invalidates just the support steps.
+        config.set_key_value("enable_support", new ConfigOptionBool(false));
+        print.apply(model, config);
+        print.process();
+        config.set_key_value("enable_support", new ConfigOptionBool(true));
+        print.apply(model, config);
+        bench.start();
+        print.process();
+        bench.stop();
+        time_total += bench.getElapsedSec();
+        time_min    = std::min(time_min, bench.getElapsedSec());
+    }
+    for (const PrintObject *object : print.objects())
+        num_layers += object->support_layer_count();
+
+    cout << "Support type " << support_type << ", " << num_layers << " support layers" << endl;
+    cout << "Support generation: average " << time_total / repeats << " s, minimum " << time_min << " s over " << repeats << " runs" << endl;
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/base_class.hpp>
+#include <cereal/types/utility.hpp>
+#include <cereal/types/vector.hpp>
+
+#include <libslic3r/libslic3r.h>
+#include <libslic3r/ChunkStore.hpp>
+#include <libslic3r/Model.hpp>
+#include <libslic3r/TriangleMesh.hpp>
+#include <libslic3r/TriangleSelector.hpp>
+
+#include "libnest2d/tools/benchmark.h"
+
+// Measures the time and memory of the Undo / Redo snapshots of a painted model: the painting is modified by brush strokes
+// and after each stroke the painting is serialized, compared to the previous snapshot and stored the way
+// MutableObjectHistory::save() does it. The triangle mesh is stored once, as ImmutableObjectHistory::serialize_unshared() does.
+// The snapshots are stored either as full copies, or into a ChunkStore sharing the unmodified chunks, then compressed.
+// UndoRedo::StackImpl itself needs the 3D scene, thus it is not used here: the timestamp checks of the other objects
+// and the serialization of the Model, which are the same before and after the ChunkStore was introduced, are not measured.
+
+const std::string USAGE_STR = {
+    "Usage: undo_redo_benchmark [facets] [strokes]\n"
+    "       default 5000000 facets, 50 strokes"
+};
+
+template<typename T> static std::string serialize(const T &object)
+{
+    std::ostringstream oss;
+    {
+        cereal::BinaryOutputArchive archive(oss);
+        archive(object);
+    }
+    return oss.str();
+}
+
+static double mb(size_t bytes) { return double(bytes) / (1024. * 1024.); }
+
+int main(const int argc, const char *argv[])
+{
+    using namespace Slic3r;
+    using std::cout; using std::endl;
+
+    if (argc > 1 && (std::string(argv[1]) == "-h" || std::string(argv[1]) == "--help")) {
+        cout << USAGE_STR << endl;
+        return EXIT_SUCCESS;
+    }
+
+    const size_t num_facets  = argc > 1 ? std::max(1000, atoi(argv[1])) : 5000000;
+    const int    num_strokes = argc > 2 ? std::max(1, atoi(argv[2])) : 50;
+
+    // A sphere made of 4 pi^2 / fa^2 facets.
+    Model        model;
+    ModelVolume *volume = model.add_object()->add_volume(make_sphere(50., 2. * PI / std::sqrt(double(num_facets))));
+    const TriangleMesh &mesh = volume->mesh();
+    cout << "Painted sphere of " << mesh.facets_count() << " facets" << endl;
+
+    TriangleSelector                 selector(mesh);
+    std::mt19937                     rng(0);
+    std::uniform_int_distribution<>  random_facet(0, int(mesh.facets_count()) - 1);
+    std::uniform_int_distribution<>  random_extruder(int(EnforcerBlockerType::Extruder1), int(EnforcerBlockerType::Extruder4));
+    auto stroke = [&mesh, &selector, &rng, &random_facet, &random_extruder](float radius) {
+        int   facet  = random_facet(rng);
+        Vec3f center = mesh.its.vertices[mesh.its.indices[facet].x()];
+        selector.select_patch(facet,
+            TriangleSelector::SinglePointCursor::cursor_factory(center, center * 2.f, radius, TriangleSelector::CursorType::SPHERE, Transform3d::Identity(), TriangleSelector::ClippingPlane()),
+            EnforcerBlockerType(random_extruder(rng)), Transform3d::Identity(), true);
+    };
+
+    // Paint large areas of the sphere first.
+    for (int i = 0; i < 16; ++ i)
+        stroke(20.f);
+
+    Benchmark   bench;
+    ChunkStore  store;
+    std::vector<ChunkStore::Blob> blobs;
+    size_t      full_copies_size = 0;
+    double      time_serialize   = 0.;
+    double      time_store       = 0.;
+
+    // The triangle mesh does not change, it is serialized once when it is referenced by the Undo / Redo stack only.
+    bench.start();
+    blobs.emplace_back(store.store(serialize(mesh), 0));
+    bench.stop();
+    const size_t mesh_size     = blobs.back().size();
+    const double time_mesh     = bench.getElapsedSec();
+
+    for (int i = 0; i < num_strokes; ++ i) {
+        stroke(2.f);
+        bench.start();
+        volume->mmu_segmentation_facets.set(selector);
+        std::string data = serialize(volume->mmu_segmentation_facets);
+        bench.stop();
+        time_serialize   += bench.getElapsedSec();
+        full_copies_size += data.size();
+        bench.start();
+        // The painting changed, thus it is stored as new data.
+        if (! store.equals(blobs.back(), data))
+            blobs.emplace_back(store.store(data, size_t(i + 1)));
+        bench.stop();
+        time_store += bench.getElapsedSec();
+    }
+    const size_t painting_size = blobs.back().size();
+    const size_t memsize       = store.memsize();
+
+    // Compress all but the last snapshot.
+    bench.start();
+    store.compress_cold(size_t(num_strokes));
+    bench.stop();
+    const double time_compress       = bench.getElapsedSec();
+    const size_t memsize_compressed = store.memsize();
+
+    bench.start();
+    std::string loaded = store.load(blobs[1], 0);
+    bench.stop();
+    const double time_load = bench.getElapsedSec();
+
+    cout << "Serialized mesh: " << mb(mesh_size) << " MB, stored in " << time_mesh << " s" << endl;
+    cout << "Serialized painting: " << mb(painting_size) << " MB" << endl;
+    cout << "Snapshot of a stroke: serialization " << time_serialize / num_strokes << " s, comparison and storing " << time_store / num_strokes << " s on average" << endl;
+    cout << "Snapshots of " << num_strokes << " strokes and the mesh stored as full copies: " << mb(full_copies_size + mesh_size) << " MB" << endl;
+    cout << "Snapshots stored in chunks: " << mb(memsize) << " MB in " << store.num_chunks() << " chunks" << endl;
+    cout << "Cold chunks compressed in " << time_compress << " s: " << mb(memsize_compressed) << " MB, " << store.num_compressed_chunks() << " chunks compressed" << endl;
+    cout << "Compressed snapshot of " << mb(loaded.size()) << " MB loaded in " << time_load << " s" << endl;
+
+    return EXIT_SUCCESS;
+}
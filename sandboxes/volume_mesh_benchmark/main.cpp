@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include <tbb/parallel_for.h>
+
+#include <libslic3r/libslic3r.h>
+#include <libslic3r/TriangleMesh.hpp>
+
+#include "libnest2d/tools/benchmark.h"
+
+// Measures the CPU side preparation of the vertex arrays of the volumes of a large assembly for the 3D scene,
+// done one volume after the other and for all the volumes in parallel.
+// The assembly is made of spheres of varying resolution, so that the volumes differ in size.
+
+const std::string USAGE_STR = {
+    "Usage: volume_mesh_benchmark [volumes] [repeats]\n"
+    "       default 200 volumes, 3 runs"
+};
+
+int main(const int argc, const char *argv[])
+{
+    using namespace Slic3r;
+    using std::cout; using std::endl;
+
+    if (argc > 1 && (std::string(argv[1]) == "-h" || std::string(argv[1]) == "--help")) {
+        cout << USAGE_STR << endl;
+        return EXIT_SUCCESS;
+    }
+
+    const size_t num_volumes = argc > 1 ? std::max(1, atoi(argv[1])) : 200;
+    const int    repeats     = argc > 2 ? std::max(1, atoi(argv[2])) : 3;
+
+    std::vector<indexed_triangle_set> meshes;
+    size_t                            num_triangles = 0;
+    for (size_t i = 0; i < num_volumes; ++ i) {
+        meshes.emplace_back(its_make_sphere(10., PI / double(20 + 20 * (i % 8))));
+        num_triangles += meshes.back().indices.size();
+    }
+
+    // Vertex packing and the bounding box, as done by GLIndexedVertexArray::load_its_flat_shading().
+    auto prepare = [](const indexed_triangle_set &its, std::vector<float> &out) {
+        its_flat_shading_interleaved(its, out);
+        BoundingBoxf3 bbox;
+        for (size_t i = 3; i < out.size(); i += 6)
+            bbox.merge(Vec3d(out[i], out[i + 1], out[i + 2]));
+        return bbox;
+    };
+
+    Benchmark bench;
+    double time_serial_total   = 0.;
+    double time_serial_min     = std::numeric_limits<double>::max();
+    double time_parallel_total = 0.;
+    double time_parallel_min   = std::numeric_limits<double>::max();
+    for (int i = 0; i < repeats; ++ i) {
+        {
+            std::vector<std::vector<float>> vertex_arrays(meshes.size());
+            bench.start();
+            for (size_t j = 0; j < meshes.size(); ++ j)
+                prepare(meshes[j], vertex_arrays[j]);
+            bench.stop();
+            time_serial_total += bench.getElapsedSec();
+            time_serial_min    = std::min(time_serial_min, bench.getElapsedSec());
+        }
+        {
+            std::vector<std::vector<float>> vertex_arrays(meshes.size());
+            bench.start();
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, meshes.size(), 1), [&meshes, &vertex_arrays, &prepare](const tbb::blocked_range<size_t> &range) {
+                for (size_t j = range.begin(); j < range.end(); ++ j)
+                    prepare(meshes[j], vertex_arrays[j]);
+            });
+            bench.stop();
+            time_parallel_total += bench.getElapsedSec();
+            time_parallel_min    = std::min(time_parallel_min, bench.getElapsedSec());
+        }
+    }
+
+    cout << "Vertex arrays of " << num_volumes << " volumes, " << num_triangles << " triangles" << endl;
+    cout << "Serial preparation: average " << time_serial_total / repeats << " s, minimum " << time_serial_min << " s over " << repeats << " runs" << endl;
+    cout << "Parallel preparation: average " << time_parallel_total / repeats << " s, minimum " << time_parallel_min << " s over " << repeats << " runs" << endl;
+
+    return EXIT_SUCCESS;
+}
@@ -43,6 +43,9 @@ using namespace nlohmann;
 #include <boost/dll/runtime_symbol_info.hpp>
 #include <boost/log/trivial.hpp>
 
+#include <tbb/task_arena.h>
+#include <tbb/task_group.h>
+
 #include "unix/fhs.hpp"  // Generated by CMake from ../platform/unix/fhs.hpp.in
 
 #include "libslic3r/libslic3r.h"
@@ -206,6 +209,8 @@ typedef struct _sliced_info {
     std::vector<std::string> upward_compatibility_taint;
 }sliced_info_t;
 std::vector<PrintBase::SlicingStatus> g_slicing_warnings;
+// guards g_slicing_warnings, the G-code export of a plate may report warnings while the next plate is being sliced
+std::mutex g_slicing_warnings_mutex;
 
 #if defined(__linux__) || defined(__LINUX__)
 #define PIPE_BUFFER_SIZE 512
@@ -393,7 +398,10 @@ cli_callback_mgr_t g_cli_callback_mgr;
 void cli_status_callback(const PrintBase::SlicingStatus& slicing_status)
 {
     if (slicing_status.warning_step != -1) {
-        g_slicing_warnings.push_back(slicing_status);
+        {
+            std::lock_guard<std::mutex> lock(g_slicing_warnings_mutex);
+            g_slicing_warnings.push_back(slicing_status);
+        }
         BOOST_LOG_TRIVIAL(info) << __FUNCTION__ << boost::format(": percent=%1%, warning_step=%2%, message=%3%, message_type=%4%, flag=%5%")
             %slicing_status.percent %slicing_status.warning_step %slicing_status.text %(int)(slicing_status.message_type) %slicing_status.flags;
     }
@@ -405,6 +413,7 @@ void cli_status_callback(const PrintBase::SlicingStatus& slicing_status)
 void default_status_callback(const PrintBase::SlicingStatus& slicing_status)
 {
     if (slicing_status.warning_step != -1) {
+        std::lock_guard<std::mutex> lock(g_slicing_warnings_mutex);
         g_slicing_warnings.push_back(slicing_status);
     }
     BOOST_LOG_TRIVIAL(debug) << __FUNCTION__ << boost::format(": percent=%1%, warning_step=%2%, message=%3%, message_type=%4%")%slicing_status.percent %slicing_status.warning_step %slicing_status.text %(int)(slicing_status.message_type);
@@ -1540,7 +1549,7 @@ int CLI::run(int argc, char **argv)
     PlateDataPtrs plate_data_src;
     std::vector<plate_obj_size_info_t> plate_obj_size_infos;
     //int arrange_option;
-    int plate_to_slice = 0, filament_count = 0, duplicate_count = 0, real_duplicate_count = 0, current_extruder_count = 1, new_extruder_count = 1, current_printer_variant_count = 1, current_print_variant_count = 1, new_printer_variant_count = 1;
+    int plate_to_slice = 0, slice_concurrency = 1, filament_count = 0, duplicate_count = 0, real_duplicate_count = 0, current_extruder_count = 1, new_extruder_count = 1, current_printer_variant_count = 1, current_print_variant_count = 1, new_printer_variant_count = 1;
     bool first_file = true, is_bbl_3mf = false, need_arrange = true, has_thumbnails = false, up_config_to_date = false, normative_check = true, duplicate_single_object = false, use_first_fila_as_default = false, minimum_save = false, enable_timelapse = false, has_support = false;
     bool allow_rotations = true, skip_modified_gcodes = false, avoid_extrusion_cali_region = false, skip_useless_pick = false, allow_newer_file = false, current_is_multi_extruder = false, new_is_multi_extruder = false, allow_mix_temp = false, enable_wrapping_detect = false;
     Semver file_version;
@@ -1602,6 +1611,10 @@ int CLI::run(int argc, char **argv)
     if (skip_useless_picks_option)
         skip_useless_pick = skip_useless_picks_option->value;
 
+    ConfigOptionInt* slice_concurrency_option = m_config.option<ConfigOptionInt>("slice_concurrency");
+    if (slice_concurrency_option)
+        slice_concurrency = slice_concurrency_option->value;
+
     ConfigOptionBool* allow_newer_file_option = m_config.option<ConfigOptionBool>("allow_newer_file");
     if (allow_newer_file_option)
         allow_newer_file = allow_newer_file_option->value;
@@ -6125,6 +6138,231 @@ int CLI::run(int argc, char **argv)
                 //Print       fff_print;
                 std::vector<size_t> plate_triangle_counts(partplate_list.get_plate_count(), 0);
 
+                // BBS: when slicing all plates with a thread budget, the G-code of a plate is exported by a worker of the shared arena
+                // while the next plate is being sliced. The plate is checked and recorded once the next plate is sliced, in plate order,
+                // so the outputs are the same as slicing the plates one by one.
+                std::unique_ptr<tbb::task_arena> slice_arena;
+                if ((plate_to_slice == 0) && (slice_concurrency != 1) && (printer_technology == ptFFF) && (partplate_list.get_plate_count() > 1)
+#if defined(__linux__) || defined(__LINUX__)
+                    // the cli callback reports the progress of a single plate
+                    && !g_cli_callback_mgr.is_started()
+#endif
+                    ) {
+                    slice_arena = std::make_unique<tbb::task_arena>(slice_concurrency > 0 ? slice_concurrency : int(tbb::task_arena::automatic));
+                    BOOST_LOG_TRIVIAL(info) << boost::format("slice plates pipelined, slice_concurrency %1%, arena concurrency %2%")%slice_concurrency %slice_arena->max_concurrency();
+                }
+
+                struct PlateExport
+                {
+                    int                                        index { 0 };
+                    PrintBase                                 *print { nullptr };
+                    Slic3r::GUI::GCodeResult                  *gcode_result { nullptr };
+                    Slic3r::GUI::PartPlate                    *part_plate { nullptr };
+                    sliced_plate_info_t                        sliced_plate_info;
+                    std::unordered_map<std::string, long long> slice_time;
+                    long long                                  start_time { 0 };
+                    // time the G-code export of this plate finished, 0 if it was not exported
+                    long long                                  export_end_time { 0 };
+                    std::string                                outfile;
+                };
+                std::unique_ptr<PlateExport> pending_export;
+                tbb::task_group              export_tasks;
+
+                auto export_plate_gcode = [](PlateExport &plate_export, ThumbnailsGeneratorCallback thumbnail_cb) {
+                    long long temp_time = (long long)Slic3r::Utils::get_current_milliseconds_time_utc();
+                    plate_export.outfile = static_cast<Print*>(plate_export.print)->export_gcode(plate_export.outfile, plate_export.gcode_result, thumbnail_cb);
+                    plate_export.export_end_time = (long long)Slic3r::Utils::get_current_milliseconds_time_utc();
+                    plate_export.slice_time[TIME_USING_CACHE] = plate_export.slice_time[TIME_USING_CACHE] + (plate_export.export_end_time - temp_time);
+                    BOOST_LOG_TRIVIAL(info) << "export_gcode finished: time_using_cache update to " << plate_export.slice_time[TIME_USING_CACHE] << " secs.";
+                };
+
+                // check the exported G-code of a plate and record its statistics, returns the exit code, 0 on success
+                auto finish_plate_export = [&](PlateExport &plate_export) -> int {
+                    // the G-code of a plate exported in background may be finished after the next plate was sliced,
+                    // only the time of the export itself and of the work below is accounted to this plate
+                    long long                                   finish_time       = (long long)Slic3r::Utils::get_current_milliseconds_time_utc();
+                    int                                         index             = plate_export.index;
+                    PrintBase                                  *print             = plate_export.print;
+                    Slic3r::GUI::GCodeResult                   *gcode_result      = plate_export.gcode_result;
+                    Slic3r::GUI::PartPlate                     *part_plate        = plate_export.part_plate;
+                    sliced_plate_info_t                        &sliced_plate_info = plate_export.sliced_plate_info;
+                    std::unordered_map<std::string, long long> &slice_time        = plate_export.slice_time;
+                    long long                                   start_time        = plate_export.start_time, end_time = 0;
+                    outfile = plate_export.outfile;
+
+                    if (printer_technology == ptFFF) {
+                        if (gcode_result && gcode_result->gcode_check_result.error_code) {
+                            BOOST_LOG_TRIVIAL(error) << "plate " << index + 1 << ": found gcode unprintable! gcode_result->gcode_check_result.error_code = "
+                                    << gcode_result->gcode_check_result.error_code << std::endl;
+                            //found gcode error
+                            if (gcode_result->gcode_check_result.error_code & 0b1100) {
+                                record_exit_reson(outfile_dir, CLI_GCODE_PATH_OUTSIDE, index + 1, cli_errors[CLI_GCODE_PATH_OUTSIDE], sliced_info);
+                                return CLI_GCODE_PATH_OUTSIDE;
+                            }
+                            else if (gcode_result->gcode_check_result.error_code & 0b10000) {
+                                record_exit_reson(outfile_dir, CLI_GCODE_IN_WRAPPING_DETECT_AREA, index + 1, cli_errors[CLI_GCODE_IN_WRAPPING_DETECT_AREA], sliced_info);
+                                return CLI_GCODE_IN_WRAPPING_DETECT_AREA;
+                            }
+                            else if (gcode_result->gcode_check_result.error_code & 0b00011) {
+                                record_exit_reson(outfile_dir, CLI_GCODE_PATH_IN_UNPRINTABLE_AREA, index + 1, cli_errors[CLI_GCODE_PATH_IN_UNPRINTABLE_AREA], sliced_info);
+                                return CLI_GCODE_PATH_IN_UNPRINTABLE_AREA;
+                            }
+                        }
+
+                        if (gcode_result && gcode_result->filament_printable_reuslt.has_value()) {
+                            //found gcode error
+                            BOOST_LOG_TRIVIAL(error) << "plate " << index + 1 << ": found some filament unprintable on current bed- "<< gcode_result->filament_printable_reuslt.plate_name << std::endl;
+                            record_exit_reson(outfile_dir, CLI_FILAMENT_UNPRINTABLE_ON_FIRST_LAYER, index + 1, cli_errors[CLI_FILAMENT_UNPRINTABLE_ON_FIRST_LAYER], sliced_info);
+                            return CLI_FILAMENT_UNPRINTABLE_ON_FIRST_LAYER;
+                        }
+                    }
+                    BOOST_LOG_TRIVIAL(info) << "Slicing result exported to " << outfile << std::endl;
+                    part_plate->update_slice_result_valid_state(true);
+#if defined(__linux__) || defined(__LINUX__)
+                    if (g_cli_callback_mgr.is_started()) {
+                        PrintBase::SlicingStatus slicing_status{100, "Slicing finished"};
+                        cli_status_callback(slicing_status);
+                    }
+#endif
+                    if (export_slicedata) {
+                        BOOST_LOG_TRIVIAL(info) << boost::format("plate %1% will export Slicing data to %2%")%(index+1) %export_slice_data_dir;
+                        std::string plate_dir = export_slice_data_dir+"/"+std::to_string(index+1);
+                        bool with_space = (get_logging_level() >= 4)?true:false;
+                        int ret = print->export_cached_data(plate_dir, sliced_plate_info.obj_cached_cnt, with_space);
+                        if (ret) {
+                            BOOST_LOG_TRIVIAL(error) << "plate "<< index+1<< ": export Slicing data error, ret=" << ret;
+                            export_slicedata_error = true;
+                            if (fs::exists(plate_dir))
+                                fs::remove_all(plate_dir);
+                            record_exit_reson(outfile_dir, ret, index+1, cli_errors[ret], sliced_info);
+                            return ret;
+                        }
+                        BOOST_LOG_TRIVIAL(info) << boost::format("plate %1% exported %2% objects")%(index+1) %(sliced_plate_info.obj_cached_cnt);
+                    }
+                    end_time = (long long)Slic3r::Utils::get_current_milliseconds_time_utc();
+                    if (plate_export.export_end_time != 0)
+                        end_time = plate_export.export_end_time + (end_time - finish_time);
+                    sliced_plate_info.sliced_time = end_time - start_time;
+                    sliced_plate_info.sliced_time_with_cache = slice_time[TIME_USING_CACHE];
+                    sliced_plate_info.make_perimeters_time = slice_time[TIME_MAKE_PERIMETERS];
+                    sliced_plate_info.infill_time = slice_time[TIME_INFILL];
+                    sliced_plate_info.generate_support_material_time = slice_time[TIME_GENERATE_SUPPORT];
+
+                    //get predication and filament change
+                    PrintEstimatedStatistics& print_estimated_stat = gcode_result->print_statistics;
+                    const PrintEstimatedStatistics::Mode& time_mode = print_estimated_stat.modes[static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Normal)];
+                    auto it_wipe = std::find_if(time_mode.roles_times.begin(), time_mode.roles_times.end(), [](const std::pair<ExtrusionRole, float>& item) { return ExtrusionRole::erWipeTower == item.first; });
+                    sliced_plate_info.total_predication = time_mode.time;
+                    sliced_plate_info.main_predication = time_mode.time - time_mode.prepare_time;
+                    sliced_plate_info.filament_change_times = print_estimated_stat.total_filament_changes;
+                    if (it_wipe != time_mode.roles_times.end()) {
+                        //filament changes time will be included in prime tower time later
+                        //ConfigOptionFloat* machine_load_filament_time_opt = m_print_config.option<ConfigOptionFloat>("machine_load_filament_time");
+                        //ConfigOptionFloat* machine_unload_filament_time_opt = m_print_config.option<ConfigOptionFloat>("machine_unload_filament_time");
+                        sliced_plate_info.main_predication -= it_wipe->second;
+                        //sliced_plate_info.main_predication -= sliced_plate_info.filament_change_times * (machine_load_filament_time_opt->value + machine_unload_filament_time_opt->value);
+                    }
+                    auto it_flush = std::find_if(time_mode.roles_times.begin(), time_mode.roles_times.end(), [](const std::pair<ExtrusionRole, float>& item) { return ExtrusionRole::erFlush == item.first; });
+                    if (it_flush != time_mode.roles_times.end()) {
+                        sliced_plate_info.main_predication -= it_flush->second;
+                    }
+                    bool has_tool_change = false;
+                    auto custom_gcodes_iter = model.plates_custom_gcodes.find(index);
+                    if (custom_gcodes_iter != model.plates_custom_gcodes.end())
+                    {
+                        CustomGCode::Info custom_gcodes = custom_gcodes_iter->second;
+                        for (const CustomGCode::Item& custom_gcode : custom_gcodes.gcodes)
+                            if (custom_gcode.type == CustomGCode::ToolChange) {
+                                has_tool_change = true;
+                                break;
+                            }
+                    }
+                    if (has_tool_change)
+                        sliced_plate_info.layer_filament_change = print_estimated_stat.total_filament_changes;
+
+                    //filaments
+                    auto* filament_ids = dynamic_cast<const ConfigOptionStrings*>(m_print_config.option("filament_ids"));
+                    std::vector<float>        filament_diameters = gcode_result->filament_diameters;
+                    std::vector<float>        filament_densities = gcode_result->filament_densities;
+
+                    for (auto& iter : print_estimated_stat.total_volumes_per_extruder)
+                    {
+                        filament_info_t filament_info;
+
+                        filament_info.id = iter.first + 1;
+                        filament_info.total_used_g = iter.second;
+
+                        if (filament_ids && (filament_info.id <= filament_ids->values.size()))
+                            filament_info.filament_id = filament_ids->values[iter.first];
+                        else
+                            filament_info.filament_id = "unknown";
+
+                        auto main_iter = print_estimated_stat.model_volumes_per_extruder.find(iter.first);
+                        if (main_iter != print_estimated_stat.model_volumes_per_extruder.end())
+                            filament_info.main_used_g = main_iter->second;
+
+                        auto support_iter = print_estimated_stat.support_volumes_per_extruder.find(iter.first);
+                        if (support_iter != print_estimated_stat.support_volumes_per_extruder.end())
+                            filament_info.main_used_g += support_iter->second;
+
+                        double koef = 0.001;
+                        //filament_info.main_used_m = koef * filament_info.main_used_m / (PI * sqr(0.5 * filament_diameters[filament_info.id]));
+                        filament_info.main_used_g = koef * filament_info.main_used_g * filament_densities[iter.first];
+                        filament_info.total_used_g = koef * filament_info.total_used_g * filament_densities[iter.first];
+
+                        sliced_plate_info.filaments.push_back(std::move(filament_info));
+                    }
+
+                    //objects
+                    ModelObjectPtrs plate_objects = part_plate->get_objects_on_this_plate();
+                    for (ModelObject* object : plate_objects)
+                    {
+                        object_info_t object_info;
+                        object_info.id = object->id().id;
+                        object_info.name = object->name;
+                        object_info.triangle_count = object->facets_count();
+
+                        BoundingBoxf3 bbox_f = object->bounding_box();
+                        object_info.bbox_x = bbox_f.min.x();
+                        object_info.bbox_y = bbox_f.min.y();
+                        object_info.bbox_z = bbox_f.min.z();
+                        object_info.bbox_width = bbox_f.max.x() - object_info.bbox_x;
+                        object_info.bbox_depth = bbox_f.max.y() - object_info.bbox_y;
+                        object_info.bbox_height = bbox_f.max.z() - object_info.bbox_z;
+
+                        sliced_plate_info.objects.push_back(std::move(object_info));
+                    }
+
+                    if (max_slicing_time_per_plate != 0) {
+                        long long time_cost = end_time - start_time;
+                        if (time_cost > max_slicing_time_per_plate * 1000) {
+                            sliced_plate_info.warning_message = (boost::format("plate %1%'s slice time %2% exceeds the limit %3%, return error.")%(index+1) %time_cost %(max_slicing_time_per_plate * 1000)).str();
+                            BOOST_LOG_TRIVIAL(error) << sliced_plate_info.warning_message;
+                            sliced_info.sliced_plates.push_back(sliced_plate_info);
+                            record_exit_reson(outfile_dir, CLI_SLICING_TIME_EXCEEDS_LIMIT, index+1, cli_errors[CLI_SLICING_TIME_EXCEEDS_LIMIT], sliced_info);
+                            return CLI_SLICING_TIME_EXCEEDS_LIMIT;
+                        }
+                    }
+                    sliced_info.sliced_plates.push_back(sliced_plate_info);
+                    return 0;
+                };
+
+                // wait for the G-code export of the previous plate and finish it, returns the exit code, 0 on success
+                auto finish_pending_export = [&]() -> int {
+                    if (!pending_export)
+                        return 0;
+                    std::unique_ptr<PlateExport> plate_export = std::move(pending_export);
+                    try {
+                        slice_arena->execute([&export_tasks]() { export_tasks.wait(); });
+                        return finish_plate_export(*plate_export);
+                    } catch (const std::exception &ex) {
+                        BOOST_LOG_TRIVIAL(error) << "found slicing or export error for partplate "<<plate_export->index+1 << std::endl;
+                        boost::nowide::cerr << ex.what() << std::endl;
+                        record_exit_reson(outfile_dir, CLI_SLICING_ERROR, plate_export->index+1, cli_errors[CLI_SLICING_ERROR], sliced_info);
+                        return CLI_SLICING_ERROR;
+                    }
+                };
+
                 while(!finished)
                 {
                     //BBS: slice every partplate one by one
@@ -6144,7 +6382,7 @@ int CLI::run(int argc, char **argv)
 
                         model.curr_plate_index = index;
                         BOOST_LOG_TRIVIAL(info) << boost::format("Plate %1%: pre_check %2%, start")%(index+1)%pre_check;
-                        long long start_time = 0, end_time = 0, temp_time = 0;
+                        long long start_time = 0;
 
                         std::unordered_map<std::string, long long> slice_time;
                         slice_time[TIME_USING_CACHE] = 0;
@@ -6181,6 +6419,8 @@ int CLI::run(int argc, char **argv)
                         unsigned int count = model.update_print_volume_state(build_volume);
 
                         if (count == 0) {
+                            if (int ret = finish_pending_export())
+                                flush_and_exit(ret);
                             BOOST_LOG_TRIVIAL(error) << "plate "<< index+1<< ": Nothing to be sliced, Either the print is empty or no object is fully inside the print volume before apply." << std::endl;
                             record_exit_reson(outfile_dir, CLI_NO_SUITABLE_OBJECTS, index+1, cli_errors[CLI_NO_SUITABLE_OBJECTS], sliced_info);
                             flush_and_exit(CLI_NO_SUITABLE_OBJECTS);
@@ -6617,6 +6857,8 @@ int CLI::run(int argc, char **argv)
                                 BOOST_LOG_TRIVIAL(warning) << "got warnings: "<< err.string << std::endl;
                             }
                             else {
+                                if (int ret = finish_pending_export())
+                                    flush_and_exit(ret);
                                 BOOST_LOG_TRIVIAL(error) << "got error when validate: "<< err.string << std::endl;
                                 boost::nowide::cerr << err.string << std::endl;
                                 int validate_error;
@@ -6650,6 +6892,8 @@ int CLI::run(int argc, char **argv)
                         }
 
                         if (print->empty()) {
+                            if (int ret = finish_pending_export())
+                                flush_and_exit(ret);
                             BOOST_LOG_TRIVIAL(error) << "plate "<< index+1<< ": Nothing to be sliced, Either the print is empty or no object is fully inside the print volume after apply." << std::endl;
                             record_exit_reson(outfile_dir, CLI_NO_SUITABLE_OBJECTS, index+1, cli_errors[CLI_NO_SUITABLE_OBJECTS], sliced_info);
                             flush_and_exit(CLI_NO_SUITABLE_OBJECTS);
@@ -6704,30 +6948,40 @@ int CLI::run(int argc, char **argv)
                                 const PrintConfig& print_config = print_fff->config();
                                 Model::setExtruderParams(m_print_config, filament_count);
                                 Model::setPrintSpeedTable(m_print_config, print_config);
-                                if (load_slicedata) {
-                                    std::string plate_dir = load_slice_data_dir+"/"+std::to_string(index+1);
-                                    int ret = print->load_cached_data(plate_dir);
-                                    if (ret) {
-                                        BOOST_LOG_TRIVIAL(warning) << "plate "<< index+1<< ": load Slicing data error, ret=" << ret;
-                                        BOOST_LOG_TRIVIAL(warning) << "plate "<< index+1<< ": switch normal slicing";
-                                        print->process();
-                                    }
-                                    else {
-                                        BOOST_LOG_TRIVIAL(info) << "plate "<< index+1<< ": load cached data success, go on.";
-#if defined(__linux__) || defined(__LINUX__)
-                                        if (g_cli_callback_mgr.is_started()) {
-                                            PrintBase::SlicingStatus slicing_status{69, "Cache data loaded"};
-                                            cli_status_callback(slicing_status);
+                                // in the pipelined mode the plate is sliced in the shared arena, concurrently with the G-code export of the previous plate
+                                auto process_plate = [&]() {
+                                    if (load_slicedata) {
+                                        std::string plate_dir = load_slice_data_dir+"/"+std::to_string(index+1);
+                                        int ret = print->load_cached_data(plate_dir);
+                                        if (ret) {
+                                            BOOST_LOG_TRIVIAL(warning) << "plate "<< index+1<< ": load Slicing data error, ret=" << ret;
+                                            BOOST_LOG_TRIVIAL(warning) << "plate "<< index+1<< ": switch normal slicing";
+                                            print->process();
                                         }
+                                        else {
+                                            BOOST_LOG_TRIVIAL(info) << "plate "<< index+1<< ": load cached data success, go on.";
+#if defined(__linux__) || defined(__LINUX__)
+                                            if (g_cli_callback_mgr.is_started()) {
+                                                PrintBase::SlicingStatus slicing_status{69, "Cache data loaded"};
+                                                cli_status_callback(slicing_status);
+                                            }
 #endif
-                                        print->process(nullptr, true);
-                                        BOOST_LOG_TRIVIAL(info) << "plate "<< index+1<< ": finished print::process.";
+                                            print->process(nullptr, true);
+                                            BOOST_LOG_TRIVIAL(info) << "plate "<< index+1<< ": finished print::process.";
+                                        }
                                     }
-                                }
-                                else {
-                                    print->process(&slice_time);
-                                    BOOST_LOG_TRIVIAL(info) << "print::process: first time_using_cache is " << slice_time[TIME_USING_CACHE] << " secs.";
-                                }
+                                    else {
+                                        print->process(&slice_time);
+                                        BOOST_LOG_TRIVIAL(info) << "print::process: first time_using_cache is " << slice_time[TIME_USING_CACHE] << " secs.";
+                                    }
+                                };
+                                if (slice_arena)
+                                    slice_arena->execute(process_plate);
+                                else
+                                    process_plate();
+                                if (int ret = finish_pending_export())
+                                    flush_and_exit(ret);
+                                ThumbnailsGeneratorCallback thumbnail_cb = nullptr;
                                 if (printer_technology == ptFFF) {
                                     std::string conflict_result = print_fff->get_conflict_string();
                                     if (!conflict_result.empty()) {
@@ -6797,41 +7051,11 @@ int CLI::run(int argc, char **argv)
                                         part_plate->set_tmp_gcode_path(outfile);
                                     }
                                     BOOST_LOG_TRIVIAL(info) << "process finished, will export gcode temporily to " << outfile << std::endl;
-                                    temp_time = (long long)Slic3r::Utils::get_current_milliseconds_time_utc();
-                                    if (is_bbl_vendor_preset) {
-                                        outfile = print_fff->export_gcode(outfile, gcode_result, nullptr);
-                                    }
-                                    else {
+                                    if (!is_bbl_vendor_preset) {
                                         if (!opengl_valid)
                                             opengl_valid = init_opengl_and_colors(model, colors);
-                                        outfile = opengl_valid ? print_fff->export_gcode(outfile, gcode_result, cli_generate_thumbnails) : print_fff->export_gcode(outfile, gcode_result, nullptr);
-                                    }
-                                    slice_time[TIME_USING_CACHE] = slice_time[TIME_USING_CACHE] + ((long long)Slic3r::Utils::get_current_milliseconds_time_utc() - temp_time);
-                                    BOOST_LOG_TRIVIAL(info) << "export_gcode finished: time_using_cache update to " << slice_time[TIME_USING_CACHE] << " secs.";
-
-                                    if (gcode_result && gcode_result->gcode_check_result.error_code) {
-                                        BOOST_LOG_TRIVIAL(error) << "plate " << index + 1 << ": found gcode unprintable! gcode_result->gcode_check_result.error_code = "
-                                                << gcode_result->gcode_check_result.error_code << std::endl;
-                                        //found gcode error
-                                        if (gcode_result->gcode_check_result.error_code & 0b1100) {
-                                            record_exit_reson(outfile_dir, CLI_GCODE_PATH_OUTSIDE, index + 1, cli_errors[CLI_GCODE_PATH_OUTSIDE], sliced_info);
-                                            flush_and_exit(CLI_GCODE_PATH_OUTSIDE);
-                                        }
-                                        else if (gcode_result->gcode_check_result.error_code & 0b10000) {
-                                            record_exit_reson(outfile_dir, CLI_GCODE_IN_WRAPPING_DETECT_AREA, index + 1, cli_errors[CLI_GCODE_IN_WRAPPING_DETECT_AREA], sliced_info);
-                                            flush_and_exit(CLI_GCODE_IN_WRAPPING_DETECT_AREA);
-                                        }
-                                        else if (gcode_result->gcode_check_result.error_code & 0b00011) {
-                                            record_exit_reson(outfile_dir, CLI_GCODE_PATH_IN_UNPRINTABLE_AREA, index + 1, cli_errors[CLI_GCODE_PATH_IN_UNPRINTABLE_AREA], sliced_info);
-                                            flush_and_exit(CLI_GCODE_PATH_IN_UNPRINTABLE_AREA);
-                                        }
-                                    }
-
-                                    if (gcode_result && gcode_result->filament_printable_reuslt.has_value()) {
-                                        //found gcode error
-                                        BOOST_LOG_TRIVIAL(error) << "plate " << index + 1 << ": found some filament unprintable on current bed- "<< gcode_result->filament_printable_reuslt.plate_name << std::endl;
-                                        record_exit_reson(outfile_dir, CLI_FILAMENT_UNPRINTABLE_ON_FIRST_LAYER, index + 1, cli_errors[CLI_FILAMENT_UNPRINTABLE_ON_FIRST_LAYER], sliced_info);
-                                        flush_and_exit(CLI_FILAMENT_UNPRINTABLE_ON_FIRST_LAYER);
+                                        if (opengl_valid)
+                                            thumbnail_cb = cli_generate_thumbnails;
                                     }
 
                                     //outfile_final = (dynamic_cast<Print*>(print))->print_statistics().finalize_output_path(outfile);
@@ -6852,133 +7076,31 @@ int CLI::run(int argc, char **argv)
                                 }*/
                                 // Run the post-processing scripts if defined.
                                 //run_post_process_scripts(outfile, print->full_print_config());
-                                BOOST_LOG_TRIVIAL(info) << "Slicing result exported to " << outfile << std::endl;
-                                part_plate->update_slice_result_valid_state(true);
-#if defined(__linux__) || defined(__LINUX__)
-                                if (g_cli_callback_mgr.is_started()) {
-                                    PrintBase::SlicingStatus slicing_status{100, "Slicing finished"};
-                                    cli_status_callback(slicing_status);
-                                }
-#endif
-                                if (export_slicedata) {
-                                    BOOST_LOG_TRIVIAL(info) << boost::format("plate %1% will export Slicing data to %2%")%(index+1) %export_slice_data_dir;
-                                    std::string plate_dir = export_slice_data_dir+"/"+std::to_string(index+1);
-                                    bool with_space = (get_logging_level() >= 4)?true:false;
-                                    int ret = print->export_cached_data(plate_dir, sliced_plate_info.obj_cached_cnt, with_space);
-                                    if (ret) {
-                                        BOOST_LOG_TRIVIAL(error) << "plate "<< index+1<< ": export Slicing data error, ret=" << ret;
-                                        export_slicedata_error = true;
-                                        if (fs::exists(plate_dir))
-                                            fs::remove_all(plate_dir);
-                                        record_exit_reson(outfile_dir, ret, index+1, cli_errors[ret], sliced_info);
-                                        flush_and_exit(ret);
-                                    }
-                                    BOOST_LOG_TRIVIAL(info) << boost::format("plate %1% exported %2% objects")%(index+1) %(sliced_plate_info.obj_cached_cnt);
-                                }
-                                end_time = (long long)Slic3r::Utils::get_current_milliseconds_time_utc();
-                                sliced_plate_info.sliced_time = end_time - start_time;
-                                sliced_plate_info.sliced_time_with_cache = slice_time[TIME_USING_CACHE];
-                                sliced_plate_info.make_perimeters_time = slice_time[TIME_MAKE_PERIMETERS];
-                                sliced_plate_info.infill_time = slice_time[TIME_INFILL];
-                                sliced_plate_info.generate_support_material_time = slice_time[TIME_GENERATE_SUPPORT];
-
-                                //get predication and filament change
-                                PrintEstimatedStatistics& print_estimated_stat = gcode_result->print_statistics;
-                                const PrintEstimatedStatistics::Mode& time_mode = print_estimated_stat.modes[static_cast<size_t>(PrintEstimatedStatistics::ETimeMode::Normal)];
-                                auto it_wipe = std::find_if(time_mode.roles_times.begin(), time_mode.roles_times.end(), [](const std::pair<ExtrusionRole, float>& item) { return ExtrusionRole::erWipeTower == item.first; });
-                                sliced_plate_info.total_predication = time_mode.time;
-                                sliced_plate_info.main_predication = time_mode.time - time_mode.prepare_time;
-                                sliced_plate_info.filament_change_times = print_estimated_stat.total_filament_changes;
-                                if (it_wipe != time_mode.roles_times.end()) {
-                                    //filament changes time will be included in prime tower time later
-                                    //ConfigOptionFloat* machine_load_filament_time_opt = m_print_config.option<ConfigOptionFloat>("machine_load_filament_time");
-                                    //ConfigOptionFloat* machine_unload_filament_time_opt = m_print_config.option<ConfigOptionFloat>("machine_unload_filament_time");
-                                    sliced_plate_info.main_predication -= it_wipe->second;
-                                    //sliced_plate_info.main_predication -= sliced_plate_info.filament_change_times * (machine_load_filament_time_opt->value + machine_unload_filament_time_opt->value);
-                                }
-                                auto it_flush = std::find_if(time_mode.roles_times.begin(), time_mode.roles_times.end(), [](const std::pair<ExtrusionRole, float>& item) { return ExtrusionRole::erFlush == item.first; });
-                                if (it_flush != time_mode.roles_times.end()) {
-                                    sliced_plate_info.main_predication -= it_flush->second;
-                                }
-                                bool has_tool_change = false;
-                                auto custom_gcodes_iter = model.plates_custom_gcodes.find(index);
-                                if (custom_gcodes_iter != model.plates_custom_gcodes.end())
-                                {
-                                    CustomGCode::Info custom_gcodes = custom_gcodes_iter->second;
-                                    for (const CustomGCode::Item& custom_gcode : custom_gcodes.gcodes)
-                                        if (custom_gcode.type == CustomGCode::ToolChange) {
-                                            has_tool_change = true;
-                                            break;
-                                        }
-                                }
-                                if (has_tool_change)
-                                    sliced_plate_info.layer_filament_change = print_estimated_stat.total_filament_changes;
-
-                                //filaments
-                                auto* filament_ids = dynamic_cast<const ConfigOptionStrings*>(m_print_config.option("filament_ids"));
-                                std::vector<float>        filament_diameters = gcode_result->filament_diameters;
-                                std::vector<float>        filament_densities = gcode_result->filament_densities;
-
-                                for (auto& iter : print_estimated_stat.total_volumes_per_extruder)
-                                {
-                                    filament_info_t filament_info;
-
-                                    filament_info.id = iter.first + 1;
-                                    filament_info.total_used_g = iter.second;
-
-                                    if (filament_ids && (filament_info.id <= filament_ids->values.size()))
-                                        filament_info.filament_id = filament_ids->values[iter.first];
-                                    else
-                                        filament_info.filament_id = "unknown";
-
-                                    auto main_iter = print_estimated_stat.model_volumes_per_extruder.find(iter.first);
-                                    if (main_iter != print_estimated_stat.model_volumes_per_extruder.end())
-                                        filament_info.main_used_g = main_iter->second;
-
-                                    auto support_iter = print_estimated_stat.support_volumes_per_extruder.find(iter.first);
-                                    if (support_iter != print_estimated_stat.support_volumes_per_extruder.end())
-                                        filament_info.main_used_g += support_iter->second;
-
-                                    double koef = 0.001;
-                                    //filament_info.main_used_m = koef * filament_info.main_used_m / (PI * sqr(0.5 * filament_diameters[filament_info.id]));
-                                    filament_info.main_used_g = koef * filament_info.main_used_g * filament_densities[iter.first];
-                                    filament_info.total_used_g = koef * filament_info.total_used_g * filament_densities[iter.first];
-
-                                    sliced_plate_info.filaments.push_back(std::move(filament_info));
-                                }
-
-                                //objects
-                                ModelObjectPtrs plate_objects = part_plate->get_objects_on_this_plate();
-                                for (ModelObject* object : plate_objects)
-                                {
-                                    object_info_t object_info;
-                                    object_info.id = object->id().id;
-                                    object_info.name = object->name;
-                                    object_info.triangle_count = object->facets_count();
-
-                                    BoundingBoxf3 bbox_f = object->bounding_box();
-                                    object_info.bbox_x = bbox_f.min.x();
-                                    object_info.bbox_y = bbox_f.min.y();
-                                    object_info.bbox_z = bbox_f.min.z();
-                                    object_info.bbox_width = bbox_f.max.x() - object_info.bbox_x;
-                                    object_info.bbox_depth = bbox_f.max.y() - object_info.bbox_y;
-                                    object_info.bbox_height = bbox_f.max.z() - object_info.bbox_z;
-
-                                    sliced_plate_info.objects.push_back(std::move(object_info));
-                                }
-
-                                if (max_slicing_time_per_plate != 0) {
-                                    long long time_cost = end_time - start_time;
-                                    if (time_cost > max_slicing_time_per_plate * 1000) {
-                                        sliced_plate_info.warning_message = (boost::format("plate %1%'s slice time %2% exceeds the limit %3%, return error.")%(index+1) %time_cost %(max_slicing_time_per_plate * 1000)).str();
-                                        BOOST_LOG_TRIVIAL(error) << sliced_plate_info.warning_message;
-                                        sliced_info.sliced_plates.push_back(sliced_plate_info);
-                                        record_exit_reson(outfile_dir, CLI_SLICING_TIME_EXCEEDS_LIMIT, index+1, cli_errors[CLI_SLICING_TIME_EXCEEDS_LIMIT], sliced_info);
-                                        flush_and_exit(CLI_SLICING_TIME_EXCEEDS_LIMIT);
+                                auto plate_export = std::make_unique<PlateExport>();
+                                plate_export->index             = index;
+                                plate_export->print             = print;
+                                plate_export->gcode_result      = gcode_result;
+                                plate_export->part_plate        = part_plate;
+                                plate_export->sliced_plate_info = std::move(sliced_plate_info);
+                                plate_export->slice_time        = std::move(slice_time);
+                                plate_export->start_time        = start_time;
+                                plate_export->outfile           = outfile;
+                                if (printer_technology == ptFFF) {
+                                    if (slice_arena && !thumbnail_cb) {
+                                        // the thumbnails are rendered by the OpenGL context of this thread, only the plates without them are exported in background
+                                        pending_export = std::move(plate_export);
+                                        slice_arena->execute([&export_tasks, &export_plate_gcode, job = pending_export.get()]() {
+                                            export_tasks.run([&export_plate_gcode, job]() { export_plate_gcode(*job, nullptr); });
+                                        });
+                                        continue;
                                     }
+                                    export_plate_gcode(*plate_export, thumbnail_cb);
                                 }
-                                sliced_info.sliced_plates.push_back(sliced_plate_info);
+                                if (int ret = finish_plate_export(*plate_export))
+                                    flush_and_exit(ret);
                             } catch (const std::exception &ex) {
+                                if (int ret = finish_pending_export())
+                                    flush_and_exit(ret);
                                 BOOST_LOG_TRIVIAL(error) << "found slicing or export error for partplate "<<index+1 << std::endl;
                                 boost::nowide::cerr << ex.what() << std::endl;
                                 //continue;
@@ -6987,6 +7109,8 @@ int CLI::run(int argc, char **argv)
                             }
                         }
                     }
+                    if (int ret = finish_pending_export())
+                        flush_and_exit(ret);
                     if (pre_check&& (partplate_list.get_plate_count() > 1))
                         pre_check = false;
                     else
@@ -34,6 +34,8 @@
 #define BOOST_POOL_NO_MT
 #include <boost/pool/object_pool.hpp>
 
+#include <tbb/parallel_for.h>
+
 #include "stl.h"
 
 struct HashEdge {
@@ -53,11 +55,14 @@ struct HashEdge {
 
 	void load_exact(stl_file *stl, const stl_vertex *a, const stl_vertex *b)
 	{
-		{
-	    	stl_vertex diff = (*a - *b).cwiseAbs();
-	    	float max_diff = std::max(diff(0), std::max(diff(1), diff(2)));
-	    	stl->stats.shortest_edge = std::min(max_diff, stl->stats.shortest_edge);
-	  	}
+		stl->stats.shortest_edge = std::min(this->load_exact(a, b), stl->stats.shortest_edge);
+	}
+
+	// Returns the length of the edge in the maximum norm.
+	float load_exact(const stl_vertex *a, const stl_vertex *b)
+	{
+    	stl_vertex diff     = (*a - *b).cwiseAbs();
+    	float      max_diff = std::max(diff(0), std::max(diff(1), diff(2)));
 
 	  	// Ensure identical vertex ordering of equal edges.
 	  	// This method is numerically robust.
@@ -82,6 +87,7 @@ struct HashEdge {
 	      		p[0] = 0;
 	#endif /* BOOST_ENDIAN_LITTLE_BYTE */
 	  	}
+	  	return max_diff;
 	}
 
 	bool load_nearby(const stl_file *stl, const stl_vertex &a, const stl_vertex &b, float tolerance)
@@ -120,9 +126,28 @@ private:
 	}
 };
 
+// Connect edge_a with edge_b without updating the edge connection statistics.
+// Only the neighbors of the two edges are written to, thus edge pairs may be connected in parallel.
+static inline void connect_neighbors(stl_file *stl, const HashEdge &edge_a, const HashEdge &edge_b)
+{
+	// Facet a's neighbor is facet b
+	stl->neighbors_start[edge_a.facet_number].neighbor[edge_a.which_edge % 3] = edge_b.facet_number;	/* sets the .neighbor part */
+	stl->neighbors_start[edge_a.facet_number].which_vertex_not[edge_a.which_edge % 3] = (edge_b.which_edge + 2) % 3; /* sets the .which_vertex_not part */
+
+	// Facet b's neighbor is facet a
+	stl->neighbors_start[edge_b.facet_number].neighbor[edge_b.which_edge % 3] = edge_a.facet_number;	/* sets the .neighbor part */
+	stl->neighbors_start[edge_b.facet_number].which_vertex_not[edge_b.which_edge % 3] = (edge_a.which_edge + 2) % 3; /* sets the .which_vertex_not part */
+
+	if ((edge_a.which_edge < 3 && edge_b.which_edge < 3) || (edge_a.which_edge > 2 && edge_b.which_edge > 2)) {
+		// These facets are oriented in opposite directions, their normals are probably messed up.
+		stl->neighbors_start[edge_a.facet_number].which_vertex_not[edge_a.which_edge % 3] += 3;
+		stl->neighbors_start[edge_b.facet_number].which_vertex_not[edge_b.which_edge % 3] += 3;
+	}
+}
+
 struct HashTableEdges {
-	HashTableEdges(size_t number_of_faces) {
-		this->M = (int)hash_size_from_nr_faces(number_of_faces);
+	HashTableEdges(size_t number_of_edges) {
+		this->M = (int)hash_size_from_nr_edges(number_of_edges);
 		this->heads.assign(this->M, nullptr);
 		this->tail = pool.construct();
 		this->tail->next = this->tail;
@@ -161,13 +186,13 @@ struct HashTableEdges {
 #endif /* NDEBUG */
 
 private:
-	static inline size_t hash_size_from_nr_faces(const size_t nr_faces)
+	static inline size_t hash_size_from_nr_edges(const size_t nr_edges)
 	{
 		// Good primes for addressing a cca. 30 bit space.
 		// https://planetmath.org/goodhashtableprimes
 		static std::vector<uint32_t> primes{ 98317, 196613, 393241, 786433, 1572869, 3145739, 6291469, 12582917, 25165843, 50331653, 100663319, 201326611, 402653189, 805306457, 1610612741 };
-		// Find a prime number for 50% filling of the shared triangle edges in the mesh.
-		auto it = std::upper_bound(primes.begin(), primes.end(), nr_faces * 3 * 2 - 1);
+		// Find a prime number for 50% filling of the hash table by the inserted edges.
+		auto it = std::upper_bound(primes.begin(), primes.end(), nr_edges * 2);
 		return (it == primes.end()) ? primes.back() : *it;
 	}
 
@@ -242,19 +267,7 @@ private:
 	// Connect edge_a with edge_b, update edge connection statistics.
 	static void record_neighbors(stl_file *stl, const HashEdge &edge_a, const HashEdge &edge_b)
 	{
-		// Facet a's neighbor is facet b
-		stl->neighbors_start[edge_a.facet_number].neighbor[edge_a.which_edge % 3] = edge_b.facet_number;	/* sets the .neighbor part */
-		stl->neighbors_start[edge_a.facet_number].which_vertex_not[edge_a.which_edge % 3] = (edge_b.which_edge + 2) % 3; /* sets the .which_vertex_not part */
-
-		// Facet b's neighbor is facet a
-		stl->neighbors_start[edge_b.facet_number].neighbor[edge_b.which_edge % 3] = edge_a.facet_number;	/* sets the .neighbor part */
-		stl->neighbors_start[edge_b.facet_number].which_vertex_not[edge_b.which_edge % 3] = (edge_a.which_edge + 2) % 3; /* sets the .which_vertex_not part */
-
-		if ((edge_a.which_edge < 3 && edge_b.which_edge < 3) || (edge_a.which_edge > 2 && edge_b.which_edge > 2)) {
-			// These facets are oriented in opposite directions, their normals are probably messed up.
-			stl->neighbors_start[edge_a.facet_number].which_vertex_not[edge_a.which_edge % 3] += 3;
-			stl->neighbors_start[edge_b.facet_number].which_vertex_not[edge_b.which_edge % 3] += 3;
-		}
+		connect_neighbors(stl, edge_a, edge_b);
 
 		// Count successful connects:
 		// Total connects:
@@ -454,22 +467,118 @@ void stl_check_facets_exact(stl_file *stl)
 		  	++ i;
   	}
 
-  	// Initialize hash table.
-  	HashTableEdges hash_table(stl->stats.number_of_facets);
 	for (auto &neighbor : stl->neighbors_start)
 		neighbor.reset();
 
-  	// Connect neighbor edges.
-	for (uint32_t i = 0; i < stl->stats.number_of_facets; ++ i) {
-		const stl_facet &facet = stl->facet_start[i];
-		for (int j = 0; j < 3; ++ j) {
+	// Matching of the edges in parallel. The edges are partitioned into buckets by the top bits of a 64 bit hash of their keys
+	// keeping the order, in which admesh used to insert them into its global edge hash table. Each bucket fits into the cache
+	// and it is matched independently using a small hash table. Each edge is connected with the first preceding unpaired
+	// equal edge of another facet, thus the result is the same as with the global hash table.
+	const size_t           num_edges   = size_t(stl->stats.number_of_facets) * 3;
+	const size_t           num_chunks  = std::clamp<size_t>(num_edges / 65536, 1, 64);
+	constexpr int          bucket_bits = 12;
+	constexpr size_t       num_buckets = size_t(1) << bucket_bits;
+	std::vector<uint64_t>  hashes(num_edges);
+	std::vector<float>     shortest_edges(num_chunks, stl->stats.shortest_edge);
+	// Number of edges of a chunk in a bucket, later the position of the next edge of a chunk in a bucket.
+	std::vector<uint32_t>  bucket_chunk_offsets(num_chunks * num_buckets, 0);
+	std::vector<uint32_t>  bucket_offsets(num_buckets + 1, 0);
+	std::vector<HashEdge>  bucketed(num_edges);
+	std::vector<uint64_t>  bucketed_hashes(num_edges);
+	auto chunk_range = [num_edges, num_chunks](size_t chunk) { return std::make_pair(num_edges * chunk / num_chunks, num_edges * (chunk + 1) / num_chunks); };
+	auto load_edge   = [stl](size_t i, HashEdge &edge) {
+		const stl_facet &facet = stl->facet_start[i / 3];
+		edge.facet_number = int(i / 3);
+		edge.which_edge   = int(i % 3);
+		return edge.load_exact(&facet.vertex[i % 3], &facet.vertex[(i + 1) % 3]);
+	};
+	auto bucket_of   = [](uint64_t hash) { return size_t(hash >> (64 - bucket_bits)); };
+
+	tbb::parallel_for(size_t(0), num_chunks, [&](size_t chunk) {
+		uint32_t *counts = bucket_chunk_offsets.data() + chunk * num_buckets;
+		auto [begin, end] = chunk_range(chunk);
+		for (size_t i = begin; i < end; ++ i) {
 			HashEdge edge;
-			edge.facet_number = i;
-			edge.which_edge = j;
-			edge.load_exact(stl, &facet.vertex[j], &facet.vertex[(j + 1) % 3]);
-			hash_table.insert_edge_exact(stl, edge);
+			shortest_edges[chunk] = std::min(shortest_edges[chunk], load_edge(i, edge));
+			uint64_t hash = 0xcbf29ce484222325ull;
+			for (uint32_t k : edge.key)
+				hash = (hash ^ k) * 0x100000001b3ull;
+			// Mix the low bits into the top bits used for the buckets.
+			hash ^= hash >> 31;
+			hash *= 0x94d049bb133111ebull;
+			hash ^= hash >> 29;
+			hashes[i] = hash;
+			++ counts[bucket_of(hash)];
+		}
+	});
+	stl->stats.shortest_edge = *std::min_element(shortest_edges.begin(), shortest_edges.end());
+	for (size_t bucket = 0, offset = 0; bucket < num_buckets; ++ bucket) {
+		bucket_offsets[bucket] = uint32_t(offset);
+		for (size_t chunk = 0; chunk < num_chunks; ++ chunk) {
+			uint32_t &count = bucket_chunk_offsets[chunk * num_buckets + bucket];
+			size_t    next  = offset + count;
+			count  = uint32_t(offset);
+			offset = next;
 		}
 	}
+	bucket_offsets.back() = uint32_t(num_edges);
+	tbb::parallel_for(size_t(0), num_chunks, [&](size_t chunk) {
+		uint32_t *offsets = bucket_chunk_offsets.data() + chunk * num_buckets;
+		auto [begin, end] = chunk_range(chunk);
+		for (size_t i = begin; i < end; ++ i) {
+			size_t idx = offsets[bucket_of(hashes[i])] ++;
+			load_edge(i, bucketed[idx]);
+			bucketed_hashes[idx] = hashes[i];
+		}
+	});
+	hashes.clear();
+	hashes.shrink_to_fit();
+
+	tbb::parallel_for(tbb::blocked_range<size_t>(0, num_buckets, 16), [stl, &bucketed, &bucketed_hashes, &bucket_offsets](const tbb::blocked_range<size_t> &range) {
+		// Open addressing hash table of indices of unpaired edges into bucketed, offset by one, zero marks an empty slot.
+		// Paired edges are not removed but marked as paired, so that the equal edges are found in the order of insertion.
+		std::vector<uint32_t> table;
+		std::vector<uint8_t>  paired;
+		for (size_t bucket = range.begin(); bucket < range.end(); ++ bucket) {
+			const uint32_t begin = bucket_offsets[bucket];
+			const uint32_t end   = bucket_offsets[bucket + 1];
+			if (end - begin < 2)
+				continue;
+			size_t table_size = 4;
+			while (table_size < 2 * (end - begin))
+				table_size *= 2;
+			table.assign(table_size, 0);
+			paired.assign(end - begin, false);
+			for (uint32_t i = begin; i < end; ++ i) {
+				const HashEdge &edge = bucketed[i];
+				for (size_t slot = bucketed_hashes[i] & (table_size - 1);; slot = (slot + 1) & (table_size - 1)) {
+					if (table[slot] == 0) {
+						table[slot] = i - begin + 1;
+						break;
+					}
+					const uint32_t  other_idx = table[slot] - 1;
+					const HashEdge &other     = bucketed[begin + other_idx];
+					if (! paired[other_idx] && other.facet_number != edge.facet_number && other == edge) {
+						connect_neighbors(stl, edge, other);
+						paired[other_idx] = true;
+						break;
+					}
+				}
+			}
+		}
+	});
+
+	// Count successful connects.
+	for (const stl_neighbors &neighbors : stl->neighbors_start) {
+		int num_neighbors = neighbors.num_neighbors();
+		stl->stats.connected_edges += num_neighbors;
+		if (num_neighbors >= 1)
+			++ stl->stats.connected_facets_1_edge;
+		if (num_neighbors >= 2)
+			++ stl->stats.connected_facets_2_edge;
+		if (num_neighbors == 3)
+			++ stl->stats.connected_facets_3_edge;
+	}
 
 #if 0
 	printf("Number of faces: %d, number of manifold edges: %d, number of connected edges: %d, number of unconnected edges: %d\r\n", 
@@ -478,6 +587,14 @@ void stl_check_facets_exact(stl_file *stl)
 #endif
 }
 
+static size_t stl_count_unconnected_edges(const stl_file *stl)
+{
+	size_t num_edges = 0;
+	for (uint32_t i = 0; i < stl->stats.number_of_facets; ++ i)
+		num_edges += 3 - stl->neighbors_start[i].num_neighbors();
+	return num_edges;
+}
+
 void stl_check_facets_nearby(stl_file *stl, float tolerance)
 {
 	assert(stl->stats.connected_facets_3_edge <= stl->stats.connected_facets_2_edge);
@@ -488,7 +605,8 @@ void stl_check_facets_nearby(stl_file *stl, float tolerance)
     	// No need to check any further.  All facets are connected.
     	return;
 
-  	HashTableEdges hash_table(stl->stats.number_of_facets);
+  	// Only the unconnected edges are inserted, they are usually a tiny fraction of the edges of a large mesh.
+  	HashTableEdges hash_table(stl_count_unconnected_edges(stl));
   	for (uint32_t i = 0; i < stl->stats.number_of_facets; ++ i) {
     	//FIXME is the copy necessary?
     	stl_facet facet = stl->facet_start[i];
@@ -652,7 +770,7 @@ void stl_remove_unconnected_facets(stl_file *stl)
 void stl_fill_holes(stl_file *stl)
 {
 	// Insert all unconnected edges into hash list.
-	HashTableEdges hash_table(stl->stats.number_of_facets);
+	HashTableEdges hash_table(stl_count_unconnected_edges(stl));
 	for (uint32_t i = 0; i < stl->stats.number_of_facets; ++ i) {
   		stl_facet facet = stl->facet_start[i];
 		for (int j = 0; j < 3; ++ j) {
@@ -771,15 +771,39 @@ bool ClipperBase::AddPath(const Path &pg, PolyType PolyTyp, bool Closed)
   if ((Closed && highI < 2) || (!Closed && highI < 1))
     return false;
 
-  // Allocate a new edge array.
-  std::vector<TEdge> edges(highI + 1);
+  // Allocate a new edge array or recycle one retained by Clear().
+  std::vector<TEdge> edges = AllocateEdges(highI + 1);
   // Fill in the edge array.
   bool result = AddPathInternal(pg, highI, PolyTyp, Closed, edges.data());
   if (result)
     // Success, remember the edge array.
     m_edges.emplace_back(std::move(edges));
+  else
+    RecycleEdges(std::move(edges));
   return result;
 }
+//------------------------------------------------------------------------------
+
+std::vector<TEdge> ClipperBase::AllocateEdges(size_t num_edges)
+{
+  std::vector<TEdge> edges;
+  if (! m_edgesFree.empty()) {
+    edges = std::move(m_edgesFree.back());
+    m_edgesFree.pop_back();
+    m_edgesFreeSize -= edges.capacity();
+  }
+  edges.assign(num_edges, TEdge());
+  return edges;
+}
+//------------------------------------------------------------------------------
+
+void ClipperBase::RecycleEdges(std::vector<TEdge> &&edges)
+{
+  if (m_edgesFreeSize + edges.capacity() <= m_RetainEdgesMax) {
+    m_edgesFreeSize += edges.capacity();
+    m_edgesFree.emplace_back(std::move(edges));
+  }
+}
 
 bool ClipperBase::AddPathInternal(const Path &pg, int highI, PolyType PolyTyp, bool Closed, TEdge* edges)
 {
@@ -963,7 +987,13 @@ void ClipperBase::Clear()
 {
   CLIPPERLIB_PROFILE_FUNC();
   m_MinimaList.clear();
+  for (std::vector<TEdge> &edges : m_edges)
+    RecycleEdges(std::move(edges));
   m_edges.clear();
+  if (m_RetainEdgesMax == 0) {
+    m_edgesFree.clear();
+    m_edgesFreeSize = 0;
+  }
 #ifndef CLIPPERLIB_INT32
   m_UseFullRange = false;
 #endif // CLIPPERLIB_INT32
@@ -1047,6 +1077,7 @@ IntRect ClipperBase::GetBounds()
 
 Clipper::Clipper(int initOptions) : 
   ClipperBase(),
+  m_OutPtsChunksUsed(0),
   m_OutPtsFree(nullptr),
   m_OutPtsChunkSize(32),
   m_OutPtsChunkLast(32),
@@ -1067,7 +1098,9 @@ void Clipper::Reset()
 {
   CLIPPERLIB_PROFILE_FUNC();
   ClipperBase::Reset();
-  m_Scanbeam = std::priority_queue<cInt>();
+  // Empty the scan beam while keeping its memory.
+  while (! m_Scanbeam.empty())
+    m_Scanbeam.pop();
   m_Maxima.clear();
   m_ActiveEdges = 0;
   m_SortedEdges = 0;
@@ -1189,23 +1222,27 @@ OutPt* Clipper::AllocateOutPt()
     m_OutPtsFree = pt->Next;
   } else if (m_OutPtsChunkLast < m_OutPtsChunkSize) {
     // Get a point from the last chunk.
-    pt = m_OutPts.back() + (m_OutPtsChunkLast ++);
+    pt = m_OutPts[m_OutPtsChunksUsed - 1] + (m_OutPtsChunkLast ++);
   } else {
-    // The last chunk is full. Allocate a new one.
-    m_OutPts.push_back(new OutPt[m_OutPtsChunkSize]);
+    // The last chunk is full. Reuse a retained chunk or allocate a new one.
+    if (m_OutPtsChunksUsed == m_OutPts.size())
+      m_OutPts.push_back(new OutPt[m_OutPtsChunkSize]);
     m_OutPtsChunkLast = 1;
-    pt = m_OutPts.back();
+    pt = m_OutPts[m_OutPtsChunksUsed ++];
   }
   return pt;
 }
 
 void Clipper::DisposeAllOutRecs()
 {
-  for (OutPt *pts : m_OutPts)
-    delete[] pts;
+  // Release the output point chunks above the limit set by RetainMemory(), keep the rest for reuse.
+  size_t num_retained = std::min(m_OutPts.size(), m_RetainEdgesMax / m_OutPtsChunkSize);
+  for (size_t i = num_retained; i < m_OutPts.size(); ++ i)
+    delete[] m_OutPts[i];
   for (OutRec *rec : m_PolyOuts)
     delete rec;
-  m_OutPts.clear();
+  m_OutPts.resize(num_retained);
+  m_OutPtsChunksUsed = 0;
   m_OutPtsFree = nullptr;
   m_OutPtsChunkLast = m_OutPtsChunkSize;
   m_PolyOuts.clear();
@@ -3439,7 +3476,8 @@ void ClipperOffset::Execute(Paths& solution, double delta)
   DoOffset(delta);
   
   //now clean up 'corners' ...
-  Clipper clpr;
+  Clipper &clpr = m_clipper;
+  clpr.ReverseSolution(false);
   clpr.AddPaths(m_destPolys, ptSubject, true);
   if (delta > 0)
   {
@@ -3460,6 +3498,7 @@ void ClipperOffset::Execute(Paths& solution, double delta)
     if (! solution.empty())
       solution.erase(solution.begin());
   }
+  clpr.Clear();
 }
 //------------------------------------------------------------------------------
 
@@ -3470,7 +3509,8 @@ void ClipperOffset::Execute(PolyTree& solution, double delta)
   DoOffset(delta);
 
   //now clean up 'corners' ...
-  Clipper clpr;
+  Clipper &clpr = m_clipper;
+  clpr.ReverseSolution(false);
   clpr.AddPaths(m_destPolys, ptSubject, true);
   if (delta > 0)
   {
@@ -3491,6 +3531,7 @@ void ClipperOffset::Execute(PolyTree& solution, double delta)
     //remove the outer PolyNode rectangle ...
     solution.RemoveOutermostPolygon();
   }
+  clpr.Clear();
 }
 //------------------------------------------------------------------------------
 
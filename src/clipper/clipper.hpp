@@ -296,7 +296,9 @@ public:
 #ifndef CLIPPERLIB_INT32
     m_UseFullRange(false), 
 #endif // CLIPPERLIB_INT32
-    m_HasOpenPaths(false) {}
+    m_HasOpenPaths(false),
+    m_RetainEdgesMax(0),
+    m_edgesFreeSize(0) {}
   ~ClipperBase() { Clear(); }
   bool AddPath(const Path &pg, PolyType PolyTyp, bool Closed);
 
@@ -309,7 +311,8 @@ public:
     if (num_paths == 1)
         return AddPath(*paths_provider.begin(), PolyTyp, Closed);
 
-    std::vector<int> num_edges(num_paths, 0);
+    std::vector<int> &num_edges = m_NumEdges;
+    num_edges.assign(num_paths, 0);
     int num_edges_total = 0;
     size_t i = 0;
     for (const Path &pg : paths_provider) {
@@ -329,8 +332,8 @@ public:
     if (num_edges_total == 0)
       return false;
 
-    // Allocate a new edge array.
-    std::vector<TEdge> edges(num_edges_total);
+    // Allocate a new edge array or recycle one retained by Clear().
+    std::vector<TEdge> edges = AllocateEdges(num_edges_total);
     // Fill in the edge array.
     bool result = false;
     TEdge *p_edge = edges.data();
@@ -348,10 +351,16 @@ public:
     if (result)
       // At least some edges were generated. Remember the edge array.
       m_edges.emplace_back(std::move(edges));
+    else
+      RecycleEdges(std::move(edges));
     return result;
   }
 
   void Clear();
+  // Keep up to max_edges edges (and with Clipper, up to max_edges output points) allocated by Clear()
+  // to be reused by the following AddPath() / AddPaths() / Execute() calls. Zero by default: Clear() releases all memory.
+  // Intended for long living Clipper instances performing many small operations, see ClipperUtils.
+  void RetainMemory(size_t max_edges) { m_RetainEdgesMax = max_edges; }
   IntRect GetBounds();
   // By default, when three or more vertices are collinear in input polygons (subject or clip), the Clipper object removes the 'inner' vertices before clipping.
   // When enabled the PreserveCollinear property prevents this default behavior to allow these inner vertices to appear in the solution.
@@ -360,6 +369,8 @@ public:
 protected:
   bool AddPathInternal(const Path &pg, int highI, PolyType PolyTyp, bool Closed, TEdge* edges);
   TEdge* AddBoundsToLML(TEdge *e, bool IsClosed);
+  std::vector<TEdge> AllocateEdges(size_t num_edges);
+  void RecycleEdges(std::vector<TEdge> &&edges);
   void Reset();
   TEdge* ProcessBound(TEdge* E, bool IsClockwise);
   TEdge* DescendToMin(TEdge *&E);
@@ -378,6 +389,13 @@ protected:
 
   // A vector of edges per each input path.
   std::vector<std::vector<TEdge>> m_edges;
+  // Edge arrays released by Clear() to be reused by AddPath() / AddPaths(), see RetainMemory().
+  size_t                          m_RetainEdgesMax;
+  std::vector<std::vector<TEdge>> m_edgesFree;
+  // Sum of capacities of m_edgesFree.
+  size_t                          m_edgesFreeSize;
+  // Scratch buffer of AddPaths().
+  std::vector<int>                m_NumEdges;
   // Don't remove intermediate vertices of a collinear sequence of points.
   bool             m_PreserveCollinear;
   // Is any of the paths inserted by AddPath() or AddPaths() open?
@@ -389,7 +407,7 @@ class Clipper : public ClipperBase
 {
 public:
   Clipper(int initOptions = 0);
-  ~Clipper() { Clear(); }
+  ~Clipper() { RetainMemory(0); Clear(); }
   void Clear() { ClipperBase::Clear(); DisposeAllOutRecs(); }
   bool Execute(ClipType clipType,
       Paths &solution,
@@ -423,7 +441,9 @@ private:
   // Output polygons.
   std::vector<OutRec*>  m_PolyOuts;
   // Output points, allocated by a continuous sets of m_OutPtsChunkSize.
+  // Chunks past m_OutPtsChunksUsed are retained for reuse, see RetainMemory().
   std::vector<OutPt*>   m_OutPts;
+  size_t                m_OutPtsChunksUsed;
   // List of free output points, to be used before taking a point from m_OutPts or allocating a new chunk.
   OutPt                *m_OutPtsFree;
   size_t                m_OutPtsChunkSize;
@@ -510,6 +530,8 @@ public:
   ClipperOffset(double miterLimit = 2.0, double roundPrecision = 0.25, double shortestEdgeLength = 0.) :
     MiterLimit(miterLimit), ArcTolerance(roundPrecision), ShortestEdgeLength(shortestEdgeLength), m_lowest(-1, 0) {}
   ~ClipperOffset() { Clear(); }
+  // Keep the buffers of the internal Clipper for reuse by the following Execute() calls, see ClipperBase::RetainMemory().
+  void RetainMemory(size_t max_edges) { m_clipper.RetainMemory(max_edges); }
   void AddPath(const Path& path, JoinType joinType, EndType endType);
   template<typename PathsProvider>
   void AddPaths(PathsProvider &&paths, JoinType joinType, EndType endType) {
@@ -534,6 +556,8 @@ private:
   // y: index of the lowest point in the lowest contour
   IntPoint m_lowest;
   PolyNode m_polyNodes;
+  // Cleans up the offsetted contours, reused by Execute().
+  Clipper m_clipper;
 
   void FixOrientations();
   void DoOffset(double delta);
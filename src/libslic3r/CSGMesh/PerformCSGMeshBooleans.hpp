@@ -8,6 +8,7 @@
 
 #include "CSGMesh.hpp"
 
+#include "libslic3r/Exception.hpp"
 #include "libslic3r/Execution/ExecutionTBB.hpp"
 //#include "libslic3r/Execution/ExecutionSeq.hpp"
 #include "libslic3r/MeshBoolean.hpp"
@@ -41,6 +42,14 @@ MeshBoolean::cgal::CGALMeshPtr get_cgalmesh(const CSGPartT &csgpart)
     return ret;
 }
 
+// A difference with a mesh not overlapping the current result is a no-op, an intersection with it is empty
+// and a union with it is just a concatenation of the two meshes. The bounding boxes are inflated by EPSILON,
+// so that meshes touching each other are passed to the boolean kernel.
+inline bool bounding_boxes_overlap(const BoundingBoxf3 &a, const BoundingBoxf3 &b)
+{
+    return a.defined && b.defined && a.inflated(EPSILON).intersects(b);
+}
+
 // This method can be overriden when a specific CSGPart type supports caching
 // of the voxel grid
 template<class CSGPartT>
@@ -82,6 +91,17 @@ inline void perform_csg(CSGType op, CGALMeshPtr &dst, CGALMeshPtr &src)
     if (!dst || !src)
         return;
 
+    if (! bounding_boxes_overlap(MeshBoolean::cgal::get_extents(*dst), MeshBoolean::cgal::get_extents(*src))) {
+        // The boolean kernel throws on self intersecting input, so does the shortcut.
+        if (MeshBoolean::cgal::does_self_intersect(*src))
+            throw Slic3r::RuntimeError("CGAL mesh boolean operation failed.");
+        if (op == CSGType::Union)
+            MeshBoolean::cgal::join(*dst, *src);
+        else if (op == CSGType::Intersection)
+            dst = MeshBoolean::cgal::triangle_mesh_to_cgal(indexed_triangle_set{});
+        return;
+    }
+
     switch (op) {
     case CSGType::Union:
         MeshBoolean::cgal::plus(*dst, *src);
@@ -126,6 +146,14 @@ namespace detail_mcut {
         if (!dst || !src)
             return;
 
+        if (! bounding_boxes_overlap(MeshBoolean::mcut::get_extents(*dst), MeshBoolean::mcut::get_extents(*src))) {
+            if (op == CSGType::Union)
+                MeshBoolean::mcut::join(*dst, *src);
+            else if (op == CSGType::Intersection)
+                dst = MeshBoolean::mcut::triangle_mesh_to_mcut(indexed_triangle_set{});
+            return;
+        }
+
         switch (op) {
         case CSGType::Union:
             MeshBoolean::mcut::do_boolean(*dst, *src,"UNION");
@@ -3,6 +3,8 @@
 
 #include "CSGMesh.hpp"
 
+#include <algorithm>
+#include <limits>
 #include <stack>
 
 #include "libslic3r/TriangleMeshSlicer.hpp"
@@ -13,20 +15,25 @@ namespace Slic3r { namespace csg {
 
 namespace detail {
 
+// Merge source[i] into target[i + offset].
+// Only the expolygons of target overlapping the source by their bounding boxes are passed to Clipper.
 inline void merge_slices(csg::CSGType op, size_t i,
                   std::vector<ExPolygons> &target,
-                  std::vector<ExPolygons> &source)
+                  std::vector<ExPolygons> &source,
+                  size_t                   offset = 0)
 {
+    ExPolygons &dst = target[i + offset];
     switch(op) {
     case CSGType::Union:
         for (ExPolygon &expoly : source[i])
-            target[i].emplace_back(std::move(expoly));
+            dst.emplace_back(std::move(expoly));
         break;
     case CSGType::Difference:
-        target[i] = diff_ex(target[i], source[i]);
+        if (! dst.empty() && ! source[i].empty())
+            dst = diff_ex_indexed(dst, source[i]);
         break;
     case CSGType::Intersection:
-        target[i] = intersection_ex(target[i], source[i]);
+        dst = dst.empty() || source[i].empty() ? ExPolygons() : intersection_ex_indexed(dst, source[i]);
         break;
     }
 }
@@ -43,8 +50,45 @@ inline void collect_nonempty_indices(csg::CSGType                   op,
     }
 }
 
+// Range of slicegrid indices [first, second) possibly intersecting the transformed mesh.
+inline std::pair<size_t, size_t> slicegrid_range(const indexed_triangle_set &its,
+                                                 const Transform3d          &trafo,
+                                                 const std::vector<float>   &slicegrid)
+{
+    if (its.vertices.empty() || its.indices.empty())
+        return { 0, 0 };
+
+    const Eigen::RowVector3d zrow = trafo.matrix().block<1, 3>(2, 0);
+    const double             zoff = trafo.translation().z();
+    double zmin = std::numeric_limits<double>::max();
+    double zmax = std::numeric_limits<double>::lowest();
+    for (const stl_vertex &v : its.vertices) {
+        double z = zrow.dot(v.cast<double>()) + zoff;
+        zmin = std::min(zmin, z);
+        zmax = std::max(zmax, z);
+    }
+
+    auto first = std::lower_bound(slicegrid.begin(), slicegrid.end(), float(zmin - EPSILON));
+    auto last  = std::upper_bound(first, slicegrid.end(), float(zmax + EPSILON));
+    return { size_t(first - slicegrid.begin()), size_t(last - slicegrid.begin()) };
+}
+
+// Does any of the target slices in the range [first, last) contain some polygons?
+inline bool has_slices(const std::vector<ExPolygons> &slices, size_t first, size_t last)
+{
+    for (size_t i = first; i < last; ++ i)
+        if (! slices[i].empty())
+            return true;
+    return false;
+}
+
 } // namespace detail
 
+// Evaluate a CSG collection by slicing each part and applying the CSG operations on the slices, layer by layer.
+// Contrary to the 3D mesh booleans, the CSG operations never fail and their complexity depends on the number of layers
+// and on the complexity of the slices, not on the complexity of the meshes.
+// Each part is sliced only in the range of the slicing grid it spans, parts which cannot change the result are not sliced at all.
+// slicegrid is expected to be sorted in ascending order.
 template<class ItCSG>
 std::vector<ExPolygons> slice_csgmesh_ex(
     const Range<ItCSG>          &csgrange,
@@ -78,19 +122,34 @@ std::vector<ExPolygons> slice_csgmesh_ex(
 
         if (its) {
             params_cpy.trafo = trafo * csg::get_transform(csgpart).template cast<double>();
-            std::vector<ExPolygons> slices = slice_mesh_ex(*its,
-                                                           slicegrid, params_cpy,
-                                                           throw_on_cancel);
 
-            assert(slices.size() == slicegrid.size());
+            auto [first, last] = slicegrid_range(*its, params_cpy.trafo, slicegrid);
 
-            collect_nonempty_indices(op, slicegrid, slices, nonempty_indices);
-
-            execution::for_each(
-                ex_tbb, nonempty_indices.begin(), nonempty_indices.end(),
-                [op, &slices, &top](size_t i) {
-                    merge_slices(op, i, top->slices, slices);
+            if (op == CSGType::Intersection) {
+                // Nothing survives outside of the range of the part.
+                execution::for_each(ex_tbb, size_t(0), slicegrid.size(), [first = first, last = last, &top](size_t i) {
+                    if (i < first || i >= last)
+                        top->slices[i].clear();
                 }, execution::max_concurrency(ex_tbb));
+            }
+
+            // A difference or an intersection does not change empty slices.
+            if (first < last && (op == CSGType::Union || has_slices(top->slices, first, last))) {
+                std::vector<float> subgrid(slicegrid.begin() + first, slicegrid.begin() + last);
+                std::vector<ExPolygons> slices = slice_mesh_ex(*its,
+                                                               subgrid, params_cpy,
+                                                               throw_on_cancel);
+
+                assert(slices.size() == subgrid.size());
+
+                collect_nonempty_indices(op, subgrid, slices, nonempty_indices);
+
+                execution::for_each(
+                    ex_tbb, nonempty_indices.begin(), nonempty_indices.end(),
+                    [op, &slices, &top, first = first](size_t i) {
+                        merge_slices(op, i, top->slices, slices, first);
+                    }, execution::max_concurrency(ex_tbb));
+            }
         }
 
         if (get_stack_operation(csgpart) == CSGStackOp::Pop) {
@@ -0,0 +1,291 @@
+#include "ChunkStore.hpp"
+#include "Exception.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstring>
+
+#include <miniz.h>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+namespace Slic3r {
+
+// Chunks are cut at content defined boundaries between the minimum and maximum size.
+// With the 14 bit boundary mask, the average chunk size is MinChunkSize + 16kB.
+static constexpr const size_t   MinChunkSize        = 8 * 1024;
+static constexpr const size_t   MaxChunkSize        = 128 * 1024;
+static constexpr const uint64_t ChunkBoundaryMask   = 0xfffc000000000000ull;
+
+struct ChunkStore::Chunk
+{
+    Chunk(uint64_t hash, size_t size) : hash(hash), size(size) {}
+
+    size_t      memsize() const { return sizeof(Chunk) + data.capacity(); }
+
+    uint64_t    hash;
+    // Size of the uncompressed chunk.
+    size_t      size;
+    // Number of references from blobs.
+    size_t      refcnt { 0 };
+    // Logical time of the last store or load of this chunk, see ChunkStore::compress_cold().
+    size_t      last_access { 0 };
+    bool        compressed { false };
+    // The chunk was found not to compress well, don't try it again.
+    bool        incompressible { false };
+    // Is the chunk indexed by ChunkStore::m_chunks?
+    bool        shared { false };
+    // Either the uncompressed or the compressed content.
+    std::string data;
+};
+
+// Finalizer of the SplitMix64 generator.
+static inline uint64_t mix64(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+static uint64_t hash_bytes(const char *data, size_t size)
+{
+    uint64_t hash = mix64(size + 0x9e3779b97f4a7c15ull);
+    size_t   i    = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, data + i, 8);
+        hash ^= mix64(word);
+        hash  = ((hash << 27) | (hash >> 37)) * 0x9fb21c651e98df25ull;
+    }
+    if (i < size) {
+        uint64_t word = 0;
+        memcpy(&word, data + i, size - i);
+        hash ^= mix64(word);
+    }
+    return mix64(hash);
+}
+
+// Random values of the bytes for the Gear rolling hash.
+static const std::array<uint64_t, 256>& gear_table()
+{
+    static const std::array<uint64_t, 256> table = []() {
+        std::array<uint64_t, 256> out;
+        uint64_t seed = 0;
+        for (uint64_t &v : out)
+            v = mix64(seed += 0x9e3779b97f4a7c15ull);
+        return out;
+    }();
+    return table;
+}
+
+// End of a chunk starting at begin. The Gear hash depends on the last 64 bytes only, thus the chunk boundaries
+// following a modification of the data synchronize with the boundaries of the unmodified data.
+static size_t chunk_end(const char *data, size_t begin, size_t size)
+{
+    if (size - begin <= MinChunkSize)
+        return size;
+    const std::array<uint64_t, 256> &gear = gear_table();
+    const size_t                     end  = std::min(size, begin + MaxChunkSize);
+    uint64_t                         hash = 0;
+    for (size_t i = begin + MinChunkSize; i < end; ++ i) {
+        hash = (hash << 1) + gear[(unsigned char)data[i]];
+        if ((hash & ChunkBoundaryMask) == 0)
+            return i + 1;
+    }
+    return end;
+}
+
+static void uncompress_chunk(const std::string &compressed, char *out, size_t size)
+{
+    mz_ulong len = mz_ulong(size);
+    if (mz_uncompress((unsigned char*)out, &len, (const unsigned char*)compressed.data(), mz_ulong(compressed.size())) != MZ_OK || len != size)
+        throw Slic3r::RuntimeError("ChunkStore: Failed to decompress a chunk");
+}
+
+ChunkStore::Blob& ChunkStore::Blob::operator=(Blob &&rhs) noexcept
+{
+    if (this != &rhs) {
+        this->reset();
+        m_store  = rhs.m_store;
+        m_chunks = std::move(rhs.m_chunks);
+        m_size   = rhs.m_size;
+        rhs.m_store = nullptr;
+        rhs.m_chunks.clear();
+        rhs.m_size  = 0;
+    }
+    return *this;
+}
+
+void ChunkStore::Blob::reset()
+{
+    if (m_store != nullptr) {
+        for (Chunk *chunk : m_chunks)
+            m_store->release_chunk(chunk);
+        m_chunks.clear();
+        m_store = nullptr;
+        m_size  = 0;
+    }
+}
+
+size_t ChunkStore::Blob::memsize() const
+{
+    size_t memsize = sizeof(Blob) + m_chunks.capacity() * sizeof(Chunk*);
+    for (const Chunk *chunk : m_chunks)
+        // Count the size of the chunk divided by the number of references, rounded up.
+        memsize += (chunk->memsize() + chunk->refcnt - 1) / chunk->refcnt;
+    return memsize;
+}
+
+ChunkStore::~ChunkStore()
+{
+    // All the blobs have to be released before their store.
+    assert(m_num_chunks == 0);
+}
+
+ChunkStore::Blob ChunkStore::store(const char *data, size_t size, size_t time)
+{
+    Blob blob;
+    blob.m_store = this;
+    blob.m_size  = size;
+    for (size_t begin = 0; begin < size;) {
+        size_t end = chunk_end(data, begin, size);
+        blob.m_chunks.emplace_back(this->acquire_chunk(data + begin, end - begin, time));
+        begin = end;
+    }
+    blob.m_chunks.shrink_to_fit();
+    return blob;
+}
+
+std::string ChunkStore::load(const Blob &blob, size_t time)
+{
+    assert(blob.m_store == this);
+    std::string out(blob.m_size, 0);
+    size_t      offset = 0;
+    for (Chunk *chunk : blob.m_chunks) {
+        if (chunk->compressed)
+            // Keep the chunk compressed, loading a cold snapshot does not make it hot.
+            uncompress_chunk(chunk->data, out.data() + offset, chunk->size);
+        else
+            memcpy(out.data() + offset, chunk->data.data(), chunk->size);
+        chunk->last_access = std::max(chunk->last_access, time);
+        offset += chunk->size;
+    }
+    assert(offset == out.size());
+    return out;
+}
+
+bool ChunkStore::equals(const Blob &blob, const char *data, size_t size) const
+{
+    assert(blob.m_store == this);
+    if (blob.m_size != size)
+        return false;
+    std::string uncompressed;
+    size_t      offset = 0;
+    for (const Chunk *chunk : blob.m_chunks) {
+        const char *chunk_data = chunk->data.data();
+        if (chunk->compressed) {
+            uncompressed.resize(chunk->size);
+            uncompress_chunk(chunk->data, uncompressed.data(), chunk->size);
+            chunk_data = uncompressed.data();
+        }
+        if (memcmp(chunk_data, data + offset, chunk->size) != 0)
+            return false;
+        offset += chunk->size;
+    }
+    return true;
+}
+
+size_t ChunkStore::compress_cold(size_t time)
+{
+    std::vector<Chunk*> cold;
+    for (const std::pair<const uint64_t, Chunk*> &kvp : m_chunks)
+        if (const Chunk *chunk = kvp.second; ! chunk->compressed && ! chunk->incompressible && chunk->last_access < time)
+            cold.emplace_back(kvp.second);
+
+    std::vector<size_t> memsize_before(cold.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, cold.size()), [&cold, &memsize_before](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i) {
+            Chunk &chunk = *cold[i];
+            memsize_before[i] = chunk.memsize();
+            std::string compressed(mz_compressBound(mz_ulong(chunk.size)), 0);
+            mz_ulong    len = mz_ulong(compressed.size());
+            // Keep the chunk uncompressed if it does not shrink by at least 1/8.
+            if (mz_compress2((unsigned char*)compressed.data(), &len, (const unsigned char*)chunk.data.data(), mz_ulong(chunk.size), MZ_BEST_SPEED) == MZ_OK &&
+                len < chunk.size - chunk.size / 8) {
+                compressed.resize(len);
+                compressed.shrink_to_fit();
+                chunk.data       = std::move(compressed);
+                chunk.compressed = true;
+            } else
+                chunk.incompressible = true;
+        }
+    });
+
+    size_t saved = 0;
+    for (size_t i = 0; i < cold.size(); ++ i)
+        if (cold[i]->compressed) {
+            saved += memsize_before[i] - cold[i]->memsize();
+            ++ m_num_compressed_chunks;
+        }
+    assert(m_memsize >= saved);
+    m_memsize -= saved;
+    return saved;
+}
+
+ChunkStore::Chunk* ChunkStore::acquire_chunk(const char *data, size_t size, size_t time)
+{
+    uint64_t hash  = hash_bytes(data, size);
+    auto     it    = m_chunks.find(hash);
+    Chunk   *chunk = nullptr;
+    if (it != m_chunks.end() && it->second->size == size) {
+        if (it->second->compressed)
+            // The chunk is being stored again, it is likely to be accessed again soon.
+            this->decompress(*it->second);
+        if (memcmp(it->second->data.data(), data, size) == 0)
+            chunk = it->second;
+    }
+    if (chunk == nullptr) {
+        chunk = new Chunk(hash, size);
+        chunk->data.assign(data, size);
+        if (it == m_chunks.end()) {
+            m_chunks.emplace(hash, chunk);
+            chunk->shared = true;
+        }
+        m_memsize += chunk->memsize();
+        ++ m_num_chunks;
+    }
+    ++ chunk->refcnt;
+    chunk->last_access = std::max(chunk->last_access, time);
+    return chunk;
+}
+
+void ChunkStore::release_chunk(Chunk *chunk)
+{
+    assert(chunk->refcnt > 0);
+    if (-- chunk->refcnt == 0) {
+        if (chunk->shared)
+            m_chunks.erase(chunk->hash);
+        if (chunk->compressed)
+            -- m_num_compressed_chunks;
+        m_memsize -= chunk->memsize();
+        -- m_num_chunks;
+        delete chunk;
+    }
+}
+
+void ChunkStore::decompress(Chunk &chunk)
+{
+    assert(chunk.compressed);
+    std::string data(chunk.size, 0);
+    uncompress_chunk(chunk.data, data.data(), chunk.size);
+    m_memsize -= chunk.memsize();
+    chunk.data       = std::move(data);
+    chunk.compressed = false;
+    m_memsize += chunk.memsize();
+    -- m_num_compressed_chunks;
+}
+
+} // namespace Slic3r
@@ -0,0 +1,95 @@
+#ifndef slic3r_ChunkStore_hpp_
+#define slic3r_ChunkStore_hpp_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Slic3r {
+
+// Content addressed storage of binary blobs, used by the Undo / Redo stack to hold the serialized snapshots.
+//
+// A blob is split into chunks at content defined boundaries, thus a local modification of a large blob
+// (for example of the serialized painting of a triangle mesh) changes just the chunks around the modification,
+// while the rest of the chunks are shared with the previous versions of the blob by their content hash.
+// Chunks not accessed for a while may be compressed by compress_cold() to save memory.
+//
+// Not thread safe.
+class ChunkStore
+{
+    struct Chunk;
+
+public:
+    // Reference counted handle to a blob stored in a ChunkStore, releasing its chunks when destroyed.
+    // The ChunkStore has to outlive its blobs.
+    class Blob
+    {
+    public:
+        Blob() = default;
+        Blob(Blob &&rhs) noexcept { *this = std::move(rhs); }
+        Blob& operator=(Blob &&rhs) noexcept;
+        ~Blob() { this->reset(); }
+
+        Blob(const Blob &) = delete;
+        Blob& operator=(const Blob &) = delete;
+
+        void   reset();
+        // Does this handle reference a blob?
+        bool   valid() const { return m_store != nullptr; }
+        // Size of the uncompressed blob.
+        size_t size() const { return m_size; }
+        // Memory occupied by the chunks of this blob. Chunks shared by multiple blobs are accounted
+        // proportionally to the number of blobs referencing them.
+        size_t memsize() const;
+
+    private:
+        ChunkStore          *m_store { nullptr };
+        std::vector<Chunk*>  m_chunks;
+        size_t               m_size { 0 };
+
+        friend class ChunkStore;
+    };
+
+    ChunkStore() = default;
+    ~ChunkStore();
+
+    ChunkStore(const ChunkStore &) = delete;
+    ChunkStore& operator=(const ChunkStore &) = delete;
+
+    // Store a blob, sharing the chunks already stored. Time is a logical time of the access, see compress_cold().
+    Blob        store(const char *data, size_t size, size_t time);
+    Blob        store(const std::string &data, size_t time) { return this->store(data.data(), data.size(), time); }
+    // Reconstruct the content of a blob, decompressing its chunks as needed.
+    std::string load(const Blob &blob, size_t time);
+    // Does the blob hold the data?
+    bool        equals(const Blob &blob, const char *data, size_t size) const;
+    bool        equals(const Blob &blob, const std::string &data) const { return this->equals(blob, data.data(), data.size()); }
+
+    // Compress the chunks last accessed before the given time. Chunks are compressed in parallel.
+    // Returns the number of bytes saved.
+    size_t      compress_cold(size_t time);
+
+    // Memory occupied by the chunks.
+    size_t      memsize() const { return m_memsize; }
+    size_t      num_chunks() const { return m_num_chunks; }
+    size_t      num_compressed_chunks() const { return m_num_compressed_chunks; }
+
+private:
+    Chunk*      acquire_chunk(const char *data, size_t size, size_t time);
+    void        release_chunk(Chunk *chunk);
+    // Replace the compressed content of a chunk with its uncompressed content.
+    void        decompress(Chunk &chunk);
+
+    // Chunks indexed by their content hash. In the unlikely case of a hash collision, the colliding chunk
+    // is owned by its blob only, it is neither shared nor compressed.
+    std::unordered_map<uint64_t, Chunk*>    m_chunks;
+    size_t                                  m_memsize { 0 };
+    size_t                                  m_num_chunks { 0 };
+    size_t                                  m_num_compressed_chunks { 0 };
+};
+
+} // namespace Slic3r
+
+#endif // slic3r_ChunkStore_hpp_
@@ -1,4 +1,5 @@
 #include "Clipper2Utils.hpp"
+#include "ClipperUtils.hpp"
 #include "libslic3r.h"
 #include "clipper2/clipper.h"
 
@@ -208,4 +209,235 @@ ExPolygons offset2_ex_2(const ExPolygons& expolygons, double delta1, double delt
     return results;
 }
 
-} // namespace Slic3r
\ No newline at end of file
+namespace Clipper2Utils {
+
+static Clipper2Lib::ClipType to_clip_type(ClipperLib::ClipType clip_type)
+{
+    switch (clip_type) {
+    case ClipperLib::ctIntersection: return Clipper2Lib::ClipType::Intersection;
+    case ClipperLib::ctUnion:        return Clipper2Lib::ClipType::Union;
+    case ClipperLib::ctDifference:   return Clipper2Lib::ClipType::Difference;
+    case ClipperLib::ctXor:          return Clipper2Lib::ClipType::Xor;
+    }
+    assert(false);
+    return Clipper2Lib::ClipType::NoClip;
+}
+
+static Clipper2Lib::FillRule to_fill_rule(ClipperLib::PolyFillType fill_type)
+{
+    switch (fill_type) {
+    case ClipperLib::pftEvenOdd:  return Clipper2Lib::FillRule::EvenOdd;
+    case ClipperLib::pftNonZero:  return Clipper2Lib::FillRule::NonZero;
+    case ClipperLib::pftPositive: return Clipper2Lib::FillRule::Positive;
+    case ClipperLib::pftNegative: return Clipper2Lib::FillRule::Negative;
+    }
+    assert(false);
+    return Clipper2Lib::FillRule::NonZero;
+}
+
+static Clipper2Lib::JoinType to_join_type(ClipperLib::JoinType join_type)
+{
+    switch (join_type) {
+    case ClipperLib::jtSquare: return Clipper2Lib::JoinType::Square;
+    case ClipperLib::jtRound:  return Clipper2Lib::JoinType::Round;
+    case ClipperLib::jtMiter:  return Clipper2Lib::JoinType::Miter;
+    }
+    assert(false);
+    return Clipper2Lib::JoinType::Miter;
+}
+
+static Clipper2Lib::EndType to_end_type(ClipperLib::EndType end_type)
+{
+    switch (end_type) {
+    case ClipperLib::etClosedPolygon: return Clipper2Lib::EndType::Polygon;
+    case ClipperLib::etClosedLine:    return Clipper2Lib::EndType::Joined;
+    case ClipperLib::etOpenButt:      return Clipper2Lib::EndType::Butt;
+    case ClipperLib::etOpenSquare:    return Clipper2Lib::EndType::Square;
+    case ClipperLib::etOpenRound:     return Clipper2Lib::EndType::Round;
+    }
+    assert(false);
+    return Clipper2Lib::EndType::Polygon;
+}
+
+Polygons to_polygons(Clipper2Lib::Paths64 &&paths)
+{
+    Polygons out;
+    out.reserve(paths.size());
+    for (const Clipper2Lib::Path64 &path : paths)
+        out.emplace_back(Path64ToPoints(path));
+    return out;
+}
+
+Polylines to_polylines(Clipper2Lib::Paths64 &&paths)
+{
+    return Paths64_to_polylines(paths);
+}
+
+Clipper2Lib::Paths64 clip_paths(ClipperLib::ClipType clip_type, const Clipper2Lib::Paths64 &subject, const Clipper2Lib::Paths64 &clip, ClipperLib::PolyFillType fill_type)
+{
+    Clipper2Lib::Clipper64 c;
+    c.AddSubject(subject);
+    if (! clip.empty())
+        c.AddClip(clip);
+    Clipper2Lib::Paths64 out;
+    c.Execute(to_clip_type(clip_type), to_fill_rule(fill_type), out);
+    return out;
+}
+
+ExPolygons clip_paths_ex(ClipperLib::ClipType clip_type, const Clipper2Lib::Paths64 &subject, const Clipper2Lib::Paths64 &clip, ClipperLib::PolyFillType fill_type)
+{
+    // Contrary to ClipperLib, Clipper2 builds the PolyTree efficiently even for overlapping edges,
+    // thus the two pass workaround of clipper_do_polytree() is not needed.
+    Clipper2Lib::Clipper64 c;
+    c.AddSubject(subject);
+    if (! clip.empty())
+        c.AddClip(clip);
+    Clipper2Lib::PolyTree64 polytree;
+    c.Execute(to_clip_type(clip_type), to_fill_rule(fill_type), polytree);
+    return PolyTreeToExPolygons(std::move(polytree));
+}
+
+Polylines clip_paths_open(ClipperLib::ClipType clip_type, const Clipper2Lib::Paths64 &subject, const Clipper2Lib::Paths64 &clip)
+{
+    Clipper2Lib::Clipper64 c;
+    c.AddOpenSubject(subject);
+    c.AddClip(clip);
+    Clipper2Lib::Paths64 solution, solution_open;
+    c.Execute(to_clip_type(clip_type), Clipper2Lib::FillRule::NonZero, solution, solution_open);
+
+    Polylines out;
+    out.reserve(solution.size() + solution_open.size());
+    polylines_append(out, Paths64_to_polylines(solution));
+    polylines_append(out, Paths64_to_polylines(solution_open));
+    return out;
+}
+
+static void setup_offset(Clipper2Lib::ClipperOffset &co, ClipperLib::JoinType join_type, double miter_limit)
+{
+    // Same interpretation of the miter limit as in ClipperUtils raw_offset().
+    if (join_type == ClipperLib::jtRound)
+        co.ArcTolerance(miter_limit);
+    else
+        co.MiterLimit(miter_limit);
+}
+
+// Clipper2Lib::ClipperOffset has no ShortestEdgeLength, drop the short edges the way ClipperLib::ClipperOffset::AddPath() does:
+// A point closer than shortest_edge_length to the last point kept is skipped, so are the closing points of a closed path
+// close to its first point. Closed polygons with less than three points left are dropped.
+static Clipper2Lib::Paths64 remove_short_edges(const Clipper2Lib::Paths64 &paths, double shortest_edge_length, ClipperLib::EndType end_type)
+{
+    const bool   closed                = end_type == ClipperLib::etClosedPolygon || end_type == ClipperLib::etClosedLine;
+    const double shortest_edge_length2 = sqr(shortest_edge_length);
+    auto         too_close             = [shortest_edge_length2](const Clipper2Lib::Point64 &p1, const Clipper2Lib::Point64 &p2) {
+        return sqr(double(p2.x - p1.x)) + sqr(double(p2.y - p1.y)) < shortest_edge_length2;
+    };
+    Clipper2Lib::Paths64 out;
+    out.reserve(paths.size());
+    for (const Clipper2Lib::Path64 &path : paths) {
+        if (path.empty())
+            continue;
+        size_t end = path.size();
+        if (closed)
+            while (end > 1 && too_close(path.front(), path[end - 1]))
+                -- end;
+        Clipper2Lib::Path64 &dst = out.emplace_back();
+        dst.reserve(end);
+        dst.emplace_back(path.front());
+        for (size_t i = 1; i < end; ++ i)
+            if (! too_close(dst.back(), path[i]))
+                dst.emplace_back(path[i]);
+        if (end_type == ClipperLib::etClosedPolygon && dst.size() < 3)
+            out.pop_back();
+    }
+    return out;
+}
+
+static void add_offset_paths(Clipper2Lib::ClipperOffset &co, const Clipper2Lib::Paths64 &paths, float delta, ClipperLib::JoinType join_type, ClipperLib::EndType end_type)
+{
+    const double shortest_edge_length = std::abs(delta * ClipperOffsetShortestEdgeFactor);
+    if (shortest_edge_length > 0.)
+        co.AddPaths(remove_short_edges(paths, shortest_edge_length, end_type), to_join_type(join_type), to_end_type(end_type));
+    else
+        co.AddPaths(paths, to_join_type(join_type), to_end_type(end_type));
+}
+
+Clipper2Lib::Paths64 offset_paths(const Clipper2Lib::Paths64 &paths, float delta, ClipperLib::JoinType join_type, double miter_limit, ClipperLib::EndType end_type)
+{
+    Clipper2Lib::Paths64 out;
+    if (! paths.empty()) {
+        Clipper2Lib::ClipperOffset co;
+        setup_offset(co, join_type, miter_limit);
+        add_offset_paths(co, paths, delta, join_type, end_type);
+        co.Execute(delta, out);
+    }
+    return out;
+}
+
+ExPolygons offset_paths_ex(const Clipper2Lib::Paths64 &paths, float delta, ClipperLib::JoinType join_type, double miter_limit)
+{
+    if (paths.empty())
+        return {};
+    Clipper2Lib::ClipperOffset co;
+    setup_offset(co, join_type, miter_limit);
+    add_offset_paths(co, paths, delta, join_type, ClipperLib::etClosedPolygon);
+    Clipper2Lib::PolyTree64 polytree;
+    co.Execute(delta, polytree);
+    return PolyTreeToExPolygons(std::move(polytree));
+}
+
+int offset_expolygon(const ExPolygon &expoly, float delta, ClipperLib::JoinType join_type, double miter_limit, Clipper2Lib::Paths64 &out)
+{
+    // 1) Offset the outer contour.
+    Clipper2Lib::Paths64 contours = offset_paths({ to_path64(expoly.contour.points) }, delta, join_type, miter_limit);
+    if (contours.empty())
+        // No need to try to offset the holes.
+        return 0;
+
+    if (expoly.holes.empty()) {
+        // No need to subtract holes from the offsetted expolygon, we are done.
+        append(out, std::move(contours));
+        return 1;
+    }
+
+    // 2) Offset the holes one by one, collect the offsetted holes. A hole is reversed to be offsetted as a CCW contour,
+    // thus the signum of the offset value is reversed and the offsetted holes are CCW oriented.
+    Clipper2Lib::Paths64 holes;
+    for (const Polygon &hole : expoly.holes) {
+        Clipper2Lib::Path64 path = to_path64(hole.points);
+        std::reverse(path.begin(), path.end());
+        append(holes, offset_paths({ std::move(path) }, - delta, join_type, miter_limit));
+    }
+
+    // 3) Subtract holes from the contours.
+    if (holes.empty()) {
+        // No hole remaining after an offset. Just copy the outer contour.
+        append(out, std::move(contours));
+    } else if (delta < 0) {
+        // Negative offset. There is a chance, that the offsetted hole intersects the outer contour.
+        // Subtract the offsetted holes from the offsetted contours.
+        Clipper2Lib::Paths64 output = clip_paths(ClipperLib::ctDifference, contours, holes, ClipperLib::pftNonZero);
+        if (output.empty())
+            // The offsetted holes have eaten up the offsetted outer contour.
+            return 0;
+        append(out, std::move(output));
+    } else {
+        // Positive offset. The offsetted holes are smaller than the original holes or they disappeared,
+        // therefore there are no new intersections. Just collect the reversed holes.
+        out.reserve(out.size() + contours.size() + holes.size());
+        append(out, std::move(contours));
+        for (Clipper2Lib::Path64 &path : holes) {
+            std::reverse(path.begin(), path.end());
+            out.emplace_back(std::move(path));
+        }
+    }
+    return 1;
+}
+
+Clipper2Lib::Paths64 safety_offset(const Clipper2Lib::Paths64 &paths)
+{
+    return offset_paths(paths, ClipperSafetyOffset, DefaultJoinType, DefaultMiterLimit);
+}
+
+} // namespace Clipper2Utils
+
+} // namespace Slic3r
@@ -4,6 +4,9 @@
 #include "ExPolygon.hpp"
 #include "Polygon.hpp"
 #include "Polyline.hpp"
+#include "clipper.hpp"
+
+#include <clipper2/clipper.h>
 
 namespace Slic3r {
 
@@ -13,7 +16,55 @@ ExPolygons         union_ex_2(const Polygons &expolygons);
 ExPolygons         union_ex_2(const ExPolygons &expolygons);
 ExPolygons         offset_ex_2(const ExPolygons &expolygons, double delta);
 ExPolygons         offset2_ex_2(const ExPolygons &expolygons, double delta1, double delta2);
+
+// Clipper2 backend of ClipperUtils, see ClipperBackend.
+// The ClipperLib enums are accepted and mapped to their Clipper2Lib counterparts,
+// so that ClipperUtils may forward its arguments unchanged.
+namespace Clipper2Utils {
+
+inline Clipper2Lib::Path64 to_path64(const Points &points)
+{
+    Clipper2Lib::Path64 out;
+    out.reserve(points.size());
+    for (const Point &pt : points)
+        out.emplace_back(pt.x(), pt.y());
+    return out;
 }
 
-#endif
+// Convert a ClipperUtils::PathsProvider (or any other container of Points) to Clipper2 paths.
+template<typename PathsProvider>
+inline Clipper2Lib::Paths64 to_paths64(PathsProvider &&paths)
+{
+    Clipper2Lib::Paths64 out;
+    out.reserve(paths.size());
+    for (const Points &path : paths)
+        out.emplace_back(to_path64(path));
+    return out;
+}
 
+Polygons             to_polygons(Clipper2Lib::Paths64 &&paths);
+Polylines            to_polylines(Clipper2Lib::Paths64 &&paths);
+
+// Boolean operation on closed paths.
+Clipper2Lib::Paths64 clip_paths(ClipperLib::ClipType clip_type, const Clipper2Lib::Paths64 &subject, const Clipper2Lib::Paths64 &clip, ClipperLib::PolyFillType fill_type);
+ExPolygons           clip_paths_ex(ClipperLib::ClipType clip_type, const Clipper2Lib::Paths64 &subject, const Clipper2Lib::Paths64 &clip, ClipperLib::PolyFillType fill_type);
+// Boolean operation of open subject paths with closed clipping paths.
+Polylines            clip_paths_open(ClipperLib::ClipType clip_type, const Clipper2Lib::Paths64 &subject, const Clipper2Lib::Paths64 &clip);
+
+// Offset of all paths at once. Contrary to the ClipperLib raw_offset(), the result is always united,
+// CCW contours are offsetted outside, CW contours (holes) inside.
+// As with ClipperLib, the input points closer than delta * ClipperOffsetShortestEdgeFactor to their predecessor are dropped.
+Clipper2Lib::Paths64 offset_paths(const Clipper2Lib::Paths64 &paths, float delta, ClipperLib::JoinType join_type, double miter_limit,
+                                  ClipperLib::EndType end_type = ClipperLib::etClosedPolygon);
+ExPolygons           offset_paths_ex(const Clipper2Lib::Paths64 &paths, float delta, ClipperLib::JoinType join_type, double miter_limit);
+// Counterpart of the ClipperUtils offset_expolygon_inner(): The contour and each hole are offsetted separately,
+// for a negative offset the offsetted holes are subtracted from the offsetted contour.
+// Appends the result to out, returns 0 if nothing remained of the ExPolygon, 1 otherwise.
+int                  offset_expolygon(const ExPolygon &expoly, float delta, ClipperLib::JoinType join_type, double miter_limit, Clipper2Lib::Paths64 &out);
+// Offset outside by ClipperSafetyOffset.
+Clipper2Lib::Paths64 safety_offset(const Clipper2Lib::Paths64 &paths);
+
+} // namespace Clipper2Utils
+} // namespace Slic3r
+
+#endif
@@ -1,19 +1,27 @@
 #include "ClipperUtils.hpp"
+#include "Clipper2Utils.hpp"
+#include "AABBTreeIndirect.hpp"
 #include "Geometry.hpp"
 #include "ShortestPath.hpp"
 
+#include <atomic>
+#include <cstdlib>
+#include <optional>
+
+#include <boost/algorithm/string/predicate.hpp>
+
 // #define CLIPPER_UTILS_DEBUG
 
 #ifdef CLIPPER_UTILS_DEBUG
 #include "SVG.hpp"
 #endif /* CLIPPER_UTILS_DEBUG */
 
-// Profiling support using the Shiny intrusive profiler
+// Profiling support using the tracing profiler. Not enabled by default, as the zones are too fine grained.
 //#define CLIPPER_UTILS_PROFILE
-#if defined(SLIC3R_PROFILE) && defined(CLIPPER_UTILS_PROFILE)
-	#include <Shiny/Shiny.h>
-	#define CLIPPERUTILS_PROFILE_FUNC() PROFILE_FUNC()
-	#define CLIPPERUTILS_PROFILE_BLOCK(name) PROFILE_BLOCK(name)
+#ifdef CLIPPER_UTILS_PROFILE
+	#include "Profiler.hpp"
+	#define CLIPPERUTILS_PROFILE_FUNC() SLIC3R_PROFILE_FUNC()
+	#define CLIPPERUTILS_PROFILE_BLOCK(name) SLIC3R_PROFILE_ZONE(#name)
 #else
 	#define CLIPPERUTILS_PROFILE_FUNC()
 	#define CLIPPERUTILS_PROFILE_BLOCK(name)
@@ -56,6 +64,33 @@ err:
 }
 #endif /* CLIPPER_UTILS_DEBUG */
 
+static ClipperBackend initial_clipper_backend()
+{
+#ifdef SLIC3R_CLIPPER2_BACKEND
+    ClipperBackend backend = ClipperBackend::Clipper2;
+#else
+    ClipperBackend backend = ClipperBackend::ClipperLib;
+#endif
+    if (const char *env = std::getenv("SLIC3R_CLIPPER_BACKEND"); env != nullptr) {
+        if (boost::iequals(env, "clipper2"))
+            backend = ClipperBackend::Clipper2;
+        else if (boost::iequals(env, "clipperlib"))
+            backend = ClipperBackend::ClipperLib;
+    }
+    return backend;
+}
+
+static std::atomic<ClipperBackend>& clipper_backend_storage()
+{
+    static std::atomic<ClipperBackend> backend { initial_clipper_backend() };
+    return backend;
+}
+
+ClipperBackend clipper_backend() { return clipper_backend_storage().load(std::memory_order_relaxed); }
+void set_clipper_backend(ClipperBackend backend) { clipper_backend_storage().store(backend, std::memory_order_relaxed); }
+
+static inline bool use_clipper2() { return clipper_backend() == ClipperBackend::Clipper2; }
+
 namespace ClipperUtils {
 Points EmptyPathsProvider::s_empty_points;
 Points SinglePathProvider::s_end;
@@ -267,28 +302,103 @@ bool has_duplicate_points(const ClipperLib::PolyTree &polytree)
 }
 #endif
 
+// Upper limit of the ClipperLib edges and output points kept by the thread local clipping context between calls,
+// roughly 7MB per thread.
+static constexpr const size_t ClipperContextRetainedEdges = 65536;
+
+// ClipperLib::Clipper and ClipperLib::ClipperOffset of the calling thread, reused by the successive ClipperUtils calls
+// so that their edge arrays, output points and scratch paths are not reallocated for each of the many small
+// offsets and booleans performed per layer. The input paths are still passed in through the PathsProvider
+// iterators without being copied.
+struct ClipperContext
+{
+    ClipperContext() {
+        clipper.RetainMemory(ClipperContextRetainedEdges);
+        offsetter.RetainMemory(ClipperContextRetainedEdges);
+    }
+
+    ClipperLib::Clipper       clipper;
+    ClipperLib::ClipperOffset offsetter;
+    bool                      clipper_busy   { false };
+    bool                      offsetter_busy { false };
+};
+
+static ClipperContext& clipper_context()
+{
+    thread_local ClipperContext context;
+    return context;
+}
+
+// Lease of the thread local ClipperLib::Clipper or ClipperLib::ClipperOffset, returned cleared and reset
+// to its default settings at the end of the scope. A nested lease on the same thread gets a fresh instance.
+template<typename ClipperType>
+class ClipperLease
+{
+public:
+    ClipperLease(ClipperType &shared, bool &busy) {
+        if (! busy) {
+            busy     = true;
+            m_busy   = &busy;
+            m_clipper = &shared;
+        } else
+            m_clipper = &m_local.emplace();
+    }
+    ~ClipperLease() {
+        if (m_busy) {
+            reset(*m_clipper);
+            *m_busy = false;
+        }
+    }
+    ClipperLease(const ClipperLease&) = delete;
+    ClipperLease& operator=(const ClipperLease&) = delete;
+
+    ClipperType* operator->() { return m_clipper; }
+    ClipperType& operator*()  { return *m_clipper; }
+
+private:
+    static void reset(ClipperLib::Clipper &clipper) {
+        clipper.Clear();
+        clipper.ReverseSolution(false);
+        clipper.StrictlySimple(false);
+        clipper.PreserveCollinear(false);
+    }
+    static void reset(ClipperLib::ClipperOffset &co) {
+        co.Clear();
+        co.MiterLimit         = 2.;
+        co.ArcTolerance       = 0.25;
+        co.ShortestEdgeLength = 0.;
+    }
+
+    ClipperType                *m_clipper { nullptr };
+    bool                       *m_busy    { nullptr };
+    std::optional<ClipperType>  m_local;
+};
+
+static ClipperLease<ClipperLib::Clipper>       reuse_clipper()   { ClipperContext &ctx = clipper_context(); return { ctx.clipper, ctx.clipper_busy }; }
+static ClipperLease<ClipperLib::ClipperOffset> reuse_offsetter() { ClipperContext &ctx = clipper_context(); return { ctx.offsetter, ctx.offsetter_busy }; }
+
 // Offset CCW contours outside, CW contours (holes) inside.
 // Don't calculate union of the output paths.
 template<typename PathsProvider>
 static ClipperLib::Paths raw_offset(PathsProvider &&paths, float offset, ClipperLib::JoinType joinType, double miterLimit, ClipperLib::EndType endType = ClipperLib::etClosedPolygon)
 {
-    ClipperLib::ClipperOffset co;
+    auto co = reuse_offsetter();
     ClipperLib::Paths out;
     out.reserve(paths.size());
     ClipperLib::Paths out_this;
     if (joinType == jtRound)
-        co.ArcTolerance = miterLimit;
+        co->ArcTolerance = miterLimit;
     else
-        co.MiterLimit = miterLimit;
-    co.ShortestEdgeLength = std::abs(offset * ClipperOffsetShortestEdgeFactor);
+        co->MiterLimit = miterLimit;
+    co->ShortestEdgeLength = std::abs(offset * ClipperOffsetShortestEdgeFactor);
     for (const ClipperLib::Path &path : paths) {
-        co.Clear();
+        co->Clear();
         // Execute reorients the contours so that the outer most contour has a positive area. Thus the output
         // contours will be CCW oriented even though the input paths are CW oriented.
         // Offset is applied after contour reorientation, thus the signum of the offset value is reversed.
-        co.AddPath(path, joinType, endType);
+        co->AddPath(path, joinType, endType);
         bool ccw = endType == ClipperLib::etClosedPolygon ? ClipperLib::Orientation(path) : true;
-        co.Execute(out_this, ccw ? offset : - offset);
+        co->Execute(out_this, ccw ? offset : - offset);
         if (! ccw) {
             // Reverse the resulting contours.
             for (ClipperLib::Path &path : out_this)
@@ -313,11 +423,11 @@ TResult clipper_do(
     TClip &&                       clip,
     const ClipperLib::PolyFillType fillType)
 {
-    ClipperLib::Clipper clipper;
-    clipper.AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
-    clipper.AddPaths(std::forward<TClip>(clip),    ClipperLib::ptClip,    true);
+    auto clipper = reuse_clipper();
+    clipper->AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
+    clipper->AddPaths(std::forward<TClip>(clip),    ClipperLib::ptClip,    true);
     TResult retval;
-    clipper.Execute(clipType, retval, fillType, fillType);
+    clipper->Execute(clipType, retval, fillType, fillType);
     return retval;
 }
 
@@ -342,10 +452,10 @@ TResult clipper_union(
     // fillType pftNonZero and pftPositive "should" produce the same result for "normalized with implicit union" set of polygons
     const ClipperLib::PolyFillType fillType = ClipperLib::pftNonZero)
 {
-    ClipperLib::Clipper clipper;
-    clipper.AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
+    auto clipper = reuse_clipper();
+    clipper->AddPaths(std::forward<TSubj>(subject), ClipperLib::ptSubject, true);
     TResult retval;
-    clipper.Execute(ClipperLib::ctUnion, retval, fillType, fillType);
+    clipper->Execute(ClipperLib::ctUnion, retval, fillType, fillType);
     return retval;
 }
 
@@ -385,12 +495,12 @@ static TResult shrink_paths(PathsProvider &&paths, float offset, ClipperLib::Joi
     //assert(offset > 0);
     TResult out;
     if (auto raw = raw_offset(std::forward<PathsProvider>(paths), - offset, joinType, miterLimit); ! raw.empty()) {
-        ClipperLib::Clipper clipper;
-        clipper.AddPaths(raw, ClipperLib::ptSubject, true);
-        ClipperLib::IntRect r = clipper.GetBounds();
-        clipper.AddPath({ { r.left - 10, r.bottom + 10 }, { r.right + 10, r.bottom + 10 }, { r.right + 10, r.top - 10 }, { r.left - 10, r.top - 10 } }, ClipperLib::ptSubject, true);
-        clipper.ReverseSolution(true);
-        clipper.Execute(ClipperLib::ctUnion, out, ClipperLib::pftNegative, ClipperLib::pftNegative);
+        auto clipper = reuse_clipper();
+        clipper->AddPaths(raw, ClipperLib::ptSubject, true);
+        ClipperLib::IntRect r = clipper->GetBounds();
+        clipper->AddPath({ { r.left - 10, r.bottom + 10 }, { r.right + 10, r.bottom + 10 }, { r.right + 10, r.top - 10 }, { r.left - 10, r.top - 10 } }, ClipperLib::ptSubject, true);
+        clipper->ReverseSolution(true);
+        clipper->Execute(ClipperLib::ctUnion, out, ClipperLib::pftNegative, ClipperLib::pftNegative);
         remove_outermost_polygon(out);
     }
     return out;
@@ -407,28 +517,61 @@ static TResult offset_paths(PathsProvider &&paths, float offset, ClipperLib::Joi
         shrink_paths<TResult>(std::forward<PathsProvider>(paths), - offset, joinType, miterLimit);
 }
 
+// Clipper2 counterpart of offset_paths(). Clipper2Lib::ClipperOffset unites its output, thus expand and shrink are handled alike.
+template<typename PathsProvider>
+static Clipper2Lib::Paths64 clipper2_offset_paths(PathsProvider &&paths, float offset, ClipperLib::JoinType joinType, double miterLimit, ClipperLib::EndType endType = ClipperLib::etClosedPolygon)
+{
+    return Clipper2Utils::offset_paths(Clipper2Utils::to_paths64(std::forward<PathsProvider>(paths)), offset, joinType, miterLimit, endType);
+}
+
 Slic3r::Polygons offset(const Slic3r::Polygon &polygon, const float delta, ClipperLib::JoinType joinType, double miterLimit)
-    { return to_polygons(raw_offset(ClipperUtils::SinglePathProvider(polygon.points), delta, joinType, miterLimit)); }
+{
+    if (use_clipper2())
+        return Clipper2Utils::to_polygons(clipper2_offset_paths(ClipperUtils::SinglePathProvider(polygon.points), delta, joinType, miterLimit));
+    return to_polygons(raw_offset(ClipperUtils::SinglePathProvider(polygon.points), delta, joinType, miterLimit));
+}
 
 Slic3r::Polygons offset(const Slic3r::Polygons &polygons, const float delta, ClipperLib::JoinType joinType, double miterLimit)
-    { return to_polygons(offset_paths<ClipperLib::Paths>(ClipperUtils::PolygonsProvider(polygons), delta, joinType, miterLimit)); }
+{
+    if (use_clipper2())
+        return Clipper2Utils::to_polygons(clipper2_offset_paths(ClipperUtils::PolygonsProvider(polygons), delta, joinType, miterLimit));
+    return to_polygons(offset_paths<ClipperLib::Paths>(ClipperUtils::PolygonsProvider(polygons), delta, joinType, miterLimit));
+}
 Slic3r::ExPolygons offset_ex(const Slic3r::Polygons &polygons, const float delta, ClipperLib::JoinType joinType, double miterLimit)
-    { return PolyTreeToExPolygons(offset_paths<ClipperLib::PolyTree>(ClipperUtils::PolygonsProvider(polygons), delta, joinType, miterLimit)); }
+{
+    if (use_clipper2())
+        return Clipper2Utils::offset_paths_ex(Clipper2Utils::to_paths64(ClipperUtils::PolygonsProvider(polygons)), delta, joinType, miterLimit);
+    return PolyTreeToExPolygons(offset_paths<ClipperLib::PolyTree>(ClipperUtils::PolygonsProvider(polygons), delta, joinType, miterLimit));
+}
 
 Slic3r::Polygons offset(const Slic3r::Polyline &polyline, const float delta, ClipperLib::JoinType joinType, double miterLimit, ClipperLib::EndType end_type)
-    { assert(delta > 0); return to_polygons(clipper_union<ClipperLib::Paths>(raw_offset_polyline(ClipperUtils::SinglePathProvider(polyline.points), delta, joinType, miterLimit, end_type))); }
+{
+    assert(delta > 0);
+    if (use_clipper2())
+        return Clipper2Utils::to_polygons(clipper2_offset_paths(ClipperUtils::SinglePathProvider(polyline.points), delta, joinType, miterLimit, end_type));
+    return to_polygons(clipper_union<ClipperLib::Paths>(raw_offset_polyline(ClipperUtils::SinglePathProvider(polyline.points), delta, joinType, miterLimit, end_type)));
+}
 Slic3r::Polygons offset(const Slic3r::Polylines &polylines, const float delta, ClipperLib::JoinType joinType, double miterLimit, ClipperLib::EndType end_type)
-    { assert(delta > 0); return to_polygons(clipper_union<ClipperLib::Paths>(raw_offset_polyline(ClipperUtils::PolylinesProvider(polylines), delta, joinType, miterLimit, end_type))); }
+{
+    assert(delta > 0);
+    if (use_clipper2())
+        return Clipper2Utils::to_polygons(clipper2_offset_paths(ClipperUtils::PolylinesProvider(polylines), delta, joinType, miterLimit, end_type));
+    return to_polygons(clipper_union<ClipperLib::Paths>(raw_offset_polyline(ClipperUtils::PolylinesProvider(polylines), delta, joinType, miterLimit, end_type)));
+}
 
 Polygons contour_to_polygons(const Polygon &polygon, const float line_width, ClipperLib::JoinType join_type, double miter_limit)
     {
         assert(line_width > 1.f);
+        if (use_clipper2())
+            return Clipper2Utils::to_polygons(clipper2_offset_paths(ClipperUtils::SinglePathProvider(polygon.points), line_width / 2, join_type, miter_limit, ClipperLib::etClosedLine));
         return to_polygons(
             clipper_union<ClipperLib::Paths>(raw_offset(ClipperUtils::SinglePathProvider(polygon.points), line_width / 2, join_type, miter_limit, ClipperLib::etClosedLine)));
     }
 Polygons contour_to_polygons(const Polygons &polygons, const float line_width, ClipperLib::JoinType join_type, double miter_limit)
     {
         assert(line_width > 1.f);
+        if (use_clipper2())
+            return Clipper2Utils::to_polygons(clipper2_offset_paths(ClipperUtils::PolygonsProvider(polygons), line_width / 2, join_type, miter_limit, ClipperLib::etClosedLine));
         return to_polygons(
             clipper_union<ClipperLib::Paths>(raw_offset(ClipperUtils::PolygonsProvider(polygons), line_width / 2, join_type, miter_limit, ClipperLib::etClosedLine)));
     }
@@ -439,14 +582,14 @@ static int offset_expolygon_inner(const Slic3r::ExPolygon &expoly, const float d
     // 1) Offset the outer contour.
     ClipperLib::Paths contours;
     {
-        ClipperLib::ClipperOffset co;
+        auto co = reuse_offsetter();
         if (joinType == jtRound)
-            co.ArcTolerance = miterLimit;
+            co->ArcTolerance = miterLimit;
         else
-            co.MiterLimit = miterLimit;
-        co.ShortestEdgeLength = double(std::abs(delta * ClipperOffsetShortestEdgeFactor));
-        co.AddPath(expoly.contour.points, joinType, ClipperLib::etClosedPolygon);
-        co.Execute(contours, delta);
+            co->MiterLimit = miterLimit;
+        co->ShortestEdgeLength = double(std::abs(delta * ClipperOffsetShortestEdgeFactor));
+        co->AddPath(expoly.contour.points, joinType, ClipperLib::etClosedPolygon);
+        co->Execute(contours, delta);
     }
     if (contours.empty())
         // No need to try to offset the holes.
@@ -459,19 +602,20 @@ static int offset_expolygon_inner(const Slic3r::ExPolygon &expoly, const float d
         // 2) Offset the holes one by one, collect the offsetted holes.
         ClipperLib::Paths holes;
         {
+            auto co = reuse_offsetter();
+            if (joinType == jtRound)
+                co->ArcTolerance = miterLimit;
+            else
+                co->MiterLimit = miterLimit;
+            co->ShortestEdgeLength = double(std::abs(delta * ClipperOffsetShortestEdgeFactor));
+            ClipperLib::Paths out2;
             for (const Polygon &hole : expoly.holes) {
-                ClipperLib::ClipperOffset co;
-                if (joinType == jtRound)
-                    co.ArcTolerance = miterLimit;
-                else
-                    co.MiterLimit = miterLimit;
-                co.ShortestEdgeLength = double(std::abs(delta * ClipperOffsetShortestEdgeFactor));
-                co.AddPath(hole.points, joinType, ClipperLib::etClosedPolygon);
-                ClipperLib::Paths out2;
+                co->Clear();
+                co->AddPath(hole.points, joinType, ClipperLib::etClosedPolygon);
                 // Execute reorients the contours so that the outer most contour has a positive area. Thus the output
                 // contours will be CCW oriented even though the input paths are CW oriented.
                 // Offset is applied after contour reorientation, thus the signum of the offset value is reversed.
-                co.Execute(out2, - delta);
+                co->Execute(out2, - delta);
                 append(holes, std::move(out2));
             }
         }
@@ -556,34 +700,119 @@ static ClipperLib::PolyTree expolygons_offset_pt(const ExPolygonVector &expolygo
     return clipper_union<ClipperLib::PolyTree>(output);
 }
 
+// Clipper2 counterparts of expolygons_offset_raw(), expolygons_offset() and expolygons_offset_pt().
+static int clipper2_offset_expolygon_inner(const Slic3r::ExPolygon &expoly, const float delta, ClipperLib::JoinType joinType, double miterLimit, Clipper2Lib::Paths64 &out)
+    { return Clipper2Utils::offset_expolygon(expoly, delta, joinType, miterLimit, out); }
+static int clipper2_offset_expolygon_inner(const Slic3r::Surface &surface, const float delta, ClipperLib::JoinType joinType, double miterLimit, Clipper2Lib::Paths64 &out)
+    { return Clipper2Utils::offset_expolygon(surface.expolygon, delta, joinType, miterLimit, out); }
+static int clipper2_offset_expolygon_inner(const Slic3r::Surface *surface, const float delta, ClipperLib::JoinType joinType, double miterLimit, Clipper2Lib::Paths64 &out)
+    { return Clipper2Utils::offset_expolygon(surface->expolygon, delta, joinType, miterLimit, out); }
+
+template<typename ExPolygonVector>
+static std::pair<Clipper2Lib::Paths64, size_t> clipper2_expolygons_offset_raw(const ExPolygonVector &expolygons, const float delta, ClipperLib::JoinType joinType, double miterLimit)
+{
+    Clipper2Lib::Paths64 output;
+    output.reserve(expolygons.size());
+    size_t expolygons_collected = 0;
+    for (const auto &expoly : expolygons)
+        expolygons_collected += clipper2_offset_expolygon_inner(expoly, delta, joinType, miterLimit, output);
+    return std::make_pair(std::move(output), expolygons_collected);
+}
+static std::pair<Clipper2Lib::Paths64, size_t> clipper2_expolygons_offset_raw(const ExPolygon &expolygon, const float delta, ClipperLib::JoinType joinType, double miterLimit)
+{
+    Clipper2Lib::Paths64 output;
+    size_t expolygons_collected = Clipper2Utils::offset_expolygon(expolygon, delta, joinType, miterLimit, output);
+    return std::make_pair(std::move(output), expolygons_collected);
+}
+
+template<typename ExPolygonVector>
+static Clipper2Lib::Paths64 clipper2_expolygons_offset(const ExPolygonVector &expolygons, const float delta, ClipperLib::JoinType joinType, double miterLimit)
+{
+    auto [output, expolygons_collected] = clipper2_expolygons_offset_raw(expolygons, delta, joinType, miterLimit);
+    return expolygons_collected > 1 && delta > 0 ?
+        Clipper2Utils::clip_paths(ClipperLib::ctUnion, output, {}, ClipperLib::pftNonZero) :
+        output;
+}
+
+template<typename ExPolygonVector>
+static ExPolygons clipper2_expolygons_offset_ex(const ExPolygonVector &expolygons, const float delta, ClipperLib::JoinType joinType, double miterLimit)
+{
+    auto [output, expolygons_collected] = clipper2_expolygons_offset_raw(expolygons, delta, joinType, miterLimit);
+    return Clipper2Utils::clip_paths_ex(ClipperLib::ctUnion, output, {}, ClipperLib::pftNonZero);
+}
+
 Slic3r::Polygons offset(const Slic3r::ExPolygon &expolygon, const float delta, ClipperLib::JoinType joinType, double miterLimit)
-    { return to_polygons(expolygon_offset(expolygon, delta, joinType, miterLimit)); }
+{
+    if (use_clipper2())
+        return Clipper2Utils::to_polygons(clipper2_expolygons_offset(expolygon, delta, joinType, miterLimit));
+    return to_polygons(expolygon_offset(expolygon, delta, joinType, miterLimit));
+}
 Slic3r::Polygons offset(const Slic3r::ExPolygons &expolygons, const float delta, ClipperLib::JoinType joinType, double miterLimit)
-    { return to_polygons(expolygons_offset(expolygons, delta, joinType, miterLimit)); }
+{
+    if (use_clipper2())
+        return Clipper2Utils::to_polygons(clipper2_expolygons_offset(expolygons, delta, joinType, miterLimit));
+    return to_polygons(expolygons_offset(expolygons, delta, joinType, miterLimit));
+}
 Slic3r::Polygons offset(const Slic3r::Surfaces &surfaces, const float delta, ClipperLib::JoinType joinType, double miterLimit)
-    { return to_polygons(expolygons_offset(surfaces, delta, joinType, miterLimit)); }
+{
+    if (use_clipper2())
+        return Clipper2Utils::to_polygons(clipper2_expolygons_offset(surfaces, delta, joinType, miterLimit));
+    return to_polygons(expolygons_offset(surfaces, delta, joinType, miterLimit));
+}
 Slic3r::Polygons offset(const Slic3r::SurfacesPtr &surfaces, const float delta, ClipperLib::JoinType joinType, double miterLimit)
-    { return to_polygons(expolygons_offset(surfaces, delta, joinType, miterLimit)); }
+{
+    if (use_clipper2())
+        return Clipper2Utils::to_polygons(clipper2_expolygons_offset(surfaces, delta, joinType, miterLimit));
+    return to_polygons(expolygons_offset(surfaces, delta, joinType, miterLimit));
+}
 Slic3r::ExPolygons offset_ex(const Slic3r::ExPolygon &expolygon, const float delta, ClipperLib::JoinType joinType, double miterLimit)
+{
+    if (use_clipper2())
+        return clipper2_expolygons_offset_ex(expolygon, delta, joinType, miterLimit);
     //FIXME one may spare one Clipper Union call.
-    { return ClipperPaths_to_Slic3rExPolygons(expolygon_offset(expolygon, delta, joinType, miterLimit)); }
+    return ClipperPaths_to_Slic3rExPolygons(expolygon_offset(expolygon, delta, joinType, miterLimit));
+}
 Slic3r::ExPolygons offset_ex(const Slic3r::ExPolygons &expolygons, const float delta, ClipperLib::JoinType joinType, double miterLimit)
-    { return PolyTreeToExPolygons(expolygons_offset_pt(expolygons, delta, joinType, miterLimit)); }
+{
+    if (use_clipper2())
+        return clipper2_expolygons_offset_ex(expolygons, delta, joinType, miterLimit);
+    return PolyTreeToExPolygons(expolygons_offset_pt(expolygons, delta, joinType, miterLimit));
+}
 Slic3r::ExPolygons offset_ex(const Slic3r::Surfaces &surfaces, const float delta, ClipperLib::JoinType joinType, double miterLimit)
-    { return PolyTreeToExPolygons(expolygons_offset_pt(surfaces, delta, joinType, miterLimit)); }
+{
+    if (use_clipper2())
+        return clipper2_expolygons_offset_ex(surfaces, delta, joinType, miterLimit);
+    return PolyTreeToExPolygons(expolygons_offset_pt(surfaces, delta, joinType, miterLimit));
+}
 Slic3r::ExPolygons offset_ex(const Slic3r::SurfacesPtr &surfaces, const float delta, ClipperLib::JoinType joinType, double miterLimit)
-    { return PolyTreeToExPolygons(expolygons_offset_pt(surfaces, delta, joinType, miterLimit)); }
+{
+    if (use_clipper2())
+        return clipper2_expolygons_offset_ex(surfaces, delta, joinType, miterLimit);
+    return PolyTreeToExPolygons(expolygons_offset_pt(surfaces, delta, joinType, miterLimit));
+}
 
 Polygons offset2(const ExPolygons &expolygons, const float delta1, const float delta2, ClipperLib::JoinType joinType, double miterLimit)
 {
+    if (use_clipper2())
+        return Clipper2Utils::to_polygons(Clipper2Utils::offset_paths(clipper2_expolygons_offset(expolygons, delta1, joinType, miterLimit), delta2, joinType, miterLimit));
     return to_polygons(offset_paths<ClipperLib::Paths>(expolygons_offset(expolygons, delta1, joinType, miterLimit), delta2, joinType, miterLimit));
 }
 ExPolygons offset2_ex(const ExPolygons &expolygons, const float delta1, const float delta2, ClipperLib::JoinType joinType, double miterLimit)
 {
+    if (use_clipper2())
+        return Clipper2Utils::offset_paths_ex(clipper2_expolygons_offset(expolygons, delta1, joinType, miterLimit), delta2, joinType, miterLimit);
     return PolyTreeToExPolygons(offset_paths<ClipperLib::PolyTree>(expolygons_offset(expolygons, delta1, joinType, miterLimit), delta2, joinType, miterLimit));
 }
+ExPolygons offset2_ex(const ExPolygon &expolygon, const float delta1, const float delta2, ClipperLib::JoinType joinType, double miterLimit)
+{
+    if (use_clipper2())
+        return Clipper2Utils::offset_paths_ex(clipper2_expolygons_offset(expolygon, delta1, joinType, miterLimit), delta2, joinType, miterLimit);
+    return PolyTreeToExPolygons(offset_paths<ClipperLib::PolyTree>(expolygon_offset(expolygon, delta1, joinType, miterLimit), delta2, joinType, miterLimit));
+}
 ExPolygons offset2_ex(const Surfaces &surfaces, const float delta1, const float delta2, ClipperLib::JoinType joinType, double miterLimit)
 {
+    if (use_clipper2())
+        return Clipper2Utils::offset_paths_ex(clipper2_expolygons_offset(surfaces, delta1, joinType, miterLimit), delta2, joinType, miterLimit);
     //FIXME it may be more efficient to offset to_expolygons(surfaces) instead of to_polygons(surfaces).
     return PolyTreeToExPolygons(offset_paths<ClipperLib::PolyTree>(expolygons_offset(surfaces, delta1, joinType, miterLimit), delta2, joinType, miterLimit));
 }
@@ -593,18 +822,24 @@ Slic3r::Polygons closing(const Slic3r::Polygons &polygons, const float delta1, c
 {
     assert(delta1 > 0);
     assert(delta2 > 0);
+    if (use_clipper2())
+        return Clipper2Utils::to_polygons(Clipper2Utils::offset_paths(clipper2_offset_paths(ClipperUtils::PolygonsProvider(polygons), delta1, joinType, miterLimit), - delta2, joinType, miterLimit));
     return to_polygons(shrink_paths<ClipperLib::Paths>(expand_paths<ClipperLib::Paths>(ClipperUtils::PolygonsProvider(polygons), delta1, joinType, miterLimit), delta2, joinType, miterLimit));
 }
 Slic3r::ExPolygons closing_ex(const Slic3r::Polygons &polygons, const float delta1, const float delta2, ClipperLib::JoinType joinType, double miterLimit)
 {
     assert(delta1 > 0);
     assert(delta2 > 0);
+    if (use_clipper2())
+        return Clipper2Utils::offset_paths_ex(clipper2_offset_paths(ClipperUtils::PolygonsProvider(polygons), delta1, joinType, miterLimit), - delta2, joinType, miterLimit);
     return PolyTreeToExPolygons(shrink_paths<ClipperLib::PolyTree>(expand_paths<ClipperLib::Paths>(ClipperUtils::PolygonsProvider(polygons), delta1, joinType, miterLimit), delta2, joinType, miterLimit));
 }
 Slic3r::ExPolygons closing_ex(const Slic3r::Surfaces &surfaces, const float delta1, const float delta2, ClipperLib::JoinType joinType, double miterLimit)
 {
     assert(delta1 > 0);
     assert(delta2 > 0);
+    if (use_clipper2())
+        return Clipper2Utils::offset_paths_ex(clipper2_offset_paths(ClipperUtils::SurfacesProvider(surfaces), delta1, joinType, miterLimit), - delta2, joinType, miterLimit);
     //FIXME it may be more efficient to offset to_expolygons(surfaces) instead of to_polygons(surfaces).
     return PolyTreeToExPolygons(shrink_paths<ClipperLib::PolyTree>(expand_paths<ClipperLib::Paths>(ClipperUtils::SurfacesProvider(surfaces), delta1, joinType, miterLimit), delta2, joinType, miterLimit));
 }
@@ -614,18 +849,24 @@ Slic3r::Polygons opening(const Slic3r::Polygons &polygons, const float delta1, c
 {
     assert(delta1 > 0);
     assert(delta2 > 0);
+    if (use_clipper2())
+        return Clipper2Utils::to_polygons(Clipper2Utils::offset_paths(clipper2_offset_paths(ClipperUtils::PolygonsProvider(polygons), - delta1, joinType, miterLimit), delta2, joinType, miterLimit));
     return to_polygons(expand_paths<ClipperLib::Paths>(shrink_paths<ClipperLib::Paths>(ClipperUtils::PolygonsProvider(polygons), delta1, joinType, miterLimit), delta2, joinType, miterLimit));
 }
 Slic3r::Polygons opening(const Slic3r::ExPolygons &expolygons, const float delta1, const float delta2, ClipperLib::JoinType joinType, double miterLimit)
 {
     assert(delta1 > 0);
     assert(delta2 > 0);
+    if (use_clipper2())
+        return Clipper2Utils::to_polygons(Clipper2Utils::offset_paths(clipper2_expolygons_offset(expolygons, - delta1, joinType, miterLimit), delta2, joinType, miterLimit));
     return to_polygons(expand_paths<ClipperLib::Paths>(shrink_paths<ClipperLib::Paths>(ClipperUtils::ExPolygonsProvider(expolygons), delta1, joinType, miterLimit), delta2, joinType, miterLimit));
 }
 Slic3r::Polygons opening(const Slic3r::Surfaces &surfaces, const float delta1, const float delta2, ClipperLib::JoinType joinType, double miterLimit)
 {
     assert(delta1 > 0);
     assert(delta2 > 0);
+    if (use_clipper2())
+        return Clipper2Utils::to_polygons(Clipper2Utils::offset_paths(clipper2_expolygons_offset(surfaces, - delta1, joinType, miterLimit), delta2, joinType, miterLimit));
     //FIXME it may be more efficient to offset to_expolygons(surfaces) instead of to_polygons(surfaces).
     return to_polygons(expand_paths<ClipperLib::Paths>(shrink_paths<ClipperLib::Paths>(ClipperUtils::SurfacesProvider(surfaces), delta1, joinType, miterLimit), delta2, joinType, miterLimit));
 }
@@ -666,10 +907,21 @@ inline ClipperLib::PolyTree clipper_do_polytree(
         clipper_do_polytree(clipType, std::forward<PathProvider1>(subject), std::forward<PathProvider2>(clip), fillType);
 }
 
+// Clipping paths for the Clipper2 backend, optionally inflated by the safety offset.
+template<typename PathsProvider>
+static Clipper2Lib::Paths64 clipper2_clip_paths(PathsProvider &&clip, ApplySafetyOffset do_safety_offset)
+{
+    Clipper2Lib::Paths64 out = Clipper2Utils::to_paths64(std::forward<PathsProvider>(clip));
+    return do_safety_offset == ApplySafetyOffset::Yes ? Clipper2Utils::safety_offset(out) : out;
+}
+
 template<class TSubj, class TClip>
-static inline Polygons _clipper(ClipperLib::ClipType clipType, TSubj &&subject, TClip &&clip, ApplySafetyOffset do_safety_offset)
+static inline Polygons _clipper(ClipperLib::ClipType clipType, TSubj &&subject, TClip &&clip, ApplySafetyOffset do_safety_offset, ClipperLib::PolyFillType fill_type = ClipperLib::pftNonZero)
 {
-    return to_polygons(clipper_do<ClipperLib::Paths>(clipType, std::forward<TSubj>(subject), std::forward<TClip>(clip), ClipperLib::pftNonZero, do_safety_offset));
+    if (use_clipper2())
+        return Clipper2Utils::to_polygons(Clipper2Utils::clip_paths(clipType,
+            Clipper2Utils::to_paths64(std::forward<TSubj>(subject)), clipper2_clip_paths(std::forward<TClip>(clip), do_safety_offset), fill_type));
+    return to_polygons(clipper_do<ClipperLib::Paths>(clipType, std::forward<TSubj>(subject), std::forward<TClip>(clip), fill_type, do_safety_offset));
 }
 
 Slic3r::Polygons diff(const Slic3r::Polygon &subject, const Slic3r::Polygon &clip, ApplySafetyOffset do_safety_offset)
@@ -723,7 +975,7 @@ Slic3r::Polygons union_(const Slic3r::Polygons &subject)
 Slic3r::Polygons union_(const Slic3r::ExPolygons &subject)
     { return _clipper(ClipperLib::ctUnion, ClipperUtils::ExPolygonsProvider(subject), ClipperUtils::EmptyPathsProvider(), ApplySafetyOffset::No); }
 Slic3r::Polygons union_(const Slic3r::Polygons &subject, const ClipperLib::PolyFillType fillType)
-    { return to_polygons(clipper_do<ClipperLib::Paths>(ClipperLib::ctUnion, ClipperUtils::PolygonsProvider(subject), ClipperUtils::EmptyPathsProvider(), fillType, ApplySafetyOffset::No)); }
+    { return _clipper(ClipperLib::ctUnion, ClipperUtils::PolygonsProvider(subject), ClipperUtils::EmptyPathsProvider(), ApplySafetyOffset::No, fillType); }
 Slic3r::Polygons union_(const Slic3r::Polygons &subject, const Slic3r::Polygons &subject2)
     {
         // BBS
@@ -736,7 +988,12 @@ Slic3r::Polygons union_(const Slic3r::Polygons &subject, const Slic3r::ExPolygon
     { return _clipper(ClipperLib::ctUnion, ClipperUtils::PolygonsProvider(subject), ClipperUtils::ExPolygonProvider(subject2), ApplySafetyOffset::No); }
 template <typename TSubject, typename TClip>
 static ExPolygons _clipper_ex(ClipperLib::ClipType clipType, TSubject &&subject,  TClip &&clip, ApplySafetyOffset do_safety_offset, ClipperLib::PolyFillType fill_type = ClipperLib::pftNonZero)
-    { return PolyTreeToExPolygons(clipper_do_polytree(clipType, std::forward<TSubject>(subject), std::forward<TClip>(clip), fill_type, do_safety_offset)); }
+{
+    if (use_clipper2())
+        return Clipper2Utils::clip_paths_ex(clipType,
+            Clipper2Utils::to_paths64(std::forward<TSubject>(subject)), clipper2_clip_paths(std::forward<TClip>(clip), do_safety_offset), fill_type);
+    return PolyTreeToExPolygons(clipper_do_polytree(clipType, std::forward<TSubject>(subject), std::forward<TClip>(clip), fill_type, do_safety_offset));
+}
 
 Slic3r::ExPolygons diff_ex(const Slic3r::Polygons &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset)
     { return _clipper_ex(ClipperLib::ctDifference, ClipperUtils::PolygonsProvider(subject), ClipperUtils::PolygonsProvider(clip), do_safety_offset); }
@@ -813,14 +1070,11 @@ Slic3r::ExPolygons intersection_ex(const Slic3r::SurfacesPtr &subject, const Sli
 Slic3r::ExPolygons union_ex(const Slic3r::Polygons &subject, ClipperLib::PolyFillType fill_type)
     { return _clipper_ex(ClipperLib::ctUnion, ClipperUtils::PolygonsProvider(subject), ClipperUtils::EmptyPathsProvider(), ApplySafetyOffset::No, fill_type); }
 Slic3r::ExPolygons union_ex(const Slic3r::ExPolygons &subject)
-    { return PolyTreeToExPolygons(clipper_do_polytree(ClipperLib::ctUnion, ClipperUtils::ExPolygonsProvider(subject), ClipperUtils::EmptyPathsProvider(), ClipperLib::pftNonZero)); }
+    { return _clipper_ex(ClipperLib::ctUnion, ClipperUtils::ExPolygonsProvider(subject), ClipperUtils::EmptyPathsProvider(), ApplySafetyOffset::No); }
 Slic3r::ExPolygons union_ex(const Slic3r::ExPolygons &subject, const Slic3r::Polygons &subject2)
-{
-    return PolyTreeToExPolygons(
-        clipper_do_polytree(ClipperLib::ctUnion, ClipperUtils::ExPolygonsProvider(subject), ClipperUtils::PolygonsProvider(subject2), ClipperLib::pftNonZero));
-}
-    Slic3r::ExPolygons union_ex(const Slic3r::Surfaces &subject)
-    { return PolyTreeToExPolygons(clipper_do_polytree(ClipperLib::ctUnion, ClipperUtils::SurfacesProvider(subject), ClipperUtils::EmptyPathsProvider(), ClipperLib::pftNonZero)); }
+    { return _clipper_ex(ClipperLib::ctUnion, ClipperUtils::ExPolygonsProvider(subject), ClipperUtils::PolygonsProvider(subject2), ApplySafetyOffset::No); }
+Slic3r::ExPolygons union_ex(const Slic3r::Surfaces &subject)
+    { return _clipper_ex(ClipperLib::ctUnion, ClipperUtils::SurfacesProvider(subject), ClipperUtils::EmptyPathsProvider(), ApplySafetyOffset::No); }
 // BBS
 Slic3r::ExPolygons union_ex(const Slic3r::ExPolygons& poly1, const Slic3r::ExPolygons& poly2, bool safety_offset_)
     {
@@ -840,11 +1094,13 @@ Slic3r::ExPolygons xor_ex(const Slic3r::ExPolygons &subject, const Slic3r::ExPol
 template<typename PathsProvider1, typename PathsProvider2>
 Polylines _clipper_pl_open(ClipperLib::ClipType clipType, PathsProvider1 &&subject, PathsProvider2 &&clip)
 {
-    ClipperLib::Clipper clipper;
-    clipper.AddPaths(std::forward<PathsProvider1>(subject), ClipperLib::ptSubject, false);
-    clipper.AddPaths(std::forward<PathsProvider2>(clip), ClipperLib::ptClip, true);
+    if (use_clipper2())
+        return Clipper2Utils::clip_paths_open(clipType, Clipper2Utils::to_paths64(std::forward<PathsProvider1>(subject)), Clipper2Utils::to_paths64(std::forward<PathsProvider2>(clip)));
+    auto clipper = reuse_clipper();
+    clipper->AddPaths(std::forward<PathsProvider1>(subject), ClipperLib::ptSubject, false);
+    clipper->AddPaths(std::forward<PathsProvider2>(clip), ClipperLib::ptClip, true);
     ClipperLib::PolyTree retval;
-    clipper.Execute(clipType, retval, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
+    clipper->Execute(clipType, retval, ClipperLib::pftNonZero, ClipperLib::pftNonZero);
     return PolyTreeToPolylines(std::move(retval));
 }
 
@@ -937,6 +1193,117 @@ Slic3r::Polylines intersection_pl(const Slic3r::Polylines &subject, const Slic3r
 Slic3r::Polylines intersection_pl(const Slic3r::Polygons &subject, const Slic3r::Polygons &clip)
     { return _clipper_pl_closed(ClipperLib::ctIntersection, ClipperUtils::PolygonsProvider(subject), ClipperUtils::PolygonsProvider(clip)); }
 
+// Above this number of subject paths their bounding boxes are indexed by an AABB tree instead of being tested one by one.
+static constexpr const size_t ClipIndexedSubjectPathsMin = 16;
+
+// Collect the clipping paths with bounding boxes overlapping a bounding box of some subject path.
+// A clipping contour outside of the subject bounding boxes does not change the winding numbers inside the subject,
+// therefore it does not change the result of a difference or an intersection.
+template<typename SubjectProvider, typename ClipProvider>
+static std::vector<const Points*> clip_paths_interacting(const SubjectProvider &subject, const ClipProvider &clip, ApplySafetyOffset do_safety_offset)
+{
+    // The safety offset is applied to the clipping paths later on.
+    const coord_t inflate = SCALED_EPSILON + (do_safety_offset == ApplySafetyOffset::Yes ? coord_t(std::ceil(ClipperSafetyOffset)) : 0);
+    std::vector<BoundingBox> subject_bboxes;
+    subject_bboxes.reserve(subject.size());
+    for (const Points &path : subject)
+        if (! path.empty()) {
+            subject_bboxes.emplace_back(path);
+            subject_bboxes.back().offset(inflate);
+        }
+
+    std::vector<const Points*> out;
+    if (subject_bboxes.empty())
+        return out;
+    out.reserve(clip.size());
+    if (subject_bboxes.size() < ClipIndexedSubjectPathsMin) {
+        for (const Points &path : clip)
+            if (! path.empty()) {
+                BoundingBox bbox(path);
+                if (std::any_of(subject_bboxes.begin(), subject_bboxes.end(), [&bbox](const BoundingBox &subject_bbox) { return subject_bbox.overlap(bbox); }))
+                    out.emplace_back(&path);
+            }
+    } else {
+        std::vector<AABBTreeIndirect::BoundingBoxWrapper> wrappers;
+        wrappers.reserve(subject_bboxes.size());
+        for (const BoundingBox &bbox : subject_bboxes)
+            wrappers.emplace_back(wrappers.size(), bbox);
+        AABBTreeIndirect::Tree<2, coord_t> tree;
+        tree.build(std::move(wrappers));
+        for (const Points &path : clip)
+            if (! path.empty()) {
+                BoundingBox bbox(path);
+                bool        hit = false;
+                AABBTreeIndirect::traverse(tree, AABBTreeIndirect::intersecting(AABBTreeIndirect::BoundingBoxWrapper::BoundingBox(bbox.min, bbox.max)),
+                    [&hit](const auto &) { hit = true; return false; });
+                if (hit)
+                    out.emplace_back(&path);
+            }
+    }
+    return out;
+}
+
+// Run the boolean operation fn with just the clipping paths interacting with the subject,
+// or with all of them if none could be filtered out.
+template<typename SubjectProvider, typename ClipProvider, typename Fn>
+static auto clip_indexed(SubjectProvider &&subject, ClipProvider &&clip, ApplySafetyOffset do_safety_offset, Fn &&fn)
+{
+    std::vector<const Points*> interacting = clip_paths_interacting(subject, clip, do_safety_offset);
+    return interacting.size() == clip.size() ?
+        fn(std::forward<SubjectProvider>(subject), std::forward<ClipProvider>(clip)) :
+        fn(std::forward<SubjectProvider>(subject), ClipperUtils::PathsPtrProvider(interacting));
+}
+
+template<typename SubjectProvider, typename ClipProvider>
+static Polygons _clipper_indexed(ClipperLib::ClipType clipType, SubjectProvider &&subject, ClipProvider &&clip, ApplySafetyOffset do_safety_offset)
+{
+    return clip_indexed(std::forward<SubjectProvider>(subject), std::forward<ClipProvider>(clip), do_safety_offset,
+        [clipType, do_safety_offset](auto &&subject, auto &&clip) { return _clipper(clipType, subject, clip, do_safety_offset); });
+}
+
+template<typename SubjectProvider, typename ClipProvider>
+static ExPolygons _clipper_ex_indexed(ClipperLib::ClipType clipType, SubjectProvider &&subject, ClipProvider &&clip, ApplySafetyOffset do_safety_offset)
+{
+    return clip_indexed(std::forward<SubjectProvider>(subject), std::forward<ClipProvider>(clip), do_safety_offset,
+        [clipType, do_safety_offset](auto &&subject, auto &&clip) { return _clipper_ex(clipType, subject, clip, do_safety_offset); });
+}
+
+template<typename SubjectProvider, typename ClipProvider>
+static Polylines _clipper_pl_open_indexed(ClipperLib::ClipType clipType, SubjectProvider &&subject, ClipProvider &&clip)
+{
+    return clip_indexed(std::forward<SubjectProvider>(subject), std::forward<ClipProvider>(clip), ApplySafetyOffset::No,
+        [clipType](auto &&subject, auto &&clip) { return _clipper_pl_open(clipType, subject, clip); });
+}
+
+Slic3r::Polygons diff_indexed(const Slic3r::Polygons &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset)
+    { return _clipper_indexed(ClipperLib::ctDifference, ClipperUtils::PolygonsProvider(subject), ClipperUtils::PolygonsProvider(clip), do_safety_offset); }
+Slic3r::ExPolygons diff_ex_indexed(const Slic3r::ExPolygon &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset)
+    { return _clipper_ex_indexed(ClipperLib::ctDifference, ClipperUtils::ExPolygonProvider(subject), ClipperUtils::PolygonsProvider(clip), do_safety_offset); }
+Slic3r::ExPolygons diff_ex_indexed(const Slic3r::ExPolygon &subject, const Slic3r::ExPolygons &clip, ApplySafetyOffset do_safety_offset)
+    { return _clipper_ex_indexed(ClipperLib::ctDifference, ClipperUtils::ExPolygonProvider(subject), ClipperUtils::ExPolygonsProvider(clip), do_safety_offset); }
+Slic3r::ExPolygons diff_ex_indexed(const Slic3r::ExPolygons &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset)
+    { return _clipper_ex_indexed(ClipperLib::ctDifference, ClipperUtils::ExPolygonsProvider(subject), ClipperUtils::PolygonsProvider(clip), do_safety_offset); }
+Slic3r::ExPolygons diff_ex_indexed(const Slic3r::ExPolygons &subject, const Slic3r::ExPolygons &clip, ApplySafetyOffset do_safety_offset)
+    { return _clipper_ex_indexed(ClipperLib::ctDifference, ClipperUtils::ExPolygonsProvider(subject), ClipperUtils::ExPolygonsProvider(clip), do_safety_offset); }
+Slic3r::Polylines diff_pl_indexed(const Slic3r::Polylines &subject, const Slic3r::Polygons &clip)
+    { return _clipper_pl_open_indexed(ClipperLib::ctDifference, ClipperUtils::PolylinesProvider(subject), ClipperUtils::PolygonsProvider(clip)); }
+Slic3r::Polylines diff_pl_indexed(const Slic3r::Polylines &subject, const Slic3r::ExPolygons &clip)
+    { return _clipper_pl_open_indexed(ClipperLib::ctDifference, ClipperUtils::PolylinesProvider(subject), ClipperUtils::ExPolygonsProvider(clip)); }
+Slic3r::Polygons intersection_indexed(const Slic3r::Polygons &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset)
+    { return _clipper_indexed(ClipperLib::ctIntersection, ClipperUtils::PolygonsProvider(subject), ClipperUtils::PolygonsProvider(clip), do_safety_offset); }
+Slic3r::ExPolygons intersection_ex_indexed(const Slic3r::ExPolygon &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset)
+    { return _clipper_ex_indexed(ClipperLib::ctIntersection, ClipperUtils::ExPolygonProvider(subject), ClipperUtils::PolygonsProvider(clip), do_safety_offset); }
+Slic3r::ExPolygons intersection_ex_indexed(const Slic3r::ExPolygon &subject, const Slic3r::ExPolygons &clip, ApplySafetyOffset do_safety_offset)
+    { return _clipper_ex_indexed(ClipperLib::ctIntersection, ClipperUtils::ExPolygonProvider(subject), ClipperUtils::ExPolygonsProvider(clip), do_safety_offset); }
+Slic3r::ExPolygons intersection_ex_indexed(const Slic3r::ExPolygons &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset)
+    { return _clipper_ex_indexed(ClipperLib::ctIntersection, ClipperUtils::ExPolygonsProvider(subject), ClipperUtils::PolygonsProvider(clip), do_safety_offset); }
+Slic3r::ExPolygons intersection_ex_indexed(const Slic3r::ExPolygons &subject, const Slic3r::ExPolygons &clip, ApplySafetyOffset do_safety_offset)
+    { return _clipper_ex_indexed(ClipperLib::ctIntersection, ClipperUtils::ExPolygonsProvider(subject), ClipperUtils::ExPolygonsProvider(clip), do_safety_offset); }
+Slic3r::Polylines intersection_pl_indexed(const Slic3r::Polylines &subject, const Slic3r::Polygons &clip)
+    { return _clipper_pl_open_indexed(ClipperLib::ctIntersection, ClipperUtils::PolylinesProvider(subject), ClipperUtils::PolygonsProvider(clip)); }
+Slic3r::Polylines intersection_pl_indexed(const Slic3r::Polylines &subject, const Slic3r::ExPolygons &clip)
+    { return _clipper_pl_open_indexed(ClipperLib::ctIntersection, ClipperUtils::PolylinesProvider(subject), ClipperUtils::ExPolygonsProvider(clip)); }
+
 Lines _clipper_ln(ClipperLib::ClipType clipType, const Lines &subject, const Polygons &clip)
 {
     // convert Lines to Polylines
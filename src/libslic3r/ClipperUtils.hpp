@@ -48,6 +48,20 @@ enum class ApplySafetyOffset {
     Yes
 };
 
+// Polygon clipping library performing the offsets and booleans of the functions below.
+// Functions exposing ClipperLib types in their interface (union_pt(), variable_offset_*() etc.) always use ClipperLib.
+enum class ClipperBackend {
+    // Legacy Clipper 6.4 fork (clipper.hpp).
+    ClipperLib,
+    // Clipper2Lib, see Clipper2Utils.hpp.
+    Clipper2
+};
+
+// Backend used by all threads. The initial value is ClipperLib, or Clipper2 if libslic3r was compiled with SLIC3R_CLIPPER2_BACKEND.
+// The initial value may be overridden by the SLIC3R_CLIPPER_BACKEND environment variable set to "clipperlib" or "clipper2".
+ClipperBackend clipper_backend();
+void           set_clipper_backend(ClipperBackend backend);
+
 namespace ClipperUtils {
     class PathsProviderIteratorBase {
     public:
@@ -134,6 +148,33 @@ namespace ClipperUtils {
         const std::vector<PathType> &m_paths;
     };
 
+    // Paths referenced by pointers, for example a subset of the paths of another provider.
+    class PathsPtrProvider {
+    public:
+        PathsPtrProvider(const std::vector<const Points*> &paths) : m_paths(paths) {}
+
+        struct iterator : public PathsProviderIteratorBase {
+        public:
+            explicit iterator(std::vector<const Points*>::const_iterator it) : m_it(it) {}
+            const Points& operator*() const { return **m_it; }
+            bool operator==(const iterator &rhs) const { return m_it == rhs.m_it; }
+            bool operator!=(const iterator &rhs) const { return !(*this == rhs); }
+            const Points& operator++(int) { return **(m_it ++); }
+            iterator& operator++() { ++ m_it; return *this; }
+        private:
+            std::vector<const Points*>::const_iterator m_it;
+        };
+
+        iterator cbegin() const { return iterator(m_paths.begin()); }
+        iterator begin()  const { return this->cbegin(); }
+        iterator cend()   const { return iterator(m_paths.end()); }
+        iterator end()    const { return this->cend(); }
+        size_t   size()   const { return m_paths.size(); }
+
+    private:
+        const std::vector<const Points*> &m_paths;
+    };
+
     template<typename MultiPointType>
     class MultiPointsProvider {
     public:
@@ -395,6 +436,7 @@ inline Slic3r::ExPolygons shrink_ex(const Slic3r::ExPolygons &polygons, const fl
 // Input polygons for negative offset shall be "normalized": There must be no overlap / intersections between the input polygons.
 Slic3r::Polygons   offset2(const Slic3r::ExPolygons &expolygons, const float delta1, const float delta2, ClipperLib::JoinType joinType = DefaultJoinType, double miterLimit = DefaultMiterLimit);
 Slic3r::ExPolygons offset2_ex(const Slic3r::ExPolygons &expolygons, const float delta1, const float delta2, ClipperLib::JoinType joinType = DefaultJoinType, double miterLimit = DefaultMiterLimit);
+Slic3r::ExPolygons offset2_ex(const Slic3r::ExPolygon &expolygon, const float delta1, const float delta2, ClipperLib::JoinType joinType = DefaultJoinType, double miterLimit = DefaultMiterLimit);
 Slic3r::ExPolygons offset2_ex(const Slic3r::Surfaces &surfaces, const float delta1, const float delta2, ClipperLib::JoinType joinType = DefaultJoinType, double miterLimit = DefaultMiterLimit);
 
 // BBS
@@ -533,6 +575,26 @@ Slic3r::Polylines  intersection_pl(const Slic3r::Polylines &subject, const Slic3
 Slic3r::Polylines  intersection_pl(const Slic3r::Polylines &subject, const Slic3r::ExPolygons &clip);
 Slic3r::Polylines  intersection_pl(const Slic3r::Polygons &subject, const Slic3r::Polygons &clip);
 
+// Index accelerated diff / intersection: Only the clipping paths with bounding boxes overlapping a bounding box of some subject path
+// are passed to Clipper, the bounding boxes of the subject paths are indexed by an AABB tree if there are many of them.
+// Contrary to the "clipped" variants, the clipping paths are not modified and the result is the same as of the plain operation.
+// Falls back to the plain operation if all the clipping paths may interact with the subject.
+// To be used if a small subject, for example a single island, is clipped with polygons covering the whole layer.
+Slic3r::Polygons   diff_indexed(const Slic3r::Polygons &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+Slic3r::ExPolygons diff_ex_indexed(const Slic3r::ExPolygon &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+Slic3r::ExPolygons diff_ex_indexed(const Slic3r::ExPolygon &subject, const Slic3r::ExPolygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+Slic3r::ExPolygons diff_ex_indexed(const Slic3r::ExPolygons &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+Slic3r::ExPolygons diff_ex_indexed(const Slic3r::ExPolygons &subject, const Slic3r::ExPolygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+Slic3r::Polylines  diff_pl_indexed(const Slic3r::Polylines &subject, const Slic3r::Polygons &clip);
+Slic3r::Polylines  diff_pl_indexed(const Slic3r::Polylines &subject, const Slic3r::ExPolygons &clip);
+Slic3r::Polygons   intersection_indexed(const Slic3r::Polygons &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+Slic3r::ExPolygons intersection_ex_indexed(const Slic3r::ExPolygon &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+Slic3r::ExPolygons intersection_ex_indexed(const Slic3r::ExPolygon &subject, const Slic3r::ExPolygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+Slic3r::ExPolygons intersection_ex_indexed(const Slic3r::ExPolygons &subject, const Slic3r::Polygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+Slic3r::ExPolygons intersection_ex_indexed(const Slic3r::ExPolygons &subject, const Slic3r::ExPolygons &clip, ApplySafetyOffset do_safety_offset = ApplySafetyOffset::No);
+Slic3r::Polylines  intersection_pl_indexed(const Slic3r::Polylines &subject, const Slic3r::Polygons &clip);
+Slic3r::Polylines  intersection_pl_indexed(const Slic3r::Polylines &subject, const Slic3r::ExPolygons &clip);
+
 inline Slic3r::Lines intersection_ln(const Slic3r::Lines &subject, const Slic3r::Polygons &clip)
 {
     return _clipper_ln(ClipperLib::ctIntersection, subject, clip);
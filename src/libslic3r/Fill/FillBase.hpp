@@ -23,6 +23,7 @@
 namespace Slic3r {
 
 class Surface;
+class FillCache;
 enum InfillPattern : int;
 
 namespace FillAdaptive {
@@ -128,6 +129,8 @@ public:
 
     // Octree builds on mesh for usage in the adaptive cubic infill
     FillAdaptive::Octree* adapt_fill_octree = nullptr;
+    // Caches of the pattern generators shared by the layers of an object, no caching if null.
+    FillCache*  fill_cache = nullptr;
 
     // BBS: all no overlap expolygons in same layer
     ExPolygons  no_overlap_expolygons;
@@ -171,6 +174,7 @@ public:
         loop_clipping         = f->loop_clipping;
         bounding_box          = f->bounding_box;
         adapt_fill_octree     = f->adapt_fill_octree;
+        fill_cache            = f->fill_cache;
         no_overlap_expolygons = f->no_overlap_expolygons;
     };
 
@@ -0,0 +1,124 @@
+#include "FillCache.hpp"
+#include "FillBase.hpp"
+
+namespace Slic3r {
+
+static size_t points_memsize(const Points &points)
+{
+    return sizeof(Points) + points.capacity() * sizeof(Point);
+}
+
+static size_t polygons_memsize(const Polygons &polygons)
+{
+    size_t out = polygons.capacity() * sizeof(Polygon);
+    for (const Polygon &polygon : polygons)
+        out += points_memsize(polygon.points);
+    return out;
+}
+
+static size_t entry_memsize(const FillLinesCache::Key &key, const FillLinesCache::Lines &lines)
+{
+    size_t out = sizeof(FillLinesCache::Key) + sizeof(FillLinesCache::Lines) + points_memsize(key.expolygon.contour.points) +
+                 polygons_memsize(key.expolygon.holes) + key.sweeps.capacity() * sizeof(std::pair<float, float>) +
+                 polygons_memsize(lines.polygons_outer) + lines.fill_lines.capacity() * sizeof(Polyline);
+    for (const Polyline &polyline : lines.fill_lines)
+        out += points_memsize(polyline.points);
+    return out;
+}
+
+FillLinesCache::Key FillLinesCache::make_key(const ExPolygon &expolygon, double spacing, double overlap, const FillParams &params,
+                                             const std::pair<float, Point> &rotate_vector, std::vector<std::pair<float, float>> &&sweeps)
+{
+    Key key { expolygon, spacing, overlap, params.density, params.multiline, rotate_vector.first, rotate_vector.second, std::move(sweeps), 0 };
+    size_t hash = 0;
+    auto hash_combine = [&hash](size_t v) { hash ^= v + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2); };
+    hash_combine(std::hash<double>()(spacing));
+    hash_combine(std::hash<double>()(overlap));
+    hash_combine(std::hash<float>()(params.density));
+    hash_combine(std::hash<int>()(params.multiline));
+    hash_combine(std::hash<float>()(rotate_vector.first));
+    hash_combine(PointHash()(rotate_vector.second));
+    for (const std::pair<float, float> &sweep : key.sweeps) {
+        hash_combine(std::hash<float>()(sweep.first));
+        hash_combine(std::hash<float>()(sweep.second));
+    }
+    for (const Point &pt : expolygon.contour.points)
+        hash_combine(PointHash()(pt));
+    for (const Polygon &hole : expolygon.holes) {
+        hash_combine(hole.points.size());
+        for (const Point &pt : hole.points)
+            hash_combine(PointHash()(pt));
+    }
+    key.hash = hash;
+    return key;
+}
+
+std::shared_ptr<const FillLinesCache::Lines> FillLinesCache::find(const Key &key)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_lines.find(key);
+    return it == m_lines.end() ? nullptr : it->second;
+}
+
+void FillLinesCache::insert(Key &&key, std::shared_ptr<const Lines> lines)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto [it, inserted] = m_lines.emplace(std::move(key), std::move(lines));
+    if (inserted) {
+        size_t bytes = entry_memsize(it->first, *it->second);
+        m_order.push_back({ &it->first, bytes });
+        m_memsize += bytes;
+        // Keep at least the surface just inserted.
+        while (m_memsize > max_memsize && m_order.size() > 1) {
+            // Look the oldest entry up and erase it by the iterator, erasing by the key would pass a reference to the key being destroyed.
+            // The iterators are not stored in m_order, they are invalidated by rehashing.
+            m_memsize -= m_order.front().memsize;
+            m_lines.erase(m_lines.find(*m_order.front().key));
+            m_order.pop_front();
+        }
+    }
+}
+
+void FillLinesCache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_lines.clear();
+    m_order.clear();
+    m_memsize = 0;
+}
+
+std::shared_ptr<const GyroidWaveTemplate> GyroidWaveTemplateCache::get(const Key &key, const std::function<GyroidWaveTemplate()> &create)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (auto it = m_templates.find(key); it != m_templates.end())
+            return it->second;
+    }
+    // Evaluate outside of the lock, two threads may evaluate the same template, the first one wins.
+    auto wave_template = std::make_shared<const GyroidWaveTemplate>(create());
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto [it, inserted] = m_templates.emplace(key, std::move(wave_template));
+    if (inserted) {
+        size_t bytes = sizeof(GyroidWaveTemplate) + sizeof(Key) +
+            (it->second->one_period_odd.capacity() + it->second->one_period_even.capacity()) * sizeof(Vec2d);
+        m_order.emplace_back(key, bytes);
+        m_memsize += bytes;
+        // Keep at least the template just inserted.
+        while (m_memsize > max_memsize && m_order.size() > 1) {
+            m_memsize -= m_order.front().second;
+            m_templates.erase(m_order.front().first);
+            m_order.pop_front();
+        }
+    }
+    return it->second;
+}
+
+void GyroidWaveTemplateCache::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_templates.clear();
+    m_order.clear();
+    m_memsize = 0;
+}
+
+} // namespace Slic3r
@@ -0,0 +1,126 @@
+#ifndef slic3r_FillCache_hpp_
+#define slic3r_FillCache_hpp_
+
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+#include "../ExPolygon.hpp"
+#include "../Polyline.hpp"
+
+namespace Slic3r {
+
+struct FillParams;
+
+// Infill lines of the sparse multi-line patterns (grid, triangles, stars, 2D lattice and multi-line rectilinear).
+// The sparse infill of most parts repeats the same surface over many layers, the lines of such a surface are generated once
+// and then just connected on every layer. The lines of a surface depend on the surface, on the fill spacing, overlap and density,
+// on the direction of the infill and on the sweeps of the pattern. The cache is bounded by the memory of the cached surfaces
+// and lines, the oldest surfaces are dropped first.
+class FillLinesCache
+{
+public:
+    struct Key
+    {
+        ExPolygon                            expolygon;
+        double                               spacing;
+        double                               overlap;
+        float                                density;
+        int                                  multiline;
+        float                                angle;
+        Point                                refpt;
+        std::vector<std::pair<float, float>> sweeps;
+        size_t                               hash { 0 };
+
+        bool operator==(const Key &rhs) const {
+            return hash == rhs.hash && spacing == rhs.spacing && overlap == rhs.overlap && density == rhs.density && multiline == rhs.multiline &&
+                   angle == rhs.angle && refpt == rhs.refpt && sweeps == rhs.sweeps && expolygon == rhs.expolygon;
+        }
+    };
+
+    struct KeyHash
+    {
+        size_t operator()(const Key &key) const { return key.hash; }
+    };
+
+    struct Lines
+    {
+        // Outer offset of the surface, along which the lines are connected.
+        Polygons  polygons_outer;
+        Polylines fill_lines;
+    };
+
+    static Key make_key(const ExPolygon &expolygon, double spacing, double overlap, const FillParams &params, const std::pair<float, Point> &rotate_vector,
+                        std::vector<std::pair<float, float>> &&sweeps);
+
+    std::shared_ptr<const Lines> find(const Key &key);
+    void                         insert(Key &&key, std::shared_ptr<const Lines> lines);
+    void                         clear();
+    // Memory held by the cached surfaces and lines.
+    size_t                       memsize() const { std::lock_guard<std::mutex> lock(m_mutex); return m_memsize; }
+
+private:
+    static constexpr size_t max_memsize = 64 * 1024 * 1024;
+
+    struct Entry {
+        const Key *key;
+        size_t     memsize;
+    };
+
+    mutable std::mutex                                             m_mutex;
+    std::unordered_map<Key, std::shared_ptr<const Lines>, KeyHash> m_lines;
+    // Keys of m_lines in the order of insertion. References to the keys of an unordered_map stay valid until the key is erased.
+    std::deque<Entry>                                              m_order;
+    size_t                                                         m_memsize { 0 };
+};
+
+// One period of the odd and of the even waves of a gyroid layer.
+struct GyroidWaveTemplate
+{
+    std::vector<Vec2d> one_period_odd;
+    std::vector<Vec2d> one_period_even;
+};
+
+// The wave templates only depend on the phase of the Z height within the period of the pattern, on the pattern scale, the tolerance
+// and on the area width if the area is narrower than a single period. They are shared by all the regions and islands of a layer and by all the layers at the same height,
+// thus they are cached. The cache is bounded by the memory of the templates, the oldest templates are dropped first.
+class GyroidWaveTemplateCache
+{
+public:
+    // Phase of the Z height in <0, 2 PI), scale, tolerance, width limit, vertical, flip.
+    using Key = std::tuple<double, double, double, double, bool, bool>;
+
+    std::shared_ptr<const GyroidWaveTemplate> get(const Key &key, const std::function<GyroidWaveTemplate()> &create);
+    void                                      clear();
+    // Memory held by the cached templates.
+    size_t                                    memsize() const { std::lock_guard<std::mutex> lock(m_mutex); return m_memsize; }
+
+private:
+    static constexpr size_t max_memsize = 16 * 1024 * 1024;
+
+    mutable std::mutex                                        m_mutex;
+    std::map<Key, std::shared_ptr<const GyroidWaveTemplate>>  m_templates;
+    std::deque<std::pair<Key, size_t>>                        m_order;
+    size_t                                                    m_memsize { 0 };
+};
+
+// Caches of the infill generators, owned by a PrintObject and shared by its layers, which are filled in parallel.
+// See Fill::fill_cache and PrintObject::infill().
+class FillCache
+{
+public:
+    FillLinesCache          lines;
+    GyroidWaveTemplateCache gyroid_wave_templates;
+
+    void   clear() { lines.clear(); gyroid_wave_templates.clear(); }
+    size_t memsize() const { return lines.memsize() + gyroid_wave_templates.memsize(); }
+};
+
+} // namespace Slic3r
+
+#endif // slic3r_FillCache_hpp_
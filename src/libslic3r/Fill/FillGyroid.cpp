@@ -5,6 +5,7 @@
 #include <algorithm>
 #include <iostream>
 
+#include "FillCache.hpp"
 #include "FillGyroid.hpp"
 
 namespace Slic3r {
@@ -29,9 +30,40 @@ static inline double f(double x, double z_sin, double z_cos, bool vertical, bool
     }
 }
 
-static inline Polyline make_wave(
-    const std::vector<Vec2d>& one_period, double width, double height, double offset, double scaleFactor,
-    double z_cos, double z_sin, bool vertical, bool flip)
+// Evaluate f() for a batch of sample points, y[i] = f(x[i]).
+// The branches are hoisted out of the loops, so that the loop bodies are straight line code the compiler may vectorize.
+// The expressions are those of f(), so that the results are bit identical.
+static void f_batch(const std::vector<double> &x, std::vector<double> &y, double z_sin, double z_cos, bool vertical, bool flip)
+{
+    y.resize(x.size());
+    const size_t n  = x.size();
+    const double *px = x.data();
+    double       *py = y.data();
+    if (vertical) {
+        const double phase_offset = (z_cos < 0 ? M_PI : 0) + M_PI;
+        const double res_offset   = flip ? M_PI : 0.;
+        const double b            = - z_cos;
+        for (size_t i = 0; i < n; ++ i) {
+            const double a   = sin(px[i] + phase_offset);
+            const double res = z_sin * cos(px[i] + phase_offset + res_offset);
+            const double r   = sqrt(sqr(a) + sqr(b));
+            py[i] = asin(a/r) + asin(res/r) + M_PI;
+        }
+    } else {
+        const double phase_offset = z_sin < 0 ? M_PI : 0.;
+        const double res_offset   = flip ? 0 : M_PI;
+        const double b            = - z_sin;
+        for (size_t i = 0; i < n; ++ i) {
+            const double a   = cos(px[i] + phase_offset);
+            const double res = z_cos * sin(px[i] + phase_offset + res_offset);
+            const double r   = sqrt(sqr(a) + sqr(b));
+            py[i] = (asin(a/r) + asin(res/r) + 0.5 * M_PI);
+        }
+    }
+}
+
+// Repeat one period of the wave up to the width of the area to be filled.
+static std::vector<Vec2d> extend_wave(const std::vector<Vec2d>& one_period, double width, double z_cos, double z_sin, bool vertical, bool flip)
 {
     std::vector<Vec2d> points = one_period;
     double period = points.back()(0);
@@ -47,11 +79,15 @@ static inline Polyline make_wave(
 
         points.emplace_back(Vec2d(width, f(width, z_sin, z_cos, vertical, flip)));
     }
+    return points;
+}
 
-    // and construct the final polyline to return:
+static inline Polyline make_wave(const std::vector<Vec2d>& wave, double height, double offset, double scaleFactor, bool vertical)
+{
+    // construct the final polyline to return:
     Polyline polyline;
-    polyline.points.reserve(points.size());
-    for (auto& point : points) {
+    polyline.points.reserve(wave.size());
+    for (Vec2d point : wave) {
         point(1) += offset;
         point(1) = std::clamp(double(point.y()), 0., height);
         if (vertical)
@@ -75,15 +111,20 @@ static std::vector<Vec2d> make_one_period(double width, double scaleFactor, doub
     points.emplace_back(Vec2d(limit, f(limit, z_sin, z_cos, vertical, flip)));
 
     // piecewise increase in resolution up to requested tolerance
+    std::vector<double> mid_x;
+    std::vector<double> mid_y;
     for(;;)
     {
+        // evaluate the midpoints of all the segments at once
         size_t size = points.size();
-        for (unsigned int i = 1;i < size; ++i) {
-            auto& lp = points[i-1]; // left point
-            auto& rp = points[i];   // right point
-            double x = lp(0) + (rp(0) - lp(0)) / 2;
-            double y = f(x, z_sin, z_cos, vertical, flip);
-            Vec2d ip = {x, y};
+        mid_x.clear();
+        for (size_t i = 1; i < size; ++ i)
+            mid_x.emplace_back(points[i-1](0) + (points[i](0) - points[i-1](0)) / 2);
+        f_batch(mid_x, mid_y, z_sin, z_cos, vertical, flip);
+        for (size_t i = 1; i < size; ++ i) {
+            const Vec2d &lp = points[i-1]; // left point
+            const Vec2d &rp = points[i];   // right point
+            Vec2d ip = {mid_x[i-1], mid_y[i-1]};
             if (std::abs(cross2(Vec2d(ip - lp), Vec2d(ip - rp))) > sqr(tolerance)) {
                 points.emplace_back(std::move(ip));
             }
@@ -102,7 +143,7 @@ static std::vector<Vec2d> make_one_period(double width, double scaleFactor, doub
     return points;
 }
 
-static Polylines make_gyroid_waves(double gridZ, double density_adjusted, double line_spacing, double width, double height)
+static Polylines make_gyroid_waves(double gridZ, double density_adjusted, double line_spacing, double width, double height, FillCache *fill_cache)
 {
     const double scaleFactor = scale_(line_spacing) / density_adjusted;
 
@@ -112,7 +153,11 @@ static Polylines make_gyroid_waves(double gridZ, double density_adjusted, double
 
     //scale factor for 5% : 8 712 388
     // 1z = 10^-6 mm ?
-    const double z     = gridZ / scaleFactor;
+    // The waves are periodic in Z, the height is reduced to a single period, so that the wave templates are shared by the layers
+    // at the same phase of the pattern.
+    double z = std::fmod(gridZ / scaleFactor, 2. * M_PI);
+    if (z < 0.)
+        z += 2. * M_PI;
     const double z_sin = sin(z);
     const double z_cos = cos(z);
 
@@ -127,18 +172,31 @@ static Polylines make_gyroid_waves(double gridZ, double density_adjusted, double
         std::swap(width,height);
     }
 
-    std::vector<Vec2d> one_period_odd = make_one_period(width, scaleFactor, z_cos, z_sin, vertical, flip, tolerance); // creates one period of the waves, so it doesn't have to be recalculated all the time
-    flip = !flip;                                                                   // even polylines are a bit shifted
-    std::vector<Vec2d> one_period_even = make_one_period(width, scaleFactor, z_cos, z_sin, vertical, flip, tolerance);
+    // creates one period of the waves, so it doesn't have to be recalculated all the time
+    const double limit = std::min(2*M_PI, width);
+    auto make_template = [&]() {
+        GyroidWaveTemplate out;
+        out.one_period_odd  = make_one_period(width, scaleFactor, z_cos, z_sin, vertical, flip, tolerance);
+        // even polylines are a bit shifted
+        out.one_period_even = make_one_period(width, scaleFactor, z_cos, z_sin, vertical, !flip, tolerance);
+        return out;
+    };
+    std::shared_ptr<const GyroidWaveTemplate> wave_template = fill_cache ?
+        fill_cache->gyroid_wave_templates.get(GyroidWaveTemplateCache::Key{ z, scaleFactor, tolerance, limit, vertical, flip }, make_template) :
+        std::make_shared<const GyroidWaveTemplate>(make_template());
+    flip = !flip;
+    // The odd and even waves differ just by the vertical offset, thus they are extended to the full width just once.
+    const std::vector<Vec2d> wave_odd  = extend_wave(wave_template->one_period_odd, width, z_cos, z_sin, vertical, flip);
+    const std::vector<Vec2d> wave_even = extend_wave(wave_template->one_period_even, width, z_cos, z_sin, vertical, flip);
     Polylines result;
 
     for (double y0 = lower_bound; y0 < upper_bound + EPSILON; y0 += M_PI) {
         // creates odd polylines
-        result.emplace_back(make_wave(one_period_odd, width, height, y0, scaleFactor, z_cos, z_sin, vertical, flip));
+        result.emplace_back(make_wave(wave_odd, height, y0, scaleFactor, vertical));
         // creates even polylines
         y0 += M_PI;
         if (y0 < upper_bound + EPSILON) {
-            result.emplace_back(make_wave(one_period_even, width, height, y0, scaleFactor, z_cos, z_sin, vertical, flip));
+            result.emplace_back(make_wave(wave_even, height, y0, scaleFactor, vertical));
         }
     }
 
@@ -174,7 +232,8 @@ void FillGyroid::_fill_surface_single(
         density_adjusted,
         this->spacing,
         ceil(bb.size()(0) / distance) + 1.,
-        ceil(bb.size()(1) / distance) + 1.);
+        ceil(bb.size()(1) / distance) + 1.,
+        this->fill_cache);
 
 	// shift the polyline to the grid origin
 	for (Polyline &pl : polylines)
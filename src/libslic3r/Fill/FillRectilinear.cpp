@@ -18,6 +18,7 @@
 #include "../ShortestPath.hpp"
 #include "../VariableWidth.hpp"
 
+#include "FillCache.hpp"
 #include "FillRectilinear.hpp"
 
 // #define SLIC3R_DEBUG
@@ -3037,36 +3038,50 @@ bool FillRectilinear::fill_surface_by_multilines(const Surface *surface, FillPar
     int n_multilines = params.multiline;
     assert(params.density > 0.0001f && params.density <= 1.f);
 
-    ExPolygonWithOffset poly_with_offset_base(surface->expolygon, 0, float(scale_(this->overlap - 0.5 * this->spacing)));
-    if (poly_with_offset_base.n_contours == 0)
-        // Not a single infill line fits.
-        return true;
-
-    Polylines fill_lines;
-    coord_t line_width   = coord_t(scale_(this->spacing));
-    coord_t line_spacing = coord_t(scale_(this->spacing) * params.multiline / params.density);
     std::pair<float, Point> rotate_vector = this->_infill_direction(surface);
-    for (const SweepParams &sweep : sweep_params) {
-        // Rotate polygons so that we can work with vertical lines here
-        float angle = rotate_vector.first + sweep.angle_base;
-        //Fill Multiline
-        for (int i = 0; i < n_multilines; ++i) {
-            coord_t group_offset = i * line_spacing;
-            coord_t internal_offset = (i - (n_multilines - 1) / 2.0f) * line_width;
-            coord_t total_offset  = group_offset + internal_offset;
-            coord_t pattern_shift = scale_(sweep.pattern_shift + unscale_(total_offset));
-
-            make_fill_lines(ExPolygonWithOffset(poly_with_offset_base, -angle), rotate_vector.second.rotated(-angle), angle,
-                            line_width + coord_t(SCALED_EPSILON), line_spacing, pattern_shift, fill_lines);
+    std::vector<std::pair<float, float>> sweeps;
+    for (const SweepParams &sweep : sweep_params)
+        sweeps.emplace_back(sweep.angle_base, sweep.pattern_shift);
+    FillLinesCache::Key cache_key = FillLinesCache::make_key(surface->expolygon, this->spacing, this->overlap, params, rotate_vector, std::move(sweeps));
+
+    // Same surface with the same pattern as on another layer: the lines are just connected.
+    std::shared_ptr<const FillLinesCache::Lines> lines = this->fill_cache ? this->fill_cache->lines.find(cache_key) : nullptr;
+    if (! lines) {
+        auto new_lines = std::make_shared<FillLinesCache::Lines>();
+        ExPolygonWithOffset poly_with_offset_base(surface->expolygon, 0, float(scale_(this->overlap - 0.5 * this->spacing)));
+        // Not a single infill line fits, if there is no contour.
+        if (poly_with_offset_base.n_contours > 0) {
+            Polylines &fill_lines   = new_lines->fill_lines;
+            coord_t    line_width   = coord_t(scale_(this->spacing));
+            coord_t    line_spacing = coord_t(scale_(this->spacing) * params.multiline / params.density);
+            for (const SweepParams &sweep : sweep_params) {
+                // Rotate polygons so that we can work with vertical lines here
+                float angle = rotate_vector.first + sweep.angle_base;
+                //Fill Multiline
+                for (int i = 0; i < n_multilines; ++i) {
+                    coord_t group_offset = i * line_spacing;
+                    coord_t internal_offset = (i - (n_multilines - 1) / 2.0f) * line_width;
+                    coord_t total_offset  = group_offset + internal_offset;
+                    coord_t pattern_shift = scale_(sweep.pattern_shift + unscale_(total_offset));
+
+                    make_fill_lines(ExPolygonWithOffset(poly_with_offset_base, -angle), rotate_vector.second.rotated(-angle), angle,
+                                    line_width + coord_t(SCALED_EPSILON), line_spacing, pattern_shift, fill_lines);
+                }
+            }
+            new_lines->polygons_outer = std::move(poly_with_offset_base.polygons_outer);
         }
+        lines = new_lines;
+        if (this->fill_cache)
+            this->fill_cache->lines.insert(std::move(cache_key), lines);
     }
 
+    Polylines fill_lines = lines->fill_lines;
     if (params.dont_connect() || fill_lines.size() <= 1) {
         if (fill_lines.size() > 1)
             fill_lines = chain_polylines(std::move(fill_lines));
         append(polylines_out, std::move(fill_lines));
     } else
-        connect_infill(std::move(fill_lines), poly_with_offset_base.polygons_outer, get_extents(surface->expolygon.contour), polylines_out, this->spacing, params);
+        connect_infill(std::move(fill_lines), lines->polygons_outer, get_extents(surface->expolygon.contour), polylines_out, this->spacing, params);
 
     return true;
 }
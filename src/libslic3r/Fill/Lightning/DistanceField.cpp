@@ -36,14 +36,15 @@ void export_distance_field_to_svg(const std::string &path, const Polygons &outli
 }
 #endif
 
-DistanceField::DistanceField(const coord_t& radius, const Polygons& current_outline, const BoundingBox& current_outlines_bbox, const Polygons& current_overhang) :
+DistanceField::DistanceField(const coord_t& radius, const Polygons& current_outline, const BoundingBox& current_outlines_bbox, const Polygons& current_overhang, const BoundingBox& current_overhang_bbox) :
     m_cell_size(radius / radius_per_cell_size),
     m_supporting_radius(radius),
     m_unsupported_points_bbox(current_outlines_bbox)
 {
     m_supporting_radius2 = Slic3r::sqr(int64_t(radius));
     // Sample source polygons with a regular grid sampling pattern.
-    const BoundingBox overhang_bbox = get_extents(current_overhang);
+    // The grid is aligned to the overhang of the whole layer, so that the islands of a layer sample the same grid.
+    const BoundingBox &overhang_bbox = current_overhang_bbox;
     // remove dangling lines which causes sample_grid_pattern crash (fails the OUTER_LOW assertions)
     ExPolygons expolys = offset2_ex_2(union_ex_2(current_overhang), -m_cell_size / 2, m_cell_size / 2);
     for (const ExPolygon &expoly : expolys) {
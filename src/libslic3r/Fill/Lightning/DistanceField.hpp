@@ -31,8 +31,9 @@ public:
      * \param current_outline The total infill area on this layer.
      * \param current_overhang The overhang that needs to be supported on this
      * layer.
+     * \param current_overhang_bbox The bounding box the sampling grid is aligned to.
      */
-    DistanceField(const coord_t& radius, const Polygons& current_outline, const BoundingBox& current_outlines_bbox, const Polygons& current_overhang);
+    DistanceField(const coord_t& radius, const Polygons& current_outline, const BoundingBox& current_outlines_bbox, const Polygons& current_overhang, const BoundingBox& current_overhang_bbox);
     
     /*!
      * Gets the next unsupported location to be supported by a new branch.
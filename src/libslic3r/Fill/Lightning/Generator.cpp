@@ -10,6 +10,8 @@
 
 #include "ExPolygon.hpp"
 
+#include <tbb/parallel_for.h>
+
 /* Possible future tasks/optimizations,etc.:
  * - Improve connecting heuristic to favor connecting to shorter trees
  * - Change which node of a tree is the root when that would be better in reconnectRoots.
@@ -125,8 +127,8 @@ Generator::Generator(PrintObject* m_object, std::vector<Polygons>& contours, std
     //for (size_t i = 0; i < overhangs.size(); i++)
     //{
     //    auto svg = draw_two_overhangs_to_svg(i, to_expolygons(contours[i]), to_expolygons(overhangs[i]));
-    //    for (auto& root : m_lightning_layers[i].tree_roots)
-    //        root->draw_tree(svg);
+    //    for (NodeIdx root : m_lightning_layers[i].tree_roots)
+    //        m_lightning_layers[i].nodes[root].draw_tree(m_lightning_layers[i].nodes, svg);
     //}
 }
 
@@ -160,8 +162,6 @@ const Layer& Generator::getTreesForLayer(const size_t& layer_id) const
 
 void Generator::generateTrees(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback)
 {
-    m_lightning_layers.resize(print_object.layers().size());
-    bboxs.resize(print_object.layers().size());
     std::vector<Polygons> infill_outlines(print_object.layers().size(), Polygons());
 
     // For-each layer from top to bottom:
@@ -173,92 +173,127 @@ void Generator::generateTrees(const PrintObject &print_object, const std::functi
                     append(infill_outlines[layer_id], to_polygons(surface.expolygon));
     }
 
-    // For various operations its beneficial to quickly locate nearby features on the polygon:
-    const size_t top_layer_id = print_object.layers().size() - 1;
-    EdgeGrid::Grid outlines_locator(get_extents(infill_outlines[top_layer_id]).inflated(SCALED_EPSILON));
-    outlines_locator.create(infill_outlines[top_layer_id], locator_cell_size);
-
-    // For-each layer from top to bottom:
-    for (int layer_id = int(top_layer_id); layer_id >= 0; layer_id--) {
-        throw_on_cancel_callback();
-        Layer             &current_lightning_layer = m_lightning_layers[layer_id];
-        const Polygons    &current_outlines        = infill_outlines[layer_id];
-        const BoundingBox &current_outlines_bbox   = get_extents(current_outlines);
-
-        bboxs[layer_id] = get_extents(current_outlines);
-
-        // register all trees propagated from the previous layer as to-be-reconnected
-        std::vector<NodeSPtr> to_be_reconnected_tree_roots = current_lightning_layer.tree_roots;
-
-        current_lightning_layer.generateNewTrees(m_overhang_per_layer[layer_id], current_outlines, current_outlines_bbox, outlines_locator, m_supporting_radius, m_wall_supporting_radius, throw_on_cancel_callback);
-        current_lightning_layer.reconnectRoots(to_be_reconnected_tree_roots, current_outlines, current_outlines_bbox, outlines_locator, m_supporting_radius, m_wall_supporting_radius);
-
-        // Initialize trees for next lower layer from the current one.
-        if (layer_id == 0)
-            return;
-
-        const Polygons &below_outlines      = infill_outlines[layer_id - 1];
-        BoundingBox     below_outlines_bbox = get_extents(below_outlines).inflated(SCALED_EPSILON);
-        if (const BoundingBox &outlines_locator_bbox = outlines_locator.bbox(); outlines_locator_bbox.defined)
-            below_outlines_bbox.merge(outlines_locator_bbox);
-
-        if (!current_lightning_layer.tree_roots.empty())
-            below_outlines_bbox.merge(get_extents(current_lightning_layer.tree_roots).inflated(SCALED_EPSILON));
+    generateTreesForOutlines(infill_outlines, throw_on_cancel_callback);
+}
 
-        outlines_locator.set_bbox(below_outlines_bbox);
-        outlines_locator.create(below_outlines, locator_cell_size);
+void Generator::generateTreesforSupport(std::vector<Polygons>& contours, const std::function<void()> &throw_on_cancel_callback)
+{
+    generateTreesForOutlines(contours, throw_on_cancel_callback);
+}
 
-        std::vector<NodeSPtr>& lower_trees = m_lightning_layers[layer_id - 1].tree_roots;
-        for (auto& tree : current_lightning_layer.tree_roots)
-            tree->propagateToNextLayer(lower_trees, below_outlines, outlines_locator, m_prune_length, m_straightening_max_distance, locator_cell_size / 2);
+// Index of the island the point belongs to: the island containing the point, otherwise the island with the closest bounding box.
+static size_t island_of_point(const ExPolygons &islands, const std::vector<BoundingBox> &islands_bboxes, const Point &pt)
+{
+    size_t  best_island = 0;
+    int64_t best_dist2  = std::numeric_limits<int64_t>::max();
+    for (size_t island_idx = 0; island_idx < islands.size(); ++ island_idx) {
+        const BoundingBox &bbox = islands_bboxes[island_idx];
+        const int64_t dx = pt.x() < bbox.min.x() ? int64_t(bbox.min.x() - pt.x()) : pt.x() > bbox.max.x() ? int64_t(pt.x() - bbox.max.x()) : 0;
+        const int64_t dy = pt.y() < bbox.min.y() ? int64_t(bbox.min.y() - pt.y()) : pt.y() > bbox.max.y() ? int64_t(pt.y() - bbox.max.y()) : 0;
+        const int64_t dist2 = dx * dx + dy * dy;
+        if (dist2 == 0 && islands[island_idx].contains(pt))
+            return island_idx;
+        if (dist2 < best_dist2) {
+            best_dist2  = dist2;
+            best_island = island_idx;
+        }
     }
+    return best_island;
 }
 
-void Generator::generateTreesforSupport(std::vector<Polygons>& contours, const std::function<void()> &throw_on_cancel_callback)
+void Generator::generateTreesForOutlines(const std::vector<Polygons> &infill_outlines, const std::function<void()> &throw_on_cancel_callback)
 {
-    if (contours.empty()) return;
+    if (infill_outlines.empty()) return;
 
-    m_lightning_layers.resize(contours.size());
-    bboxs.resize(contours.size());
+    m_lightning_layers.resize(infill_outlines.size());
+    bboxs.resize(infill_outlines.size());
 
     // For various operations its beneficial to quickly locate nearby features on the polygon:
-    const size_t top_layer_id = contours.size() - 1;
-    EdgeGrid::Grid outlines_locator(get_extents(contours[top_layer_id]).inflated(SCALED_EPSILON));
-    outlines_locator.create(contours[top_layer_id], locator_cell_size);
+    const size_t top_layer_id = infill_outlines.size() - 1;
+    EdgeGrid::Grid outlines_locator(get_extents(infill_outlines[top_layer_id]).inflated(SCALED_EPSILON));
+    outlines_locator.create(infill_outlines[top_layer_id], locator_cell_size);
 
     // For-each layer from top to bottom:
     for (int layer_id = int(top_layer_id); layer_id >= 0; layer_id--) {
-		throw_on_cancel_callback();
-        Layer& current_lightning_layer = m_lightning_layers[layer_id];
-        const Polygons& current_outlines = contours[layer_id];
-        const BoundingBox& current_outlines_bbox = get_extents(current_outlines);
-
-        bboxs[layer_id] = get_extents(current_outlines);
-
-        // register all trees propagated from the previous layer as to-be-reconnected
-        std::vector<NodeSPtr> to_be_reconnected_tree_roots = current_lightning_layer.tree_roots;
-
-        current_lightning_layer.generateNewTrees(m_overhang_per_layer[layer_id], current_outlines, current_outlines_bbox, outlines_locator, m_supporting_radius, m_wall_supporting_radius, throw_on_cancel_callback);
-        current_lightning_layer.reconnectRoots(to_be_reconnected_tree_roots, current_outlines, current_outlines_bbox, outlines_locator, m_supporting_radius, m_wall_supporting_radius);
+        throw_on_cancel_callback();
+        Layer             &current_lightning_layer = m_lightning_layers[layer_id];
+        const Polygons    &current_outlines        = infill_outlines[layer_id];
+        const Polygons    &current_overhang        = m_overhang_per_layer[layer_id];
+        const BoundingBox  current_outlines_bbox   = get_extents(current_outlines);
+        const BoundingBox  current_overhang_bbox   = get_extents(current_overhang);
+
+        bboxs[layer_id] = current_outlines_bbox;
+
+        // The trees of disjoint infill islands never connect to each other, thus the islands are grown in parallel.
+        // Each island gets its outline, its part of the overhang and the trees propagated onto it from the layer above.
+        ExPolygons islands = current_outlines.empty() ? ExPolygons() : union_ex(current_outlines);
+        if (islands.size() <= 1) {
+            // register all trees propagated from the previous layer as to-be-reconnected
+            std::vector<NodeIdx> to_be_reconnected_tree_roots = current_lightning_layer.tree_roots;
+
+            current_lightning_layer.generateNewTrees(current_lightning_layer.tree_roots, current_overhang, current_overhang_bbox, current_outlines, current_outlines_bbox, outlines_locator, m_supporting_radius, m_wall_supporting_radius, throw_on_cancel_callback);
+            current_lightning_layer.reconnectRoots(current_lightning_layer.tree_roots, to_be_reconnected_tree_roots, current_outlines, current_outlines_bbox, outlines_locator, m_supporting_radius, m_wall_supporting_radius);
+        } else {
+            std::vector<BoundingBox> islands_bboxes;
+            islands_bboxes.reserve(islands.size());
+            for (const ExPolygon &island : islands)
+                islands_bboxes.emplace_back(get_extents(island.contour));
+
+            std::vector<Polygons> islands_overhang(islands.size());
+            for (ExPolygon &overhang : union_ex(current_overhang)) {
+                const size_t island_idx = island_of_point(islands, islands_bboxes, overhang.contour.points.front());
+                append(islands_overhang[island_idx], to_polygons(std::move(overhang)));
+            }
+
+            std::vector<std::vector<NodeIdx>> islands_tree_roots(islands.size());
+            for (NodeIdx root : current_lightning_layer.tree_roots)
+                islands_tree_roots[island_of_point(islands, islands_bboxes, current_lightning_layer.nodes[root].getLocation())].emplace_back(root);
+
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, islands.size(), 1),
+                [&](const tbb::blocked_range<size_t> &range) {
+                for (size_t island_idx = range.begin(); island_idx < range.end(); ++ island_idx) {
+                    throw_on_cancel_callback();
+                    const Polygons        island_outlines = to_polygons(islands[island_idx]);
+                    std::vector<NodeIdx> &island_roots    = islands_tree_roots[island_idx];
+                    // register all trees propagated from the previous layer as to-be-reconnected
+                    const std::vector<NodeIdx> to_be_reconnected_tree_roots = island_roots;
+
+                    current_lightning_layer.generateNewTrees(island_roots, islands_overhang[island_idx], current_overhang_bbox, island_outlines, current_outlines_bbox, outlines_locator, m_supporting_radius, m_wall_supporting_radius, throw_on_cancel_callback);
+                    current_lightning_layer.reconnectRoots(island_roots, to_be_reconnected_tree_roots, island_outlines, current_outlines_bbox, outlines_locator, m_supporting_radius, m_wall_supporting_radius);
+                }
+            });
+
+            current_lightning_layer.tree_roots.clear();
+            for (const std::vector<NodeIdx> &island_roots : islands_tree_roots)
+                append(current_lightning_layer.tree_roots, island_roots);
+        }
 
         // Initialize trees for next lower layer from the current one.
         if (layer_id == 0)
             return;
 
-        const Polygons& below_outlines = contours[layer_id - 1];
+        const Polygons &below_outlines      = infill_outlines[layer_id - 1];
         BoundingBox     below_outlines_bbox = get_extents(below_outlines).inflated(SCALED_EPSILON);
-        if (const BoundingBox& outlines_locator_bbox = outlines_locator.bbox(); outlines_locator_bbox.defined)
+        if (const BoundingBox &outlines_locator_bbox = outlines_locator.bbox(); outlines_locator_bbox.defined)
             below_outlines_bbox.merge(outlines_locator_bbox);
 
         if (!current_lightning_layer.tree_roots.empty())
-            below_outlines_bbox.merge(get_extents(current_lightning_layer.tree_roots).inflated(SCALED_EPSILON));
+            below_outlines_bbox.merge(get_extents(current_lightning_layer.nodes, current_lightning_layer.tree_roots).inflated(SCALED_EPSILON));
 
         outlines_locator.set_bbox(below_outlines_bbox);
         outlines_locator.create(below_outlines, locator_cell_size);
 
-        std::vector<NodeSPtr>& lower_trees = m_lightning_layers[layer_id - 1].tree_roots;
-        for (auto& tree : current_lightning_layer.tree_roots)
-            tree->propagateToNextLayer(lower_trees, below_outlines, outlines_locator, m_prune_length, m_straightening_max_distance, locator_cell_size / 2);
+        // Each tree is copied to the layer below independently, the new roots are collected per tree to keep the order of the trees.
+        Layer                            &lower_layer = m_lightning_layers[layer_id - 1];
+        std::vector<std::vector<NodeIdx>> lower_trees_per_tree(current_lightning_layer.tree_roots.size());
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, current_lightning_layer.tree_roots.size()),
+            [this, &current_lightning_layer, &lower_layer, &lower_trees_per_tree, &below_outlines, &outlines_locator](const tbb::blocked_range<size_t> &range) {
+            for (size_t tree_idx = range.begin(); tree_idx < range.end(); ++ tree_idx)
+                current_lightning_layer.nodes[current_lightning_layer.tree_roots[tree_idx]].propagateToNextLayer(
+                    current_lightning_layer.nodes, lower_layer.nodes, lower_trees_per_tree[tree_idx], below_outlines, outlines_locator, m_prune_length, m_straightening_max_distance, locator_cell_size / 2);
+        });
+        for (const std::vector<NodeIdx> &lower_trees : lower_trees_per_tree)
+            append(lower_layer.tree_roots, lower_trees);
     }
 }
 
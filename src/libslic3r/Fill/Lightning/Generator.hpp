@@ -79,6 +79,11 @@ protected:
      */
     void generateTrees(const PrintObject &print_object, const std::function<void()> &throw_on_cancel_callback);
     void generateTreesforSupport(std::vector<Polygons>& contours, const std::function<void()> &throw_on_cancel_callback);
+    /*!
+     * Grow the trees layer by layer from the top, supporting the overhangs inside the given infill outlines.
+     * The disjoint islands of a layer are processed in parallel.
+     */
+    void generateTreesForOutlines(const std::vector<Polygons> &infill_outlines, const std::function<void()> &throw_on_cancel_callback);
 
     float m_infill_extrusion_width;
 
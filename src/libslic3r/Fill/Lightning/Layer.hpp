@@ -6,8 +6,8 @@
 
 #include "../../EdgeGrid.hpp"
 #include "../../Polygon.hpp"
+#include "TreeNode.hpp"
 
-#include <memory>
 #include <vector>
 #include <list>
 #include <unordered_map>
@@ -16,30 +16,37 @@
 namespace Slic3r::FillLightning
 {
 
-class Node;
-using NodeSPtr = std::shared_ptr<Node>;
-using SparseNodeGrid = std::unordered_multimap<Point, std::weak_ptr<Node>, PointHash>;
+using SparseNodeGrid = std::unordered_multimap<Point, NodeIdx, PointHash>;
 
 struct GroundingLocation
 {
-    NodeSPtr tree_node; //!< not null if the gounding location is on a tree
+    NodeIdx tree_node { InvalidNodeIdx }; //!< valid if the gounding location is on a tree
     std::optional<Point> boundary_location; //!< in case the gounding location is on the boundary
-    Point p() const;
+    Point p(const NodePool &nodes) const;
 };
 
 /*!
  * A layer of the lightning fill.
  *
  * Contains the trees to be printed and propagated to the next layer below.
+ * The trees of separate islands of a layer are grown independently of each other,
+ * so the methods growing the trees work on the roots of a single island passed as
+ * \p island_tree_roots, sharing the node pool of the layer.
  */
 class Layer
 {
 public:
-    std::vector<NodeSPtr> tree_roots;
+    NodePool             nodes;
+    std::vector<NodeIdx> tree_roots;
 
+    /*!
+     * \param current_overhang_bbox Bounding box of the overhangs of the whole layer, aligning the sampling of the unsupported points of all islands.
+     */
     void generateNewTrees
     (
+        std::vector<NodeIdx>& island_tree_roots,
         const Polygons& current_overhang,
+        const BoundingBox& current_overhang_bbox,
         const Polygons& current_outlines,
         const BoundingBox& current_outlines_bbox,
         const EdgeGrid::Grid& outline_locator,
@@ -60,7 +67,7 @@ public:
         coord_t supporting_radius,
         coord_t wall_supporting_radius,
         const SparseNodeGrid& tree_node_locator,
-        const NodeSPtr& exclude_tree = nullptr
+        NodeIdx exclude_tree = InvalidNodeIdx
     );
 
     /*!
@@ -68,11 +75,12 @@ public:
      * \param[out] new_root The new root node if one had been made
      * \return Whether a new root was added
      */
-    bool attach(const Point& unsupported_location, const GroundingLocation& ground, NodeSPtr& new_child, NodeSPtr& new_root);
+    bool attach(std::vector<NodeIdx>& island_tree_roots, const Point& unsupported_location, const GroundingLocation& ground, NodeIdx& new_child, NodeIdx& new_root);
 
     void reconnectRoots
     (
-        std::vector<NodeSPtr>& to_be_reconnected_tree_roots,
+        std::vector<NodeIdx>& island_tree_roots,
+        const std::vector<NodeIdx>& to_be_reconnected_tree_roots,
         const Polygons& current_outlines,
         const BoundingBox& current_outlines_bbox,
         const EdgeGrid::Grid& outline_locator,
@@ -84,7 +92,7 @@ public:
 
     coord_t getWeightedDistance(const Point& boundary_loc, const Point& unsupported_location);
 
-    void fillLocator(SparseNodeGrid& tree_node_locator, const BoundingBox& current_outlines_bbox);
+    void fillLocator(const std::vector<NodeIdx>& island_tree_roots, SparseNodeGrid& tree_node_locator, const BoundingBox& current_outlines_bbox) const;
 };
 
 } // namespace Slic3r::FillLightning
@@ -19,119 +19,131 @@ coord_t Node::getWeightedDistance(const Point& unsupported_location, const coord
     return dist_here - valence_boost;
 }
 
-bool Node::hasOffspring(const NodeSPtr& to_be_checked) const
+bool Node::hasOffspring(const NodePool& nodes, NodeIdx to_be_checked) const
 {
-    if (to_be_checked == shared_from_this())
+    if (to_be_checked == m_idx)
         return true;
 
-    for (auto& child_ptr : m_children)
-        if (child_ptr->hasOffspring(to_be_checked)) 
+    for (NodeIdx child_idx : m_children)
+        if (nodes[child_idx].hasOffspring(nodes, to_be_checked))
             return true;
 
     return false;
 }
 
-NodeSPtr Node::addChild(const Point& child_loc)
+NodeIdx Node::create(NodePool &nodes, const Point &p, const std::optional<Point> &last_grounding_location)
+{
+    auto it = nodes.emplace_back(InvalidNodeIdx, p, last_grounding_location);
+    it->m_idx = NodeIdx(it - nodes.begin());
+    return it->m_idx;
+}
+
+NodeIdx Node::addChild(NodePool &nodes, const Point& child_loc)
 {
     assert(m_p != child_loc);
-    NodeSPtr child = Node::create(child_loc);
-    return addChild(child);
+    NodeIdx child = Node::create(nodes, child_loc);
+    return addChild(nodes, child);
 }
 
-NodeSPtr Node::addChild(NodeSPtr& new_child)
+NodeIdx Node::addChild(NodePool &nodes, NodeIdx new_child)
 {
-    assert(new_child != shared_from_this());
+    assert(new_child != m_idx);
     //assert(p != new_child->p); // NOTE: No problem for now. Issue to solve later. Maybe even afetr final. Low prio.
     m_children.push_back(new_child);
-    new_child->m_parent = shared_from_this();
-    new_child->m_is_root = false;
+    nodes[new_child].m_parent  = m_idx;
+    nodes[new_child].m_is_root = false;
     return new_child;
 }
 
 void Node::propagateToNextLayer(
-    std::vector<NodeSPtr>& next_trees,
+    const NodePool& nodes,
+    NodePool& next_nodes,
+    std::vector<NodeIdx>& next_trees,
     const Polygons& next_outlines,
     const EdgeGrid::Grid& outline_locator,
     const coord_t prune_distance,
     const coord_t smooth_magnitude,
     const coord_t max_remove_colinear_dist) const
 {
-    auto tree_below = deepCopy();
-    tree_below->prune(prune_distance);
-    tree_below->straighten(smooth_magnitude, max_remove_colinear_dist);
-    if (tree_below->realign(next_outlines, outline_locator, next_trees))
+    NodeIdx tree_below = deepCopy(nodes, next_nodes);
+    next_nodes[tree_below].prune(next_nodes, prune_distance);
+    next_nodes[tree_below].straighten(next_nodes, smooth_magnitude, max_remove_colinear_dist);
+    if (next_nodes[tree_below].realign(next_nodes, next_outlines, outline_locator, next_trees))
         next_trees.push_back(tree_below);
 }
 
 // NOTE: Depth-first, as currently implemented.
 //       Skips the root (because that has no root itself), but all initial nodes will have the root point anyway.
-void Node::visitBranches(const std::function<void(const Point&, const Point&)>& visitor) const
+void Node::visitBranches(const NodePool& nodes, const std::function<void(const Point&, const Point&)>& visitor) const
 {
-    for (const auto& node : m_children) {
-        assert(node->m_parent.lock() == shared_from_this());
-        visitor(m_p, node->m_p);
-        node->visitBranches(visitor);
+    for (NodeIdx child_idx : m_children) {
+        const Node &node = nodes[child_idx];
+        assert(node.m_parent == m_idx);
+        visitor(m_p, node.m_p);
+        node.visitBranches(nodes, visitor);
     }
 }
 
 // NOTE: Depth-first, as currently implemented.
-void Node::visitNodes(const std::function<void(NodeSPtr)>& visitor)
+void Node::visitNodes(const NodePool& nodes, const std::function<void(const Node&)>& visitor) const
 {
-    visitor(shared_from_this());
-    for (const auto& node : m_children) {
-        assert(node->m_parent.lock() == shared_from_this());
-        node->visitNodes(visitor);
+    visitor(*this);
+    for (NodeIdx child_idx : m_children) {
+        const Node &node = nodes[child_idx];
+        assert(node.m_parent == m_idx);
+        node.visitNodes(nodes, visitor);
     }
 }
 
-Node::Node(const Point& p, const std::optional<Point>& last_grounding_location /*= std::nullopt*/) : 
-    m_is_root(true), m_p(p), m_last_grounding_location(last_grounding_location)
+Node::Node(NodeIdx idx, const Point& p, const std::optional<Point>& last_grounding_location) :
+    m_idx(idx), m_is_root(true), m_p(p), m_last_grounding_location(last_grounding_location)
 {}
 
-NodeSPtr Node::deepCopy() const
+NodeIdx Node::deepCopy(const NodePool& nodes, NodePool& dst_nodes) const
 {
-    NodeSPtr local_root = Node::create(m_p);
-    local_root->m_is_root = m_is_root;
+    NodeIdx local_root_idx = Node::create(dst_nodes, m_p);
+    Node   &local_root     = dst_nodes[local_root_idx];
+    local_root.m_is_root = m_is_root;
     if (m_is_root)
     {
-        local_root->m_last_grounding_location = m_last_grounding_location.value_or(m_p);
+        local_root.m_last_grounding_location = m_last_grounding_location.value_or(m_p);
     }
-    local_root->m_children.reserve(m_children.size());
-    for (const auto& node : m_children)
+    local_root.m_children.reserve(m_children.size());
+    for (NodeIdx child_idx : m_children)
     {
-        NodeSPtr child = node->deepCopy();
-        child->m_parent = local_root;
-        local_root->m_children.push_back(child);
+        NodeIdx child = nodes[child_idx].deepCopy(nodes, dst_nodes);
+        dst_nodes[child].m_parent = local_root_idx;
+        local_root.m_children.push_back(child);
     }
-    return local_root;
+    return local_root_idx;
 }
 
-void Node::reroot(const NodeSPtr &new_parent)
+void Node::reroot(NodePool &nodes, NodeIdx new_parent)
 {
     if (! m_is_root) {
-        auto old_parent = m_parent.lock();
-        old_parent->reroot(shared_from_this());
+        NodeIdx old_parent = m_parent;
+        nodes[old_parent].reroot(nodes, m_idx);
         m_children.push_back(old_parent);
     }
 
-    if (new_parent) {
+    if (new_parent != InvalidNodeIdx) {
         m_children.erase(std::remove(m_children.begin(), m_children.end(), new_parent), m_children.end());
         m_is_root = false;
         m_parent = new_parent;
     } else {
         m_is_root = true;
-        m_parent.reset();
+        m_parent = InvalidNodeIdx;
     }
 }
 
-NodeSPtr Node::closestNode(const Point& loc)
+NodeIdx Node::closestNode(const NodePool& nodes, const Point& loc) const
 {
-    NodeSPtr result = shared_from_this();
+    NodeIdx result = m_idx;
     auto closest_dist2 = coord_t((m_p - loc).cast<double>().norm());
 
-    for (const auto& child : m_children) {
-        NodeSPtr candidate_node = child->closestNode(loc);
-        const auto child_dist2 = coord_t((candidate_node->m_p - loc).cast<double>().norm());
+    for (NodeIdx child_idx : m_children) {
+        NodeIdx candidate_node = nodes[child_idx].closestNode(nodes, loc);
+        const auto child_dist2 = coord_t((nodes[candidate_node].m_p - loc).cast<double>().norm());
         if (child_dist2 < closest_dist2) {
             closest_dist2 = child_dist2;
             result = candidate_node;
@@ -187,7 +199,7 @@ bool lineSegmentPolygonsIntersection(const Point& a, const Point& b, const EdgeG
     return false;
 }
 
-bool Node::realign(const Polygons& outlines, const EdgeGrid::Grid& outline_locator, std::vector<NodeSPtr>& rerooted_parts)
+bool Node::realign(NodePool& nodes, const Polygons& outlines, const EdgeGrid::Grid& outline_locator, std::vector<NodeIdx>& rerooted_parts)
 {
     if (outlines.empty())
         return false;
@@ -196,14 +208,15 @@ bool Node::realign(const Polygons& outlines, const EdgeGrid::Grid& outline_locat
         // Only keep children that have an unbroken connection to here, realign will put the rest in rerooted parts due to recursion:
         Point coll;
         bool reground_me = false;
-        m_children.erase(std::remove_if(m_children.begin(), m_children.end(), [&](const NodeSPtr &child) {
-            bool connect_branch = child->realign(outlines, outline_locator, rerooted_parts);
+        m_children.erase(std::remove_if(m_children.begin(), m_children.end(), [&](NodeIdx child_idx) {
+            Node &child = nodes[child_idx];
+            bool connect_branch = child.realign(nodes, outlines, outline_locator, rerooted_parts);
             // Find an intersection of the line segment from p to child->p, at maximum outline_locator.resolution() * 2 distance from p.
-            if (connect_branch && lineSegmentPolygonsIntersection(child->m_p, m_p, outline_locator, coll, outline_locator.resolution() * 2)) {
-                child->m_last_grounding_location.reset();
-                child->m_parent.reset();
-                child->m_is_root = true;
-                rerooted_parts.push_back(child);
+            if (connect_branch && lineSegmentPolygonsIntersection(child.m_p, m_p, outline_locator, coll, outline_locator.resolution() * 2)) {
+                child.m_last_grounding_location.reset();
+                child.m_parent = InvalidNodeIdx;
+                child.m_is_root = true;
+                rerooted_parts.push_back(child_idx);
                 reground_me = true;
                 connect_branch = false;
             }
@@ -215,24 +228,27 @@ bool Node::realign(const Polygons& outlines, const EdgeGrid::Grid& outline_locat
     }
 
     // 'Lift' any decendants out of this tree:
-    for (auto& child : m_children)
-        if (child->realign(outlines, outline_locator, rerooted_parts)) {
-            child->m_last_grounding_location = m_p;
-            child->m_parent.reset();
-            child->m_is_root = true;
-            rerooted_parts.push_back(child);
+    for (NodeIdx child_idx : m_children) {
+        Node &child = nodes[child_idx];
+        if (child.realign(nodes, outlines, outline_locator, rerooted_parts)) {
+            child.m_last_grounding_location = m_p;
+            child.m_parent = InvalidNodeIdx;
+            child.m_is_root = true;
+            rerooted_parts.push_back(child_idx);
         }
+    }
 
     m_children.clear();
     return false;
 }
 
-void Node::straighten(const coord_t magnitude, const coord_t max_remove_colinear_dist)
+void Node::straighten(NodePool& nodes, const coord_t magnitude, const coord_t max_remove_colinear_dist)
 {
-    straighten(magnitude, m_p, 0, int64_t(max_remove_colinear_dist) * int64_t(max_remove_colinear_dist));
+    straighten(nodes, magnitude, m_p, 0, int64_t(max_remove_colinear_dist) * int64_t(max_remove_colinear_dist));
 }
 
 Node::RectilinearJunction Node::straighten(
+    NodePool& nodes,
     const coord_t magnitude,
     const Point& junction_above,
     const coord_t accumulated_dist,
@@ -244,9 +260,9 @@ Node::RectilinearJunction Node::straighten(
     const coord_t junction_magnitude = magnitude * junction_magnitude_factor_numerator / junction_magnitude_factor_denominator;
     if (m_children.size() == 1)
     {
-        auto child_p = m_children.front();
+        Node *child_p = &nodes[m_children.front()];
         auto child_dist = coord_t((m_p - child_p->m_p).cast<double>().norm());
-        RectilinearJunction junction_below = child_p->straighten(magnitude, junction_above, accumulated_dist + child_dist, max_remove_colinear_dist2);
+        RectilinearJunction junction_below = child_p->straighten(nodes, magnitude, junction_above, accumulated_dist + child_dist, max_remove_colinear_dist2);
         coord_t total_dist_to_junction_below = junction_below.total_recti_dist;
         const Point& a = junction_above;
         Point        b = junction_below.junction_loc;
@@ -262,18 +278,19 @@ Node::RectilinearJunction Node::straighten(
         { // remove nodes on linear segments
             constexpr coord_t close_enough = 10;
 
-            child_p = m_children.front(); //recursive call to straighten might have removed the child
-            const NodeSPtr& parent_node = m_parent.lock();
-            if (parent_node &&
-                (child_p->m_p - parent_node->m_p).cast<int64_t>().squaredNorm() < max_remove_colinear_dist2 &&
-                Line::distance_to_squared(m_p, parent_node->m_p, child_p->m_p) < close_enough * close_enough) {
-                child_p->m_parent = m_parent;
-                for (auto& sibling : parent_node->m_children)
-                { // find this node among siblings
-                    if (sibling == shared_from_this())
-                    {
-                        sibling = child_p; // replace this node by child
-                        break;
+            child_p = &nodes[m_children.front()]; //recursive call to straighten might have removed the child
+            if (m_parent != InvalidNodeIdx) {
+                Node &parent_node = nodes[m_parent];
+                if ((child_p->m_p - parent_node.m_p).cast<int64_t>().squaredNorm() < max_remove_colinear_dist2 &&
+                    Line::distance_to_squared(m_p, parent_node.m_p, child_p->m_p) < close_enough * close_enough) {
+                    child_p->m_parent = m_parent;
+                    for (NodeIdx& sibling : parent_node.m_children)
+                    { // find this node among siblings
+                        if (sibling == m_idx)
+                        {
+                            sibling = child_p->m_idx; // replace this node by child
+                            break;
+                        }
                     }
                 }
             }
@@ -285,10 +302,12 @@ Node::RectilinearJunction Node::straighten(
         constexpr coord_t weight = 1000;
         Point junction_moving_dir = ((junction_above - m_p).cast<double>().normalized() * weight).cast<coord_t>();
         bool prevent_junction_moving = false;
-        for (auto& child_p : m_children)
+        for (size_t i = 0; i < m_children.size(); ++ i)
         {
-            const auto child_dist = coord_t((m_p - child_p->m_p).cast<double>().norm());
-            RectilinearJunction below = child_p->straighten(magnitude, m_p, child_dist, max_remove_colinear_dist2);
+            // The child may replace itself in m_children by its own child while straightening.
+            Node &child_p = nodes[m_children[i]];
+            const auto child_dist = coord_t((m_p - child_p.m_p).cast<double>().norm());
+            RectilinearJunction below = child_p.straighten(nodes, magnitude, m_p, child_dist, max_remove_colinear_dist2);
 
             junction_moving_dir += ((below.junction_loc - m_p).cast<double>().normalized() * weight).cast<coord_t>();
             if (below.total_recti_dist < magnitude) // TODO: make configurable?
@@ -310,27 +329,27 @@ Node::RectilinearJunction Node::straighten(
 }
 
 // Prune the tree from the extremeties (leaf-nodes) until the pruning distance is reached.
-coord_t Node::prune(const coord_t& pruning_distance)
+coord_t Node::prune(NodePool& nodes, const coord_t& pruning_distance)
 {
     if (pruning_distance <= 0)
         return 0;
 
     coord_t max_distance_pruned = 0;
     for (auto child_it = m_children.begin(); child_it != m_children.end(); ) {
-        auto& child = *child_it;
-        coord_t dist_pruned_child = child->prune(pruning_distance);
+        Node &child = nodes[*child_it];
+        coord_t dist_pruned_child = child.prune(nodes, pruning_distance);
         if (dist_pruned_child >= pruning_distance)
         { // pruning is finished for child; dont modify further
             max_distance_pruned = std::max(max_distance_pruned, dist_pruned_child);
             ++child_it;
         } else {
             const Point a = getLocation();
-            const Point b = child->getLocation();
+            const Point b = child.getLocation();
             const Point ba = a - b;
             const auto ab_len = coord_t(ba.cast<double>().norm());
             if (dist_pruned_child + ab_len <= pruning_distance) { 
                 // we're still in the process of pruning
-                assert(child->m_children.empty() && "when pruning away a node all it's children must already have been pruned away");
+                assert(child.m_children.empty() && "when pruning away a node all it's children must already have been pruned away");
                 max_distance_pruned = std::max(max_distance_pruned, dist_pruned_child + ab_len);
                 child_it = m_children.erase(child_it);
             } else {
@@ -338,7 +357,7 @@ coord_t Node::prune(const coord_t& pruning_distance)
                 const Point n = b + (ba.cast<double>().normalized() * (pruning_distance - dist_pruned_child)).cast<coord_t>();
                 assert(std::abs((n - b).cast<double>().norm() + dist_pruned_child - pruning_distance) < 10 && "total pruned distance must be equal to the pruning_distance");
                 max_distance_pruned = std::max(max_distance_pruned, pruning_distance);
-                child->setLocation(n);
+                child.setLocation(n);
                 ++child_it;
             }
         }
@@ -347,31 +366,31 @@ coord_t Node::prune(const coord_t& pruning_distance)
     return max_distance_pruned;
 }
 
-void Node::convertToPolylines(Polylines &output, const coord_t line_overlap) const
+void Node::convertToPolylines(const NodePool &nodes, Polylines &output, const coord_t line_overlap) const
 {
     Polylines result;
     result.emplace_back();
-    convertToPolylines(0, result);
+    convertToPolylines(nodes, 0, result);
     removeJunctionOverlap(result, line_overlap);
     append(output, std::move(result));
 }
 
-void Node::convertToPolylines(size_t long_line_idx, Polylines &output) const
+void Node::convertToPolylines(const NodePool &nodes, size_t long_line_idx, Polylines &output) const
 {
     if (m_children.empty()) {
         output[long_line_idx].points.push_back(m_p);
         return;
     }
     size_t first_child_idx = rand() % m_children.size();
-    m_children[first_child_idx]->convertToPolylines(long_line_idx, output);
+    nodes[m_children[first_child_idx]].convertToPolylines(nodes, long_line_idx, output);
     output[long_line_idx].points.push_back(m_p);
 
     for (size_t idx_offset = 1; idx_offset < m_children.size(); idx_offset++) {
         size_t child_idx = (first_child_idx + idx_offset) % m_children.size();
-        const Node& child = *m_children[child_idx];
+        const Node& child = nodes[m_children[child_idx]];
         output.emplace_back();
         size_t child_line_idx = output.size() - 1;
-        child.convertToPolylines(child_line_idx, output);
+        child.convertToPolylines(nodes, child_line_idx, output);
         output[child_line_idx].points.emplace_back(m_p);
     }
 }
@@ -413,27 +432,23 @@ void Node::removeJunctionOverlap(Polylines &result_lines, const coord_t line_ove
 }
 
 #ifdef LIGHTNING_TREE_NODE_DEBUG_OUTPUT
-void export_to_svg(const NodeSPtr &root_node, SVG &svg)
+void export_to_svg(const NodePool &nodes, NodeIdx root_node, SVG &svg)
 {
-    for (const NodeSPtr &children : root_node->m_children) {
-        svg.draw(Line(root_node->getLocation(), children->getLocation()), "red");
-        export_to_svg(children, svg);
+    for (NodeIdx children : nodes[root_node].m_children) {
+        svg.draw(Line(nodes[root_node].getLocation(), nodes[children].getLocation()), "red");
+        export_to_svg(nodes, children, svg);
     }
 }
 
-void export_to_svg(const std::string &path, const Polygons &contour, const std::vector<NodeSPtr> &root_nodes) {
+void export_to_svg(const std::string &path, const Polygons &contour, const NodePool &nodes, const std::vector<NodeIdx> &root_nodes) {
     BoundingBox bbox = get_extents(contour);
 
     bbox.offset(SCALED_EPSILON);
     SVG svg(path, bbox);
     svg.draw_outline(contour, "blue");
 
-    for (const NodeSPtr &root_node: root_nodes) {
-        for (const NodeSPtr &children: root_node->m_children) {
-            svg.draw(Line(root_node->getLocation(), children->getLocation()), "red");
-            export_to_svg(children, svg);
-        }
-    }
+    for (NodeIdx root_node: root_nodes)
+        export_to_svg(nodes, root_node, svg);
 }
 #endif /* LIGHTNING_TREE_NODE_DEBUG_OUTPUT */
 
@@ -5,10 +5,12 @@
 #define LIGHTNING_TREE_NODE_H
 
 #include <functional>
-#include <memory>
+#include <limits>
 #include <optional>
 #include <vector>
 
+#include <tbb/concurrent_vector.h>
+
 #include "../../EdgeGrid.hpp"
 #include "../../Polygon.hpp"
 #include "SVG.hpp"
@@ -22,7 +24,14 @@ constexpr auto locator_cell_size = scaled<coord_t>(4.);
 
 class Node;
 
-using NodeSPtr = std::shared_ptr<Node>;
+// Nodes reference each other by their index into the node pool of their lightning layer.
+using NodeIdx = uint32_t;
+constexpr NodeIdx InvalidNodeIdx = std::numeric_limits<NodeIdx>::max();
+
+// All the nodes of all the trees of a single lightning layer. Nodes are never freed one by one, they are released
+// together with their layer. The pool may grow from multiple threads while the islands of a layer are processed
+// in parallel, each tree being only modified by a single thread.
+using NodePool = tbb::concurrent_vector<Node>;
 
 // NOTE: As written, this struct will only be valid for a single layer, will have to be updated for the next.
 // NOTE: Reasons for implementing this with some separate closures:
@@ -38,18 +47,22 @@ using NodeSPtr = std::shared_ptr<Node>;
  * a tree. The class also has some helper functions specific to Lightning Infill
  * e.g. to straighten the paths around this node.
  */
-class Node : public std::enable_shared_from_this<Node>
+class Node
 {
 public:
-    // Workaround for private/protected constructors and 'make_shared': https://stackoverflow.com/a/27832765
-    template<typename ...Arg> NodeSPtr static create(Arg&&...arg)
-    {
-        struct EnableMakeShared : public Node
-        {
-            explicit EnableMakeShared(Arg&&...arg) : Node(std::forward<Arg>(arg)...) {}
-        };
-        return std::make_shared<EnableMakeShared>(std::forward<Arg>(arg)...);
-    }
+    /*!
+     * Construct a new node in \p nodes, either for insertion in a tree or as root.
+     * \param p The physical location in the 2D layer that this node represents.
+     * Connecting other nodes to this node indicates that a line segment should
+     * be drawn between those two physical positions.
+     * \return The index of the new node.
+     */
+    static NodeIdx create(NodePool &nodes, const Point &p, const std::optional<Point> &last_grounding_location = std::nullopt);
+
+    /*!
+     * Index of this node in the node pool of its layer.
+     */
+    NodeIdx idx() const { return m_idx; }
 
     /*!
      * Get the position on this layer that this node represents, a vertex of the
@@ -68,24 +81,26 @@ public:
      * Construct a new ``Node`` instance and add it as a child of
      * this node.
      * \param p The location of the new node.
-     * \return A shared pointer to the new node.
+     * \return The index of the new node.
      */
-    NodeSPtr addChild(const Point& p);
+    NodeIdx addChild(NodePool &nodes, const Point& p);
 
     /*!
      * Add an existing ``Node`` as a child of this node.
      * \param new_child The node that must be added as a child.
      * \return Always returns \p new_child.
      */
-    NodeSPtr addChild(NodeSPtr& new_child);
+    NodeIdx addChild(NodePool &nodes, NodeIdx new_child);
 
     /*!
      * Propagate this node's sub-tree to the next layer.
      *
-     * Creates a copy of this tree, realign it to the new layer boundaries
-     * \p next_outlines and reduce (i.e. prune and straighten) it. A copy of
-     * this node and all of its descendant nodes will be added to the
+     * Creates a copy of this tree in \p next_nodes, realign it to the new layer
+     * boundaries \p next_outlines and reduce (i.e. prune and straighten) it.
+     * A copy of this node and all of its descendant nodes will be added to the
      * \p next_trees vector.
+     * \param nodes The node pool of this node.
+     * \param next_nodes The node pool of the next layer.
      * \param next_trees A collection of tree nodes to use for the next layer.
      * \param next_outlines The shape of the layer below, to make sure that the
      * tree stays within the bounds of the infill area.
@@ -99,7 +114,9 @@ public:
      */
     void propagateToNextLayer
     (
-        std::vector<NodeSPtr>& next_trees,
+        const NodePool& nodes,
+        NodePool& next_nodes,
+        std::vector<NodeIdx>& next_trees,
         const Polygons& next_outlines,
         const EdgeGrid::Grid& outline_locator,
         coord_t prune_distance,
@@ -118,19 +135,17 @@ public:
      * \param visitor A function to execute for every branch in the node's sub-
      * tree.
      */
-    void visitBranches(const std::function<void(const Point&, const Point&)>& visitor) const;
+    void visitBranches(const NodePool& nodes, const std::function<void(const Point&, const Point&)>& visitor) const;
 
     /*!
      * Execute a given function for every node in this node's sub-tree.
      *
-     * The visitor function takes a node as input. This node is not const, so
-     * this can be used to change the tree.
      * Nodes are visited in depth-first order. This node itself is visited as
      * well (pre-order).
      * \param visitor A function to execute for every node in this node's sub-
      * tree.
      */
-    void visitNodes(const std::function<void(NodeSPtr)>& visitor);
+    void visitNodes(const NodePool& nodes, const std::function<void(const Node&)>& visitor) const;
 
     /*!
      * Get a weighted distance from an unsupported point to this node (given the current supporting radius).
@@ -159,14 +174,14 @@ public:
      * This is then recursively bubbled up until it reaches the (former) root, which then will become a leaf.
      * \param new_parent The (new) parent-node of the root, useful for recursing or immediately attaching the node to another tree.
      */
-    void reroot(const NodeSPtr &new_parent = nullptr);
+    void reroot(NodePool &nodes, NodeIdx new_parent = InvalidNodeIdx);
 
     /*!
      * Retrieves the closest node to the specified location.
      * \param loc The specified location.
      * \result The branch that starts at the position closest to the location within this tree.
      */
-    NodeSPtr closestNode(const Point& loc);
+    NodeIdx closestNode(const NodePool& nodes, const Point& loc) const;
 
     /*!
      * Returns whether the given tree node is a descendant of this node.
@@ -177,30 +192,25 @@ public:
      * \return ``true`` if the given node is a descendant or this node itself,
      * or ``false`` if it is not in the sub-tree.
      */
-    bool hasOffspring(const NodeSPtr& to_be_checked) const;
+    bool hasOffspring(const NodePool& nodes, NodeIdx to_be_checked) const;
 
     Node() = delete; // Don't allow empty contruction
 
-protected:
-    /*!
-     * Construct a new node, either for insertion in a tree or as root.
-     * \param p The physical location in the 2D layer that this node represents.
-     * Connecting other nodes to this node indicates that a line segment should
-     * be drawn between those two physical positions.
-     */
-    explicit Node(const Point& p, const std::optional<Point>& last_grounding_location = std::nullopt);
+    // Only to be called through create(), public for the node pool.
+    Node(NodeIdx idx, const Point& p, const std::optional<Point>& last_grounding_location);
 
+protected:
     /*!
-     * Copy this node and its entire sub-tree.
+     * Copy this node and its entire sub-tree into \p dst_nodes.
      * \return The equivalent of this node in the copy (the root of the new sub-
      * tree).
      */
-    NodeSPtr deepCopy() const;
+    NodeIdx deepCopy(const NodePool& nodes, NodePool& dst_nodes) const;
 
     /*! Reconnect trees from the layer above to the new outlines of the lower layer.
      * \return Wether or not the root is kept (false is no, true is yes).
      */
-    bool realign(const Polygons& outlines, const EdgeGrid::Grid& outline_locator, std::vector<NodeSPtr>& rerooted_parts);
+    bool realign(NodePool& nodes, const Polygons& outlines, const EdgeGrid::Grid& outline_locator, std::vector<NodeIdx>& rerooted_parts);
 
     struct RectilinearJunction
     {
@@ -214,7 +224,7 @@ protected:
      * \param magnitude The maximum allowed distance to move the node.
      * \param max_remove_colinear_dist Maximum distance of the (compound) line-segment from which a co-linear point may be removed.
      */
-    void straighten(coord_t magnitude, coord_t max_remove_colinear_dist);
+    void straighten(NodePool& nodes, coord_t magnitude, coord_t max_remove_colinear_dist);
 
     /*! Recursive part of \ref straighten(.)
      * \param junction_above The last seen junction with multiple children above
@@ -222,12 +232,12 @@ protected:
      * \param max_remove_colinear_dist2 Maximum distance _squared_ of the (compound) line-segment from which a co-linear point may be removed.
      * \return the total distance along the tree from the last junction above to the first next junction below and the location of the next junction below
      */
-    RectilinearJunction straighten(coord_t magnitude, const Point& junction_above, coord_t accumulated_dist, int64_t max_remove_colinear_dist2);
+    RectilinearJunction straighten(NodePool& nodes, coord_t magnitude, const Point& junction_above, coord_t accumulated_dist, int64_t max_remove_colinear_dist2);
 
     /*! Prune the tree from the extremeties (leaf-nodes) until the pruning distance is reached.
      * \return The distance that has been pruned. If less than \p distance, then the whole tree was puned away.
      */
-    coord_t prune(const coord_t& distance);
+    coord_t prune(NodePool& nodes, const coord_t& distance);
 
 public:
     /*!
@@ -239,7 +249,7 @@ public:
      * 
      * \param output all branches in this tree connected into polylines
      */
-    void convertToPolylines(Polylines &output, coord_t line_overlap) const;
+    void convertToPolylines(const NodePool &nodes, Polylines &output, coord_t line_overlap) const;
 
     /*! If this was ever a direct child of the root, it'll have a previous grounding location.
      *
@@ -247,7 +257,7 @@ public:
      */
     const std::optional<Point>& getLastGroundingLocation() const { return m_last_grounding_location; }
 
-    void draw_tree(SVG& svg) { for (auto& child : m_children) { svg.draw(Line(m_p, child->getLocation()), "yellow"); child->draw_tree(svg); } }
+    void draw_tree(const NodePool& nodes, SVG& svg) const { for (NodeIdx child : m_children) { svg.draw(Line(m_p, nodes[child].getLocation()), "yellow"); nodes[child].draw_tree(nodes, svg); } }
 
 protected:
     /*!
@@ -260,49 +270,50 @@ protected:
      * \param long_line a reference to a polyline in \p output which to continue building on in the recursion
      * \param output all branches in this tree connected into polylines
      */
-    void convertToPolylines(size_t long_line_idx, Polylines &output) const;
+    void convertToPolylines(const NodePool &nodes, size_t long_line_idx, Polylines &output) const;
 
     void removeJunctionOverlap(Polylines &polylines, coord_t line_overlap) const;
 
+    NodeIdx m_idx;
     bool m_is_root;
     Point m_p;
-    std::weak_ptr<Node> m_parent;
-    std::vector<NodeSPtr> m_children;
+    NodeIdx m_parent { InvalidNodeIdx };
+    std::vector<NodeIdx> m_children;
 
     std::optional<Point> m_last_grounding_location;  //<! The last known grounding location, see 'getLastGroundingLocation()'.
 
-    friend BoundingBox get_extents(const NodeSPtr &root_node);
-    friend BoundingBox get_extents(const std::vector<NodeSPtr> &tree_roots);
+    friend BoundingBox get_extents(const NodePool &nodes, NodeIdx root_node);
+    friend BoundingBox get_extents(const NodePool &nodes, const std::vector<NodeIdx> &tree_roots);
 
 #ifdef LIGHTNING_TREE_NODE_DEBUG_OUTPUT
-    friend void export_to_svg(const NodeSPtr &root_node, Slic3r::SVG &svg);
-    friend void export_to_svg(const std::string &path, const Polygons &contour, const std::vector<NodeSPtr> &root_nodes);
+    friend void export_to_svg(const NodePool &nodes, NodeIdx root_node, Slic3r::SVG &svg);
+    friend void export_to_svg(const std::string &path, const Polygons &contour, const NodePool &nodes, const std::vector<NodeIdx> &root_nodes);
 #endif /* LIGHTNING_TREE_NODE_DEBUG_OUTPUT */
 };
 
 bool inside(const Polygons &polygons, const Point &p);
 bool lineSegmentPolygonsIntersection(const Point& a, const Point& b, const EdgeGrid::Grid& outline_locator, Point& result, coord_t within_max_dist);
 
-inline BoundingBox get_extents(const NodeSPtr &root_node)
+inline BoundingBox get_extents(const NodePool &nodes, NodeIdx root_node)
 {
     BoundingBox bbox;
-    for (const NodeSPtr &children : root_node->m_children)
-        bbox.merge(get_extents(children));
-    bbox.merge(root_node->getLocation());
+    for (NodeIdx children : nodes[root_node].m_children)
+        bbox.merge(get_extents(nodes, children));
+    bbox.merge(nodes[root_node].getLocation());
     return bbox;
 }
 
-inline BoundingBox get_extents(const std::vector<NodeSPtr> &tree_roots)
+inline BoundingBox get_extents(const NodePool &nodes, const std::vector<NodeIdx> &tree_roots)
 {
     BoundingBox bbox;
-    for (const NodeSPtr &root_node : tree_roots)
-        bbox.merge(get_extents(root_node));
+    for (NodeIdx root_node : tree_roots)
+        bbox.merge(get_extents(nodes, root_node));
     return bbox;
 }
 
 #ifdef LIGHTNING_TREE_NODE_DEBUG_OUTPUT
-void export_to_svg(const NodeSPtr &root_node, SVG &svg);
-void export_to_svg(const std::string &path, const Polygons &contour, const std::vector<NodeSPtr> &root_nodes);
+void export_to_svg(const NodePool &nodes, NodeIdx root_node, SVG &svg);
+void export_to_svg(const std::string &path, const Polygons &contour, const NodePool &nodes, const std::vector<NodeIdx> &root_nodes);
 #endif /* LIGHTNING_TREE_NODE_DEBUG_OUTPUT */
 
 } // namespace Slic3r::FillLightning
@@ -500,14 +500,16 @@ void SL1Archive::export_print(Zipper& zipper,
         zipper.add_entry("prusaslicer.ini");
         zipper << to_ini(slicerconf);
 
-        size_t i = 0;
-        for (const sla::EncodedRaster &rst : m_layers) {
-
-            std::string imgname = project + string_printf("%.5d", i++) + "." +
+        write_layers(print, [&zipper, &project](size_t i, const sla::EncodedRaster &rst) {
+            std::string imgname = project + string_printf("%.5d", i) + "." +
                                   rst.extension();
 
             zipper.add_entry(imgname.c_str(), rst.data(), rst.size());
-        }
+        });
+
+        BOOST_LOG_TRIVIAL(info) << "SL1 export of " << m_raster_statistics.layers << " layers: "
+                                << m_raster_statistics.encoded_bytes << " bytes of encoded rasters, at most "
+                                << m_raster_statistics.peak_bytes_in_memory << " bytes held in memory";
     } catch(std::exception& e) {
         BOOST_LOG_TRIVIAL(error) << e.what();
         // Rethrow the exception
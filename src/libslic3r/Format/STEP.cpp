@@ -505,6 +505,97 @@ Step::Step_Status Step::load()
     
 }
 
+// Split the compounds and compsolids into solids the same way getNamedSolids() does with isSplitCompound set.
+static std::vector<NamedSolid> split_compounds(const std::vector<NamedSolid> &namedSolids)
+{
+    std::vector<NamedSolid> out;
+    out.reserve(namedSolids.size());
+    for (const NamedSolid &namedSolid : namedSolids) {
+        TopAbs_ShapeEnum shape_type = namedSolid.solid.ShapeType();
+        if (shape_type == TopAbs_COMPOUND || shape_type == TopAbs_COMPSOLID) {
+            int i = 0;
+            for (TopExp_Explorer explorer(namedSolid.solid, TopAbs_SOLID); explorer.More(); explorer.Next())
+                out.emplace_back(TopoDS::Solid(explorer.Current()), namedSolid.name + "-SOLID-" + std::to_string(++ i));
+        } else
+            out.emplace_back(namedSolid.solid, namedSolid.name);
+    }
+    return out;
+}
+
+// Collect the triangulations of the faces of an already tessellated shape into a mesh.
+// The faces are triangulated independently, the vertices shared by the faces are welded by TriangleMesh::from_stl().
+static void triangulation_to_mesh(const TopoDS_Shape &solid, TriangleMesh &out)
+{
+    // BBS: calculate total number of the nodes and triangles
+    int aNbNodes = 0;
+    int aNbTriangles = 0;
+    for (TopExp_Explorer anExpSF(solid, TopAbs_FACE); anExpSF.More(); anExpSF.Next()) {
+        TopLoc_Location aLoc;
+        Handle(Poly_Triangulation) aTriangulation = BRep_Tool::Triangulation(TopoDS::Face(anExpSF.Current()), aLoc);
+        if (!aTriangulation.IsNull()) {
+            aNbNodes += aTriangulation->NbNodes();
+            aNbTriangles += aTriangulation->NbTriangles();
+        }
+    }
+
+    if (aNbTriangles == 0 || aNbNodes == 0)
+        // BBS: No triangulation on the shape.
+        return;
+
+    stl_file stl;
+    stl.stats.type = inmemory;
+    stl.stats.number_of_facets = (uint32_t)aNbTriangles;
+    stl.stats.original_num_facets = stl.stats.number_of_facets;
+    stl_allocate(&stl);
+
+    std::vector<Vec3f> points;
+    points.reserve(aNbNodes);
+    // BBS: fill temporary triangulation
+    Standard_Integer aNodeOffset = 0;
+    Standard_Integer aTriangleOffet = 0;
+    for (TopExp_Explorer anExpSF(solid, TopAbs_FACE); anExpSF.More(); anExpSF.Next()) {
+        const TopoDS_Shape& aFace = anExpSF.Current();
+        TopLoc_Location     aLoc;
+        Handle(Poly_Triangulation) aTriangulation = BRep_Tool::Triangulation(TopoDS::Face(aFace), aLoc);
+        if (aTriangulation.IsNull())
+            continue;
+        // BBS: copy nodes
+        gp_Trsf aTrsf = aLoc.Transformation();
+        for (Standard_Integer aNodeIter = 1; aNodeIter <= aTriangulation->NbNodes(); ++aNodeIter) {
+            gp_Pnt aPnt = aTriangulation->Node(aNodeIter);
+            aPnt.Transform(aTrsf);
+            points.emplace_back(aPnt.X(), aPnt.Y(), aPnt.Z());
+        }
+        // BBS: copy triangles
+        const TopAbs_Orientation anOrientation = anExpSF.Current().Orientation();
+        Standard_Integer anId[3] = {};
+        for (Standard_Integer aTriIter = 1; aTriIter <= aTriangulation->NbTriangles(); ++aTriIter) {
+            Poly_Triangle aTri = aTriangulation->Triangle(aTriIter);
+
+            aTri.Get(anId[0], anId[1], anId[2]);
+            if (anOrientation == TopAbs_REVERSED)
+                std::swap(anId[1], anId[2]);
+            // BBS: save triangles facets
+            stl_facet facet;
+            facet.vertex[0] = points[anId[0] + aNodeOffset - 1];
+            facet.vertex[1] = points[anId[1] + aNodeOffset - 1];
+            facet.vertex[2] = points[anId[2] + aNodeOffset - 1];
+            facet.extra[0] = 0;
+            facet.extra[1] = 0;
+            stl_normal normal;
+            stl_calculate_normal(normal, &facet);
+            stl_normalize_vector(normal);
+            facet.normal = normal;
+            stl.facet_start[aTriangleOffet + aTriIter - 1] = facet;
+        }
+
+        aNodeOffset += aTriangulation->NbNodes();
+        aTriangleOffet += aTriangulation->NbTriangles();
+    }
+
+    out.from_stl(stl);
+}
+
 Step::Step_Status Step::mesh(Model* model,
                              bool& is_cancel,
                              bool isSplitCompound,
@@ -514,118 +605,44 @@ Step::Step_Status Step::mesh(Model* model,
 {
     bool task_result = false;
     bool cb_cancel = false;
-    float progress = .0;
     std::atomic<int> meshed_solid_num = 0;
-    std::vector<NamedSolid> namedSolids;
-    float progress_2 = .0;
+    std::atomic<int> converted_solid_num = 0;
+    // The solids were collected by load(), don't walk the document again.
+    std::vector<NamedSolid> namedSolids = isSplitCompound ? split_compounds(m_name_solids) : m_name_solids;
     ModelObject* new_object = model->add_object();
     const char* last_slash = strrchr(m_path.c_str(), DIR_SEPARATOR);
     new_object->name.assign((last_slash == nullptr) ? m_path.c_str() : last_slash + 1);
     new_object->input_file = m_path.c_str();
 
     auto task = new boost::thread(Slic3r::create_thread([&]() -> void {
-        TDF_LabelSequence topLevelShapes;
-        m_shape_tool->GetFreeShapes(topLevelShapes);
-        unsigned int id{ 1 };
-        Standard_Integer topShapeLength = topLevelShapes.Length() + 1;
-        
-        for (Standard_Integer iLabel = 1; iLabel < topShapeLength; ++iLabel) {
-            progress = static_cast<double>(iLabel) / (topShapeLength-1);
-            if (cb_cancel) {
-                return;
-            }
-            getNamedSolids(TopLoc_Location{}, "", id, m_shape_tool, topLevelShapes.Value(iLabel), namedSolids, isSplitCompound);
-        }
-
-        std::vector<stl_file> stl;
-        stl.resize(namedSolids.size());
-        tbb::parallel_for(tbb::blocked_range<size_t>(0, namedSolids.size()), [&](const tbb::blocked_range<size_t>& range) {
-            for (size_t i = range.begin(); i < range.end(); i++) {
-                BRepMesh_IncrementalMesh mesh(namedSolids[i].solid, linear_defletion, false, angle_defletion, true);
-                // BBS: calculate total number of the nodes and triangles
-                int aNbNodes = 0;
-                int aNbTriangles = 0;
-                for (TopExp_Explorer anExpSF(namedSolids[i].solid, TopAbs_FACE); anExpSF.More(); anExpSF.Next()) {
-                    TopLoc_Location aLoc;
-                    Handle(Poly_Triangulation) aTriangulation = BRep_Tool::Triangulation(TopoDS::Face(anExpSF.Current()), aLoc);
-                    if (!aTriangulation.IsNull()) {
-                        aNbNodes += aTriangulation->NbNodes();
-                        aNbTriangles += aTriangulation->NbTriangles();
-                    }
-                }
-
-                if (aNbTriangles == 0 || aNbNodes == 0)
-                    // BBS: No triangulation on the shape.
-                    continue;
-
-                stl[i].stats.type = inmemory;
-                stl[i].stats.number_of_facets = (uint32_t)aNbTriangles;
-                stl[i].stats.original_num_facets = stl[i].stats.number_of_facets;
-                stl_allocate(&stl[i]);
-
-                std::vector<Vec3f> points;
-                points.reserve(aNbNodes);
-                // BBS: count faces missing triangulation
-                Standard_Integer aNbFacesNoTri = 0;
-                // BBS: fill temporary triangulation
-                Standard_Integer aNodeOffset = 0;
-                Standard_Integer aTriangleOffet = 0;
-                for (TopExp_Explorer anExpSF(namedSolids[i].solid, TopAbs_FACE); anExpSF.More(); anExpSF.Next()) {
-                    const TopoDS_Shape& aFace = anExpSF.Current();
-                    TopLoc_Location     aLoc;
-                    Handle(Poly_Triangulation) aTriangulation = BRep_Tool::Triangulation(TopoDS::Face(aFace), aLoc);
-                    if (aTriangulation.IsNull()) {
-                        ++aNbFacesNoTri;
-                        continue;
-                    }
-                    // BBS: copy nodes
-                    gp_Trsf aTrsf = aLoc.Transformation();
-                    for (Standard_Integer aNodeIter = 1; aNodeIter <= aTriangulation->NbNodes(); ++aNodeIter) {
-                        gp_Pnt aPnt = aTriangulation->Node(aNodeIter);
-                        aPnt.Transform(aTrsf);
-                        points.emplace_back(std::move(Vec3f(aPnt.X(), aPnt.Y(), aPnt.Z())));
-                    }
-                    // BBS: copy triangles
-                    const TopAbs_Orientation anOrientation = anExpSF.Current().Orientation();
-                    Standard_Integer anId[3] = {};
-                    for (Standard_Integer aTriIter = 1; aTriIter <= aTriangulation->NbTriangles(); ++aTriIter) {
-                        Poly_Triangle aTri = aTriangulation->Triangle(aTriIter);
-
-                        aTri.Get(anId[0], anId[1], anId[2]);
-                        if (anOrientation == TopAbs_REVERSED)
-                            std::swap(anId[1], anId[2]);
-                        // BBS: save triangles facets
-                        stl_facet facet;
-                        facet.vertex[0] = points[anId[0] + aNodeOffset - 1].cast<float>();
-                        facet.vertex[1] = points[anId[1] + aNodeOffset - 1].cast<float>();
-                        facet.vertex[2] = points[anId[2] + aNodeOffset - 1].cast<float>();
-                        facet.extra[0] = 0;
-                        facet.extra[1] = 0;
-                        stl_normal normal;
-                        stl_calculate_normal(normal, &facet);
-                        stl_normalize_vector(normal);
-                        facet.normal = normal;
-                        stl[i].facet_start[aTriangleOffet + aTriIter - 1] = facet;
-                    }
-
-                    aNodeOffset += aTriangulation->NbNodes();
-                    aTriangleOffet += aTriangulation->NbTriangles();
-                }
+        // Tessellate the shapes collected by load() before splitting the compounds, as the solids of a compsolid share faces,
+        // which must not be meshed concurrently. Each of the collected shapes is a transformed copy, they don't share any face.
+        // If get_triangle_num() meshed the shapes with the same parameters already, BRepMesh_IncrementalMesh reuses the triangulation.
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, m_name_solids.size(), 1), [&](const tbb::blocked_range<size_t>& range) {
+            for (size_t i = range.begin(); i < range.end() && ! cb_cancel; ++ i) {
+                BRepMesh_IncrementalMesh mesh(m_name_solids[i].solid, linear_defletion, false, angle_defletion, true);
                 meshed_solid_num.fetch_add(1, std::memory_order_relaxed);
             }
         });
+        if (cb_cancel)
+            return;
 
+        // Convert the triangulations of the solids to meshes including the admesh repair, one solid per task.
+        std::vector<TriangleMesh> meshes(namedSolids.size());
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, namedSolids.size(), 1), [&](const tbb::blocked_range<size_t>& range) {
+            for (size_t i = range.begin(); i < range.end() && ! cb_cancel; ++ i) {
+                triangulation_to_mesh(namedSolids[i].solid, meshes[i]);
+                converted_solid_num.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+        if (cb_cancel)
+            return;
 
-        for (size_t i = 0; i < stl.size(); i++) {
-            progress_2 = static_cast<float>(i) / stl.size();
-            if (cb_cancel)
-                return;
-
+        // Add the volumes in the order of the solids in the file.
+        for (size_t i = 0; i < meshes.size(); i++) {
             //BBS: maybe mesh is empty from step file. Don't add
-            if (stl[i].stats.number_of_facets > 0) {
-                TriangleMesh triangle_mesh;
-                triangle_mesh.from_stl(stl[i]);
-                ModelVolume* new_volume = new_object->add_volume(std::move(triangle_mesh));
+            if (! meshes[i].empty()) {
+                ModelVolume* new_volume = new_object->add_volume(std::move(meshes[i]));
                 new_volume->name = namedSolids[i].name;
                 new_volume->source.input_file = m_path.c_str();
                 new_volume->source.object_idx = (int)model->objects.size() - 1;
@@ -637,23 +654,17 @@ Step::Step_Status Step::mesh(Model* model,
 
     while (!task_result) {
         boost::this_thread::sleep_for(boost::chrono::milliseconds(300));
-        if (progress_2 > 0) {
+        if (int converted_solid = converted_solid_num.load(); converted_solid > 0) {
             // third progress
-            update_process(LOAD_STEP_STAGE_GET_MESH, static_cast<int>(progress_2 * 100), 100, cb_cancel);
-        }else {
-            if (meshed_solid_num.load()) {
-                // second progress
-                int meshed_solid = meshed_solid_num.load();
-                update_process(LOAD_STEP_STAGE_GET_SOLID, static_cast<int>((float)meshed_solid / namedSolids.size() * 10) + 10, 20, cb_cancel);
-            } else {
-                if (progress > 0) {
-                    // first progress
-                    update_process(LOAD_STEP_STAGE_GET_SOLID, static_cast<int>(progress * 10), 20, cb_cancel);
-                }
-            }
+            update_process(LOAD_STEP_STAGE_GET_MESH, static_cast<int>((float)converted_solid / namedSolids.size() * 100), 100, cb_cancel);
+        } else if (int meshed_solid = meshed_solid_num.load(); meshed_solid > 0) {
+            // second progress
+            update_process(LOAD_STEP_STAGE_GET_SOLID, static_cast<int>((float)meshed_solid / m_name_solids.size() * 10) + 10, 20, cb_cancel);
+        } else {
+            // first progress
+            update_process(LOAD_STEP_STAGE_GET_SOLID, 10, 20, cb_cancel);
         }
-        
-        
+
         if (cb_cancel) {
             if (task) {
                 if (task->joinable()) {
@@ -102,6 +102,9 @@ public:
     unsigned int get_triangle_num(double linear_defletion, double angle_defletion);
     unsigned int get_triangle_num_tbb(double linear_defletion, double angle_defletion);
     void clean_mesh_data();
+    // Tessellate the solids collected by load() and add them as volumes of a new object in the order they appear in the file.
+    // linear_defletion is the maximum chordal deviation in mm, angle_defletion the maximum angle between the normals
+    // of adjacent triangles in radians. Larger values produce coarser meshes, which are faster to tessellate and to load.
     Step_Status mesh(Model* model,
                      bool& is_cancel,
                      bool isSplitCompound,
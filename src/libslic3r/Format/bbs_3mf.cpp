@@ -7,6 +7,7 @@
 #include "../GCode.hpp"
 #include "../Geometry.hpp"
 #include "../GCode/ThumbnailData.hpp"
+#include "../PNGReadWrite.hpp"
 #include "../Semver.hpp"
 #include "../Time.hpp"
 
@@ -5878,6 +5879,8 @@ void PlateData::parse_filament_info(GCodeProcessorResult *result)
         std::string m_thumbnail_small  = PRINTER_THUMBNAIL_SMALL_FILE;
         std::map<void const *, std::pair<ObjectData*, ModelVolume const *>> m_shared_meshes;
         std::map<ModelVolume const *, std::pair<std::string, int>> m_volume_paths;
+        // Thumbnails encoded to png in parallel before they are added to the archive one by one.
+        std::map<ThumbnailData const *, std::vector<uint8_t>> m_encoded_thumbnails;
     public:
         //BBS: add plate data related logic
 
@@ -6162,6 +6165,24 @@ void PlateData::parse_filament_info(GCodeProcessorResult *result)
                     return false;
             }
 
+            // Encode the thumbnails of all the plates in parallel, the archive is written sequentially below.
+            m_encoded_thumbnails.clear();
+            for (const std::vector<ThumbnailData*> *thumbnails : { &thumbnail_data, &no_light_thumbnail_data, &top_thumbnail_data, &pick_thumbnail_data })
+                for (const ThumbnailData *thumbnail : *thumbnails)
+                    if (thumbnail->is_valid())
+                        m_encoded_thumbnails[thumbnail];
+            {
+                std::vector<std::pair<ThumbnailData const *const, std::vector<uint8_t>>*> to_encode;
+                for (auto &encoded : m_encoded_thumbnails)
+                    to_encode.emplace_back(&encoded);
+                tbb::parallel_for(tbb::blocked_range<size_t>(0, to_encode.size(), 1), [&to_encode](const tbb::blocked_range<size_t> &range) {
+                    for (size_t i = range.begin(); i < range.end(); ++ i) {
+                        const ThumbnailData &thumbnail = *to_encode[i]->first;
+                        to_encode[i]->second = png::encode_png(thumbnail.pixels.data(), thumbnail.width, thumbnail.height, 4, png::Compression::Fast, true);
+                    }
+                });
+            }
+
             for (unsigned int index = 0; index < thumbnail_data.size(); index++)
             {
                 if (thumbnail_data[index]->is_valid())
@@ -6206,6 +6227,7 @@ void PlateData::parse_filament_info(GCodeProcessorResult *result)
                     pick_thumbnail_status[index] = true;
                 }
             }
+            m_encoded_thumbnails.clear();
 
             for (int i = 0; i < plate_data_list.size(); i++) {
                 PlateData *plate_data = plate_data_list[i];
@@ -6576,12 +6598,14 @@ void PlateData::parse_filament_info(GCodeProcessorResult *result)
     {
         bool res = false;
 
-        size_t png_size = 0;
-        void* png_data = tdefl_write_image_to_png_file_in_memory_ex((const void*)thumbnail_data.pixels.data(), thumbnail_data.width, thumbnail_data.height, 4, &png_size, MZ_DEFAULT_COMPRESSION, 1);
-        if (png_data != nullptr) {
+        auto it_encoded = m_encoded_thumbnails.find(&thumbnail_data);
+        if (it_encoded == m_encoded_thumbnails.end())
+            it_encoded = m_encoded_thumbnails.emplace(&thumbnail_data,
+                png::encode_png(thumbnail_data.pixels.data(), thumbnail_data.width, thumbnail_data.height, 4, png::Compression::Fast, true)).first;
+        const std::vector<uint8_t> &png_data = it_encoded->second;
+        if (! png_data.empty()) {
             std::string thumbnail_name = (boost::format("%1%_%2%.png")%local_path % (index + 1)).str();
-            res = mz_zip_writer_add_mem(&archive, thumbnail_name.c_str(), (const void*)png_data, png_size, MZ_NO_COMPRESSION);
-            mz_free(png_data);
+            res = mz_zip_writer_add_mem(&archive, thumbnail_name.c_str(), (const void*)png_data.data(), png_data.size(), MZ_NO_COMPRESSION);
         }
 
         if (!res) {
@@ -6621,12 +6645,10 @@ void PlateData::parse_filament_info(GCodeProcessorResult *result)
                     //memcpy((void*)&small_pixels[4*(i / sw * PLATE_THUMBNAIL_SMALL_WIDTH + j / sh)], thumbnail_data.pixels.data() + 4*(i * thumbnail_data.width + j), 4);
                 }
             }
-            size_t small_png_size = 0;
-            void* small_png_data = tdefl_write_image_to_png_file_in_memory_ex((const void*)small_pixels.data(), PLATE_THUMBNAIL_SMALL_WIDTH, PLATE_THUMBNAIL_SMALL_HEIGHT, 4, &small_png_size, MZ_DEFAULT_COMPRESSION, 1);
-            if (png_data != nullptr) {
+            std::vector<uint8_t> small_png_data = png::encode_png(small_pixels.data(), PLATE_THUMBNAIL_SMALL_WIDTH, PLATE_THUMBNAIL_SMALL_HEIGHT, 4, png::Compression::Fast, true);
+            if (! small_png_data.empty()) {
                 std::string thumbnail_name = (boost::format("%1%_%2%_small.png") % local_path % (index + 1)).str();
-                res = mz_zip_writer_add_mem(&archive, thumbnail_name.c_str(), (const void*)small_png_data, small_png_size, MZ_NO_COMPRESSION);
-                mz_free(small_png_data);
+                res = mz_zip_writer_add_mem(&archive, thumbnail_name.c_str(), (const void*)small_png_data.data(), small_png_data.size(), MZ_NO_COMPRESSION);
             }
 
             if (!res) {
@@ -1,16 +1,65 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <algorithm>
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/iostreams/device/mapped_file.hpp>
 #include <boost/log/trivial.hpp>
 #include <boost/nowide/cstdio.hpp>
 
+#include <fast_float/fast_float.h>
+
+#include <tbb/parallel_for.h>
+
 #include "objparser.hpp"
 
 #include "libslic3r/LocalesUtils.hpp"
 
 namespace ObjParser {
+
+// Parse a number like strtod() does, but faster and independent of the locale.
+// The number is parsed up to the end of the line at the latest.
+static inline double parse_double(const char *str, const char *line_end, char **endptr)
+{
+	const char *begin = (*str == '+' && str != line_end) ? str + 1 : str;
+	// fast_float does not accept hexadecimal floats, it would parse just the leading zero of 0x1p3.
+	// These and anything else fast_float fails on are left to strtod().
+	const char *digits = (*begin == '-' && begin != line_end) ? begin + 1 : begin;
+	if (line_end - digits > 1 && digits[0] == '0' && (digits[1] == 'x' || digits[1] == 'X'))
+		return strtod(str, endptr);
+	double value = 0.;
+	auto [ptr, ec] = fast_float::from_chars(begin, line_end, value);
+	if (ec != std::errc())
+		return strtod(str, endptr);
+	*endptr = const_cast<char*>(ptr);
+	return value;
+}
+
+// Face vertex referencing a vertex, normal or texture coordinate relative to the end of the data parsed so far.
+struct ObjRelativeIndex
+{
+	// Index into ObjData::vertices.
+	size_t vertex;
+	// Index of the member of ObjVertex, in the order coordIdx, textureCoordIdx, normalIdx.
+	int    member;
+	// Size of the coordinates / textureCoordinates / normals vector, to which the index was relative.
+	size_t size;
+};
+
+// Data recorded when parsing a chunk of a file, to be fixed once the data of the preceding chunks is known.
+struct ObjChunkIndices
+{
+	std::vector<ObjRelativeIndex> relative_indices;
+	// Indices of the face terminators (vertices with coordIdx == -1) into ObjData::vertices.
+	// Faces are counted into ObjUseMtl::face_end only after the relative indices are fixed, as a relative index
+	// resolved locally to -1 would be taken for a face terminator.
+	std::vector<int>              face_ends;
+};
+
 #define EATWS()  while (*line == ' ' || *line == '\t') ++line
-static bool obj_parseline(const char *line, ObjData &data)
+// Parse a line terminated by line_end, where *line_end == 0.
+static bool obj_parseline(const char *line, const char *line_end, ObjData &data, ObjChunkIndices *chunk_indices = nullptr)
 {
 	if (*line == 0)
 		return true;
@@ -38,14 +87,14 @@ static bool obj_parseline(const char *line, ObjData &data)
 				return false;
 			EATWS();
 			char *endptr = 0;
-			double u = strtod(line, &endptr);
+			double u = parse_double(line, line_end, &endptr);
 			if (endptr == 0 || (*endptr != ' ' && *endptr != '\t'))
 				return false;
 			line = endptr;
 			EATWS();
 			double v = 0;
 			if (*line != 0) {
-				v = strtod(line, &endptr);
+				v = parse_double(line, line_end, &endptr);
 				if (endptr == 0 || (*endptr != ' ' && *endptr != '\t' && *endptr != 0))
 					return false;
 				line = endptr;
@@ -75,17 +124,17 @@ static bool obj_parseline(const char *line, ObjData &data)
 				return false;
 			EATWS();
 			char *endptr = 0;
-			double x = strtod(line, &endptr);
+			double x = parse_double(line, line_end, &endptr);
 			if (endptr == 0 || (*endptr != ' ' && *endptr != '\t'))
 				return false;
 			line = endptr;
 			EATWS();
-			double y = strtod(line, &endptr);
+			double y = parse_double(line, line_end, &endptr);
 			if (endptr == 0 || (*endptr != ' ' && *endptr != '\t'))
 				return false;
 			line = endptr;
 			EATWS();
-			double z = strtod(line, &endptr);
+			double z = parse_double(line, line_end, &endptr);
 			if (endptr == 0 || (*endptr != ' ' && *endptr != '\t' && *endptr != 0))
 				return false;
 			line = endptr;
@@ -105,19 +154,19 @@ static bool obj_parseline(const char *line, ObjData &data)
 				return false;
 			EATWS();
 			char *endptr = 0;
-			double u = strtod(line, &endptr);
+			double u = parse_double(line, line_end, &endptr);
 			if (endptr == 0 || (*endptr != ' ' && *endptr != '\t' && *endptr != 0))
 				return false;
 			line = endptr;
 			EATWS();
-			double v = strtod(line, &endptr);
+			double v = parse_double(line, line_end, &endptr);
 			if (endptr == 0 || (*endptr != ' ' && *endptr != '\t' && *endptr != 0))
 				return false;
 			line = endptr;
 			EATWS();
 			double w = 0;
 			if (*line != 0) {
-				w = strtod(line, &endptr);
+				w = parse_double(line, line_end, &endptr);
 				if (endptr == 0 || (*endptr != ' ' && *endptr != '\t' && *endptr != 0))
 					return false;
 				line = endptr;
@@ -137,17 +186,17 @@ static bool obj_parseline(const char *line, ObjData &data)
 				return false;
 			EATWS();
 			char *endptr = 0;
-			double x = strtod(line, &endptr);
+			double x = parse_double(line, line_end, &endptr);
 			if (endptr == 0 || (*endptr != ' ' && *endptr != '\t'))
 				return false;
 			line = endptr;
 			EATWS();
-			double y = strtod(line, &endptr);
+			double y = parse_double(line, line_end, &endptr);
 			if (endptr == 0 || (*endptr != ' ' && *endptr != '\t'))
 				return false;
 			line = endptr;
 			EATWS();
-			double z = strtod(line, &endptr);
+			double z = parse_double(line, line_end, &endptr);
 			if (endptr == 0 || (*endptr != ' ' && *endptr != '\t' && *endptr != 0))
 				return false;
 			line = endptr;
@@ -157,24 +206,24 @@ static bool obj_parseline(const char *line, ObjData &data)
                 if (!data.has_vertex_color) {
                     data.has_vertex_color = true;
                 }
-                color_x = strtod(line, &endptr);
+                color_x = parse_double(line, line_end, &endptr);
                 if (endptr == 0 || (*endptr != ' ' && *endptr != '\t' && *endptr != 0))
                     return false;
                 line = endptr;
                 EATWS();
-                color_y = strtod(line, &endptr);
+                color_y = parse_double(line, line_end, &endptr);
                 if (endptr == 0 || (*endptr != ' ' && *endptr != '\t' && *endptr != 0))
                      return false;
                 line = endptr;
                 EATWS();
-                color_z = strtod(line, &endptr);
+                color_z = parse_double(line, line_end, &endptr);
                 if (endptr == 0 || (*endptr != ' ' && *endptr != '\t' && *endptr != 0))
                     return false;
                 line = endptr;
                 EATWS();
                 color_w = 1.0;//default define alpha = 1.0
                 if (*line != 0) {
-                    color_w = strtod(line, &endptr);
+                    color_w = parse_double(line, line_end, &endptr);
                     if (endptr == 0 || (*endptr != ' ' && *endptr != '\t' && *endptr != 0)) return false;
                     line = endptr;
                     EATWS();
@@ -236,6 +285,14 @@ static bool obj_parseline(const char *line, ObjData &data)
 					line = endptr;
 				}
 			}
+			if (chunk_indices != nullptr) {
+				if (vertex.coordIdx < 0)
+					chunk_indices->relative_indices.push_back({ data.vertices.size(), 0, data.coordinates.size() });
+				if (vertex.textureCoordIdx < 0)
+					chunk_indices->relative_indices.push_back({ data.vertices.size(), 1, data.textureCoordinates.size() });
+				if (vertex.normalIdx < 0)
+					chunk_indices->relative_indices.push_back({ data.vertices.size(), 2, data.normals.size() });
+			}
 			if (vertex.coordIdx < 0)
                 vertex.coordIdx += (int) data.coordinates.size() / OBJ_VERTEX_LENGTH;
             else
@@ -254,7 +311,9 @@ static bool obj_parseline(const char *line, ObjData &data)
         if (data.usemtls.size() > 0) {
 			data.usemtls.back().vertexIdxEnd = (int) data.vertices.size();
 		}
-        if (data.usemtls.size() > 0) {
+        if (chunk_indices != nullptr)
+            chunk_indices->face_ends.emplace_back(int(data.vertices.size()));
+        else if (data.usemtls.size() > 0) {
             int face_index_count = 0;
             for (int i = data.vertices.size() - 1; i >= 0; i--) {
                 if (data.vertices[i].coordIdx == -1) {
@@ -576,54 +635,173 @@ static bool        mtl_parseline(const char *line, MtlData &data)
     return true;
 }
 
+// Parse the lines of a chunk of an OBJ file into data. Lines are terminated by '\r' or '\n', text after the last line terminator
+// is ignored. Returns false if a line is too long, as the former OBJ reader with a fixed size buffer did.
+static bool obj_parsechunk(const char *begin, const char *end, ObjData &data, ObjChunkIndices &chunk_indices)
+{
+	std::string line;
+	for (const char *c = begin;;) {
+		const char *line_end = std::find_if(c, end, [](char ch) { return ch == '\r' || ch == '\n'; });
+		if (line_end == end)
+			return true;
+		if (line_end - c > 65536) {
+			BOOST_LOG_TRIVIAL(error) << "ObjParser: Excessive line length";
+			return false;
+		}
+		while (c != line_end && (*c == ' ' || *c == '\t'))
+			++ c;
+		line.assign(c, line_end);
+		//FIXME check the return value and exit on error?
+		// Will it break parsing of some obj files?
+		obj_parseline(line.c_str(), line.c_str() + line.size(), data, &chunk_indices);
+		c = line_end + 1;
+	}
+}
+
+// Append data parsed from a chunk of an OBJ file to the data parsed from the preceding chunks,
+// producing the same result as if the chunks were parsed one after the other into a single ObjData.
+static void obj_appendchunk(ObjData &data, ObjData &&chunk, const ObjChunkIndices &chunk_indices)
+{
+	// Indices relative to the end of the chunk are made relative to the end of all the data parsed so far.
+	for (const ObjRelativeIndex &relative : chunk_indices.relative_indices) {
+		ObjVertex &vertex = chunk.vertices[relative.vertex];
+		switch (relative.member) {
+		case 0:  vertex.coordIdx        += int((data.coordinates.size() + relative.size) / OBJ_VERTEX_LENGTH - relative.size / OBJ_VERTEX_LENGTH); break;
+		case 1:  vertex.textureCoordIdx += int((data.textureCoordinates.size() + relative.size) / 3 - relative.size / 3); break;
+		default: vertex.normalIdx       += int((data.normals.size() + relative.size) / 3 - relative.size / 3); break;
+		}
+	}
+
+	// Count the faces into the materials the same way obj_parseline() does: Faces preceding the first usemtl of the chunk
+	// belong to the last material of the preceding chunks.
+	const int  vertices_offset = int(data.vertices.size());
+	ObjUseMtl *usemtl          = data.usemtls.empty() ? nullptr : &data.usemtls.back();
+	size_t     next_usemtl     = 0;
+	auto       start_usemtl    = [&chunk, &usemtl, &next_usemtl]() {
+		ObjUseMtl &next = chunk.usemtls[next_usemtl ++];
+		next.face_start = usemtl == nullptr ? 0 : usemtl->face_end + 1;
+		next.face_end   = next.face_start - 1;
+		usemtl = &next;
+	};
+	for (int face_end : chunk_indices.face_ends) {
+		while (next_usemtl < chunk.usemtls.size() && chunk.usemtls[next_usemtl].vertexIdxFirst <= face_end)
+			start_usemtl();
+		if (usemtl != nullptr) {
+			if (next_usemtl == 0)
+				usemtl->vertexIdxEnd = vertices_offset + face_end;
+			int face_index_count = 0;
+			// Vertices of a face line failing to parse are not terminated, thus the search may continue into the preceding chunks.
+			for (int i = face_end - 1; i >= - vertices_offset && (i >= 0 ? chunk.vertices[i] : data.vertices[vertices_offset + i]).coordIdx != -1; -- i)
+				++ face_index_count;
+			if (face_index_count == 3)
+				++ usemtl->face_end;
+			else if (face_index_count == 4)
+				usemtl->face_end += 2;
+		}
+	}
+	while (next_usemtl < chunk.usemtls.size())
+		start_usemtl();
+	if (! data.usemtls.empty() && ! chunk.usemtls.empty())
+		data.usemtls.back().vertexIdxEnd = vertices_offset + chunk.usemtls.front().vertexIdxFirst;
+
+	for (ObjUseMtl &usemtl : chunk.usemtls) {
+		usemtl.vertexIdxFirst += vertices_offset;
+		if (usemtl.vertexIdxEnd != -1)
+			usemtl.vertexIdxEnd += vertices_offset;
+	}
+	for (ObjObject &object : chunk.objects)
+		object.vertexIdxFirst += vertices_offset;
+	for (ObjGroup &group : chunk.groups)
+		group.vertexIdxFirst += vertices_offset;
+	for (ObjSmoothingGroup &group : chunk.smoothingGroups)
+		group.vertexIdxFirst += vertices_offset;
+
+	auto append = [](auto &dst, auto &&src) { dst.insert(dst.end(), std::make_move_iterator(src.begin()), std::make_move_iterator(src.end())); };
+	append(data.coordinates,        std::move(chunk.coordinates));
+	append(data.textureCoordinates, std::move(chunk.textureCoordinates));
+	append(data.normals,            std::move(chunk.normals));
+	append(data.parameters,         std::move(chunk.parameters));
+	append(data.mtllibs,            std::move(chunk.mtllibs));
+	append(data.usemtls,            std::move(chunk.usemtls));
+	append(data.objects,            std::move(chunk.objects));
+	append(data.groups,             std::move(chunk.groups));
+	append(data.smoothingGroups,    std::move(chunk.smoothingGroups));
+	append(data.vertices,           std::move(chunk.vertices));
+	data.has_vertex_color |= chunk.has_vertex_color;
+}
+
+// The file is mapped into memory and split at line ends into chunks, which are parsed in parallel.
 bool objparse(const char *path, ObjData &data)
 {
     Slic3r::CNumericLocalesSetter locales_setter;
 
-	FILE *pFile = boost::nowide::fopen(path, "rt");
-	if (pFile == 0)
-		return false;
-
 	try {
-		char buf[65536 * 2];
-		size_t len = 0;
-		size_t lenPrev = 0;
-		size_t lineCount = 0;
-
-		while ((len = ::fread(buf + lenPrev, 1, 65536, pFile)) != 0) {
-			len += lenPrev;
-			size_t lastLine = 0;
-			for (size_t i = 0; i < len; ++ i)
-				if (buf[i] == '\r' || buf[i] == '\n') {
-					buf[i] = 0;
-					char *c = buf + lastLine;
-					while (*c == ' ' || *c == '\t')
-						++ c;
-					//FIXME check the return value and exit on error?
-					// Will it break parsing of some obj files?
-					obj_parseline(c, data);
-
-					/*for ml*/
-					if (lineCount == 0) { data.ml_region = parsemlinfo(c, "region:");}
-                    if (lineCount == 1) { data.ml_name = parsemlinfo(c, "ml_name:"); }
-					if (lineCount == 2) { data.ml_id = parsemlinfo(c, "ml_file_id:");}
-
-					++lineCount;
-					lastLine = i + 1;
-				}
-			lenPrev = len - lastLine;
-			if (lenPrev > 65536) {
-		    	BOOST_LOG_TRIVIAL(error) << "ObjParser: Excessive line length";
-				::fclose(pFile);
-				return false;
+		boost::filesystem::path file_path(path);
+		boost::system::error_code ec;
+		const uintmax_t file_size = boost::filesystem::file_size(file_path, ec);
+		if (ec)
+			return false;
+		if (file_size == 0)
+			// Empty files cannot be mapped.
+			return true;
+		boost::iostreams::mapped_file_source file(file_path);
+		const char *begin = file.data();
+		const char *end   = begin + file.size();
+		auto        is_eol = [](char c) { return c == '\r' || c == '\n'; };
+
+		/*for ml*/
+		{
+			std::string line;
+			const char *c = begin;
+			for (int line_idx = 0; line_idx < 3; ++ line_idx) {
+				const char *line_end = std::find_if(c, end, is_eol);
+				if (line_end == end)
+					break;
+				while (c != line_end && (*c == ' ' || *c == '\t'))
+					++ c;
+				line.assign(c, line_end);
+				if (line_idx == 0) { data.ml_region = parsemlinfo(line.c_str(), "region:"); }
+				if (line_idx == 1) { data.ml_name = parsemlinfo(line.c_str(), "ml_name:"); }
+				if (line_idx == 2) { data.ml_id = parsemlinfo(line.c_str(), "ml_file_id:"); }
+				c = line_end + 1;
+#ifdef _WIN32
+				// The file used to be read in the text mode, where "\r\n" is a single line end.
+				if (*line_end == '\r' && c != end && *c == '\n')
+					++ c;
+#endif // _WIN32
 			}
-			memmove(buf, buf + lastLine, lenPrev);
 		}
+
+		// Split the file into chunks of at least 1 MB, each chunk ending after a line end.
+		const size_t             num_chunks = std::clamp<size_t>(file.size() >> 20, 1, 4096);
+		std::vector<const char*> chunk_ends;
+		for (size_t i = 1; i < num_chunks; ++ i) {
+			const char *chunk_end = std::find_if(std::max(begin + file.size() * i / num_chunks, chunk_ends.empty() ? begin : chunk_ends.back()), end, is_eol);
+			if (chunk_end == end)
+				break;
+			chunk_ends.emplace_back(chunk_end + 1);
+		}
+		chunk_ends.emplace_back(end);
+
+		std::vector<ObjData>         chunks(chunk_ends.size());
+		std::vector<ObjChunkIndices> chunk_indices(chunk_ends.size());
+		std::vector<char>            chunk_ok(chunk_ends.size(), true);
+		tbb::parallel_for(size_t(0), chunk_ends.size(), [&](size_t i) {
+			chunk_ok[i] = obj_parsechunk(i == 0 ? begin : chunk_ends[i - 1], chunk_ends[i], chunks[i], chunk_indices[i]);
+		});
+		if (std::find(chunk_ok.begin(), chunk_ok.end(), false) != chunk_ok.end())
+			return false;
+
+		for (size_t i = 0; i < chunks.size(); ++ i)
+			obj_appendchunk(data, std::move(chunks[i]), chunk_indices[i]);
     }
     catch (std::bad_alloc&) {
     	BOOST_LOG_TRIVIAL(error) << "ObjParser: Out of memory";
 	}
-	::fclose(pFile);
+	catch (std::exception &ex) {
+		BOOST_LOG_TRIVIAL(error) << "ObjParser: Failed to read " << path << ": " << ex.what();
+		return false;
+	}
 	return true;
 }
 
@@ -705,7 +883,7 @@ bool objparse(std::istream &stream, ObjData &data)
                     char *c = buf + lastLine;
                     while (*c == ' ' || *c == '\t')
                         ++ c;
-                    obj_parseline(c, data);
+                    obj_parseline(c, buf + i, data);
 
                     /*for ml*/
                     if (lastLine < 3) {
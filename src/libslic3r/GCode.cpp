@@ -53,7 +53,7 @@
     using slic3r_tbb_filtermode = tbb::filter;
 #endif
 
-#include <Shiny/Shiny.h>
+#include "Profiler.hpp"
 
 #include "miniz_extension.hpp"
 
@@ -1570,8 +1570,6 @@ BoundingBoxf GCode::first_layer_projection(const Print& print) const
 
 void GCode::do_export(Print* print, const char* path, GCodeProcessorResult* result, ThumbnailsGeneratorCallback thumbnail_cb)
 {
-    PROFILE_CLEAR();
-
     // BBS
     m_curr_print = print;
 
@@ -1586,6 +1584,7 @@ void GCode::do_export(Print* print, const char* path, GCodeProcessorResult* resu
     GCodeProcessor::s_IsBBLPrinter = print->is_BBL_Printer();
     m_writer.set_is_bbl_printer(print->is_BBL_Printer());
     print->set_started(psGCodeExport);
+    SLIC3R_PROFILE_ZONE_CAT("psGCodeExport", "print");
 
     // check if any custom gcode contains keywords used by the gcode processor to
     // produce time estimation and gcode toolpaths
@@ -1736,9 +1735,6 @@ void GCode::do_export(Print* print, const char* path, GCodeProcessorResult* resu
     print->set_done(psGCodeExport);
     //BBS: set enable_label_object
     result->label_object_enabled = m_enable_label_object;
-    // Write the profiler measurements to file
-    PROFILE_UPDATE();
-    PROFILE_OUTPUT(debug_out_path("gcode-export-profile.txt").c_str());
 }
 
 // free functions called by GCode::_do_export()
@@ -2022,7 +2018,7 @@ static BambuBedType to_bambu_bed_type(BedType type)
 
 void GCode::_do_export(Print& print, GCodeOutputStream &file, ThumbnailsGeneratorCallback thumbnail_cb)
 {
-    PROFILE_FUNC();
+    SLIC3R_PROFILE_FUNC();
 
     m_print = &print;
     m_timelapse_pos_picker.init(&print,m_writer.get_xy_offset().cast<coord_t>());
@@ -3196,6 +3192,7 @@ void GCode::process_layers(
                 //BBS
                 check_placeholder_parser_failed();
                 print.throw_if_canceled();
+                SLIC3R_PROFILE_ZONE_CAT("process_layers: generate", "gcode");
                 GCode::LayerResult res = this->process_layer(print, layer.second, layer_tools, &layer == &layers_to_print.back(), &print_object_instances_ordering, tool_ordering.get_most_used_extruder(), size_t(-1));
                 res.gcode_store_pos = layer_to_print_idx - 1;
                 return std::move(res);
@@ -3208,6 +3205,7 @@ void GCode::process_layers(
     }
     const auto spiral_mode = tbb::make_filter<GCode::LayerResult, GCode::LayerResult>(
         slic3r_tbb_filtermode::serial_in_order, [&spiral_mode = *this->m_spiral_vase.get(), & layers_to_print](GCode::LayerResult in) -> GCode::LayerResult {
+            SLIC3R_PROFILE_ZONE_CAT("process_layers: spiral vase", "gcode");
             spiral_mode.enable(in.spiral_vase_enable);
             bool last_layer = in.layer_id == layers_to_print.size() - 1;
             return {spiral_mode.process_layer(std::move(in.gcode), last_layer), in.layer_id, in.spiral_vase_enable, in.cooling_buffer_flush, in.gcode_store_pos};
@@ -3218,6 +3216,7 @@ void GCode::process_layers(
     const auto parsing = tbb::make_filter<GCode::LayerResult, GCode::LayerResult>(slic3r_tbb_filtermode::serial_in_order,
     [&gcode_editer = *this->m_gcode_editer.get(), &layers_extruder_adjustments, object_label](GCode::LayerResult in) -> GCode::LayerResult{
         //record gcode
+        SLIC3R_PROFILE_ZONE_CAT("process_layers: parse", "gcode");
         in.gcode = gcode_editer.process_layer(std::move(in.gcode), in.not_set_additional_fan, in.layer_id, layers_extruder_adjustments[in.gcode_store_pos], object_label, in.cooling_buffer_flush, false);
          return std::move(in);
     });
@@ -3229,6 +3228,7 @@ void GCode::process_layers(
 
     const auto cooling = tbb::make_filter<GCode::LayerResult, GCode::LayerResult>(slic3r_tbb_filtermode::serial_in_order,
     [&cooling_processor, &layers_extruder_adjustments](GCode::LayerResult in) -> GCode::LayerResult {
+        SLIC3R_PROFILE_ZONE_CAT("process_layers: cooling", "gcode");
         in.layer_time = cooling_processor.calculate_layer_slowdown(layers_extruder_adjustments[in.gcode_store_pos]);
          return std::move(in);
     });
@@ -3238,6 +3238,7 @@ void GCode::process_layers(
 
     const auto build_node = tbb::make_filter<GCode::LayerResult, void>(slic3r_tbb_filtermode::serial_in_order,
     [&smooth_calculator, &layers_wall_collection, &layers_extruder_adjustments, object_label, &layers_results](GCode::LayerResult in){
+         SLIC3R_PROFILE_ZONE_CAT("process_layers: build node", "gcode");
          smooth_calculator.build_node(layers_wall_collection[in.gcode_store_pos], object_label, layers_extruder_adjustments[in.gcode_store_pos]);
          layers_results[in.gcode_store_pos] = std::move(in);
          return;
@@ -3246,6 +3247,7 @@ void GCode::process_layers(
     // step 5: rewite
     const auto write_gocde= tbb::make_filter<GCode::LayerResult, std::string>(slic3r_tbb_filtermode::serial_in_order,
     [&gcode_editer = *this->m_gcode_editer.get(), &layers_extruder_adjustments](GCode::LayerResult in) -> std::string {
+         SLIC3R_PROFILE_ZONE_CAT("process_layers: write", "gcode");
          return gcode_editer.write_layer_gcode(std::move(in.gcode), in.not_set_additional_fan, in.layer_id, in.layer_time, layers_extruder_adjustments[in.gcode_store_pos]);
     });
 
@@ -3258,6 +3260,7 @@ void GCode::process_layers(
             fc.stop();
             return{};
         }else{
+             SLIC3R_PROFILE_ZONE_CAT("process_layers: layer time", "gcode");
              if (layer_idx > 0){
                 gcode_res[layer_idx].layer_time = smooth_calculator.recaculate_layer_time(layer_idx, layers_extruder_adjustments[gcode_res[layer_idx].gcode_store_pos]);
              }
@@ -3267,7 +3270,10 @@ void GCode::process_layers(
 
 
     const auto output = tbb::make_filter<std::string, void>(slic3r_tbb_filtermode::serial_in_order,
-    [&output_stream](std::string s) { output_stream.write(s); });
+    [&output_stream](std::string s) {
+        SLIC3R_PROFILE_ZONE_CAT("process_layers: output", "gcode");
+        output_stream.write(s);
+    });
 
     // BBS: apply cooling
     // The pipeline elements are joined using const references, thus no copying is performed.
@@ -3289,7 +3295,10 @@ void GCode::process_layers(
             }
         }
 
-        smooth_calculator.smooth_layer_speed();
+        {
+            SLIC3R_PROFILE_ZONE_CAT("process_layers: smooth speed", "gcode");
+            smooth_calculator.smooth_layer_speed();
+        }
         message = _L("Exporting G-code");
         m_print->set_status(90, message);
         tbb::parallel_pipeline(12, calculate_layer_time & write_gocde & output);
@@ -3335,6 +3344,7 @@ void GCode::process_layers(
                 //BBS
                 check_placeholder_parser_failed();
                 print.throw_if_canceled();
+                SLIC3R_PROFILE_ZONE_CAT("process_layers: generate", "gcode");
                 GCode::LayerResult res = this->process_layer(print, {std::move(layer)}, tool_ordering.tools_for_layer(layer.print_z()), &layer == &layers_to_print.back(), nullptr, tool_ordering.get_most_used_extruder(), single_object_idx, prime_extruder);
                 res.gcode_store_pos = layer_to_print_idx - 1;
                 return std::move(res);
@@ -3347,6 +3357,7 @@ void GCode::process_layers(
     }
     const auto spiral_mode = tbb::make_filter<GCode::LayerResult, GCode::LayerResult>(
         slic3r_tbb_filtermode::serial_in_order, [&spiral_mode = *this->m_spiral_vase.get(), &layers_to_print](GCode::LayerResult in) -> GCode::LayerResult {
+            SLIC3R_PROFILE_ZONE_CAT("process_layers: spiral vase", "gcode");
             spiral_mode.enable(in.spiral_vase_enable);
             bool last_layer = in.layer_id == layers_to_print.size() - 1;
             return {spiral_mode.process_layer(std::move(in.gcode), last_layer), in.layer_id, in.spiral_vase_enable, in.cooling_buffer_flush, in.gcode_store_pos};
@@ -3361,6 +3372,7 @@ void GCode::process_layers(
     const auto parsing = tbb::make_filter<GCode::LayerResult, GCode::LayerResult>(slic3r_tbb_filtermode::serial_in_order,
     [&gcode_editer = *this->m_gcode_editer.get(), &layers_extruder_adjustments, object_label](GCode::LayerResult in) -> GCode::LayerResult{
         //record gcode
+        SLIC3R_PROFILE_ZONE_CAT("process_layers: parse", "gcode");
         in.gcode = gcode_editer.process_layer(std::move(in.gcode), in.not_set_additional_fan, in.layer_id, layers_extruder_adjustments[in.gcode_store_pos], object_label, in.cooling_buffer_flush, false);
          return std::move(in);
     });
@@ -3371,6 +3383,7 @@ void GCode::process_layers(
 
     const auto cooling = tbb::make_filter<GCode::LayerResult, GCode::LayerResult>(slic3r_tbb_filtermode::serial_in_order,
     [&cooling_processor, &layers_extruder_adjustments](GCode::LayerResult in) -> GCode::LayerResult {
+        SLIC3R_PROFILE_ZONE_CAT("process_layers: cooling", "gcode");
         in.layer_time = cooling_processor.calculate_layer_slowdown(layers_extruder_adjustments[in.gcode_store_pos]);
          return std::move(in);
     });
@@ -3380,6 +3393,7 @@ void GCode::process_layers(
 
     const auto build_node = tbb::make_filter<GCode::LayerResult, void>(slic3r_tbb_filtermode::serial_in_order,
     [&smooth_calculator, &layers_wall_collection, &layers_extruder_adjustments, object_label, &layers_results](GCode::LayerResult in){
+         SLIC3R_PROFILE_ZONE_CAT("process_layers: build node", "gcode");
          smooth_calculator.build_node(layers_wall_collection[in.gcode_store_pos], object_label, layers_extruder_adjustments[in.gcode_store_pos]);
          layers_results[in.gcode_store_pos] = std::move(in);
          return;
@@ -3388,6 +3402,7 @@ void GCode::process_layers(
     // step 5: rewite
     const auto write_gocde= tbb::make_filter<GCode::LayerResult, std::string>(slic3r_tbb_filtermode::serial_in_order,
     [&gcode_editer = *this->m_gcode_editer.get(), &layers_extruder_adjustments](GCode::LayerResult in) -> std::string {
+         SLIC3R_PROFILE_ZONE_CAT("process_layers: write", "gcode");
          return gcode_editer.write_layer_gcode(std::move(in.gcode), in.not_set_additional_fan, in.layer_id, in.layer_time, layers_extruder_adjustments[in.gcode_store_pos]);
     });
 
@@ -3401,6 +3416,7 @@ void GCode::process_layers(
             fc.stop();
             return{};
         }else{
+             SLIC3R_PROFILE_ZONE_CAT("process_layers: layer time", "gcode");
              if (layer_idx > 0) {
                 gcode_res[layer_idx].layer_time = smooth_calculator.recaculate_layer_time(layer_idx, layers_extruder_adjustments[gcode_res[layer_idx].gcode_store_pos]);
              }
@@ -3410,7 +3426,10 @@ void GCode::process_layers(
 
 
     const auto output = tbb::make_filter<std::string, void>(slic3r_tbb_filtermode::serial_in_order,
-    [&output_stream](std::string s) { output_stream.write(s); });
+    [&output_stream](std::string s) {
+        SLIC3R_PROFILE_ZONE_CAT("process_layers: output", "gcode");
+        output_stream.write(s);
+    });
 
     // BBS: apply cooling
     // The pipeline elements are joined using const references, thus no copying is performed.
@@ -3431,7 +3450,10 @@ void GCode::process_layers(
             }
         }
 
-        smooth_calculator.smooth_layer_speed();
+        {
+            SLIC3R_PROFILE_ZONE_CAT("process_layers: smooth speed", "gcode");
+            smooth_calculator.smooth_layer_speed();
+        }
 
         tbb::parallel_pipeline(12, calculate_layer_time & write_gocde & output);
     }
@@ -5382,6 +5404,10 @@ std::string GCode::extrude_perimeters(const Print &print, const std::vector<Obje
     return gcode;
 }
 
+// Ironing and the top surface infill may consist of many short extrusions, their greedy chaining is refined by 2-opt.
+// The time budget bounds the cost per chained collection.
+static const ChainingParams dense_infill_chaining { ChainingParams::Refinement::TwoOpt, 0.05 };
+
 // Chain the paths hierarchically by a greedy algorithm to minimize a travel distance.
 std::string GCode::extrude_infill(const Print &print, const std::vector<ObjectByExtruder::Island::Region> &by_region, bool ironing)
 {
@@ -5397,11 +5423,12 @@ std::string GCode::extrude_infill(const Print &print, const std::vector<ObjectBy
                     extrusions.emplace_back(ee);
             if (! extrusions.empty()) {
                 m_config.apply(print.get_print_region(&region - &by_region.front()).config());
-                chain_and_reorder_extrusion_entities(extrusions, &m_last_pos);
+                chain_and_reorder_extrusion_entities(extrusions, &m_last_pos, ironing ? dense_infill_chaining : ChainingParams{});
                 for (const ExtrusionEntity *fill : extrusions) {
                     auto *eec = dynamic_cast<const ExtrusionEntityCollection*>(fill);
                     if (eec) {
-                        for (ExtrusionEntity *ee : eec->chained_path_from(m_last_pos).entities)
+                        for (ExtrusionEntity *ee : eec->chained_path_from(m_last_pos, erMixed,
+                                 eec->role() == erTopSolidInfill ? dense_infill_chaining : ChainingParams{}).entities)
                             gcode += this->extrude_entity(*ee, extrusion_name);
                     } else
                         gcode += this->extrude_entity(*fill, extrusion_name);
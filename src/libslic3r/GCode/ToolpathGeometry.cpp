@@ -0,0 +1,111 @@
+#include "ToolpathGeometry.hpp"
+
+#include <cmath>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
+namespace Slic3r {
+
+std::vector<ToolpathLayer> toolpath_layers(const GCodeProcessorResult &result)
+{
+    std::vector<ToolpathLayer> layers;
+    if (! result.spiral_vase_layers.empty()) {
+        layers.reserve(result.spiral_vase_layers.size());
+        for (const auto &layer : result.spiral_vase_layers)
+            layers.push_back({ double(layer.first), layer.second.first, layer.second.second });
+        return layers;
+    }
+
+    size_t last_travel_sid = 0;
+    size_t seams_count     = 0;
+    for (size_t i = 0; i < result.moves.size(); ++ i) {
+        const GCodeProcessorResult::MoveVertex &move = result.moves[i];
+        if (move.type == EMoveType::Seam)
+            ++ seams_count;
+        const size_t sid = i - seams_count;
+        if (move.type == EMoveType::Extrude) {
+            const double z = double(move.position.z());
+            if (layers.empty() || std::abs(z - layers.back().z) > EPSILON)
+                layers.push_back({ z, last_travel_sid, sid });
+            else
+                layers.back().last_sid = sid;
+        } else if (move.type == EMoveType::Travel) {
+            if (sid > last_travel_sid && ! layers.empty())
+                layers.back().last_sid = sid;
+            last_travel_sid = sid;
+        }
+    }
+    return layers;
+}
+
+static uint32_t add_vertex(ToolpathLayerGeometry &out, size_t move_id, const GCodeProcessorResult::MoveVertex &move)
+{
+    const uint32_t vertex_id = uint32_t(out.vertices.size());
+    ToolpathVertex vertex;
+    vertex.move_id = uint32_t(move_id);
+    // The wipe moves are shown half of their height up.
+    const float z_offset = move.type == EMoveType::Wipe ? 0.5f * GCodeProcessor::Wipe_Height : 0.f;
+    auto add_position = [&out, &vertex, vertex_id, z_offset](const Vec3f &position) {
+        vertex.positions.emplace_back(uint32_t(out.positions.size()));
+        out.positions.push_back({ position + Vec3f(0.f, 0.f, z_offset), vertex_id });
+    };
+    if (move.is_arc_move_with_interpolation_points()) {
+        vertex.positions.reserve(move.interpolation_points.size() + 1);
+        for (const Vec3f &position : move.interpolation_points)
+            add_position(position);
+    }
+    add_position(move.position);
+    out.vertices.emplace_back(std::move(vertex));
+    return vertex_id;
+}
+
+ToolpathLayerGeometry build_toolpath_layer_geometry(const GCodeProcessorResult &result, const ToolpathLayer &layer,
+    const std::vector<size_t> &sid_to_move_id, const std::vector<std::vector<size_t>> &sid_to_seam_move_ids)
+{
+    ToolpathLayerGeometry out;
+    if (layer.first_sid > layer.last_sid)
+        return out;
+
+    const size_t num_moves = layer.last_sid - layer.first_sid + 1;
+    // Vertex of each move of the layer and the vertices of the seams following it.
+    std::vector<uint32_t>              sid_vertices(num_moves);
+    std::vector<std::vector<uint32_t>> sid_seam_vertices(num_moves);
+    out.vertices.reserve(num_moves);
+    out.positions.reserve(num_moves);
+    for (size_t sid = layer.first_sid; sid <= layer.last_sid; ++ sid) {
+        const size_t                            move_id = sid_to_move_id[sid];
+        const GCodeProcessorResult::MoveVertex &move    = result.moves[move_id];
+        if (move.type == EMoveType::Pause_Print || move.type == EMoveType::Custom_GCode)
+            out.has_custom_options = true;
+        sid_vertices[sid - layer.first_sid] = add_vertex(out, move_id, move);
+        for (size_t seam_move_id : sid_to_seam_move_ids[sid])
+            sid_seam_vertices[sid - layer.first_sid].emplace_back(add_vertex(out, seam_move_id, result.moves[seam_move_id]));
+    }
+
+    // A segment ends at each move but the first one, the seams are shown as single points.
+    out.segments.reserve(num_moves);
+    auto add_segment = [&out, &result](uint32_t first_vertex, uint32_t second_vertex) {
+        const GCodeProcessorResult::MoveVertex &move = result.moves[out.vertices[second_vertex].move_id];
+        out.segments.push_back({ first_vertex, second_vertex, move.type, move.extrusion_role, uint16_t(move.extruder_id) });
+    };
+    for (size_t i = 1; i < num_moves; ++ i) {
+        add_segment(sid_vertices[i - 1], sid_vertices[i]);
+        for (uint32_t seam_vertex : sid_seam_vertices[i])
+            add_segment(seam_vertex, seam_vertex);
+    }
+    return out;
+}
+
+std::vector<ToolpathLayerGeometry> build_toolpath_geometry(const GCodeProcessorResult &result, const std::vector<ToolpathLayer> &layers,
+    const std::vector<size_t> &sid_to_move_id, const std::vector<std::vector<size_t>> &sid_to_seam_move_ids)
+{
+    std::vector<ToolpathLayerGeometry> out(layers.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, layers.size()), [&](const tbb::blocked_range<size_t> &range) {
+        for (size_t layer_id = range.begin(); layer_id < range.end(); ++ layer_id)
+            out[layer_id] = build_toolpath_layer_geometry(result, layers[layer_id], sid_to_move_id, sid_to_seam_move_ids);
+    });
+    return out;
+}
+
+} // namespace Slic3r
@@ -0,0 +1,74 @@
+// Geometry of the G-code preview built on the CPU from a GCodeProcessorResult, independently of OpenGL,
+// so that the layers may be built in parallel, tested and benchmarked without a GPU.
+
+#ifndef slic3r_ToolpathGeometry_hpp_
+#define slic3r_ToolpathGeometry_hpp_
+
+#include "../libslic3r.h"
+#include "GCodeProcessor.hpp"
+
+#include <vector>
+
+namespace Slic3r {
+
+// Layer of the G-code preview. The moves are addressed by their sequential ids, which do not count the seam moves.
+struct ToolpathLayer
+{
+    double z;
+    // Sequential ids of the first and of the last move of the layer, both inclusive.
+    size_t first_sid;
+    size_t last_sid;
+};
+
+// Splits the moves into layers. A new layer is started by an extrusion at a different height only, so that the travels
+// lifted by a z hop stay in their layer. A layer starts with the travel preceding its first extrusion and it is extended
+// up to the travels following its last extrusion. The layers of a spiral vase are taken from the G-code processor,
+// as the height of a spiral vase changes with every extrusion.
+std::vector<ToolpathLayer> toolpath_layers(const GCodeProcessorResult &result);
+
+// Vertex of the preview at the end of a move. The vertex of an interpolated arc move owns several positions.
+struct ToolpathVertex
+{
+    uint32_t              move_id { uint32_t(-1) };
+    // Indices into ToolpathLayerGeometry::positions.
+    std::vector<uint32_t> positions;
+};
+
+// Move of the preview connecting two vertices of a layer, indices into ToolpathLayerGeometry::vertices.
+struct ToolpathSegment
+{
+    uint32_t      first_vertex  { uint32_t(-1) };
+    uint32_t      second_vertex { uint32_t(-1) };
+    EMoveType     type          { EMoveType::Count };
+    ExtrusionRole role          { erCount };
+    uint16_t      extruder_id   { UINT16_MAX };
+};
+
+struct ToolpathPosition
+{
+    Vec3f    position;
+    // Index into ToolpathLayerGeometry::vertices.
+    uint32_t vertex { 0 };
+};
+
+struct ToolpathLayerGeometry
+{
+    std::vector<ToolpathVertex>   vertices;
+    std::vector<ToolpathPosition> positions;
+    std::vector<ToolpathSegment>  segments;
+    // The layer contains a pause or a custom G-code.
+    bool                          has_custom_options { false };
+};
+
+// Geometry of a single layer. sid_to_move_id maps the sequential ids to the indices of GCodeProcessorResult::moves,
+// sid_to_seam_move_ids lists the seam moves following a move. Thread safe.
+ToolpathLayerGeometry build_toolpath_layer_geometry(const GCodeProcessorResult &result, const ToolpathLayer &layer,
+    const std::vector<size_t> &sid_to_move_id, const std::vector<std::vector<size_t>> &sid_to_seam_move_ids);
+
+// Geometry of all the layers, built in parallel.
+std::vector<ToolpathLayerGeometry> build_toolpath_geometry(const GCodeProcessorResult &result, const std::vector<ToolpathLayer> &layers,
+    const std::vector<size_t> &sid_to_move_id, const std::vector<std::vector<size_t>> &sid_to_seam_move_ids);
+
+} // namespace Slic3r
+
+#endif /* slic3r_ToolpathGeometry_hpp_ */
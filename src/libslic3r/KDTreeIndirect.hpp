@@ -15,6 +15,8 @@ enum class VisitorReturnMask : unsigned int {
     CONTINUE_LEFT  = 1,
     CONTINUE_RIGHT = 2,
     STOP           = 4,
+    // Visit the right subtree before the left one.
+    RIGHT_FIRST    = 8,
 };
 
 // KD tree for N-dimensional closest point search.
@@ -64,7 +66,9 @@ public:
         CoordType dist = point_coord - this->coordinate(idx, dimension);
         return (dist * dist < search_radius + CoordType(EPSILON)) ?
                                                                     // The plane intersects a hypersphere centered at point_coord of search_radius.
-                   ((unsigned int)(VisitorReturnMask::CONTINUE_LEFT) | (unsigned int)(VisitorReturnMask::CONTINUE_RIGHT)) :
+                                                                    // Visit the side of point_coord first, so that the closest point searches shrink their radius sooner.
+                   ((unsigned int)(VisitorReturnMask::CONTINUE_LEFT) | (unsigned int)(VisitorReturnMask::CONTINUE_RIGHT) |
+                    (dist > CoordType(0) ? (unsigned int)(VisitorReturnMask::RIGHT_FIRST) : 0u)) :
                    // The plane does not intersect the hypersphere.
                    (dist > CoordType(0)) ? (unsigned int)(VisitorReturnMask::CONTINUE_RIGHT) : (unsigned int)(VisitorReturnMask::CONTINUE_LEFT);
     }
@@ -179,9 +183,15 @@ private:
         unsigned int mask = visitor(m_nodes[node], dimension);
         if ((mask & (unsigned int)VisitorReturnMask::STOP) == 0) {
             size_t next_dimension = (++ dimension == NumDimensions) ? 0 : dimension;
-            if (mask & (unsigned int)VisitorReturnMask::CONTINUE_LEFT)
+            unsigned int left_mask  = (unsigned int)VisitorReturnMask::CONTINUE_LEFT;
+            unsigned int right_mask = (unsigned int)VisitorReturnMask::CONTINUE_RIGHT;
+            if (mask & (unsigned int)VisitorReturnMask::RIGHT_FIRST) {
+                std::swap(left, right);
+                std::swap(left_mask, right_mask);
+            }
+            if (mask & left_mask)
                 visit_recursive(left,  next_dimension, visitor);
-            if (mask & (unsigned int)VisitorReturnMask::CONTINUE_RIGHT)
+            if (mask & right_mask)
                 visit_recursive(right, next_dimension, visitor);
         }
     }
@@ -238,8 +248,9 @@ std::array<size_t, K> find_closest_points(
                     *it = res;
                 }
             }
+            // Search up to the K-th closest point found so far, otherwise farther points would be missed for K > 1.
             return kdtree.descent_mask(point[dimension],
-                                       results.front().second, idx,
+                                       results.back().second, idx,
                                        dimension);
         }
     } visitor(kdtree, point, filter);
@@ -29,6 +29,12 @@
 #include "mcut/include/mcut/mcut.h"
 #include "boost/log/trivial.hpp"
 
+#include <atomic>
+#include <numeric>
+
+#include <tbb/blocked_range.h>
+#include <tbb/parallel_for.h>
+
 namespace Slic3r {
 namespace MeshBoolean {
 
@@ -271,15 +277,20 @@ static bool _cgal_intersection(CGALMesh &A, CGALMesh &B, CGALMesh &R)
     return CGALProc::corefine_and_compute_intersection(A.m, B.m, R.m, p, p);
 }
 
-template<class Op> void _cgal_do(Op &&op, CGALMesh &A, CGALMesh &B)
+// try_catch_signal() replaces the process wide signal handlers, thus it must not be used by several threads at once.
+// The booleans running in parallel pass catch_signals = false and only handle the exceptions thrown by CGAL.
+template<class Op> void _cgal_do(Op &&op, CGALMesh &A, CGALMesh &B, bool catch_signals = true)
 {
     bool success = false;
     bool hw_fail = false;
     try {
         CGALMesh result;
-        try_catch_signal({SIGSEGV, SIGFPE}, [&success, &A, &B, &result, &op] {
+        if (catch_signals)
+            try_catch_signal({SIGSEGV, SIGFPE}, [&success, &A, &B, &result, &op] {
+                success = op(A, B, result);
+            }, [&] { hw_fail = true; });
+        else
             success = op(A, B, result);
-        }, [&] { hw_fail = true; });
         A = std::move(result);      // In-place operation does not work
     } catch (...) {
         success = false;
@@ -402,58 +413,197 @@ TriangleMesh merge(std::vector<TriangleMesh> meshes)
     return cgal_to_triangle_mesh(dst);
 }
 
-template<class Op> void _mesh_boolean_do(Op &&op, indexed_triangle_set &A, const indexed_triangle_set &B)
+// /////////////////////////////////////////////////////////////////////////////
+// Boolean operations on triangle meshes, split into independent parts
+// /////////////////////////////////////////////////////////////////////////////
+
+enum class BooleanOp { Difference, Union, Intersection };
+
+static bool _cgal_op(BooleanOp op, CGALMesh &A, CGALMesh &B, CGALMesh &R)
+{
+    switch (op) {
+    case BooleanOp::Difference:   return _cgal_diff(A, B, R);
+    case BooleanOp::Union:        return _cgal_union(A, B, R);
+    case BooleanOp::Intersection: return _cgal_intersection(A, B, R);
+    }
+    return false;
+}
+
+static indexed_triangle_set _cgal_boolean(BooleanOp op, const indexed_triangle_set &A, const indexed_triangle_set &B, bool catch_signals)
 {
     CGALMesh meshA;
     CGALMesh meshB;
     triangle_mesh_to_cgal(A.vertices, A.indices, meshA.m);
     triangle_mesh_to_cgal(B.vertices, B.indices, meshB.m);
 
-    _cgal_do(op, meshA, meshB);
+    _cgal_do([op](CGALMesh &A, CGALMesh &B, CGALMesh &R) { return _cgal_op(op, A, B, R); }, meshA, meshB, catch_signals);
 
-    A = cgal_to_indexed_triangle_set(meshA.m);
+    return cgal_to_indexed_triangle_set(meshA.m);
 }
 
-template<class Op> void _mesh_boolean_do(Op &&op, TriangleMesh &A, const TriangleMesh &B)
+// The boolean kernel throws on self intersecting input, see _cgal_diff(). Parts not passed to the kernel
+// are checked the same way, so that the result does not depend on the placement of the parts.
+static void _cgal_check_input(const indexed_triangle_set &its)
 {
-    CGALMesh meshA;
-    CGALMesh meshB;
-    triangle_mesh_to_cgal(A.its.vertices, A.its.indices, meshA.m);
-    triangle_mesh_to_cgal(B.its.vertices, B.its.indices, meshB.m);
+    CGALMesh mesh;
+    triangle_mesh_to_cgal(its.vertices, its.indices, mesh.m);
+    if (CGALProc::does_self_intersect(mesh.m))
+        throw Slic3r::RuntimeError("CGAL mesh boolean operation failed.");
+}
 
-    _cgal_do(op, meshA, meshB);
+// Group of connected components of a mesh. Bounding boxes of the clusters of a mesh do not overlap,
+// therefore a component nested inside another component (for example the inner wall of a hollowed object)
+// always shares the cluster with the enclosing component. The bounding boxes are inflated by EPSILON,
+// so that parts touching each other are always passed to the boolean kernel together.
+struct MeshCluster {
+    indexed_triangle_set its;
+    BoundingBoxf3        bbox;
+};
 
-    A = cgal_to_triangle_mesh(meshA);
+static std::vector<MeshCluster> _split_to_clusters(const indexed_triangle_set &its)
+{
+    std::vector<MeshCluster> clusters;
+    for (indexed_triangle_set &part : its_split(its)) {
+        MeshCluster cluster { std::move(part), {} };
+        cluster.bbox = bounding_box(cluster.its).inflated(EPSILON);
+        // Merging two clusters grows the bounding box, which may then overlap another cluster.
+        for (bool merged = true; merged;) {
+            merged = false;
+            for (size_t i = 0; i < clusters.size(); ++ i)
+                if (clusters[i].bbox.intersects(cluster.bbox)) {
+                    its_merge(cluster.its, clusters[i].its);
+                    cluster.bbox.merge(clusters[i].bbox);
+                    if (i + 1 < clusters.size())
+                        clusters[i] = std::move(clusters.back());
+                    clusters.pop_back();
+                    merged = true;
+                    break;
+                }
+        }
+        clusters.emplace_back(std::move(cluster));
+    }
+    return clusters;
+}
+
+// Boolean operation A = A op B. Parts of A and B with non-overlapping bounding boxes do not interact,
+// thus they are either copied to the output or dropped without being passed to CGAL.
+// The remaining groups of overlapping parts are independent of each other and they are processed in parallel,
+// without the hardware crash detection of try_catch_signal(), which is not thread safe.
+static void _mesh_boolean_do(BooleanOp op, indexed_triangle_set &A, const indexed_triangle_set &B)
+{
+    const BoundingBoxf3 bboxA = bounding_box(A);
+    const BoundingBoxf3 bboxB = bounding_box(B);
+    if (! bboxA.defined || ! bboxB.defined || ! bboxA.inflated(EPSILON).intersects(bboxB)) {
+        _cgal_check_input(A);
+        _cgal_check_input(B);
+        switch (op) {
+        case BooleanOp::Difference:   break;
+        case BooleanOp::Union:        its_merge(A, B); break;
+        case BooleanOp::Intersection: A.clear(); break;
+        }
+        return;
+    }
+
+    std::vector<MeshCluster> clustersA = _split_to_clusters(A);
+    std::vector<MeshCluster> clustersB = _split_to_clusters(B);
+    if (clustersA.size() <= 1 && clustersB.size() <= 1) {
+        // Nothing to split, run a single boolean on the input meshes.
+        A = _cgal_boolean(op, A, B, true);
+        return;
+    }
+
+    // Group clusters of A and B transitively connected by overlapping bounding boxes.
+    // Clusters of the same mesh do not overlap, thus only pairs of A and B clusters need to be tested.
+    std::vector<size_t> group(clustersA.size() + clustersB.size());
+    std::iota(group.begin(), group.end(), 0);
+    auto find = [&group](size_t i) {
+        while (group[i] != i)
+            i = group[i] = group[group[i]];
+        return i;
+    };
+    for (size_t i = 0; i < clustersA.size(); ++ i)
+        for (size_t j = 0; j < clustersB.size(); ++ j)
+            if (clustersA[i].bbox.intersects(clustersB[j].bbox))
+                group[find(clustersA.size() + j)] = find(i);
+
+    struct Group {
+        indexed_triangle_set A;
+        indexed_triangle_set B;
+    };
+    std::vector<Group>  groups;
+    std::vector<size_t> group_idx(group.size(), size_t(-1));
+    for (size_t i = 0; i < group.size(); ++ i) {
+        size_t root = find(i);
+        if (group_idx[root] == size_t(-1)) {
+            group_idx[root] = groups.size();
+            groups.emplace_back();
+        }
+        Group &g = groups[group_idx[root]];
+        if (i < clustersA.size())
+            its_merge(g.A, clustersA[i].its);
+        else
+            its_merge(g.B, clustersB[i - clustersA.size()].its);
+    }
+    clustersA.clear();
+    clustersB.clear();
+
+    std::vector<indexed_triangle_set> results(groups.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, groups.size(), 1), [op, &groups, &results](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i) {
+            Group &g = groups[i];
+            if (g.A.empty() || g.B.empty()) {
+                // An isolated part of A or B.
+                _cgal_check_input(g.A.empty() ? g.B : g.A);
+                if (op == BooleanOp::Union)
+                    results[i] = std::move(g.A.empty() ? g.B : g.A);
+                else if (op == BooleanOp::Difference)
+                    results[i] = std::move(g.A);
+            } else
+                results[i] = _cgal_boolean(op, g.A, g.B, false);
+        }
+    });
+
+    A.clear();
+    for (const indexed_triangle_set &result : results)
+        its_merge(A, result);
+}
+
+static void _mesh_boolean_do(BooleanOp op, TriangleMesh &A, const TriangleMesh &B)
+{
+    // Work on a copy, A is left intact if the boolean operation throws.
+    indexed_triangle_set its = A.its;
+    _mesh_boolean_do(op, its, B.its);
+    A = TriangleMesh(std::move(its));
 }
 
 void minus(TriangleMesh &A, const TriangleMesh &B)
 {
-    _mesh_boolean_do(_cgal_diff, A, B);
+    _mesh_boolean_do(BooleanOp::Difference, A, B);
 }
 
 void plus(TriangleMesh &A, const TriangleMesh &B)
 {
-    _mesh_boolean_do(_cgal_union, A, B);
+    _mesh_boolean_do(BooleanOp::Union, A, B);
 }
 
 void intersect(TriangleMesh &A, const TriangleMesh &B)
 {
-    _mesh_boolean_do(_cgal_intersection, A, B);
+    _mesh_boolean_do(BooleanOp::Intersection, A, B);
 }
 
 void minus(indexed_triangle_set &A, const indexed_triangle_set &B)
 {
-    _mesh_boolean_do(_cgal_diff, A, B);
+    _mesh_boolean_do(BooleanOp::Difference, A, B);
 }
 
 void plus(indexed_triangle_set &A, const indexed_triangle_set &B)
 {
-    _mesh_boolean_do(_cgal_union, A, B);
+    _mesh_boolean_do(BooleanOp::Union, A, B);
 }
 
 void intersect(indexed_triangle_set &A, const indexed_triangle_set &B)
 {
-    _mesh_boolean_do(_cgal_intersection, A, B);
+    _mesh_boolean_do(BooleanOp::Intersection, A, B);
 }
 
 bool does_self_intersect(const TriangleMesh &mesh)
@@ -480,6 +630,21 @@ CGALMeshPtr clone(const CGALMesh &m)
     return CGALMeshPtr{new CGALMesh{m}};
 }
 
+BoundingBoxf3 get_extents(const CGALMesh &mesh)
+{
+    BoundingBoxf3 bbox;
+    for (const auto &vi : mesh.m.vertices()) {
+        const auto &p = mesh.m.point(vi);
+        bbox.merge(Vec3d(p.x(), p.y(), p.z()));
+    }
+    return bbox;
+}
+
+void join(CGALMesh &A, const CGALMesh &B)
+{
+    A.m.join(B.m);
+}
+
 } // namespace cgal
 
 
@@ -497,6 +662,24 @@ struct McutMesh
 void McutMeshDeleter::operator()(McutMesh *ptr) { delete ptr; }
 
 bool empty(const McutMesh &mesh) { return mesh.vertexCoordsArray.empty() || mesh.faceIndicesArray.empty(); }
+
+BoundingBoxf3 get_extents(const McutMesh &mesh)
+{
+    BoundingBoxf3 bbox;
+    for (size_t i = 0; i + 2 < mesh.vertexCoordsArray.size(); i += 3)
+        bbox.merge(Vec3d(mesh.vertexCoordsArray[i], mesh.vertexCoordsArray[i + 1], mesh.vertexCoordsArray[i + 2]));
+    return bbox;
+}
+
+void join(McutMesh &A, const McutMesh &B)
+{
+    const uint32_t vertex_offset = uint32_t(A.vertexCoordsArray.size() / 3);
+    A.vertexCoordsArray.insert(A.vertexCoordsArray.end(), B.vertexCoordsArray.begin(), B.vertexCoordsArray.end());
+    A.faceSizesArray.insert(A.faceSizesArray.end(), B.faceSizesArray.begin(), B.faceSizesArray.end());
+    A.faceIndicesArray.reserve(A.faceIndicesArray.size() + B.faceIndicesArray.size());
+    for (uint32_t idx : B.faceIndicesArray)
+        A.faceIndicesArray.emplace_back(idx + vertex_offset);
+}
 void triangle_mesh_to_mcut(const TriangleMesh &src_mesh, McutMesh &srcMesh, const Transform3d &src_nm = Transform3d::Identity())
 {
     // vertices precision convention and copy
@@ -839,9 +1022,26 @@ bool do_boolean(McutMesh& srcMesh, const McutMesh& cutMesh, const std::string& b
         // when src mesh has multiple connected components, mcut refuses to work.
         // But we can force it to work by spliting the src mesh into disconnected components,
         // and do booleans seperately, then merge all the results.
-        indexed_triangle_set all_its;
-        const auto total_count = src_parts.size() * cut_parts.size();
-        int count_index = 0;
+        // Pairs of parts with non-overlapping bounding boxes do not interact, they are not passed to mcut.
+        std::vector<BoundingBoxf3> src_bboxes(src_parts.size());
+        std::vector<BoundingBoxf3> cut_bboxes(cut_parts.size());
+        for (size_t i = 0; i < src_parts.size(); ++ i)
+            src_bboxes[i] = bounding_box(src_parts[i]).inflated(EPSILON);
+        for (size_t j = 0; j < cut_parts.size(); ++ j)
+            cut_bboxes[j] = bounding_box(cut_parts[j]);
+        // Indices of the cut parts overlapping each src part.
+        std::vector<std::vector<size_t>> overlapping(src_parts.size());
+        std::vector<bool>                cut_overlaps_src(cut_parts.size(), false);
+        size_t                           total_count = 0;
+        for (size_t i = 0; i < src_parts.size(); ++ i)
+            for (size_t j = 0; j < cut_parts.size(); ++ j)
+                if (src_bboxes[i].intersects(cut_bboxes[j])) {
+                    overlapping[i].emplace_back(j);
+                    cut_overlaps_src[j] = true;
+                    ++ total_count;
+                }
+
+        std::atomic<int>  count_index { 0 };
         BooleanProgressCB temp_progress_cb = nullptr;
         if (progress_cb) {
             temp_progress_cb = [&](float progress)->void {
@@ -851,25 +1051,31 @@ bool do_boolean(McutMesh& srcMesh, const McutMesh& cutMesh, const std::string& b
                 }
             };
         }
-        if (boolean_opts == "UNION" || boolean_opts == "A_NOT_B") {
-            for (size_t i = 0; i < src_parts.size(); i++) {
+        std::atomic<bool> canceled { false };
+        // Result of the booleans of a single src part.
+        std::vector<indexed_triangle_set> src_results(src_parts.size());
+        auto process_src_part = [&](size_t i) {
+            if (boolean_opts == "UNION" || boolean_opts == "A_NOT_B") {
+                if (overlapping[i].empty()) {
+                    src_results[i] = std::move(src_parts[i]);
+                    return;
+                }
                 auto src_part = triangle_mesh_to_mcut(src_parts[i]);
-                for (size_t j = 0; j < cut_parts.size(); j++) {
-                    if (cancel_cb && cancel_cb()) {
-                        return false;
+                for (size_t j : overlapping[i]) {
+                    if (canceled || (cancel_cb && cancel_cb())) {
+                        canceled = true;
+                        return;
                     }
                     auto cut_part = triangle_mesh_to_mcut(cut_parts[j]);
                     do_boolean_single(*src_part, *cut_part, boolean_opts, cancel_cb, temp_progress_cb);
                     ++count_index;
                 }
-                TriangleMesh tri_part = mcut_to_triangle_mesh(*src_part);
-                its_merge(all_its, tri_part.its);
-            }
-        } else if (boolean_opts == "INTERSECTION") {
-            for (size_t i = 0; i < src_parts.size(); i++) {
-                for (size_t j = 0; j < cut_parts.size(); j++) {
-                    if (cancel_cb && cancel_cb()) {
-                        return false;
+                src_results[i] = mcut_to_triangle_mesh(*src_part).its;
+            } else if (boolean_opts == "INTERSECTION") {
+                for (size_t j : overlapping[i]) {
+                    if (canceled || (cancel_cb && cancel_cb())) {
+                        canceled = true;
+                        return;
                     }
                     ++count_index;
                     auto src_part = triangle_mesh_to_mcut(src_parts[i]);
@@ -877,11 +1083,33 @@ bool do_boolean(McutMesh& srcMesh, const McutMesh& cutMesh, const std::string& b
                     bool success  = do_boolean_single(*src_part, *cut_part, boolean_opts, cancel_cb, temp_progress_cb);
                     if (success) {
                         TriangleMesh tri_part = mcut_to_triangle_mesh(*src_part);
-                        its_merge(all_its, tri_part.its);
+                        its_merge(src_results[i], tri_part.its);
                     }
                 }
             }
+        };
+        if (cancel_cb || progress_cb) {
+            // The callbacks are not required to be thread safe, process the parts serially.
+            for (size_t i = 0; i < src_parts.size() && ! canceled; ++ i)
+                process_src_part(i);
+        } else {
+            // Each mcut boolean runs in its own mcut context, thus the src parts are processed in parallel.
+            tbb::parallel_for(tbb::blocked_range<size_t>(0, src_parts.size(), 1), [&process_src_part](const tbb::blocked_range<size_t> &range) {
+                for (size_t i = range.begin(); i < range.end(); ++ i)
+                    process_src_part(i);
+            });
         }
+        if (canceled)
+            return false;
+
+        indexed_triangle_set all_its;
+        for (const indexed_triangle_set &its : src_results)
+            its_merge(all_its, its);
+        if (boolean_opts == "UNION")
+            // Cut parts not touching any src part are not merged with any src part above.
+            for (size_t j = 0; j < cut_parts.size(); ++ j)
+                if (! cut_overlaps_src[j])
+                    its_merge(all_its, cut_parts[j]);
         srcMesh = *triangle_mesh_to_mcut(all_its);
         return true;
     } catch (const std::exception &e) {
@@ -70,6 +70,10 @@ TriangleMesh merge(std::vector<TriangleMesh> meshes);
 
 bool does_bound_a_volume(const CGALMesh &mesh);
 bool empty(const CGALMesh &mesh);
+
+BoundingBoxf3 get_extents(const CGALMesh &mesh);
+// Append B to A without any boolean operation, to be used if A and B do not intersect.
+void join(CGALMesh &A, const CGALMesh &B);
 }
 
 namespace mcut {
@@ -80,6 +84,9 @@ struct McutMeshDeleter
 };
 using McutMeshPtr = std::unique_ptr<McutMesh, McutMeshDeleter>;
 bool empty(const McutMesh &mesh);
+BoundingBoxf3 get_extents(const McutMesh &mesh);
+// Append B to A without any boolean operation, to be used if A and B do not intersect.
+void join(McutMesh &A, const McutMesh &B);
 
 McutMeshPtr  triangle_mesh_to_mcut(const indexed_triangle_set &M);
 TriangleMesh mcut_to_triangle_mesh(const McutMesh &mcutmesh);
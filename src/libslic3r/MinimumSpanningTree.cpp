@@ -2,7 +2,11 @@
 
 #include <iterator>
 #include <algorithm>
+#include <array>
+#include <numeric>
+#include <queue>
 #include "libslic3r.h"
+#include "KDTreeIndirect.hpp"
 
 namespace Slic3r
 {
@@ -19,6 +23,135 @@ inline double vsize2_with_unscale(const Point pt)
     return dot_with_unscale(pt, pt);
 }
 
+// Dense Prim's algorithm: the candidates not yet in the tree are kept in a flat array together with their distance
+// to the tree, and removed by swapping with the last one. This is O(V*V), but it touches contiguous memory only,
+// which is faster than the KD-tree for small sets of vertices. add_edge(i, j) is called with the vertex i joining the tree.
+template<typename AddEdge>
+static void prim_dense(const std::vector<Point> &vertices, AddEdge add_edge)
+{
+    struct Candidate {
+        Point    point;
+        size_t   vertex;    // Index of point in vertices.
+        coordf_t distance;  // The shortest distance to the current tree.
+        size_t   closest;   // Which vertex of vertices the shortest distance goes towards.
+    };
+    std::vector<Candidate> candidates;
+    candidates.reserve(vertices.size() - 1);
+    for (size_t vertex_index = 1; vertex_index < vertices.size(); ++ vertex_index)
+        candidates.push_back({ vertices[vertex_index], vertex_index, vsize2_with_unscale(vertices[vertex_index] - vertices.front()), 0 });
+
+    while (! candidates.empty())
+    {
+        //Choose the closest vertex to connect to that is not yet in the tree.
+        size_t closest = 0;
+        for (size_t i = 1; i < candidates.size(); ++ i)
+            if (candidates[i].distance < candidates[closest].distance)
+                closest = i;
+
+        //Add this point to the graph and remove it from the candidates.
+        const Point  closest_point  = candidates[closest].point;
+        const size_t closest_vertex = candidates[closest].vertex;
+        add_edge(closest_vertex, candidates[closest].closest);
+        candidates[closest] = candidates.back();
+        candidates.pop_back();
+
+        //Update the distances of all points that are not in the graph.
+        for (Candidate &candidate : candidates) {
+            const coordf_t new_distance = vsize2_with_unscale(closest_point - candidate.point);
+            if (new_distance < candidate.distance) //New point is closer.
+            {
+                candidate.distance = new_distance;
+                candidate.closest  = closest_vertex;
+            }
+        }
+    }
+}
+
+// Prim's algorithm with the candidate edges leaving the tree taken from the closest neighbors of each vertex, found
+// by a KD-tree, instead of updating the distances of all the vertices outside of the tree after each step.
+// Each vertex of the tree keeps a single candidate edge in the queue, towards its closest neighbor outside of the tree.
+// Once all the closest neighbors of a vertex joined the tree, the distance of the farthest one is a lower bound of its
+// candidate edge. The vertex outside of the tree is then searched for by a filtered KD-tree query, when that lower bound
+// gets to the top of the queue. As the vertices outside of the tree only get fewer, a candidate never gets shorter,
+// thus the shortest candidate is the shortest edge leaving the tree once its other end is verified to be outside of the tree.
+template<typename AddEdge>
+static void prim_kdtree(const std::vector<Point> &vertices, AddEdge add_edge)
+{
+    static constexpr const size_t num_neighbors = 8;
+    std::vector<std::array<size_t, num_neighbors>> neighbors(vertices.size());
+    {
+        auto coordinate_fn = [&vertices](size_t idx, size_t dimension) -> double { return double(vertices[idx][dimension]); };
+        const KDTreeIndirect<2, double, decltype(coordinate_fn)> kdtree(coordinate_fn, vertices.size());
+        for (size_t i = 0; i < vertices.size(); ++ i)
+            neighbors[i] = find_closest_points<num_neighbors>(kdtree, vertices[i].cast<double>(), [i](size_t idx) { return idx != i; });
+    }
+    // Index of the first of neighbors[i] which may be outside of the tree.
+    std::vector<size_t> next_neighbor(vertices.size(), 0);
+    std::vector<bool>   in_tree(vertices.size(), false);
+
+    // The filtered queries search a KD-tree of the vertices outside of the tree, which is rebuilt once half of its vertices
+    // joined the tree, so that the queries do not slow down by visiting the vertices of the tree.
+    std::vector<size_t> outside(vertices.size());
+    std::iota(outside.begin(), outside.end(), 0);
+    auto outside_coordinate_fn = [&vertices, &outside](size_t idx, size_t dimension) -> double { return double(vertices[outside[idx]][dimension]); };
+    using KDTree = KDTreeIndirect<2, double, decltype(outside_coordinate_fn)>;
+    KDTree outside_kdtree(outside_coordinate_fn, outside.size());
+    size_t num_joined = 0;
+    auto find_closest_outside = [&](size_t from) {
+        if (2 * num_joined > outside.size()) {
+            outside.erase(std::remove_if(outside.begin(), outside.end(), [&in_tree](size_t idx) { return in_tree[idx]; }), outside.end());
+            outside_kdtree.build(outside.size());
+            num_joined = 0;
+        }
+        const size_t closest = find_closest_point(outside_kdtree, vertices[from].cast<double>(), [&in_tree, &outside](size_t idx) { return ! in_tree[outside[idx]]; });
+        return closest == KDTree::npos ? closest : outside[closest];
+    };
+
+    struct Candidate {
+        coordf_t distance;
+        size_t   from;  // Vertex of the tree.
+        size_t   to;    // Vertex outside of the tree when the candidate was created, npos if it is to be searched for.
+        bool operator>(const Candidate &rhs) const { return distance > rhs.distance; }
+    };
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> candidates;
+    auto distance = [&vertices](size_t first, size_t second) { return vsize2_with_unscale(vertices[second] - vertices[first]); };
+    auto add_candidate = [&](size_t from) {
+        const std::array<size_t, num_neighbors> &closest = neighbors[from];
+        size_t                                  &next    = next_neighbor[from];
+        while (next < num_neighbors && closest[next] != KDTree::npos && in_tree[closest[next]])
+            ++ next;
+        if (next == num_neighbors)
+            candidates.push({ distance(from, closest.back()), from, KDTree::npos });
+        else if (closest[next] != KDTree::npos)
+            candidates.push({ distance(from, closest[next]), from, closest[next] });
+        // Otherwise there are less than num_neighbors other vertices, all of them already in the tree.
+    };
+
+    in_tree.front() = true;
+    ++ num_joined;
+    add_candidate(0);
+    while (! candidates.empty())
+    {
+        const Candidate candidate = candidates.top();
+        candidates.pop();
+        if (candidate.to == KDTree::npos) {
+            const size_t closest = find_closest_outside(candidate.from);
+            if (closest != KDTree::npos)
+                candidates.push({ distance(candidate.from, closest), candidate.from, closest });
+            continue;
+        }
+        if (! in_tree[candidate.to]) {
+            //Add this point to the graph.
+            add_edge(candidate.to, candidate.from);
+            in_tree[candidate.to] = true;
+            ++ num_joined;
+            add_candidate(candidate.to);
+        }
+        // Either the edge was added or its end already joined the tree, the vertex needs a new candidate.
+        add_candidate(candidate.from);
+    }
+}
+
 MinimumSpanningTree::MinimumSpanningTree(std::vector<Point> vertices) : adjacency_graph(prim(vertices))
 {
     //Just copy over the fields.
@@ -41,59 +174,18 @@ auto MinimumSpanningTree::prim(std::vector<Point> vertices) const -> AdjacencyGr
         return result;
     }
     result.reserve(vertices.size());
-    std::vector<Point> vertices_list(vertices.begin(), vertices.end());
-
-    std::unordered_map<const Point*, coordf_t> smallest_distance;    //The shortest distance to the current tree.
-    std::unordered_map<const Point*, const Point*> smallest_distance_to; //Which point the shortest distance goes towards.
-    smallest_distance.reserve(vertices_list.size());
-    smallest_distance_to.reserve(vertices_list.size());
-    for (size_t vertex_index = 1; vertex_index < vertices_list.size(); vertex_index++)
-    {
-        const auto& vert = vertices_list[vertex_index];
-        smallest_distance[&vert] = vsize2_with_unscale(vert - vertices_list[0]);
-        smallest_distance_to[&vert] = &vertices_list[0];
-    }
-
-    while (result.size() < vertices_list.size()) //All of the vertices need to be in the tree at the end.
-    {
-        //Choose the closest vertex to connect to that is not yet in the tree.
-        //This search is O(V) right now, which can be made down to O(log(V)). This reduces the overall time complexity from O(V*V) to O(V*log(E)).
-        //However that requires an implementation of a heap that supports the decreaseKey operation, which is not in the std library.
-        //TODO: Implement this?
-        using MapValue = std::pair<const Point*, coordf_t>;
-        const auto closest = std::min_element(smallest_distance.begin(), smallest_distance.end(),
-                                              [](const MapValue& a, const MapValue& b) {
-                                                  return a.second < b.second;
-                                              });
-
-        //Add this point to the graph and remove it from the candidates.
-        const Point* closest_point = closest->first;
-        const Point other_end = *smallest_distance_to[closest_point];
-        if (result.find(*closest_point) == result.end())
-        {
-            result[*closest_point] = std::vector<Edge>();
-        }
-        result[*closest_point].push_back({*closest_point, other_end});
-        if (result.find(other_end) == result.end())
-        {
-            result[other_end] = std::vector<Edge>();
-        }
-        result[other_end].push_back({other_end, *closest_point});
-        smallest_distance.erase(closest_point); //Remove it so we don't check for these points again.
-        smallest_distance_to.erase(closest_point);
 
-        //Update the distances of all points that are not in the graph.
-        for (std::pair<const Point*, coordf_t> point_and_distance : smallest_distance)
-        {
-            const coordf_t new_distance = vsize2_with_unscale(*closest_point - *point_and_distance.first);
-            const coordf_t old_distance = point_and_distance.second;
-            if (new_distance < old_distance) //New point is closer.
-            {
-                smallest_distance[point_and_distance.first] = new_distance;
-                smallest_distance_to[point_and_distance.first] = closest_point;
-            }
-        }
-    }
+    auto add_edge = [&vertices, &result](size_t first, size_t second) {
+        const Point &a = vertices[first];
+        const Point &b = vertices[second];
+        result[a].push_back({a, b});
+        result[b].push_back({b, a});
+    };
+    // Below this number of vertices the dense algorithm is faster.
+    if (vertices.size() < 800)
+        prim_dense(vertices, add_edge);
+    else
+        prim_kdtree(vertices, add_edge);
 
     return result;
 }
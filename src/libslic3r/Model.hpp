@@ -816,9 +816,29 @@ private:
     friend class cereal::access;
     friend class UndoRedo::StackImpl;
 
-    template<class Archive> void serialize(Archive &ar)
+    // The triangle IDs and their offsets into the bit stream are serialized as differences to the preceding triangle,
+    // thus a local change of the painting produces a local change of the serialized data, allowing the Undo / Redo stack
+    // to share the rest of the data with the previous snapshots.
+    template<class Archive> void save(Archive &ar) const
     {
-        ar(cereal::base_class<ObjectWithTimestamp>(this), m_data);
+        std::vector<std::pair<int, int>> deltas;
+        deltas.reserve(m_data.first.size());
+        std::pair<int, int> prev(0, 0);
+        for (const std::pair<int, int> &triangle_id_and_ibit : m_data.first) {
+            deltas.emplace_back(triangle_id_and_ibit.first - prev.first, triangle_id_and_ibit.second - prev.second);
+            prev = triangle_id_and_ibit;
+        }
+        ar(cereal::base_class<ObjectWithTimestamp>(this), deltas, m_data.second);
+    }
+    template<class Archive> void load(Archive &ar)
+    {
+        ar(cereal::base_class<ObjectWithTimestamp>(this), m_data.first, m_data.second);
+        std::pair<int, int> prev(0, 0);
+        for (std::pair<int, int> &triangle_id_and_ibit : m_data.first) {
+            triangle_id_and_ibit.first  += prev.first;
+            triangle_id_and_ibit.second += prev.second;
+            prev = triangle_id_and_ibit;
+        }
     }
 
     std::pair<std::vector<std::pair<int, int>>, std::vector<bool>> m_data;
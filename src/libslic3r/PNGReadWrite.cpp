@@ -3,7 +3,11 @@
 #include <memory>
 
 #include <cstdio>
+#include <cstring>
 #include <png.h>
+#include <miniz.h>
+
+#include <tbb/parallel_for.h>
 
 #include <boost/log/trivial.hpp>
 #include <boost/nowide/cstdio.hpp>
@@ -181,6 +185,107 @@ bool decode_colored_png(const ReadBuf &in_buf, ImageColorscale &out_img)
 }
 
 
+// Raw deflate of one strip of scanlines. The strips are byte aligned by a sync flush, the last one
+// finishes the stream, therefore the deflated strips may be concatenated into a single deflate stream.
+static bool deflate_strip(const std::vector<uint8_t> &src, int flags, bool last, std::vector<uint8_t> &dst)
+{
+    auto put_buf = [](const void *buf, int len, void *user) -> mz_bool {
+        auto *out = static_cast<std::vector<uint8_t>*>(user);
+        out->insert(out->end(), static_cast<const uint8_t*>(buf), static_cast<const uint8_t*>(buf) + len);
+        return MZ_TRUE;
+    };
+    // The compressor keeps its hash tables inline, it is too large for the stack.
+    auto compressor = std::make_unique<tdefl_compressor>();
+    dst.clear();
+    dst.reserve(src.size() / 2 + 64);
+    return tdefl_init(compressor.get(), put_buf, &dst, flags) == TDEFL_STATUS_OKAY &&
+           tdefl_compress_buffer(compressor.get(), src.data(), src.size(), last ? TDEFL_FINISH : TDEFL_SYNC_FLUSH) ==
+               (last ? TDEFL_STATUS_DONE : TDEFL_STATUS_OKAY);
+}
+
+static void append_png_chunk(std::vector<uint8_t> &png, const char *type, const uint8_t *data, size_t size)
+{
+    auto append_u32 = [&png](uint32_t v) {
+        png.insert(png.end(), { uint8_t(v >> 24), uint8_t(v >> 16), uint8_t(v >> 8), uint8_t(v) });
+    };
+    append_u32(uint32_t(size));
+    const size_t crc_begin = png.size();
+    png.insert(png.end(), type, type + 4);
+    if (size > 0)
+        png.insert(png.end(), data, data + size);
+    append_u32(uint32_t(mz_crc32(MZ_CRC32_INIT, png.data() + crc_begin, png.size() - crc_begin)));
+}
+
+std::vector<uint8_t> encode_png(const uint8_t *data, size_t width, size_t height, int num_channels, Compression compression, bool flip)
+{
+    static constexpr uint8_t color_types[] = { 0, 0, 4, 2, 6 };
+    if (data == nullptr || width == 0 || height == 0 || num_channels < 1 || num_channels > 4)
+        return {};
+
+    // Split into strips of at least 128kB of pixels, so that the compressor state and the lost dictionary
+    // at the strip boundaries do not matter. A 512x512 RGBA thumbnail makes 8 strips.
+    const size_t row_size       = width * num_channels;
+    const size_t rows_per_strip = std::max<size_t>(1, (size_t(128) * 1024 + row_size - 1) / row_size);
+    const size_t num_strips     = (height + rows_per_strip - 1) / rows_per_strip;
+    const int    flags          = int(tdefl_create_comp_flags_from_zip_params(compression == Compression::Fast ? 1 : MZ_DEFAULT_LEVEL, -MZ_DEFAULT_WINDOW_BITS, MZ_DEFAULT_STRATEGY));
+
+    std::vector<std::vector<uint8_t>> strips(num_strips);
+    std::vector<mz_ulong>             adlers(num_strips);
+    std::vector<char>                 ok(num_strips, false);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, num_strips, 1), [&](const tbb::blocked_range<size_t> &range) {
+        std::vector<uint8_t> scanlines;
+        for (size_t strip = range.begin(); strip < range.end(); ++ strip) {
+            const size_t row_begin = strip * rows_per_strip;
+            const size_t row_end   = std::min(height, row_begin + rows_per_strip);
+            // Scanlines with the filter type "none" in front of each row, as tdefl_write_image_to_png_file_in_memory() does.
+            scanlines.assign((row_end - row_begin) * (row_size + 1), 0);
+            for (size_t row = row_begin; row < row_end; ++ row)
+                memcpy(scanlines.data() + (row - row_begin) * (row_size + 1) + 1, data + (flip ? height - 1 - row : row) * row_size, row_size);
+            adlers[strip] = mz_adler32(MZ_ADLER32_INIT, scanlines.data(), scanlines.size());
+            ok[strip] = deflate_strip(scanlines, flags, strip + 1 == num_strips, strips[strip]);
+        }
+    });
+    if (std::find(ok.begin(), ok.end(), false) != ok.end())
+        return {};
+
+    // Combine the Adler-32 checksums of the strips, see adler32_combine() of zlib.
+    auto adler32_combine = [](mz_ulong adler1, mz_ulong adler2, size_t len2) -> mz_ulong {
+        static constexpr mz_ulong BASE = 65521;
+        const mz_ulong rem  = mz_ulong(len2 % BASE);
+        mz_ulong sum1 = adler1 & 0xffff;
+        mz_ulong sum2 = (rem * sum1) % BASE;
+        sum1 += (adler2 & 0xffff) + BASE - 1;
+        sum2 += ((adler1 >> 16) & 0xffff) + ((adler2 >> 16) & 0xffff) + BASE - rem;
+        if (sum1 >= BASE) sum1 -= BASE;
+        if (sum1 >= BASE) sum1 -= BASE;
+        if (sum2 >= (BASE << 1)) sum2 -= (BASE << 1);
+        if (sum2 >= BASE) sum2 -= BASE;
+        return sum1 | (sum2 << 16);
+    };
+
+    // zlib stream: header, the deflated strips, Adler-32 of the scanlines.
+    std::vector<uint8_t> idat { 0x78, 0x01 };
+    mz_ulong adler = MZ_ADLER32_INIT;
+    for (size_t strip = 0; strip < num_strips; ++ strip) {
+        const size_t rows = std::min(height, (strip + 1) * rows_per_strip) - strip * rows_per_strip;
+        adler = adler32_combine(adler, adlers[strip], rows * (row_size + 1));
+        idat.insert(idat.end(), strips[strip].begin(), strips[strip].end());
+        strips[strip] = {};
+    }
+    idat.insert(idat.end(), { uint8_t(adler >> 24), uint8_t(adler >> 16), uint8_t(adler >> 8), uint8_t(adler) });
+
+    std::vector<uint8_t> png { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+    png.reserve(png.size() + idat.size() + 64);
+    const uint8_t ihdr[13] = {
+        uint8_t(width >> 24), uint8_t(width >> 16), uint8_t(width >> 8), uint8_t(width),
+        uint8_t(height >> 24), uint8_t(height >> 16), uint8_t(height >> 8), uint8_t(height),
+        8 /* bit depth */, color_types[num_channels], 0 /* deflate */, 0 /* adaptive filtering */, 0 /* no interlace */ };
+    append_png_chunk(png, "IHDR", ihdr, sizeof(ihdr));
+    append_png_chunk(png, "IDAT", idat.data(), idat.size());
+    append_png_chunk(png, "IEND", nullptr, 0);
+    return png;
+}
+
 // Down to earth function to store a packed RGB image to file. Mostly useful for debugging purposes.
 // Based on https://www.lemoda.net/c/write-png/
 // png_color_type is PNG_COLOR_TYPE_RGB or PNG_COLOR_TYPE_GRAY
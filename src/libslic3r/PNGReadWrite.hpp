@@ -82,6 +82,16 @@ bool decode_colored_png(const ReadBuf &in_buf, ImageColorscale &out_img);
 
 // TODO: std::istream of FILE* could be similarly adapted in case its needed...
 
+// Compression of the encoded png. Fast is meant for thumbnails, which are encoded often and stored just once.
+enum class Compression { Fast, Default };
+
+// Encode an 8 bit grayscale (1), RGB (3) or RGBA (4 channels) image into a png in memory.
+// Rows are stored from the top, or from the bottom if flip (OpenGL frame buffer).
+// Large images are split into strips of rows, which are deflated in parallel.
+// Returns an empty vector on failure.
+std::vector<uint8_t> encode_png(const uint8_t *data, size_t width, size_t height, int num_channels,
+                                Compression compression = Compression::Default, bool flip = false);
+
 
 
 bool write_gl_rgba_to_file(const char* file_name_utf8, size_t width, size_t height, const uint8_t* data_rgb);
@@ -976,9 +976,7 @@ void PerimeterGenerator::process_classic()
                         coord_t ext_perimeter_smaller_width = this->smaller_ext_perimeter_flow.scaled_width();
                         for (const ExPolygon& expolygon : last) {
                             // BBS: judge whether it's narrow but not too long island which is hard to place two line
-                            ExPolygons expolys;
-                            expolys.push_back(expolygon);
-                            ExPolygons offset_result = offset2_ex(expolys,
+                            ExPolygons offset_result = offset2_ex(expolygon,
                                 -float(ext_perimeter_width / 2. + ext_min_spacing_smaller / 2.),
                                 +float(ext_min_spacing_smaller / 2.));
                             if (offset_result.empty() &&
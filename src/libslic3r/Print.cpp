@@ -7,6 +7,7 @@
 #include "Flow.hpp"
 #include "Geometry/ConvexHull.hpp"
 #include "I18N.hpp"
+#include "Profiler.hpp"
 #include "ShortestPath.hpp"
 #include "Support/SupportMaterial.hpp"
 #include "Thread.hpp"
@@ -1783,6 +1784,7 @@ std::map<ObjectID, unsigned int> getObjectExtruderMap(const Print& print) {
 // Slicing process, running at a background thread.
 void Print::process(std::unordered_map<std::string, long long>* slice_time, bool use_cache)
 {
+    SLIC3R_PROFILE_ZONE_CAT("Print::process", "print");
     long long start_time = 0, end_time = 0;
     if (slice_time) {
         (*slice_time)[TIME_USING_CACHE] = 0;
@@ -2037,6 +2039,7 @@ void Print::process(std::unordered_map<std::string, long long>* slice_time, bool
 
 
     if (this->set_started(psWipeTower)) {
+        SLIC3R_PROFILE_ZONE_CAT("psWipeTower", "print");
         {
             std::vector<std::set<int>> geometric_unprintables(m_config.nozzle_diameter.size());
             for (PrintObject* obj : m_objects) {
@@ -2087,6 +2090,7 @@ void Print::process(std::unordered_map<std::string, long long>* slice_time, bool
     }
 
     if (this->set_started(psSkirtBrim)) {
+        SLIC3R_PROFILE_ZONE_CAT("psSkirtBrim", "print");
         this->set_status(70, L("Generating skirt & brim"));
 
         if (slice_time) {
@@ -38,6 +38,7 @@ class SupportLayer;
 // BBS
 class TreeSupportData;
 class TreeSupport;
+namespace TreeSupport3D { class TreeModelVolumes; }
 class ExtrusionLayers;
 
 #define MARGIN_HEIGHT   1.5
@@ -80,6 +81,8 @@ namespace FillLightning {
     using GeneratorPtr = std::unique_ptr<Generator, GeneratorDeleter>;
 }; // namespace FillLightning
 
+class FillCache;
+
 // Print step IDs for keeping track of the print state.
 // The Print steps are applied in this order.
 enum PrintStep {
@@ -447,6 +450,12 @@ public:
     SupportLayer* add_tree_support_layer(int id, coordf_t height, coordf_t print_z, coordf_t slice_z);
     std::shared_ptr<TreeSupportData> alloc_tree_support_preview_cache();
     void clear_tree_support_preview_cache() { m_tree_support_preview_cache.reset(); }
+    // Collision / avoidance caches of the tree supports. They are kept between regenerations of the supports,
+    // so that painting support enforcers / blockers does not recalculate them. Released when the slices change.
+    std::shared_ptr<TreeSupport3D::TreeModelVolumes> tree_support_model_volumes() const { return m_tree_support_model_volumes; }
+    void set_tree_support_model_volumes(std::shared_ptr<TreeSupport3D::TreeModelVolumes> volumes) { m_tree_support_model_volumes = std::move(volumes); }
+    // Caches of the infill pattern generators shared by the layers. Released once the infill is generated or invalidated.
+    FillCache*      fill_cache() const { return m_fill_cache.get(); }
 
     size_t          support_layer_count() const { return m_support_layers.size(); }
     void            clear_support_layers();
@@ -611,6 +620,7 @@ private:
     SupportLayerPtrs                        m_support_layers;
     // BBS
     std::shared_ptr<TreeSupportData>        m_tree_support_preview_cache;
+    std::shared_ptr<TreeSupport3D::TreeModelVolumes> m_tree_support_model_volumes;
 
     // this is set to true when LayerRegion->slices is split in top/internal/bottom
     // so that next call to make_perimeters() performs a union() before computing loops
@@ -618,6 +628,7 @@ private:
 
     std::pair<FillAdaptive::OctreePtr, FillAdaptive::OctreePtr> m_adaptive_fill_octrees;
     FillLightning::GeneratorPtr m_lightning_generator;
+    std::unique_ptr<FillCache>  m_fill_cache;
 
     std::vector < VolumeSlices >            firstLayerObjSliceByVolume;
     std::vector<groupedVolumeSlices>        firstLayerObjSliceByGroups;
@@ -5126,6 +5126,27 @@ void PrintConfigDef::init_fff_params()
     def->mode = comAdvanced;
     def->set_default_value(new ConfigOptionInt(-1));
 
+    def = this->add("tree_support_cache_budget", coInt);
+    def->label = L("Tree support cache budget");
+    def->category = L("Support");
+    def->tooltip  = L("Memory held by the collision and avoidance areas of the tree support. The areas are calculated on demand "
+                       "and the least recently used ones are released when over the budget, at the cost of a longer calculation. "
+                       "0 means no limit, all the areas are calculated upfront.");
+    def->sidetext = "MB";
+    def->min = 0;
+    def->mode = comDevelop;
+    def->set_default_value(new ConfigOptionInt(0));
+
+    def = this->add("tree_support_cache_radius_factor", coFloat);
+    def->label = L("Tree support cache radius factor");
+    def->category = L("Support");
+    def->tooltip  = L("Growth factor of the branch radii the collision and avoidance areas of the tree support are calculated for. "
+                       "A larger factor calculates fewer areas at the cost of the branches being pushed further away from the model.");
+    def->min = 1.5;
+    def->max = 4;
+    def->mode = comDevelop;
+    def->set_default_value(new ConfigOptionFloat(1.5));
+
     def = this->add("chamber_temperatures", coInts);
     def->label = L("Chamber temperature");
     def->tooltip = L("Higher chamber temperature can help suppress or reduce warping and potentially lead to higher interlayer bonding strength for high temperature materials like ABS, ASA, PC, PA and so on."
@@ -6464,6 +6485,15 @@ void PrintConfigDef::init_sla_params()
     def->mode = comAdvanced;
     def->set_default_value(new ConfigOptionFloat(2.0));
 
+    def = this->add("hollowing_tile_size", coFloat);
+    def->label = L(" ");
+    def->category = L(" ");
+    def->tooltip  = L(" ");
+    def->sidetext = L("mm");
+    def->min = 0;
+    def->mode = comDevelop;
+    def->set_default_value(new ConfigOptionFloat(0.));
+
     def = this->add("material_print_speed", coEnum);
     def->label = L(" ");
     def->tooltip = L(" ");
@@ -9175,6 +9205,14 @@ CLIMiscConfigDef::CLIMiscConfigDef()
     def->cli_params = "option";
     def->set_default_value(new ConfigOptionBool(false));
 
+    def = this->add("slice_concurrency", coInt);
+    def->label = "Slice concurrency";
+    def->tooltip = "Thread budget shared by all plates when slicing all plates: 1-slice plates one by one, 0-use all cores, n-use n threads. "
+                   "With a budget other than 1, the G-code of a plate is exported while the next plate is being sliced";
+    def->cli_params = "count";
+    def->min = 0;
+    def->set_default_value(new ConfigOptionInt(1));
+
     def = this->add("makerlab_name", coString);
     def->label = "MakerLab name";
     def->tooltip = "MakerLab name to generate this 3mf";
@@ -903,6 +903,8 @@ PRINT_CONFIG_CLASS_DEFINE(
     ((ConfigOptionFloat,              tree_support_branch_angle))
     ((ConfigOptionFloat,              tree_support_branch_diameter_angle))
     ((ConfigOptionInt,                tree_support_wall_count))
+    ((ConfigOptionInt,                tree_support_cache_budget))
+    ((ConfigOptionFloat,              tree_support_cache_radius_factor))
     ((ConfigOptionBool,               detect_narrow_internal_solid_infill))
     ((ConfigOptionBool,               detect_floating_vertical_shell))
     // ((ConfigOptionBool,               adaptive_layer_height))
@@ -1568,6 +1570,10 @@ PRINT_CONFIG_CLASS_DEFINE(
 
     // Indirectly controls the minimum size of created cavities.
     ((ConfigOptionFloat, hollowing_closing_distance))
+
+    // Objects larger than a tile are hollowed tile by tile to limit the memory
+    // used by openvdb. Zero hollows the whole object at once.
+    ((ConfigOptionFloat, hollowing_tile_size))
 )
 
 enum SLAMaterialSpeed { slamsSlow, slamsFast };
@@ -7,6 +7,7 @@
 #include "I18N.hpp"
 #include "Layer.hpp"
 #include "MutablePolygon.hpp"
+#include "Profiler.hpp"
 #include "Support/SupportMaterial.hpp"
 #include "Support/TreeSupport.hpp"
 #include "Surface.hpp"
@@ -15,6 +16,7 @@
 #include "TriangleMeshSlicer.hpp"
 #include "Utils.hpp"
 #include "Fill/FillAdaptive.hpp"
+#include "Fill/FillCache.hpp"
 #include "Fill/FillLightning.hpp"
 #include "Format/STL.hpp"
 #include "InternalBridgeDetector.hpp"
@@ -30,8 +32,6 @@
 #include <tbb/concurrent_vector.h>
 #include <tbb/concurrent_unordered_set.h>
 
-#include <Shiny/Shiny.h>
-
 #include "format.hpp"
 
 using namespace std::literals;
@@ -64,7 +64,8 @@ PrintObject::PrintObject(Print* print, ModelObject* model_object, const Transfor
     PrintObjectBaseWithState(print, model_object),
     m_trafo(trafo),
     // BBS
-    m_tree_support_preview_cache(nullptr)
+    m_tree_support_preview_cache(nullptr),
+    m_fill_cache(std::make_unique<FillCache>())
 {
     // Compute centering offet to be applied to our meshes so that we work with smaller coordinates
     // requiring less bits to represent Clipper coordinates.
@@ -457,6 +458,7 @@ void PrintObject::make_perimeters()
 
     if (! this->set_started(posPerimeters))
         return;
+    SLIC3R_PROFILE_ZONE_CAT("posPerimeters", "print");
 
     m_print->set_status(15, L("Generating walls"));
     BOOST_LOG_TRIVIAL(info) << "Generating walls..." << log_memory_info();
@@ -624,6 +626,7 @@ void PrintObject::prepare_infill()
 {
     if (! this->set_started(posPrepareInfill))
         return;
+    SLIC3R_PROFILE_ZONE_CAT("posPrepareInfill", "print");
     m_print->set_status(25, L("Generating infill regions"));
     if (m_typed_slices) {
         // To improve robustness of detect_surfaces_type() when reslicing (working with typed slices), see GH issue #7442.
@@ -754,6 +757,7 @@ void PrintObject::infill()
     this->prepare_infill();
 
     if (this->set_started(posInfill)) {
+        SLIC3R_PROFILE_ZONE_CAT("posInfill", "print");
         m_print->set_status(35, L("Generating infill toolpath"));
 
         const auto& adaptive_fill_octree = this->m_adaptive_fill_octrees.first;
@@ -770,6 +774,8 @@ void PrintObject::infill()
            }
         );
         m_print->throw_if_canceled();
+        // The layers are filled, the cached patterns are not needed anymore.
+        m_fill_cache->clear();
         BOOST_LOG_TRIVIAL(debug) << "Filling layers in parallel - end";
         /*  we could free memory now, but this would make this step not idempotent
         ### $_->fill_surfaces->clear for map @{$_->regions}, @{$object->layers};
@@ -781,6 +787,7 @@ void PrintObject::infill()
 void PrintObject::ironing()
 {
     if (this->set_started(posIroning)) {
+        SLIC3R_PROFILE_ZONE_CAT("posIroning", "print");
         BOOST_LOG_TRIVIAL(debug) << "Ironing in parallel - start";
         tbb::parallel_for(
             // Ironing starting with layer 0 to support ironing all surfaces.
@@ -814,6 +821,7 @@ static const float g_min_overhang_percent_for_lift = 0.3f;
 void PrintObject::detect_overhangs_for_lift()
 {
     if (this->set_started(posDetectOverhangsForLift)) {
+        SLIC3R_PROFILE_ZONE_CAT("posDetectOverhangsForLift", "print");
         const float min_overlap = m_config.line_width * g_min_overhang_percent_for_lift;
         size_t num_layers = this->layer_count();
         size_t num_raft_layers = m_slicing_params.raft_layers();
@@ -856,6 +864,7 @@ void PrintObject::detect_overhangs_for_lift()
 void PrintObject::generate_support_material()
 {
     if (this->set_started(posSupportMaterial)) {
+        SLIC3R_PROFILE_ZONE_CAT("posSupportMaterial", "print");
         this->clear_support_layers();
 
         if (!has_support() && !m_print->get_no_check_flag()) {
@@ -895,6 +904,10 @@ void PrintObject::generate_support_material()
             this->_generate_support_material();
             m_print->throw_if_canceled();
         }
+        if (m_tree_support_model_volumes && ! (this->has_support() && m_layers.size() > 1 && is_tree(m_config.support_type.value)))
+            // Tree support is disabled, nothing to reuse. Otherwise the collisions and avoidances are kept for the next regeneration
+            // of the supports, limited by the memory budget of TreeModelVolumes::CacheLimits.
+            m_tree_support_model_volumes.reset();
         this->set_done(posSupportMaterial);
     }
 }
@@ -902,6 +915,7 @@ void PrintObject::generate_support_material()
 void PrintObject::simplify_extrusion_path()
 {
     if (this->set_started(posSimplifyWall)) {
+        SLIC3R_PROFILE_ZONE_CAT("posSimplifyWall", "print");
         m_print->set_status(75, L("Optimizing toolpath"));
         BOOST_LOG_TRIVIAL(debug) << "Simplify wall extrusion path of object in parallel - start";
         //BBS: walls
@@ -920,6 +934,7 @@ void PrintObject::simplify_extrusion_path()
     }
 
     if (this->set_started(posSimplifyInfill)) {
+        SLIC3R_PROFILE_ZONE_CAT("posSimplifyInfill", "print");
         m_print->set_status(75, L("Optimizing toolpath"));
         BOOST_LOG_TRIVIAL(debug) << "Simplify infill extrusion path of object in parallel - start";
         //BBS: infills
@@ -938,6 +953,7 @@ void PrintObject::simplify_extrusion_path()
     }
 
     if (this->set_started(posSimplifySupportPath)) {
+        SLIC3R_PROFILE_ZONE_CAT("posSimplifySupportPath", "print");
         m_print->set_status(75, L("Optimizing toolpath"));
         BOOST_LOG_TRIVIAL(debug) << "Simplify extrusion path of support in parallel - start";
         tbb::parallel_for(
@@ -1205,7 +1221,9 @@ bool PrintObject::invalidate_state_by_config_options(
             || opt_key == "tree_support_branch_diameter"
             || opt_key == "tree_support_branch_angle"
             || opt_key == "tree_support_branch_diameter_angle"
-            || opt_key == "tree_support_wall_count") {
+            || opt_key == "tree_support_wall_count"
+            || opt_key == "tree_support_cache_budget"
+            || opt_key == "tree_support_cache_radius_factor") {
             steps.emplace_back(posSupportMaterial);
         } else if (
                opt_key == "bottom_shell_layers"
@@ -1394,11 +1412,14 @@ bool PrintObject::invalidate_step(PrintObjectStep step)
 		invalidated |= this->invalidate_steps({ posPerimeters, posPrepareInfill, posInfill, posIroning, posSupportMaterial, posSimplifyWall, posSimplifyInfill });
         invalidated |= m_print->invalidate_steps({ psSkirtBrim });
         m_slicing_params.valid = false;
+        m_tree_support_model_volumes.reset();
     } else if (step == posSupportMaterial) {
         invalidated |= this->invalidate_steps({ posSimplifySupportPath });
         invalidated |= m_print->invalidate_steps({ psSkirtBrim });
         m_slicing_params.valid = false;
     }
+    if (step == posSlice || step == posPerimeters || step == posPrepareInfill || step == posInfill)
+        m_fill_cache->clear();
 
     // Wipe tower depends on the ordering of extruders, which in turn depends on everything.
     // It also decides about what the flush_into_infill / wipe_into_object / flush_into_support features will do,
@@ -1415,6 +1436,8 @@ bool PrintObject::invalidate_all_steps()
     bool result = Inherited::invalidate_all_steps() | m_print->invalidate_all_steps();
 	// Then reset some of the depending values.
 	m_slicing_params.valid = false;
+	m_tree_support_model_volumes.reset();
+	m_fill_cache->clear();
 	return result;
 }
 
@@ -1731,7 +1754,7 @@ void PrintObject::process_external_surfaces()
 
 void PrintObject::discover_vertical_shells()
 {
-    PROFILE_FUNC();
+    SLIC3R_PROFILE_FUNC();
 
     BOOST_LOG_TRIVIAL(info) << "Discovering vertical shells..." << log_memory_info();
 
@@ -2096,10 +2119,6 @@ void PrintObject::discover_vertical_shells()
 		}
 #endif /* SLIC3R_DEBUG_SLICE_PROCESSING */
     } // for each region
-
-    // Write the profiler measurements to file
-//    PROFILE_UPDATE();
-//    PROFILE_OUTPUT(debug_out_path("discover_vertical_shells-profile.txt").c_str());
 }
 
 
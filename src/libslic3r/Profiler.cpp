@@ -0,0 +1,234 @@
+#include "Profiler.hpp"
+#include "Thread.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iomanip>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
+#include <vector>
+
+#include <boost/log/trivial.hpp>
+#include <boost/nowide/cstdlib.hpp>
+#include <boost/nowide/fstream.hpp>
+
+#include <tbb/task_arena.h>
+#include <tbb/task_scheduler_observer.h>
+
+namespace Slic3r {
+namespace Profiler {
+
+namespace detail {
+
+std::atomic<bool> g_tracing { false };
+
+int64_t now()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace detail
+
+struct Event
+{
+    const char *name;
+    const char *category;
+    int64_t     begin;
+    int64_t     end;
+};
+
+// Ring buffer of the zones closed by a single thread, written by that thread only.
+struct ThreadBuffer
+{
+    ThreadBuffer(size_t capacity, size_t thread_idx, std::string thread_name) :
+        events(capacity), thread_idx(thread_idx), thread_name(std::move(thread_name)) {}
+
+    void push(const char *name, const char *category, int64_t begin, int64_t end) {
+        size_t n = num_pushed.load(std::memory_order_relaxed);
+        events[n % events.size()] = { name, category, begin, end };
+        num_pushed.store(n + 1, std::memory_order_release);
+    }
+
+    std::vector<Event>  events;
+    // Number of events ever pushed, the last events.size() of them are stored.
+    std::atomic<size_t> num_pushed { 0 };
+    size_t              thread_idx;
+    std::string         thread_name;
+    // Start of the stay of a TBB worker thread in an observed task arena, -1 if not inside an arena.
+    int64_t             worker_begin { -1 };
+};
+
+// Buffers of all the threads, which ever recorded a zone. The buffers are kept after their threads finish.
+static std::mutex                                  s_buffers_mutex;
+static std::vector<std::unique_ptr<ThreadBuffer>>  s_buffers;
+static std::atomic<size_t>                         s_capacity { 1 << 16 };
+static thread_local ThreadBuffer                  *s_thread_buffer = nullptr;
+
+static ThreadBuffer& thread_buffer()
+{
+    if (s_thread_buffer == nullptr) {
+        std::optional<std::string>  name = get_current_thread_name();
+        std::lock_guard<std::mutex> lock(s_buffers_mutex);
+        size_t                      thread_idx = s_buffers.size() + 1;
+        s_buffers.emplace_back(std::make_unique<ThreadBuffer>(s_capacity.load(), thread_idx,
+            name && ! name->empty() ? *name : "thread " + std::to_string(thread_idx)));
+        s_thread_buffer = s_buffers.back().get();
+    }
+    return *s_thread_buffer;
+}
+
+// Records the stays of the TBB worker threads in the task arena of the thread constructing the observer.
+class WorkerObserver : public tbb::task_scheduler_observer
+{
+public:
+    WorkerObserver() { this->observe(true); }
+    ~WorkerObserver() override { this->observe(false); }
+
+    void on_scheduler_entry(bool is_worker) override {
+        if (is_worker && is_tracing())
+            thread_buffer().worker_begin = detail::now();
+    }
+    void on_scheduler_exit(bool is_worker) override {
+        if (is_worker && s_thread_buffer != nullptr && s_thread_buffer->worker_begin >= 0) {
+            s_thread_buffer->push("TBB worker", "tbb", s_thread_buffer->worker_begin, detail::now());
+            s_thread_buffer->worker_begin = -1;
+        }
+    }
+};
+
+// One observer for the implicit task arena of each non-worker thread opening a zone.
+static thread_local std::unique_ptr<WorkerObserver> s_worker_observer;
+
+namespace detail {
+
+void open_zone()
+{
+    thread_buffer();
+    static thread_local bool observer_checked = false;
+    if (! observer_checked) {
+        observer_checked = true;
+        // The thread opening its first zone is either a TBB worker, or it owns a task arena, into which the workers will join.
+        int thread_idx = tbb::this_task_arena::current_thread_index();
+        if (thread_idx == 0 || thread_idx == tbb::task_arena::not_initialized)
+            s_worker_observer = std::make_unique<WorkerObserver>();
+    }
+}
+
+void close_zone(const char *name, const char *category, int64_t begin)
+{
+    s_thread_buffer->push(name, category, begin, now());
+}
+
+} // namespace detail
+
+void start_tracing(size_t events_per_thread)
+{
+    s_capacity.store(std::max<size_t>(events_per_thread, 1));
+    detail::g_tracing.store(true);
+}
+
+void stop_tracing()
+{
+    detail::g_tracing.store(false);
+}
+
+void clear()
+{
+    std::lock_guard<std::mutex> lock(s_buffers_mutex);
+    for (std::unique_ptr<ThreadBuffer> &buffer : s_buffers)
+        buffer->num_pushed.store(0);
+}
+
+static void append_json_string(std::ostream &out, const char *str)
+{
+    out << '"';
+    for (const char *c = str; *c != 0; ++ c)
+        if (*c == '"' || *c == '\\')
+            out << '\\' << *c;
+        else if ((unsigned char)*c < 0x20)
+            out << ' ';
+        else
+            out << *c;
+    out << '"';
+}
+
+std::string chrome_trace()
+{
+    std::lock_guard<std::mutex> lock(s_buffers_mutex);
+
+    // Ranges of the stored events of each buffer.
+    std::vector<std::pair<size_t, size_t>> ranges;
+    int64_t                                time_origin = std::numeric_limits<int64_t>::max();
+    for (const std::unique_ptr<ThreadBuffer> &buffer : s_buffers) {
+        size_t end   = buffer->num_pushed.load(std::memory_order_acquire);
+        size_t begin = end > buffer->events.size() ? end - buffer->events.size() : 0;
+        ranges.emplace_back(begin, end);
+        for (size_t i = begin; i < end; ++ i)
+            time_origin = std::min(time_origin, buffer->events[i % buffer->events.size()].begin);
+    }
+
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    for (size_t buffer_idx = 0; buffer_idx < s_buffers.size(); ++ buffer_idx) {
+        const ThreadBuffer &buffer = *s_buffers[buffer_idx];
+        out << (first ? "\n" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer.thread_idx << ",\"args\":{\"name\":";
+        append_json_string(out, buffer.thread_name.c_str());
+        out << "}}";
+        first = false;
+        for (size_t i = ranges[buffer_idx].first; i < ranges[buffer_idx].second; ++ i) {
+            const Event &event = buffer.events[i % buffer.events.size()];
+            out << ",\n{\"name\":";
+            append_json_string(out, event.name);
+            out << ",\"cat\":";
+            append_json_string(out, event.category);
+            // Time stamps and durations in microseconds.
+            out << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer.thread_idx <<
+                ",\"ts\":" << double(event.begin - time_origin) * 0.001 << ",\"dur\":" << double(event.end - event.begin) * 0.001 << "}";
+        }
+    }
+    out << "\n]}\n";
+    return out.str();
+}
+
+static bool write_chrome_trace(const std::string &path)
+{
+    boost::nowide::ofstream file(path, std::ios::binary);
+    file << chrome_trace();
+    file.close();
+    return ! file.fail();
+}
+
+bool export_chrome_trace(const std::string &path)
+{
+    if (write_chrome_trace(path))
+        return true;
+    BOOST_LOG_TRIVIAL(error) << "Profiler: Failed to write trace " << path;
+    return false;
+}
+
+// Tracing of the whole application run, enabled by the SLIC3R_TRACE_FILE environment variable.
+static struct TraceFromEnvironment
+{
+    TraceFromEnvironment() {
+        if (const char *path = boost::nowide::getenv("SLIC3R_TRACE_FILE"); path != nullptr && *path != 0) {
+            m_path = path;
+            start_tracing();
+        }
+    }
+    ~TraceFromEnvironment() {
+        if (! m_path.empty()) {
+            stop_tracing();
+            // Boost.Log may be destructed already, don't log.
+            write_chrome_trace(m_path);
+        }
+    }
+    std::string m_path;
+} s_trace_from_environment;
+
+} // namespace Profiler
+} // namespace Slic3r
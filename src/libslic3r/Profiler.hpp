@@ -0,0 +1,76 @@
+#ifndef slic3r_Profiler_hpp_
+#define slic3r_Profiler_hpp_
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+// Tracing profiler recording the time spans of named zones into per thread ring buffers, exported in the Chrome trace event
+// format to be viewed by chrome://tracing or https://ui.perfetto.dev
+//
+// The zones are always compiled in. Unless tracing is started, a zone costs a single relaxed atomic load.
+// Tracing is started either by Profiler::start_tracing(), or by setting the SLIC3R_TRACE_FILE environment variable
+// to the path of a JSON file, which is written when the application exits.
+//
+// Besides the zones, the time spans are recorded when the TBB worker threads join and leave the task arena
+// of a thread opening a zone, showing the utilization of the worker threads.
+
+namespace Slic3r {
+namespace Profiler {
+
+namespace detail {
+    extern std::atomic<bool> g_tracing;
+    int64_t now();
+    void    open_zone();
+    void    close_zone(const char *name, const char *category, int64_t begin);
+}
+
+// Is a trace being recorded?
+inline bool is_tracing() { return detail::g_tracing.load(std::memory_order_relaxed); }
+
+// Start recording, keeping up to events_per_thread last zones of each thread.
+// The capacity is applied to threads opening their first zone after this call.
+void start_tracing(size_t events_per_thread = 1 << 16);
+void stop_tracing();
+// Discard the recorded zones. Not to be called while zones are open.
+void clear();
+
+// Recorded zones in the Chrome trace event JSON format. To be called when the traced work is finished.
+std::string chrome_trace();
+bool        export_chrome_trace(const std::string &path);
+
+// Records the life time of a zone. Both name and category have to be of static storage duration, e.g. string literals.
+class Zone
+{
+public:
+    explicit Zone(const char *name, const char *category = "slic3r") : m_name(name), m_category(category), m_begin(-1) {
+        if (is_tracing()) {
+            detail::open_zone();
+            m_begin = detail::now();
+        }
+    }
+    ~Zone() {
+        if (m_begin >= 0)
+            detail::close_zone(m_name, m_category, m_begin);
+    }
+
+    Zone(const Zone &) = delete;
+    Zone& operator=(const Zone &) = delete;
+
+private:
+    const char *m_name;
+    const char *m_category;
+    int64_t     m_begin;
+};
+
+} // namespace Profiler
+} // namespace Slic3r
+
+#define SLIC3R_PROFILE_CONCAT_IMPL(a, b) a##b
+#define SLIC3R_PROFILE_CONCAT(a, b) SLIC3R_PROFILE_CONCAT_IMPL(a, b)
+// Trace the rest of the enclosing scope as a zone.
+#define SLIC3R_PROFILE_ZONE(name) ::Slic3r::Profiler::Zone SLIC3R_PROFILE_CONCAT(slic3r_profile_zone_, __LINE__)(name)
+#define SLIC3R_PROFILE_ZONE_CAT(name, category) ::Slic3r::Profiler::Zone SLIC3R_PROFILE_CONCAT(slic3r_profile_zone_, __LINE__)(name, category)
+#define SLIC3R_PROFILE_FUNC() SLIC3R_PROFILE_ZONE(__func__)
+
+#endif // slic3r_Profiler_hpp_
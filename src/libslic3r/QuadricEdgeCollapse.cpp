@@ -2,6 +2,8 @@
 #include <tuple>
 #include <optional>
 #include "MutablePriorityQueue.hpp"
+#include <numeric>
+#include <unordered_map>
 #include <tbb/parallel_for.h>
 
 using namespace Slic3r;
@@ -133,7 +135,19 @@ namespace QuadricEdgeCollapse {
     void change_neighbors(EdgeInfos &e_infos, VertexInfos &v_infos, uint32_t ti0, uint32_t ti1,
                           uint32_t vi0, uint32_t vi1, uint32_t vi_top0,
                           const Triangle &t1, CopyEdgeInfos& infos, EdgeInfos &e_infos1);
-    void compact(const VertexInfos &v_infos, const TriangleInfos &t_infos, const EdgeInfos &e_infos, indexed_triangle_set &its);
+    // vertex_map: Optional output, map from the original vertex index to the compacted vertex index or -1 if deleted.
+    void compact(const VertexInfos &v_infos, const TriangleInfos &t_infos, const EdgeInfos &e_infos, indexed_triangle_set &its,
+                 std::vector<uint32_t> *vertex_map = nullptr);
+
+    // Simplify its by collapsing edges, edges touching locked vertices are not collapsed.
+    // Returns the error of the last collapsed edge.
+    float collapse(indexed_triangle_set &its, uint32_t triangle_count, float maximal_error,
+                   const std::vector<bool> *locked_vertices, std::vector<uint32_t> *vertex_map,
+                   ThrowOnCancel &throw_on_cancel, StatusFn &status_fn);
+    // Simplify spatial partitions of its in parallel, then run collapse() on the stitched mesh
+    // to simplify the partition boundaries. Returns the error of the last collapsed edge.
+    float collapse_partitioned(indexed_triangle_set &its, uint32_t triangle_count, float maximal_error,
+                               ThrowOnCancel &throw_on_cancel, StatusFn &status_fn);
 
 #ifdef EXPENSIVE_DEBUG_CHECKS
     void store_surround(const char *obj_filename, size_t triangle_index, int depth, const indexed_triangle_set &its,
@@ -153,6 +167,11 @@ namespace QuadricEdgeCollapse {
     const int status_set_offsets = 10;
     const int status_calc_errors = 30;
     const int status_create_refs = 10;
+    // Meshes with at least twice this triangle count are simplified in parallel by partitions of at least this size.
+    // The partitioning depends on the triangle count only, not on the number of threads, thus the result is reproducible.
+    const size_t min_partition_triangle_count = 250000;
+    // Part of the progress bar taken by the parallel simplification of partitions, in percents.
+    const int status_partitions_size = 70;
     } // namespace QuadricEdgeCollapse
 
 using namespace QuadricEdgeCollapse;
@@ -162,7 +181,8 @@ void Slic3r::its_quadric_edge_collapse(
     uint32_t                  triangle_count,
     float *                   max_error,
     std::function<void(void)> throw_on_cancel,
-    std::function<void(int)>  status_fn)
+    std::function<void(int)>  status_fn,
+    bool                      allow_partitions)
 {
     // check input
     if (triangle_count >= its.indices.size()) return;
@@ -171,6 +191,25 @@ void Slic3r::its_quadric_edge_collapse(
     if (throw_on_cancel == nullptr) throw_on_cancel = []() {};
     if (status_fn == nullptr) status_fn = [](int) {};
 
+    float last_collapsed_error = 
+        (allow_partitions && its.indices.size() >= 2 * min_partition_triangle_count) ?
+        collapse_partitioned(its, triangle_count, maximal_error, throw_on_cancel, status_fn) :
+        collapse(its, triangle_count, maximal_error, nullptr, nullptr, throw_on_cancel, status_fn);
+    if (max_error != nullptr) *max_error = last_collapsed_error;
+}
+
+float QuadricEdgeCollapse::collapse(indexed_triangle_set &its, uint32_t triangle_count, float maximal_error,
+                                    const std::vector<bool> *locked_vertices, std::vector<uint32_t> *vertex_map,
+                                    ThrowOnCancel &throw_on_cancel, StatusFn &status_fn)
+{
+    if (triangle_count >= its.indices.size()) {
+        if (vertex_map != nullptr) {
+            vertex_map->resize(its.vertices.size());
+            std::iota(vertex_map->begin(), vertex_map->end(), 0);
+        }
+        return 0.f;
+    }
+
     StatusFn init_status_fn = [&](int percent) {
         float n_percent = percent * status_init_size / 100.f;
         status_fn(static_cast<int>(std::round(n_percent)));
@@ -255,7 +294,8 @@ void Slic3r::its_quadric_edge_collapse(
             reorder_edges(e_infos, v_info0, ti0, ti1);
             reorder_edges(e_infos, v_info1, ti0, ti1);
         }
-        if (!ti1_opt.has_value() || // edge has only one triangle
+        if ((locked_vertices != nullptr && ((*locked_vertices)[vi0] || (*locked_vertices)[vi1])) ||
+            !ti1_opt.has_value() || // edge has only one triangle
             degenerate(vi0, ti0, ti1, v_info1, e_infos, its.indices) ||
             degenerate(vi1, ti0, ti1, v_info0, e_infos, its.indices) ||
             create_no_volume(vi0, vi1, ti0, ti1, v_info0, v_info1, e_infos, its.indices) ||
@@ -342,8 +382,162 @@ void Slic3r::its_quadric_edge_collapse(
     }
 
     // compact triangle
-    compact(v_infos, t_infos, e_infos, its);
-    if (max_error != nullptr) *max_error = last_collapsed_error;
+    compact(v_infos, t_infos, e_infos, its, vertex_map);
+    return last_collapsed_error;
+}
+
+float QuadricEdgeCollapse::collapse_partitioned(indexed_triangle_set &its, uint32_t triangle_count, float maximal_error,
+                                                ThrowOnCancel &throw_on_cancel, StatusFn &status_fn)
+{
+    // Split the triangles by their centroids into slabs along the longest axis of the bounding box,
+    // each slab containing about the same number of triangles.
+    const size_t num_partitions = its.indices.size() / min_partition_triangle_count;
+    BoundingBoxf3 bbox = bounding_box(its);
+    int           axis = 0;
+    Vec3d         size = bbox.size();
+    if (size.y() > size[axis]) axis = 1;
+    if (size.z() > size[axis]) axis = 2;
+    std::vector<float> centroids(its.indices.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, its.indices.size()), [&its, &centroids, axis](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i) {
+            const Triangle &t = its.indices[i];
+            centroids[i] = its.vertices[t[0]][axis] + its.vertices[t[1]][axis] + its.vertices[t[2]][axis];
+        }
+    });
+    std::vector<float> splits;
+    {
+        std::vector<float> sorted = centroids;
+        for (size_t i = 1; i < num_partitions; ++ i) {
+            auto it = sorted.begin() + i * sorted.size() / num_partitions;
+            std::nth_element(sorted.begin(), it, sorted.end());
+            splits.emplace_back(*it);
+        }
+        std::sort(splits.begin(), splits.end());
+    }
+    std::vector<uint32_t> triangle_partition(its.indices.size());
+    for (size_t i = 0; i < its.indices.size(); ++ i)
+        triangle_partition[i] = uint32_t(std::upper_bound(splits.begin(), splits.end(), centroids[i]) - splits.begin());
+    centroids.clear();
+    centroids.shrink_to_fit();
+    throw_on_cancel();
+
+    // Vertices shared by triangles of multiple partitions are locked, they stitch the partitions together.
+    constexpr uint32_t shared = std::numeric_limits<uint32_t>::max();
+    constexpr uint32_t unused = shared - 1;
+    std::vector<uint32_t> vertex_partition(its.vertices.size(), unused);
+    for (size_t i = 0; i < its.indices.size(); ++ i)
+        for (int j = 0; j < 3; ++ j) {
+            uint32_t &vp = vertex_partition[its.indices[i][j]];
+            if (vp == unused)
+                vp = triangle_partition[i];
+            else if (vp != triangle_partition[i])
+                vp = shared;
+        }
+
+    struct Partition {
+        indexed_triangle_set  its;
+        // For each local vertex its index in the input mesh if the vertex is shared with another partition, otherwise unused.
+        std::vector<uint32_t> shared_vertices;
+        std::vector<bool>     locked;
+        // Map from the local vertex index to the vertex index of the simplified partition.
+        std::vector<uint32_t> vertex_map;
+        // Number of triangles touching a shared vertex.
+        size_t                num_seam_triangles = 0;
+        float                 last_collapsed_error = 0.f;
+    };
+    std::vector<Partition> partitions(num_partitions);
+    {
+        // Local index of a vertex not shared by partitions.
+        std::vector<uint32_t> local_index(its.vertices.size(), unused);
+        // Local indices of the shared vertices, one map per partition.
+        std::vector<std::unordered_map<uint32_t, uint32_t>> shared_local_index(num_partitions);
+        for (size_t i = 0; i < its.indices.size(); ++ i) {
+            Partition &partition = partitions[triangle_partition[i]];
+            Triangle   t;
+            bool       seam      = false;
+            for (int j = 0; j < 3; ++ j) {
+                uint32_t  vi        = its.indices[i][j];
+                bool      is_shared = vertex_partition[vi] == shared;
+                seam |= is_shared;
+                uint32_t &li        = is_shared ?
+                    shared_local_index[triangle_partition[i]].emplace(vi, unused).first->second :
+                    local_index[vi];
+                if (li == unused) {
+                    li = uint32_t(partition.its.vertices.size());
+                    partition.its.vertices.emplace_back(its.vertices[vi]);
+                    partition.locked.push_back(is_shared);
+                    partition.shared_vertices.push_back(is_shared ? vi : unused);
+                }
+                t[j] = li;
+            }
+            partition.its.indices.emplace_back(t);
+            if (seam)
+                ++ partition.num_seam_triangles;
+        }
+    }
+    const size_t num_vertices  = its.vertices.size();
+    const size_t num_triangles = its.indices.size();
+    its.clear();
+    triangle_partition.clear();
+    triangle_partition.shrink_to_fit();
+    vertex_partition.clear();
+    vertex_partition.shrink_to_fit();
+    throw_on_cancel();
+
+    // Simplify the partitions in parallel. The triangles along the seams are hardly simplified with their vertices locked,
+    // thus only the other triangles are reduced to their share of the wanted triangle count. The reduction of the seam
+    // triangles is held back for the final pass over the stitched mesh, which otherwise would have nothing left to collapse.
+    // The partitions are processed by one thread each, status_fn is not required to be thread safe.
+    const double ratio = double(triangle_count) / double(num_triangles);
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, partitions.size(), 1),
+        [&partitions, ratio, maximal_error, &throw_on_cancel](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i) {
+            Partition &partition = partitions[i];
+            uint32_t   wanted    = uint32_t(ratio * double(partition.its.indices.size() - partition.num_seam_triangles)) + uint32_t(partition.num_seam_triangles);
+            StatusFn   no_status = [](int) {};
+            partition.last_collapsed_error = collapse(partition.its, wanted, maximal_error, &partition.locked, &partition.vertex_map, throw_on_cancel, no_status);
+            partition.locked.clear();
+            partition.locked.shrink_to_fit();
+        }
+    });
+    status_fn(status_partitions_size);
+
+    // Stitch the partitions back together through the shared vertices, which were not moved.
+    float last_collapsed_error = 0.f;
+    {
+        std::vector<uint32_t> shared_out_index(num_vertices, unused);
+        std::vector<uint32_t> out_index;
+        for (Partition &partition : partitions) {
+            out_index.assign(partition.its.vertices.size(), unused);
+            for (size_t lv = 0; lv < partition.vertex_map.size(); ++ lv) {
+                uint32_t nv = partition.vertex_map[lv];
+                if (nv == std::numeric_limits<uint32_t>::max())
+                    // Deleted vertex.
+                    continue;
+                uint32_t gv = partition.shared_vertices[lv];
+                if (gv != unused && shared_out_index[gv] != unused) {
+                    out_index[nv] = shared_out_index[gv];
+                    continue;
+                }
+                out_index[nv] = uint32_t(its.vertices.size());
+                its.vertices.emplace_back(partition.its.vertices[nv]);
+                if (gv != unused)
+                    shared_out_index[gv] = out_index[nv];
+            }
+            for (const Triangle &t : partition.its.indices)
+                its.indices.emplace_back(int(out_index[t[0]]), int(out_index[t[1]]), int(out_index[t[2]]));
+            last_collapsed_error = std::max(last_collapsed_error, partition.last_collapsed_error);
+            partition = Partition();
+        }
+    }
+    throw_on_cancel();
+
+    // Simplify the stitched mesh, namely the partition boundaries.
+    StatusFn final_status_fn = [&status_fn](int percent) {
+        status_fn(status_partitions_size + percent * (100 - status_partitions_size) / 100);
+    };
+    return std::max(last_collapsed_error,
+        collapse(its, triangle_count, maximal_error, nullptr, nullptr, throw_on_cancel, final_status_fn));
 }
 
 Vec3d QuadricEdgeCollapse::create_normal(const Triangle &triangle,
@@ -828,12 +1022,17 @@ void QuadricEdgeCollapse::change_neighbors(EdgeInfos &     e_infos,
 void QuadricEdgeCollapse::compact(const VertexInfos &   v_infos,
                                   const TriangleInfos & t_infos,
                                   const EdgeInfos &     e_infos,
-                                  indexed_triangle_set &its)
+                                  indexed_triangle_set &its,
+                                  std::vector<uint32_t> *vertex_map)
 {
+    if (vertex_map != nullptr)
+        vertex_map->assign(v_infos.size(), std::numeric_limits<uint32_t>::max());
     uint32_t vi_new = 0;
     for (uint32_t vi = 0; vi < v_infos.size(); ++vi) {
         const VertexInfo &v_info = v_infos[vi];
         if (v_info.is_deleted()) continue; // deleted
+        if (vertex_map != nullptr)
+            (*vertex_map)[vi] = vi_new;
         uint32_t e_info_end = v_info.start + v_info.count;
         for (uint32_t ei = v_info.start; ei < e_info_end; ++ei) { 
             const EdgeInfo &e_info = e_infos[ei];
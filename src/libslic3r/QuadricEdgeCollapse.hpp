@@ -18,11 +18,14 @@ namespace Slic3r {
 /// Output: Last used ErrorValue to collapse edge</param>
 /// <param name="throw_on_cancel">Could stop process of calculation.</param>
 /// <param name="statusfn">Give a feed back to user about progress. Values 1 - 100</param>
+/// <param name="allow_partitions">Simplify large meshes by spatial partitions in parallel.
+/// When false the mesh is simplified as a whole by a single thread.</param>
 void its_quadric_edge_collapse(
     indexed_triangle_set &    its,
-    uint32_t                  triangle_count  = 0,
-    float *                   max_error       = nullptr,
-    std::function<void(void)> throw_on_cancel = nullptr,
-    std::function<void(int)>  statusfn        = nullptr);
+    uint32_t                  triangle_count   = 0,
+    float *                   max_error        = nullptr,
+    std::function<void(void)> throw_on_cancel  = nullptr,
+    std::function<void(int)>  statusfn         = nullptr,
+    bool                      allow_partitions = true);
 
 } // namespace Slic3r
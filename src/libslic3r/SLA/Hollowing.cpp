@@ -12,6 +12,8 @@
 
 #include <boost/log/trivial.hpp>
 
+#include <openvdb/tools/SignedFloodFill.h>
+
 #include <libslic3r/MTUtils.hpp>
 #include <libslic3r/I18N.hpp>
 
@@ -108,6 +110,180 @@ static InteriorPtr generate_interior_verbose(const TriangleMesh & mesh,
     return interior;
 }
 
+// Permute the coordinates cyclically so that the axis becomes Z. The orientation of the triangles is kept.
+static void axis_to_z(indexed_triangle_set &its, int axis)
+{
+    if (axis == 0)
+        for (Vec3f &v : its.vertices) v = Vec3f(v.y(), v.z(), v.x());
+    else if (axis == 1)
+        for (Vec3f &v : its.vertices) v = Vec3f(v.z(), v.x(), v.y());
+}
+
+static void z_to_axis(indexed_triangle_set &its, int axis)
+{
+    axis_to_z(its, axis == 0 ? 1 : axis == 1 ? 0 : 2);
+}
+
+// Part of the mesh inside the box, closed by caps if triangulate_caps.
+static indexed_triangle_set crop_mesh(const indexed_triangle_set &its, const BoundingBoxf3 &box, bool triangulate_caps)
+{
+    // Only the triangles of the slab of the box along X are copied. The first cut needs all the triangles crossing
+    // its plane to close the cut by a cap, all of them are in the slab, the following cuts work on the slab only.
+    indexed_triangle_set out;
+    std::vector<int>     vertex_map(its.vertices.size(), -1);
+    for (const stl_triangle_vertex_indices &face : its.indices) {
+        const float x0 = its.vertices[face(0)].x(), x1 = its.vertices[face(1)].x(), x2 = its.vertices[face(2)].x();
+        if (std::max({ x0, x1, x2 }) < box.min.x() || std::min({ x0, x1, x2 }) > box.max.x())
+            continue;
+        stl_triangle_vertex_indices new_face;
+        for (int i = 0; i < 3; ++ i) {
+            int &idx = vertex_map[face(i)];
+            if (idx == -1) {
+                idx = int(out.vertices.size());
+                out.vertices.emplace_back(its.vertices[face(i)]);
+            }
+            new_face(i) = idx;
+        }
+        out.indices.emplace_back(new_face);
+    }
+
+    for (int axis = 0; axis < 3 && ! out.indices.empty(); ++ axis) {
+        indexed_triangle_set upper, lower;
+        axis_to_z(out, axis);
+        cut_mesh(out, float(box.min[axis]), &upper, nullptr, triangulate_caps);
+        cut_mesh(upper, float(box.max[axis]), nullptr, &lower, triangulate_caps);
+        z_to_axis(lower, axis);
+        its_compactify_vertices(lower);
+        out = std::move(lower);
+    }
+    return out;
+}
+
+// Copy the values of the grid of a tile inside the box of the tile into the grid of the whole interior.
+static void copy_tile_grid(openvdb::FloatGrid &grid, const openvdb::FloatGrid &tile_grid, const openvdb::CoordBBox &tile_box)
+{
+    auto accessor = grid.getAccessor();
+    for (auto it = tile_grid.cbeginValueOn(); it; ++ it)
+        if (it.isVoxelValue()) {
+            if (tile_box.isInside(it.getCoord()))
+                accessor.setValue(it.getCoord(), *it);
+        } else {
+            openvdb::CoordBBox bbox = it.getBoundingBox();
+            bbox.intersect(tile_box);
+            if (! bbox.empty()) {
+                grid.tree().fill(bbox, *it, true);
+                accessor.clear();
+            }
+        }
+}
+
+// Hollow the mesh tile by tile. Each tile is cut from the mesh with an overlap wide enough for the caps
+// of the cut not to influence the interior inside the tile, hollowed with its own grid and its interior is
+// clipped back to the tile. The interiors of the tiles are stitched by welding the vertices on the tile boundaries.
+// The narrow bands of the grids of the tiles are copied into a single grid, which is kept by the interior for
+// hollow_mesh() to remove the triangles inside the cavity. Only the grid of a single tile is processed at a time.
+static InteriorPtr generate_interior_tiled(const TriangleMesh & mesh,
+                                           const JobController &ctl,
+                                           double min_thickness,
+                                           double voxel_scale,
+                                           double closing_dist,
+                                           double tile_size)
+{
+    // The interior depends on the mesh up to the narrow band inwards, the redistancing doubles it.
+    const double margin = 2.2 * (min_thickness + closing_dist) + 3. / voxel_scale;
+    const BoundingBoxf3 bb = mesh.bounding_box();
+    const Vec3d  size = bb.size();
+    const Vec3i  num_tiles { std::max(1, int(std::ceil(size.x() / tile_size))),
+                             std::max(1, int(std::ceil(size.y() / tile_size))),
+                             std::max(1, int(std::ceil(size.z() / tile_size))) };
+    const size_t num_tiles_total = size_t(num_tiles.x()) * size_t(num_tiles.y()) * size_t(num_tiles.z());
+
+    // Tile boundary coordinates along each axis, the outer ones outside of the mesh.
+    std::array<std::vector<double>, 3> boundaries;
+    for (int axis = 0; axis < 3; ++ axis) {
+        for (int i = 0; i <= num_tiles[axis]; ++ i)
+            boundaries[axis].emplace_back(bb.min[axis] + size[axis] * i / num_tiles[axis]);
+        boundaries[axis].front() -= margin;
+        boundaries[axis].back()  += margin;
+    }
+
+    InteriorPtr             interior = InteriorPtr{new Interior{}};
+    openvdb::FloatGrid::Ptr gridptr;
+    size_t                  tile_idx = 0;
+    for (int iz = 0; iz < num_tiles.z(); ++ iz)
+        for (int iy = 0; iy < num_tiles.y(); ++ iy)
+            for (int ix = 0; ix < num_tiles.x(); ++ ix, ++ tile_idx) {
+                if (ctl.stopcondition()) return {};
+                else ctl.statuscb(unsigned(100 * tile_idx / num_tiles_total), L("Hollowing"));
+
+                BoundingBoxf3 tile { Vec3d(boundaries[0][ix], boundaries[1][iy], boundaries[2][iz]),
+                                     Vec3d(boundaries[0][ix + 1], boundaries[1][iy + 1], boundaries[2][iz + 1]) };
+                BoundingBoxf3 tile_with_margin = tile;
+                tile_with_margin.offset(margin);
+
+                TriangleMesh piece { crop_mesh(mesh.its, tile_with_margin, true) };
+                if (piece.empty())
+                    continue;
+
+                JobController tile_ctl;
+                tile_ctl.stopcondition = ctl.stopcondition;
+                tile_ctl.cancelfn      = ctl.cancelfn;
+                InteriorPtr tile_interior = generate_interior_verbose(piece, tile_ctl, min_thickness, voxel_scale, closing_dist);
+                if (! tile_interior) {
+                    if (ctl.stopcondition()) return {};
+                    continue;
+                }
+                its_merge(interior->mesh, crop_mesh(tile_interior->mesh, tile, false));
+
+                const openvdb::FloatGrid &tile_grid = *tile_interior->gridptr;
+                if (! gridptr) {
+                    gridptr = openvdb::FloatGrid::create(tile_grid.background());
+                    gridptr->setTransform(tile_grid.transform().copy());
+                    gridptr->setGridClass(openvdb::GRID_LEVEL_SET);
+                    gridptr->insertMeta(*tile_grid.deepCopyMeta());
+                }
+                // Voxels of the tile, the grids are sampled at the mesh coordinates scaled by voxel_scale.
+                auto to_coord = [voxel_scale](const Vec3d &pt, int offset) {
+                    return openvdb::Coord(int(std::lround(pt.x() * voxel_scale)) + offset,
+                                          int(std::lround(pt.y() * voxel_scale)) + offset,
+                                          int(std::lround(pt.z() * voxel_scale)) + offset);
+                };
+                copy_tile_grid(*gridptr, tile_grid, openvdb::CoordBBox(to_coord(tile.min, 0), to_coord(tile.max, -1)));
+                // The grid of the tile is released here.
+            }
+
+    if (! gridptr)
+        return {};
+    // Set the signs of the inactive voxels outside of the narrow band, which were not copied from the tiles.
+    openvdb::tools::signedFloodFill(gridptr->tree());
+    interior->gridptr = gridptr;
+
+    // Snap the vertices on the tile boundaries, so that the vertices cut from the neighbor tiles are welded.
+    const float snap = float(0.01 / voxel_scale);
+    for (Vec3f &v : interior->mesh.vertices)
+        for (int axis = 0; axis < 3; ++ axis)
+            if (num_tiles[axis] > 1) {
+                auto it = std::lower_bound(boundaries[axis].begin() + 1, boundaries[axis].end() - 1, double(v[axis]) - snap);
+                if (it != boundaries[axis].end() - 1 && std::abs(*it - v[axis]) <= snap) {
+                    v[axis] = float(*it);
+                    for (int other = 0; other < 3; ++ other)
+                        if (other != axis)
+                            v[other] = snap * std::round(v[other] / snap);
+                }
+            }
+    its_merge_vertices(interior->mesh);
+
+    ctl.statuscb(100, L("Hollowing"));
+
+    interior->closing_distance = voxel_scale * closing_dist;
+    interior->thickness        = voxel_scale * min_thickness;
+    interior->voxel_scale      = voxel_scale;
+    interior->nb_in            = 1.1 * (interior->thickness + interior->closing_distance);
+    interior->nb_out           = interior->nb_in;
+
+    return interior;
+}
+
 InteriorPtr generate_interior(const TriangleMesh &   mesh,
                               const HollowingConfig &hc,
                               const JobController &  ctl)
@@ -124,9 +300,13 @@ InteriorPtr generate_interior(const TriangleMesh &   mesh,
     // max 8x upscale, min is native voxel size
     auto voxel_scale = MIN_OVERSAMPL + (MAX_OVERSAMPL - MIN_OVERSAMPL) * hc.quality;
 
+    const Vec3d size = mesh.bounding_box().size();
     InteriorPtr interior =
-        generate_interior_verbose(mesh, ctl, hc.min_thickness, voxel_scale,
-                                  hc.closing_distance);
+        hc.tile_size > 0. && size.maxCoeff() > hc.tile_size ?
+            generate_interior_tiled(mesh, ctl, hc.min_thickness, voxel_scale,
+                                    hc.closing_distance, hc.tile_size) :
+            generate_interior_verbose(mesh, ctl, hc.min_thickness, voxel_scale,
+                                      hc.closing_distance);
 
     if (interior && !interior->mesh.empty()) {
 
@@ -15,6 +15,9 @@ struct HollowingConfig
     double quality          = 0.5;
     double closing_distance = 0.5;
     bool enabled = true;
+    // Edge of the cubic tiles in mm. Each tile is hollowed using its own grid, which bounds
+    // the memory of large objects hollowed at a fine quality. Zero: one grid for the whole object.
+    double tile_size        = 0.;
 };
 
 enum HollowingFlags { hfRemoveInsideTriangles = 0x1 };
@@ -6,31 +6,15 @@
 #include <libslic3r/SLA/RasterBase.hpp>
 #include <libslic3r/SLA/AGGRaster.hpp>
 
-// minz image write:
-#include <miniz.h>
+#include <libslic3r/PNGReadWrite.hpp>
 
 namespace Slic3r { namespace sla {
 
 EncodedRaster PNGRasterEncoder::operator()(const void *ptr, size_t w, size_t h,
                                            size_t      num_components)
 {
-    std::vector<uint8_t> buf;
-    size_t s = 0;
-
-    void *rawdata = tdefl_write_image_to_png_file_in_memory(
-        ptr, int(w), int(h), int(num_components), &s);
-
-    // On error, data() will return an empty vector. No other info can be
-    // retrieved from miniz anyway...
-    if (rawdata == nullptr) return EncodedRaster({}, "png");
-
-    auto pptr = static_cast<std::uint8_t*>(rawdata);
-
-    buf.reserve(s);
-    std::copy(pptr, pptr + s, std::back_inserter(buf));
-
-    MZ_FREE(rawdata);
-    return EncodedRaster(std::move(buf), "png");
+    // On error, data() will return an empty vector.
+    return EncodedRaster(png::encode_png(static_cast<const uint8_t *>(ptr), w, h, int(num_components)), "png");
 }
 
 std::ostream &operator<<(std::ostream &stream, const EncodedRaster &bytes)
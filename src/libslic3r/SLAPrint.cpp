@@ -19,6 +19,18 @@
 #include <libnest2d/tools/benchmark.h>
 #endif
 
+// See the note on the TBB pipeline interface in GCode.cpp.
+#if ! defined(TBB_VERSION_MAJOR)
+    #include <tbb/version.h>
+#endif
+#if TBB_VERSION_MAJOR >= 2021
+    #include <tbb/parallel_pipeline.h>
+    using slic3r_tbb_filtermode = tbb::filter_mode;
+#else
+    #include <tbb/pipeline.h>
+    using slic3r_tbb_filtermode = tbb::filter;
+#endif
+
 #include "I18N.hpp"
 
 //! macro used to mark string used at localization,
@@ -668,6 +680,85 @@ StringObjectException SLAPrint::validate(StringObjectException *exception, Polyg
     return {};
 }
 
+void SLAArchive::write_layers(const SLAPrint &print, const std::function<void(size_t layer_id, const sla::EncodedRaster &raster)> &writefn)
+{
+    const std::vector<SLAPrint::PrintLayer> &layers = print.print_layers();
+    if (! this->streaming() || (m_layers_kept && m_layers.size() == layers.size())) {
+        // Rasterized by draw_layers() or kept from the last export. The statistics of that rasterization stay valid.
+        for (size_t i = 0; i < m_layers.size(); ++ i) {
+            if (print.canceled())
+                throw CanceledException();
+            writefn(i, m_layers[i]);
+        }
+        return;
+    }
+
+    m_raster_statistics        = {};
+    m_raster_statistics.layers = layers.size();
+    m_layers_kept              = false;
+    // Keep the layers for the next export until they exceed the memory budget.
+    bool keep = m_max_bytes_kept > 0;
+    m_layers  = {};
+    if (keep)
+        m_layers.resize(layers.size());
+
+    // Rasterize and encode in parallel, write in the order of layers. The number of live tokens
+    // bounds the number of encoded layers waiting for their predecessors to be written.
+    size_t layer_id         = 0;
+    // Encoded layers in flight and the kept ones.
+    size_t bytes_in_memory  = 0;
+    std::mutex bytes_mutex;
+    const auto generator = tbb::make_filter<void, size_t>(slic3r_tbb_filtermode::serial_in_order,
+        [&layer_id, &layers, &print](tbb::flow_control &fc) -> size_t {
+            if (print.canceled())
+                throw CanceledException();
+            if (layer_id == layers.size()) {
+                fc.stop();
+                return 0;
+            }
+            return layer_id ++;
+        });
+    const auto rasterize = tbb::make_filter<size_t, std::pair<size_t, sla::EncodedRaster>>(slic3r_tbb_filtermode::parallel,
+        [this, &layers, &print, &bytes_in_memory, &bytes_mutex](size_t idx) -> std::pair<size_t, sla::EncodedRaster> {
+            if (print.canceled())
+                throw CanceledException();
+            auto rst = create_raster();
+            for (const ExPolygon &poly : layers[idx].transformed_slices())
+                rst->draw(poly);
+            if (print.canceled())
+                throw CanceledException();
+            sla::EncodedRaster enc = rst->encode(get_encoder());
+            {
+                std::lock_guard<std::mutex> lock(bytes_mutex);
+                bytes_in_memory += enc.size();
+                m_raster_statistics.peak_bytes_in_memory = std::max(m_raster_statistics.peak_bytes_in_memory, bytes_in_memory);
+            }
+            return { idx, std::move(enc) };
+        });
+    const auto output = tbb::make_filter<std::pair<size_t, sla::EncodedRaster>, void>(slic3r_tbb_filtermode::serial_in_order,
+        [this, &writefn, &print, &keep, &bytes_in_memory, &bytes_mutex](std::pair<size_t, sla::EncodedRaster> layer) {
+            if (print.canceled())
+                throw CanceledException();
+            writefn(layer.first, layer.second);
+            const size_t size = layer.second.size();
+            std::lock_guard<std::mutex> lock(bytes_mutex);
+            m_raster_statistics.encoded_bytes += size;
+            if (keep && m_raster_statistics.encoded_bytes <= m_max_bytes_kept) {
+                m_layers[layer.first] = std::move(layer.second);
+            } else {
+                if (keep) {
+                    // Over the budget, release the layers kept so far. The next export will rasterize again.
+                    bytes_in_memory -= m_raster_statistics.encoded_bytes - size;
+                    m_layers = {};
+                    keep     = false;
+                }
+                bytes_in_memory -= size;
+            }
+        });
+    tbb::parallel_pipeline(m_max_layers_in_flight, generator & rasterize & output);
+    m_layers_kept = keep;
+}
+
 void SLAPrint::set_printer(SLAArchive *arch)
 {
     invalidate_step(slapsRasterize);
@@ -920,6 +1011,7 @@ bool SLAPrintObject::invalidate_state_by_config_options(const std::vector<t_conf
             || opt_key == "hollowing_min_thickness"
             || opt_key == "hollowing_quality"
             || opt_key == "hollowing_closing_distance"
+            || opt_key == "hollowing_tile_size"
             ) {
             steps.emplace_back(slaposHollowing);
         } else if (
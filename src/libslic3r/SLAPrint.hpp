@@ -2,6 +2,7 @@
 #define slic3r_SLAPrint_hpp_
 
 #include <cstdint>
+#include <functional>
 #include <mutex>
 #include "PrintBase.hpp"
 #include "SLA/RasterBase.hpp"
@@ -388,17 +389,52 @@ struct SLAPrintStatistics
 };
 
 class SLAArchive {
+public:
+    // Memory held by the encoded rasters of the last rasterization, reported per job.
+    struct RasterStatistics {
+        size_t layers               = 0;
+        // Sum of the sizes of all the encoded layers.
+        size_t encoded_bytes        = 0;
+        // Maximum of the encoded bytes held in memory at the same time.
+        size_t peak_bytes_in_memory = 0;
+    };
+
 protected:
     std::vector<sla::EncodedRaster> m_layers;
+    RasterStatistics                m_raster_statistics;
+    // Zero: the layers are rasterized by draw_layers() and kept in m_layers until exported.
+    // Otherwise draw_layers() does nothing and the layers are rasterized, encoded and written
+    // by write_layers() with at most this number of encoded layers held in memory.
+    size_t                          m_max_layers_in_flight = 0;
+    // Streaming mode: the layers written by write_layers() are kept in m_layers for the next export
+    // as long as all of them fit into this number of bytes. Cleared by draw_layers().
+    size_t                          m_max_bytes_kept       = 0;
+    // Streaming mode: m_layers holds all the layers written by the last write_layers().
+    bool                            m_layers_kept          = false;
 
     virtual std::unique_ptr<sla::RasterBase> create_raster() const = 0;
     virtual sla::RasterEncoder get_encoder() const = 0;
 
+    // Pass the encoded layers to writefn in the order of layers. In the streaming mode the layers are rasterized
+    // from print.print_layers() in parallel and each one is written as soon as its predecessors are written,
+    // unless the layers of the last export were kept. Throws CanceledException if the print is canceled.
+    void write_layers(const SLAPrint &print, const std::function<void(size_t layer_id, const sla::EncodedRaster &raster)> &writefn);
+
 public:
     virtual ~SLAArchive() = default;
 
     virtual void apply(const SLAPrinterConfig &cfg) = 0;
 
+    void set_max_layers_in_flight(size_t max_layers, size_t max_bytes_kept = 0)
+    {
+        m_max_layers_in_flight = max_layers;
+        m_max_bytes_kept       = max_bytes_kept;
+        m_layers               = {};
+        m_layers_kept          = false;
+    }
+    bool streaming() const { return m_max_layers_in_flight > 0; }
+    const RasterStatistics& raster_statistics() const { return m_raster_statistics; }
+
     // Fn have to be thread safe: void(sla::RasterBase& raster, size_t lyrid);
     template<class Fn, class CancelFn, class EP = ExecutionTBB>
     void draw_layers(
@@ -407,6 +443,13 @@ public:
         CancelFn cancelfn = []() { return false; },
         const EP & ep       = {})
     {
+        if (this->streaming()) {
+            // Rasterized on export by write_layers().
+            m_layers      = {};
+            m_layers_kept = false;
+            return;
+        }
+
         m_layers.resize(layer_num);
         execution::for_each(
             ep, size_t(0), m_layers.size(),
@@ -419,6 +462,12 @@ public:
                 enc = rst->encode(get_encoder());
             },
             execution::max_concurrency(ep));
+
+        m_raster_statistics        = {};
+        m_raster_statistics.layers = m_layers.size();
+        for (const sla::EncodedRaster &enc : m_layers)
+            m_raster_statistics.encoded_bytes += enc.size();
+        m_raster_statistics.peak_bytes_in_memory = m_raster_statistics.encoded_bytes;
     }
 };
 
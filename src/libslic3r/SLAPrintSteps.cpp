@@ -132,6 +132,7 @@ void SLAPrint::Steps::hollow_model(SLAPrintObject &po)
     double quality  = po.m_config.hollowing_quality.getFloat();
     double closing_d = po.m_config.hollowing_closing_distance.getFloat();
     sla::HollowingConfig hlwcfg{thickness, quality, closing_d};
+    hlwcfg.tile_size = po.m_config.hollowing_tile_size.getFloat();
 
     sla::InteriorPtr interior = generate_interior(po.transformed_mesh(), hlwcfg);
 
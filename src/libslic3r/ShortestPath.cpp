@@ -10,6 +10,7 @@
 #include "MutablePriorityQueue.hpp"
 #include "Print.hpp"
 
+#include <chrono>
 #include <cmath>
 #include <cassert>
 
@@ -998,11 +999,22 @@ std::vector<std::pair<size_t, bool>> chain_segments_greedy2(SegmentEndPointFunc
 	return chain_segments_greedy_constrained_reversals2_<PointType, SegmentEndPointFunc, false, decltype(could_reverse_func)>(end_point_func, could_reverse_func, num_segments, start_near);
 }
 
-std::vector<std::pair<size_t, bool>> chain_extrusion_entities(std::vector<ExtrusionEntity*> &entities, const Point *start_near)
+std::vector<std::pair<size_t, bool>> chain_extrusion_entities(std::vector<ExtrusionEntity*> &entities, const Point *start_near, const ChainingParams &params)
 {
 	auto segment_end_point = [&entities](size_t idx, bool first_point) -> const Point& { return first_point ? entities[idx]->first_point() : entities[idx]->last_point(); };
 	auto could_reverse = [&entities](size_t idx) { const ExtrusionEntity *ee = entities[idx]; return ee->is_loop() || ee->can_reverse(); };
 	std::vector<std::pair<size_t, bool>> out = chain_segments_greedy_constrained_reversals<Point, decltype(segment_end_point), decltype(could_reverse)>(segment_end_point, could_reverse, entities.size(), start_near);
+	if (params.refinement == ChainingParams::Refinement::TwoOpt && out.size() > 2) {
+		std::vector<std::pair<Point, Point>> end_points;
+		std::vector<char>                    could_reverse_segment;
+		end_points.reserve(entities.size());
+		could_reverse_segment.reserve(entities.size());
+		for (size_t i = 0; i < entities.size(); ++ i) {
+			end_points.emplace_back(segment_end_point(i, true), segment_end_point(i, false));
+			could_reverse_segment.emplace_back(could_reverse(i));
+		}
+		improve_ordering_by_two_opt(out, end_points, could_reverse_segment, start_near != nullptr, params.time_budget);
+	}
 	for (std::pair<size_t, bool> &segment : out) {
 		ExtrusionEntity *ee = entities[segment.first];
 		if (ee->is_loop())
@@ -1028,12 +1040,12 @@ void reorder_extrusion_entities(std::vector<ExtrusionEntity*> &entities, const s
     entities.swap(out);
 }
 
-void chain_and_reorder_extrusion_entities(std::vector<ExtrusionEntity*> &entities, const Point *start_near)
+void chain_and_reorder_extrusion_entities(std::vector<ExtrusionEntity*> &entities, const Point *start_near, const ChainingParams &params)
 {
     // this function crashes if there are empty elements in entities
     entities.erase(std::remove_if(entities.begin(), entities.end(), [](ExtrusionEntity *entity) { return static_cast<ExtrusionEntityCollection *>(entity)->empty(); }),
                    entities.end());
-	reorder_extrusion_entities(entities, chain_extrusion_entities(entities, start_near));
+	reorder_extrusion_entities(entities, chain_extrusion_entities(entities, start_near, params));
 }
 
 std::vector<std::pair<size_t, bool>> chain_extrusion_paths(std::vector<ExtrusionPath> &extrusion_paths, const Point *start_near)
@@ -1269,669 +1281,151 @@ static inline void improve_ordering_by_segment_flipping(Polylines &polylines, bo
 }
 #endif
 
-struct FlipEdge {
-	FlipEdge(const Vec2d &p1, const Vec2d &p2, size_t source_index) : p1(p1), p2(p2), source_index(source_index) {}
-	void	flip() { std::swap(this->p1, this->p2); }
-	Vec2d	p1;
-	Vec2d	p2;
-	size_t	source_index;
-};
-
-struct ConnectionCost {
-	ConnectionCost(double cost, double cost_flipped) : cost(cost), cost_flipped(cost_flipped) {}
-	ConnectionCost() : cost(0.), cost_flipped(0.) {}
-	void	flip() { std::swap(this->cost, this->cost_flipped); }
-	double	cost = 0;
-	double	cost_flipped = 0;
-};
-static inline ConnectionCost operator-(const ConnectionCost &lhs, const ConnectionCost& rhs) { return ConnectionCost(lhs.cost - rhs.cost, lhs.cost_flipped - rhs.cost_flipped); }
-
-static inline std::pair<double, size_t> minimum_crossover_cost(
-	const std::vector<FlipEdge>		  &edges,
-	const std::pair<size_t, size_t>   &span1, const ConnectionCost &cost1,
-	const std::pair<size_t, size_t>   &span2, const ConnectionCost &cost2,
-	const std::pair<size_t, size_t>   &span3, const ConnectionCost &cost3,
-	const double					   cost_current)
+double chain_travel_length(const std::vector<std::pair<size_t, bool>> &chain, const std::vector<std::pair<Point, Point>> &end_points)
 {
-	auto connection_cost = [&edges](
-		const std::pair<size_t, size_t> &span1, const ConnectionCost &cost1, bool reversed1, bool flipped1,
-		const std::pair<size_t, size_t> &span2, const ConnectionCost &cost2, bool reversed2, bool flipped2,
-		const std::pair<size_t, size_t> &span3, const ConnectionCost &cost3, bool reversed3, bool flipped3) {
-		auto first_point = [&edges](const std::pair<size_t, size_t> &span, bool flipped) { return flipped ? edges[span.first].p2 : edges[span.first].p1; };
-		auto last_point  = [&edges](const std::pair<size_t, size_t> &span, bool flipped) { return flipped ? edges[span.second - 1].p1 : edges[span.second - 1].p2; };
-		auto point       = [first_point, last_point](const std::pair<size_t, size_t> &span, bool start, bool flipped) { return start ? first_point(span, flipped) : last_point(span, flipped); };
-		auto cost        = [](const ConnectionCost &acost, bool flipped) { 
-			assert(acost.cost >= 0. && acost.cost_flipped >= 0.);
-			return flipped ? acost.cost_flipped : acost.cost;
-		};
-		// Ignore reversed single segment spans.
-		auto simple_span_ignore = [](const std::pair<size_t, size_t>& span, bool reversed) {
-			return span.first + 1 == span.second && reversed;
-		};
-		assert(span1.first < span1.second);
-		assert(span2.first < span2.second);
-		assert(span3.first < span3.second);
-		return 
-			simple_span_ignore(span1, reversed1) || simple_span_ignore(span2, reversed2) || simple_span_ignore(span3, reversed3) ?
-				// Don't perform unnecessary calculations simulating reversion of single segment spans.
-				std::numeric_limits<double>::max() :
-				// Calculate the cost of reverting chains and / or flipping segment orientations.
-				cost(cost1, flipped1) + cost(cost2, flipped2) + cost(cost3, flipped3) +
-					(point(span2, ! reversed2, flipped2) - point(span1, reversed1, flipped1)).norm() + 
-					(point(span3, ! reversed3, flipped3) - point(span2, reversed2, flipped2)).norm();
-	};
-
-#ifndef NDEBUG
-	{
-		double c = connection_cost(span1, cost1, false, false, span2, cost2, false, false, span3, cost3, false, false);
-		assert(std::abs(c - cost_current) < SCALED_EPSILON);
+	double length = 0.;
+	for (size_t i = 1; i < chain.size(); ++ i) {
+		const std::pair<Point, Point> &prev = end_points[chain[i - 1].first];
+		const std::pair<Point, Point> &next = end_points[chain[i].first];
+		length += ((chain[i].second ? next.second : next.first) - (chain[i - 1].second ? prev.first : prev.second)).cast<double>().norm();
 	}
-#endif /* NDEBUG */
-
-	double cost_min = cost_current;
-	size_t flip_min = 0; // no flip, no improvement
-	for (size_t i = 0; i < (1 << 6); ++ i) {
-		// From the three combinations of 1,2,3 ordering, the other three are reversals of the first three.
-		double c1 = (i == 0) ? cost_current : 
-			        connection_cost(span1, cost1, (i & 1) != 0, (i & (1 << 1)) != 0, span2, cost2, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span3, cost3, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0);
-		double c2 = connection_cost(span1, cost1, (i & 1) != 0, (i & (1 << 1)) != 0, span3, cost3, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span2, cost2, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0);
-		double c3 = connection_cost(span2, cost2, (i & 1) != 0, (i & (1 << 1)) != 0, span1, cost1, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span3, cost3, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0);
-		if (c1 < cost_min) {
-			cost_min = c1;
-			flip_min = i;
-		}
-		if (c2 < cost_min) {
-			cost_min = c2;
-			flip_min = i + (1 << 6);
-		}
-		if (c3 < cost_min) {
-			cost_min = c3;
-			flip_min = i + (2 << 6);
-		}
-	}
-	return std::make_pair(cost_min, flip_min);
+	return length;
 }
 
-#if 0
-static inline std::pair<double, size_t> minimum_crossover_cost(
-	const std::vector<FlipEdge>		  &edges,
-	const std::pair<size_t, size_t>   &span1, const ConnectionCost &cost1,
-	const std::pair<size_t, size_t>   &span2, const ConnectionCost &cost2,
-	const std::pair<size_t, size_t>   &span3, const ConnectionCost &cost3,
-	const std::pair<size_t, size_t>   &span4, const ConnectionCost &cost4,
-	const double					   cost_current)
+// 2-opt on a chain of segments: reversing a run of the chain and flipping its segments replaces the two connections at the ends of the run.
+// Only the moves creating a connection between an end point and one of its closest end points are tried, the candidates
+// are taken from a KD tree. Segments next to an applied move are queued for another try ("don't look bits").
+void improve_ordering_by_two_opt(std::vector<std::pair<size_t, bool>> &chain, const std::vector<std::pair<Point, Point>> &end_points,
+                                 const std::vector<char> &could_reverse, bool fixed_start, double time_budget)
 {
-	auto connection_cost = [&edges](
-		const std::pair<size_t, size_t> &span1, const ConnectionCost &cost1, bool reversed1, bool flipped1,
-		const std::pair<size_t, size_t> &span2, const ConnectionCost &cost2, bool reversed2, bool flipped2,
-		const std::pair<size_t, size_t> &span3, const ConnectionCost &cost3, bool reversed3, bool flipped3,
-		const std::pair<size_t, size_t> &span4, const ConnectionCost &cost4, bool reversed4, bool flipped4) {
-		auto first_point = [&edges](const std::pair<size_t, size_t> &span, bool flipped) { return flipped ? edges[span.first].p2 : edges[span.first].p1; };
-		auto last_point  = [&edges](const std::pair<size_t, size_t> &span, bool flipped) { return flipped ? edges[span.second - 1].p1 : edges[span.second - 1].p2; };
-		auto point       = [first_point, last_point](const std::pair<size_t, size_t> &span, bool start, bool flipped) { return start ? first_point(span, flipped) : last_point(span, flipped); };
-		auto cost        = [](const ConnectionCost &acost, bool flipped) { 
-			assert(acost.cost >= 0. && acost.cost_flipped >= 0.);
-			return flipped ? acost.cost_flipped : acost.cost;
-		};
-		// Ignore reversed single segment spans.
-		auto simple_span_ignore = [](const std::pair<size_t, size_t>& span, bool reversed) {
-			return span.first + 1 == span.second && reversed;
-		};
-		assert(span1.first < span1.second);
-		assert(span2.first < span2.second);
-		assert(span3.first < span3.second);
-		assert(span4.first < span4.second);
-		return 
-			simple_span_ignore(span1, reversed1) || simple_span_ignore(span2, reversed2) || simple_span_ignore(span3, reversed3) || simple_span_ignore(span4, reversed4) ?
-				// Don't perform unnecessary calculations simulating reversion of single segment spans.
-				std::numeric_limits<double>::max() :
-				// Calculate the cost of reverting chains and / or flipping segment orientations.
-				cost(cost1, flipped1) + cost(cost2, flipped2) + cost(cost3, flipped3) + cost(cost4, flipped4) +
-					(point(span2, ! reversed2, flipped2) - point(span1, reversed1, flipped1)).norm() + 
-					(point(span3, ! reversed3, flipped3) - point(span2, reversed2, flipped2)).norm() +
-					(point(span4, ! reversed4, flipped4) - point(span3, reversed3, flipped3)).norm();
-	};
-
-#ifndef NDEBUG
-	{
-		double c = connection_cost(span1, cost1, false, false, span2, cost2, false, false, span3, cost3, false, false, span4, cost4, false, false);
-		assert(std::abs(c - cost_current) < SCALED_EPSILON);
-	}
-#endif /* NDEBUG */
+	const size_t num_segments = chain.size();
+	if (num_segments < 3)
+		return;
 
-	double cost_min = cost_current;
-	size_t flip_min = 0; // no flip, no improvement
-	for (size_t i = 0; i < (1 << 8); ++ i) {
-		// From the three combinations of 1,2,3 ordering, the other three are reversals of the first three.
-		size_t permutation = 0;
-		for (double c : {
-				(i == 0) ? cost_current : 
-				connection_cost(span1, cost1, (i & 1) != 0, (i & (1 << 1)) != 0, span2, cost2, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span3, cost3, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, span4, cost4, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0),
-				connection_cost(span1, cost1, (i & 1) != 0, (i & (1 << 1)) != 0, span2, cost2, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span4, cost4, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, span3, cost3, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0),
-				connection_cost(span1, cost1, (i & 1) != 0, (i & (1 << 1)) != 0, span3, cost3, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span2, cost2, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, span4, cost4, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0),
-				connection_cost(span1, cost1, (i & 1) != 0, (i & (1 << 1)) != 0, span3, cost3, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span4, cost4, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, span2, cost2, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0),
-				connection_cost(span1, cost1, (i & 1) != 0, (i & (1 << 1)) != 0, span4, cost4, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span2, cost2, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, span3, cost3, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0),
-				connection_cost(span1, cost1, (i & 1) != 0, (i & (1 << 1)) != 0, span4, cost4, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span3, cost3, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, span2, cost2, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0),
-				connection_cost(span2, cost2, (i & 1) != 0, (i & (1 << 1)) != 0, span1, cost1, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span3, cost3, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, span4, cost4, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0),
-				connection_cost(span2, cost2, (i & 1) != 0, (i & (1 << 1)) != 0, span1, cost1, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span4, cost4, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, span3, cost3, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0),
-				connection_cost(span2, cost2, (i & 1) != 0, (i & (1 << 1)) != 0, span3, cost3, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span1, cost1, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, span4, cost4, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0),
-				connection_cost(span2, cost2, (i & 1) != 0, (i & (1 << 1)) != 0, span4, cost4, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span1, cost1, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, span3, cost3, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0),
-				connection_cost(span3, cost3, (i & 1) != 0, (i & (1 << 1)) != 0, span1, cost1, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span2, cost2, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, span4, cost4, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0),
-				connection_cost(span3, cost3, (i & 1) != 0, (i & (1 << 1)) != 0, span2, cost2, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span1, cost1, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, span4, cost4, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0)
-			}) {
-			if (c < cost_min) {
-				cost_min = c;
-				flip_min = i + (permutation << 8);
-			}
-			++ permutation;
-		}
-	}
-	return std::make_pair(cost_min, flip_min);
-}
-#endif
+	// Number of the closest end points to try a move with.
+	static constexpr size_t num_neighbors = 8;
 
-static inline void do_crossover(const std::vector<FlipEdge> &edges_in, std::vector<FlipEdge> &edges_out,
-	const std::pair<size_t, size_t> &span1, const std::pair<size_t, size_t> &span2, const std::pair<size_t, size_t> &span3,
-	size_t i)
-{
-	assert(edges_in.size() == edges_out.size());
-	auto do_it = [&edges_in, &edges_out](
-		const std::pair<size_t, size_t> &span1, bool reversed1, bool flipped1,
-		const std::pair<size_t, size_t> &span2, bool reversed2, bool flipped2,
-		const std::pair<size_t, size_t> &span3, bool reversed3, bool flipped3) {
-		auto it_edges_out = edges_out.begin();
-        auto copy_span = [&edges_in, &it_edges_out](std::pair<size_t, size_t> span, bool reversed, bool flipped) {
-			assert(span.first < span.second);
-			auto it = it_edges_out;
-			if (reversed)
-				std::reverse_copy(edges_in.begin() + span.first, edges_in.begin() + span.second, it_edges_out);
-			else
-				std::copy        (edges_in.begin() + span.first, edges_in.begin() + span.second, it_edges_out);
-			it_edges_out += span.second - span.first;
-			if (reversed != flipped) {
-				for (; it != it_edges_out; ++ it)
-					it->flip();
-			}
-		};
-		copy_span(span1, reversed1, flipped1);
-		copy_span(span2, reversed2, flipped2);
-		copy_span(span3, reversed3, flipped3);
+	const auto time_start = std::chrono::steady_clock::now();
+	auto       time_out   = [time_budget, time_start]() {
+		return time_budget > 0. && std::chrono::duration<double>(std::chrono::steady_clock::now() - time_start).count() > time_budget;
 	};
-	switch (i >> 6) {
-	case 0:
-		do_it(span1, (i & 1) != 0, (i & (1 << 1)) != 0, span2, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span3, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0);
-		break;
-	case 1:
-		do_it(span1, (i & 1) != 0, (i & (1 << 1)) != 0, span3, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span2, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0);
-		break;
-	default:
-		assert((i >> 6) == 2);
-		do_it(span2, (i & 1) != 0, (i & (1 << 1)) != 0, span1, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span3, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0);
-	}
-	assert(edges_in.size() == edges_out.size());
-}
 
-#if 0
-static inline void do_crossover(const std::vector<FlipEdge> &edges_in, std::vector<FlipEdge> &edges_out,
-	const std::pair<size_t, size_t> &span1, const std::pair<size_t, size_t> &span2, const std::pair<size_t, size_t> &span3, const std::pair<size_t, size_t> &span4,
-	size_t i)
-{
-	assert(edges_in.size() == edges_out.size());
-	auto do_it = [&edges_in, &edges_out](
-		const std::pair<size_t, size_t> &span1, bool reversed1, bool flipped1,
-		const std::pair<size_t, size_t> &span2, bool reversed2, bool flipped2,
-		const std::pair<size_t, size_t> &span3, bool reversed3, bool flipped3,
-		const std::pair<size_t, size_t> &span4, bool reversed4, bool flipped4) {
-		auto it_edges_out = edges_out.begin();
-        auto copy_span = [&edges_in, &it_edges_out](std::pair<size_t, size_t> span, bool reversed, bool flipped) {
-			assert(span.first < span.second);
-			auto it = it_edges_out;
-			if (reversed)
-				std::reverse_copy(edges_in.begin() + span.first, edges_in.begin() + span.second, it_edges_out);
-			else
-				std::copy        (edges_in.begin() + span.first, edges_in.begin() + span.second, it_edges_out);
-			it_edges_out += span.second - span.first;
-			if (reversed != flipped) {
-				for (; it != it_edges_out; ++ it)
-					it->flip();
-			}
-		};
-		copy_span(span1, reversed1, flipped1);
-		copy_span(span2, reversed2, flipped2);
-		copy_span(span3, reversed3, flipped3);
-		copy_span(span4, reversed4, flipped4);
-	};
-	switch (i >> 8) {
-	case 0:
-		assert(i != 0); // otherwise it would be a no-op
-		do_it(span1, (i & 1) != 0, (i & (1 << 1)) != 0, span2, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span3, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, span4, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0);
-		break;
-	case 1:
-		do_it(span1, (i & 1) != 0, (i & (1 << 1)) != 0, span2, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span4, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, span3, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0);
-		break;
-	case 2:
-		do_it(span1, (i & 1) != 0, (i & (1 << 1)) != 0, span3, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span2, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, span4, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0);
-		break;
-	case 3:
-		do_it(span1, (i & 1) != 0, (i & (1 << 1)) != 0, span3, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span4, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, span2, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0);
-		break;
-	case 4:
-		do_it(span1, (i & 1) != 0, (i & (1 << 1)) != 0, span4, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span2, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, span3, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0);
-		break;
-	case 5:
-		do_it(span1, (i & 1) != 0, (i & (1 << 1)) != 0, span4, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span3, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, span2, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0);
-		break;
-	case 6:
-		do_it(span2, (i & 1) != 0, (i & (1 << 1)) != 0, span1, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span3, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, span4, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0);
-		break;
-	case 7:
-		do_it(span2, (i & 1) != 0, (i & (1 << 1)) != 0, span1, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span4, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, span3, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0);
-		break;
-	case 8:
-		do_it(span2, (i & 1) != 0, (i & (1 << 1)) != 0, span3, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span1, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, span4, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0);
-		break;
-	case 9:
-		do_it(span2, (i & 1) != 0, (i & (1 << 1)) != 0, span4, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span1, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, span3, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0);
-		break;
-	case 10:
-		do_it(span3, (i & 1) != 0, (i & (1 << 1)) != 0, span1, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span2, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, span4, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0);
-		break;
-	default:
-		assert((i >> 8) == 11);
-		do_it(span3, (i & 1) != 0, (i & (1 << 1)) != 0, span2, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, span1, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, span4, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0);
-		break;
+	// End point 2 * i is the first point of segment i, 2 * i + 1 is its last point.
+	std::vector<Vec2d> points(num_segments * 2);
+	for (size_t i = 0; i < num_segments; ++ i) {
+		points[i * 2]     = end_points[chain[i].first].first.cast<double>();
+		points[i * 2 + 1] = end_points[chain[i].first].second.cast<double>();
 	}
-	assert(edges_in.size() == edges_out.size());
-}
-#endif
-
-// Worst time complexity:    O(min(n, 100) * (n * log n + n^2)
-// Expected time complexity: O(min(n, 100) * (n * log n + k * n)
-// where n is the number of edges and k is the number of connection_lengths candidates after the first one
-// is found that improves the total cost.
-//FIXME there are likley better heuristics to lower the time complexity.
-static inline void reorder_by_two_exchanges_with_segment_flipping(std::vector<FlipEdge> &edges)
-{
-	if (edges.size() < 2)
-		return;
-
-	std::vector<ConnectionCost> 			connections(edges.size());
-	std::vector<FlipEdge> 					edges_tmp(edges);
-	std::vector<std::pair<double, size_t>>	connection_lengths(edges.size() - 1, std::pair<double, size_t>(0., 0));
-	std::vector<char>						connection_tried(edges.size(), false);
-	const size_t 							max_iterations = std::min(edges.size(), size_t(100));
-	for (size_t iter = 0; iter < max_iterations; ++ iter) {
-		// Initialize connection costs and connection lengths.
-		for (size_t i = 1; i < edges.size(); ++ i) {
-			const FlipEdge   	 &e1 = edges[i - 1];
-			const FlipEdge   	 &e2 = edges[i];
-			ConnectionCost	     &c  = connections[i];
-			c = connections[i - 1];
-			double l = (e2.p1 - e1.p2).norm();
-			c.cost += l;
-			c.cost_flipped += (e2.p2 - e1.p1).norm();
-			connection_lengths[i - 1] = std::make_pair(l, i);
-		}
-		std::sort(connection_lengths.begin(), connection_lengths.end(), [](const std::pair<double, size_t> &l, const std::pair<double, size_t> &r) { return l.first > r.first; });
-		std::fill(connection_tried.begin(), connection_tried.end(), false);
-		size_t crossover1_pos_final = std::numeric_limits<size_t>::max();
-		size_t crossover2_pos_final = std::numeric_limits<size_t>::max();
-		size_t crossover_flip_final = 0;
-        for (const std::pair<double, size_t>& first_crossover_candidate : connection_lengths) {
-            size_t longest_connection_idx = first_crossover_candidate.second;
-			connection_tried[longest_connection_idx] = true;
-			// Find the second crossover connection with the lowest total chain cost.
-			size_t crossover_pos_min  = std::numeric_limits<size_t>::max();
-			double crossover_cost_min = connections.back().cost;
-			size_t crossover_flip_min = 0;
-			for (size_t j = 1; j < connections.size(); ++ j)
-				if (! connection_tried[j]) {
-					size_t a = j;
-					size_t b = longest_connection_idx;
-					if (a > b)
-						std::swap(a, b);
-					std::pair<double, size_t> cost_and_flip = minimum_crossover_cost(edges, 
-						std::make_pair(size_t(0), a), connections[a - 1], std::make_pair(a, b), connections[b - 1] - connections[a], std::make_pair(b, edges.size()), connections.back() - connections[b],
-						connections.back().cost);
-					if (cost_and_flip.second > 0 && cost_and_flip.first < crossover_cost_min) {
-						crossover_pos_min  = j;
-						crossover_cost_min = cost_and_flip.first;
-						crossover_flip_min = cost_and_flip.second;
-						assert(crossover_cost_min < connections.back().cost + EPSILON);
-					}
-				}
-			if (crossover_cost_min < connections.back().cost) {
-				// The cost of the chain with the proposed two crossovers has a lower total cost than the current chain. Apply the crossover.
-				crossover1_pos_final = longest_connection_idx;
-				crossover2_pos_final = crossover_pos_min;
-				crossover_flip_final = crossover_flip_min;
-				break;
-			} else {
-				// Continue with another long candidate edge.
-			}
-		}
-		if (crossover_flip_final > 0) {
-			// Pair of cross over positions and flip / reverse constellation has been found, which improves the total cost of the connection.
-			// Perform a crossover.
-			if (crossover1_pos_final > crossover2_pos_final)
-				std::swap(crossover1_pos_final, crossover2_pos_final);
-			do_crossover(edges, edges_tmp, std::make_pair(size_t(0), crossover1_pos_final), std::make_pair(crossover1_pos_final, crossover2_pos_final), std::make_pair(crossover2_pos_final, edges.size()), crossover_flip_final);
-			edges.swap(edges_tmp);
-		} else {
-			// No valid pair of cross over positions was found improving the total cost. Giving up.
-			break;
+	std::vector<std::array<uint32_t, num_neighbors>> neighbors(points.size());
+	{
+		auto coordinate_fn = [&points](size_t idx, size_t dimension) -> double { return points[idx][dimension]; };
+		KDTreeIndirect<2, double, decltype(coordinate_fn)> kdtree(coordinate_fn, points.size());
+		for (size_t idx = 0; idx < points.size(); ++ idx) {
+			std::array<size_t, num_neighbors> closest = find_closest_points<num_neighbors>(kdtree, points[idx], [idx](size_t other) { return (other ^ idx) > 1; });
+			for (size_t i = 0; i < num_neighbors; ++ i)
+				neighbors[idx][i] = closest[i] == KDTreeIndirect<2, double, decltype(coordinate_fn)>::npos ? std::numeric_limits<uint32_t>::max() : uint32_t(closest[i]);
 		}
 	}
-}
 
-#if 0
-// Currently not used, too slow.
-static inline void reorder_by_three_exchanges_with_segment_flipping(std::vector<FlipEdge> &edges)
-{
-	if (edges.size() < 3) {
-		reorder_by_two_exchanges_with_segment_flipping(edges);
-		return;
-	}
-
-	std::vector<ConnectionCost> 			connections(edges.size());
-	std::vector<FlipEdge> 					edges_tmp(edges);
-	std::vector<std::pair<double, size_t>>	connection_lengths(edges.size() - 1, std::pair<double, size_t>(0., 0));
-	std::vector<char>						connection_tried(edges.size(), false);
-	for (size_t iter = 0; iter < edges.size(); ++ iter) {
-		// Initialize connection costs and connection lengths.
-		for (size_t i = 1; i < edges.size(); ++ i) {
-			const FlipEdge   	 &e1 = edges[i - 1];
-			const FlipEdge   	 &e2 = edges[i];
-			ConnectionCost	     &c  = connections[i];
-			c = connections[i - 1];
-			double l = (e2.p1 - e1.p2).norm();
-			c.cost += l;
-			c.cost_flipped += (e2.p2 - e1.p1).norm();
-			connection_lengths[i - 1] = std::make_pair(l, i);
-		}
-		std::sort(connection_lengths.begin(), connection_lengths.end(), [](const std::pair<double, size_t> &l, const std::pair<double, size_t> &r) { return l.first > r.first; });
-		std::fill(connection_tried.begin(), connection_tried.end(), false);
-		size_t crossover1_pos_final = std::numeric_limits<size_t>::max();
-		size_t crossover2_pos_final = std::numeric_limits<size_t>::max();
-		size_t crossover3_pos_final = std::numeric_limits<size_t>::max();
-		size_t crossover_flip_final = 0;
-        for (const std::pair<double, size_t> &first_crossover_candidate : connection_lengths) {
-            size_t longest_connection_idx = first_crossover_candidate.second;
-            connection_tried[longest_connection_idx] = true;
-			// Find the second crossover connection with the lowest total chain cost.
-			double crossover_cost_min = connections.back().cost;
-			for (size_t j = 1; j < connections.size(); ++ j)
-				if (! connection_tried[j]) {
-					for (size_t k = j + 1; k < connections.size(); ++ k)
-						if (! connection_tried[k]) {
-							size_t a = longest_connection_idx;
-							size_t b = j;
-							size_t c = k;
-							if (a > c)
-								std::swap(a, c);
-							if (a > b)
-								std::swap(a, b);
-							if (b > c)
-								std::swap(b, c);
-							std::pair<double, size_t> cost_and_flip = minimum_crossover_cost(edges, 
-								std::make_pair(size_t(0), a), connections[a - 1], std::make_pair(a, b), connections[b - 1] - connections[a], 
-								std::make_pair(b, c), connections[c - 1] - connections[b], std::make_pair(c, edges.size()), connections.back() - connections[c],
-								connections.back().cost);
-							if (cost_and_flip.second > 0 && cost_and_flip.first < crossover_cost_min) {
-								crossover_cost_min   = cost_and_flip.first;
-								crossover1_pos_final = a;
-								crossover2_pos_final = b;
-								crossover3_pos_final = c;
-								crossover_flip_final = cost_and_flip.second;
-								assert(crossover_cost_min < connections.back().cost + EPSILON);
-							}
-						}
-				}
-			if (crossover_flip_final > 0) {
-				// The cost of the chain with the proposed two crossovers has a lower total cost than the current chain. Apply the crossover.
-				break;
-			} else {
-				// Continue with another long candidate edge.
-			}
-		}
-		if (crossover_flip_final > 0) {
-			// Pair of cross over positions and flip / reverse constellation has been found, which improves the total cost of the connection.
-			// Perform a crossover.
-			do_crossover(edges, edges_tmp, std::make_pair(size_t(0), crossover1_pos_final), std::make_pair(crossover1_pos_final, crossover2_pos_final), 
-				std::make_pair(crossover2_pos_final, crossover3_pos_final), std::make_pair(crossover3_pos_final, edges.size()), crossover_flip_final);
-			edges.swap(edges_tmp);
-		} else {
-			// No valid pair of cross over positions was found improving the total cost. Giving up.
-			break;
-		}
+	// Segments are identified by their position in the input chain. order[k] is the segment at position k, pos[segment] its position.
+	std::vector<uint32_t> order(num_segments);
+	std::vector<uint32_t> pos(num_segments);
+	std::vector<char>     reversed(num_segments);
+	for (size_t i = 0; i < num_segments; ++ i) {
+		order[i]    = uint32_t(i);
+		pos[i]      = uint32_t(i);
+		reversed[i] = chain[i].second;
 	}
-}
-#endif
-
-typedef Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::DontAlign> Matrixd;
-
-class FourOptCosts {
-public:
-	FourOptCosts(const ConnectionCost &c1, const ConnectionCost &c2, const ConnectionCost &c3, const ConnectionCost &c4) : costs { &c1, &c2, &c3, &c4 } {}
-
-	double operator()(size_t piece_idx, bool flipped) const { return flipped ? costs[piece_idx]->cost_flipped : costs[piece_idx]->cost; }
-
-private:
-	const ConnectionCost* costs[4];
-};
-
-#if 0
-static inline std::pair<double, size_t> minimum_crossover_cost(
-	const FourOptCosts				  &segment_costs,
-	const Matrixd 					  &segment_end_point_distance_matrix,
-	const double					   cost_current)
-{
-	// Distance from the end of span1 to the start of span2.
-	auto end_point_distance = [&segment_end_point_distance_matrix](size_t span1, bool reversed1, bool flipped1, size_t span2, bool reversed2, bool flipped2) {
-		return segment_end_point_distance_matrix(span1 * 4 + (! reversed1) * 2 + flipped1, span2 * 4 + reversed2 * 2 + flipped2);
+	// Prefix sum of the segments, which could not be reversed, over the positions.
+	std::vector<uint32_t> fixed_prefix(num_segments + 1, 0);
+	auto update_fixed_prefix = [&](size_t begin, size_t end) {
+		if (! could_reverse.empty())
+			for (size_t k = begin; k < end; ++ k)
+				fixed_prefix[k + 1] = fixed_prefix[k] + (could_reverse[chain[order[k]].first] ? 0 : 1);
 	};
-	auto connection_cost = [&segment_costs, end_point_distance](
-		const size_t span1, bool reversed1, bool flipped1,
-		const size_t span2, bool reversed2, bool flipped2,
-		const size_t span3, bool reversed3, bool flipped3,
-		const size_t span4, bool reversed4, bool flipped4) {
-		// Calculate the cost of reverting chains and / or flipping segment orientations.
-		return segment_costs(span1, flipped1) + segment_costs(span2, flipped2) + segment_costs(span3, flipped3) + segment_costs(span4, flipped4) +
-			   end_point_distance(span1, reversed1, flipped1, span2, reversed2, flipped2) +
-			   end_point_distance(span2, reversed2, flipped2, span3, reversed3, flipped3) +
-			   end_point_distance(span3, reversed3, flipped3, span4, reversed4, flipped4);
+	update_fixed_prefix(0, num_segments);
+
+	auto start_point = [&](size_t k) -> const Vec2d& { return points[order[k] * 2 + (reversed[order[k]] ? 1 : 0)]; };
+	auto end_point   = [&](size_t k) -> const Vec2d& { return points[order[k] * 2 + (reversed[order[k]] ? 0 : 1)]; };
+	// Change of the travel length by reversing the run of positions <i + 1, j>, where -1 <= i < j < num_segments.
+	auto move_cost = [&](int i, size_t j) -> double {
+		double cost = 0.;
+		if (i >= 0)
+			cost += (end_point(j) - end_point(i)).norm() - (start_point(i + 1) - end_point(i)).norm();
+		if (j + 1 < num_segments)
+			cost += (start_point(j + 1) - start_point(i + 1)).norm() - (start_point(j + 1) - end_point(j)).norm();
+		return cost;
+	};
+	auto move_valid = [&](int i, size_t j) {
+		return (i >= 0 || ! fixed_start) && (i >= 0 || j + 1 < num_segments) && fixed_prefix[j + 1] == fixed_prefix[i + 1];
 	};
 
-#ifndef NDEBUG
-	{
-		double c = connection_cost(0, false, false, 1, false, false, 2, false, false, 3, false, false);
-		assert(std::abs(c - cost_current) < SCALED_EPSILON);
-	}
-#endif /* NDEBUG */
-
-	double cost_min = cost_current;
-	size_t flip_min = 0; // no flip, no improvement
-	for (size_t i = 0; i < (1 << 8); ++ i) {
-		// From the three combinations of 1,2,3 ordering, the other three are reversals of the first three.
-		size_t permutation = 0;
-		for (double c : {
-				(i == 0) ? cost_current : 
-				connection_cost(0, (i & 1) != 0, (i & (1 << 1)) != 0, 1, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, 2, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, 3, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0),
-				connection_cost(0, (i & 1) != 0, (i & (1 << 1)) != 0, 1, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, 3, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, 2, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0),
-				connection_cost(0, (i & 1) != 0, (i & (1 << 1)) != 0, 2, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, 1, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, 3, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0),
-				connection_cost(0, (i & 1) != 0, (i & (1 << 1)) != 0, 2, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, 3, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, 1, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0),
-				connection_cost(0, (i & 1) != 0, (i & (1 << 1)) != 0, 3, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, 1, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, 2, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0),
-				connection_cost(0, (i & 1) != 0, (i & (1 << 1)) != 0, 3, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, 2, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, 1, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0),
-				connection_cost(1, (i & 1) != 0, (i & (1 << 1)) != 0, 0, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, 2, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, 3, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0),
-				connection_cost(1, (i & 1) != 0, (i & (1 << 1)) != 0, 0, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, 3, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, 2, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0),
-				connection_cost(1, (i & 1) != 0, (i & (1 << 1)) != 0, 2, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, 0, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, 3, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0),
-				connection_cost(1, (i & 1) != 0, (i & (1 << 1)) != 0, 3, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, 0, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, 2, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0),
-				connection_cost(2, (i & 1) != 0, (i & (1 << 1)) != 0, 0, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, 1, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, 3, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0),
-				connection_cost(2, (i & 1) != 0, (i & (1 << 1)) != 0, 1, (i & (1 << 2)) != 0, (i & (1 << 3)) != 0, 0, (i & (1 << 4)) != 0, (i & (1 << 5)) != 0, 3, (i & (1 << 6)) != 0, (i & (1 << 7)) != 0)
-			}) {
-			if (c < cost_min) {
-				cost_min = c;
-				flip_min = i + (permutation << 8);
-			}
-			++ permutation;
-		}
-	}
-	return std::make_pair(cost_min, flip_min);
-}
-
-// Currently not used, too slow.
-static inline void reorder_by_three_exchanges_with_segment_flipping2(std::vector<FlipEdge> &edges)
-{
-	if (edges.size() < 3) {
-		reorder_by_two_exchanges_with_segment_flipping(edges);
-		return;
-	}
-
-	std::vector<ConnectionCost> 			connections(edges.size());
-	std::vector<FlipEdge> 					edges_tmp(edges);
-	std::vector<std::pair<double, size_t>>	connection_lengths(edges.size() - 1, std::pair<double, size_t>(0., 0));
-	std::vector<char>						connection_tried(edges.size(), false);
-	for (size_t iter = 0; iter < edges.size(); ++ iter) {
-		// Initialize connection costs and connection lengths.
-		for (size_t i = 1; i < edges.size(); ++ i) {
-			const FlipEdge   	 &e1 = edges[i - 1];
-			const FlipEdge   	 &e2 = edges[i];
-			ConnectionCost	     &c  = connections[i];
-			c = connections[i - 1];
-			double l = (e2.p1 - e1.p2).norm();
-			c.cost += l;
-			c.cost_flipped += (e2.p2 - e1.p1).norm();
-			connection_lengths[i - 1] = std::make_pair(l, i);
-		}
-		std::sort(connection_lengths.begin(), connection_lengths.end(), [](const std::pair<double, size_t> &l, const std::pair<double, size_t> &r) { return l.first > r.first; });
-		std::fill(connection_tried.begin(), connection_tried.end(), false);
-		size_t crossover1_pos_final = std::numeric_limits<size_t>::max();
-		size_t crossover2_pos_final = std::numeric_limits<size_t>::max();
-		size_t crossover3_pos_final = std::numeric_limits<size_t>::max();
-		size_t crossover_flip_final = 0;
-		// Distances between the end points of the four pieces of the current segment sequence.
-#ifdef NDEBUG
-		Matrixd segment_end_point_distance_matrix(4 * 4, 4 * 4);
-#else /* NDEBUG */
-		Matrixd segment_end_point_distance_matrix = Matrixd::Constant(4 * 4, 4 * 4, std::numeric_limits<double>::max());
-#endif /* NDEBUG */
-        for (const std::pair<double, size_t> &first_crossover_candidate : connection_lengths) {
-            size_t longest_connection_idx = first_crossover_candidate.second;
-            connection_tried[longest_connection_idx] = true;
-            // Find the second crossover connection with the lowest total chain cost.
-			double crossover_cost_min = connections.back().cost;
-			for (size_t j = 1; j < connections.size(); ++ j)
-				if (! connection_tried[j]) {
-					for (size_t k = j + 1; k < connections.size(); ++ k)
-						if (! connection_tried[k]) {
-							size_t a = longest_connection_idx;
-							size_t b = j;
-							size_t c = k;
-							if (a > c)
-								std::swap(a, c);
-							if (a > b)
-								std::swap(a, b);
-							if (b > c)
-								std::swap(b, c);
-							const Vec2d* endpts[16] = {
-								&edges[0].p1, &edges[0].p2, &edges[a - 1].p2, &edges[a - 1].p1,
-								&edges[a].p1, &edges[a].p2, &edges[b - 1].p2, &edges[b - 1].p1,
-								&edges[b].p1, &edges[b].p2, &edges[c - 1].p2, &edges[c - 1].p1,
-								&edges[c].p1, &edges[c].p2, &edges.back().p2, &edges.back().p1 };
-							for (size_t v = 0; v < 16; ++ v) {
-								const Vec2d &p1 = *endpts[v];
-								for (size_t u = (v & (~3)) + 4; u < 16; ++ u)
-									segment_end_point_distance_matrix(u, v) = segment_end_point_distance_matrix(v, u) = (*endpts[u] - p1).norm();
-							}
-							FourOptCosts segment_costs(connections[a - 1], connections[b - 1] - connections[a], connections[c - 1] - connections[b],  connections.back() - connections[c]);
-							std::pair<double, size_t> cost_and_flip = minimum_crossover_cost(segment_costs, segment_end_point_distance_matrix, connections.back().cost);
-							if (cost_and_flip.second > 0 && cost_and_flip.first < crossover_cost_min) {
-								crossover_cost_min   = cost_and_flip.first;
-								crossover1_pos_final = a;
-								crossover2_pos_final = b;
-								crossover3_pos_final = c;
-								crossover_flip_final = cost_and_flip.second;
-								assert(crossover_cost_min < connections.back().cost + EPSILON);
-							}
-						}
-				}
-			if (crossover_flip_final > 0) {
-				// The cost of the chain with the proposed two crossovers has a lower total cost than the current chain. Apply the crossover.
-				break;
-			} else {
-				// Continue with another long candidate edge.
-			}
+	std::vector<uint32_t> queue(order);
+	std::vector<char>     queued(num_segments, true);
+	auto push = [&](int k) {
+		if (k >= 0 && k < int(num_segments) && ! queued[order[k]]) {
+			queued[order[k]] = true;
+			queue.emplace_back(order[k]);
 		}
-		if (crossover_flip_final > 0) {
-			// Pair of cross over positions and flip / reverse constellation has been found, which improves the total cost of the connection.
-			// Perform a crossover.
-			do_crossover(edges, edges_tmp, std::make_pair(size_t(0), crossover1_pos_final), std::make_pair(crossover1_pos_final, crossover2_pos_final), 
-				std::make_pair(crossover2_pos_final, crossover3_pos_final), std::make_pair(crossover3_pos_final, edges.size()), crossover_flip_final);
-			edges.swap(edges_tmp);
-		} else {
-			// No valid pair of cross over positions was found improving the total cost. Giving up.
+	};
+	for (size_t iter = 0; ! queue.empty(); ++ iter) {
+		if ((iter & 63) == 0 && time_out())
 			break;
+		const uint32_t segment = queue.back();
+		queue.pop_back();
+		queued[segment] = false;
+		const size_t k = pos[segment];
+
+		// Find the best move connecting the end point of this segment with the end point of another segment,
+		// or the start point of this segment with the start point of another segment.
+		int    best_i    = 0;
+		size_t best_j    = 0;
+		double best_cost = - EPSILON;
+		for (int side = 0; side < 2; ++ side) {
+			const bool at_end = side == 1;
+			const uint32_t this_point = segment * 2 + ((reversed[segment] != 0) == at_end ? 0 : 1);
+			for (uint32_t other_point : neighbors[this_point]) {
+				if (other_point == std::numeric_limits<uint32_t>::max())
+					break;
+				const uint32_t other = other_point / 2;
+				// The other point has to be on the same side of its segment.
+				if ((other_point & 1) != ((reversed[other] != 0) == at_end ? 0u : 1u))
+					continue;
+				const size_t m  = pos[other];
+				const int    i  = int(std::min(k, m)) - (at_end ? 0 : 1);
+				const size_t j  = std::max(k, m) - (at_end ? 0 : 1);
+				if (move_valid(i, j))
+					if (double cost = move_cost(i, j); cost < best_cost) {
+						best_i    = i;
+						best_j    = j;
+						best_cost = cost;
+					}
+			}
 		}
-	}
-}
-#endif
-
-// Flip the sequences of polylines to lower the total length of connecting lines.
-// Used by the infill generator if the infill is not connected with perimeter lines
-// and to order the brim lines.
-static inline void improve_ordering_by_two_exchanges_with_segment_flipping(Polylines &polylines, bool fixed_start)
-{
-#ifndef NDEBUG
-	auto cost = [&polylines]() {
-		double sum = 0.;
-		for (size_t i = 1; i < polylines.size(); ++i)
-			sum += (polylines[i].first_point() - polylines[i - 1].last_point()).cast<double>().norm();
-		return sum;
-	};
-	double cost_initial = cost();
-
-	static int iRun = 0;
-	++ iRun;
-#ifdef DEBUG_SVG_OUTPUT
-	svg_draw_polyline_chain("improve_ordering_by_two_exchanges_with_segment_flipping-initial", iRun, polylines);
-#endif /* DEBUG_SVG_OUTPUT */
-#endif /* NDEBUG */
-
-	std::vector<FlipEdge> edges;
-	edges.reserve(polylines.size());
-    std::transform(polylines.begin(), polylines.end(), std::back_inserter(edges), 
-    	[&polylines](const Polyline &pl){ return FlipEdge(pl.first_point().cast<double>(), pl.last_point().cast<double>(), &pl - polylines.data()); });
-#if 1
-	reorder_by_two_exchanges_with_segment_flipping(edges);
-#else
-	// reorder_by_three_exchanges_with_segment_flipping(edges);
-	reorder_by_three_exchanges_with_segment_flipping2(edges);
-#endif
-	Polylines out;
-	out.reserve(polylines.size());
-	for (const FlipEdge &edge : edges) {
-		Polyline &pl = polylines[edge.source_index];
-		out.emplace_back(pl);
-		if (edge.p2 == pl.first_point().cast<double>()) {
-			// Polyline is flipped.
-			out.back().reverse();
-		} else {
-			// Polyline is not flipped.
-			assert(edge.p1 == pl.first_point().cast<double>());
+		if (best_cost < - EPSILON) {
+			std::reverse(order.begin() + (best_i + 1), order.begin() + (best_j + 1));
+			for (size_t l = size_t(best_i + 1); l <= best_j; ++ l) {
+				pos[order[l]] = uint32_t(l);
+				reversed[order[l]] = ! reversed[order[l]];
+			}
+			update_fixed_prefix(size_t(best_i + 1), best_j + 1);
+			push(int(pos[segment]));
+			push(best_i);
+			push(best_i + 1);
+			push(int(best_j));
+			push(int(best_j) + 1);
 		}
 	}
 
-#ifndef NDEBUG
-	double cost_final = cost();
-#ifdef DEBUG_SVG_OUTPUT
-	svg_draw_polyline_chain("improve_ordering_by_two_exchanges_with_segment_flipping-final", iRun, out);
-#endif /* DEBUG_SVG_OUTPUT */
-	assert(cost_final <= cost_initial);
-#endif /* NDEBUG */
+	std::vector<std::pair<size_t, bool>> out;
+	out.reserve(num_segments);
+	for (uint32_t segment : order)
+		out.emplace_back(chain[segment].first, reversed[segment] != 0);
+	chain = std::move(out);
 }
 
 // Used to optimize order of infill lines and brim lines.
-Polylines chain_polylines(Polylines &&polylines, const Point *start_near)
+Polylines chain_polylines(Polylines &&polylines, const Point *start_near, const ChainingParams &params)
 {
 #ifdef DEBUG_SVG_OUTPUT
 	static int iRun = 0;
@@ -1943,16 +1437,19 @@ Polylines chain_polylines(Polylines &&polylines, const Point *start_near)
 	if (! polylines.empty()) {
 		auto segment_end_point = [&polylines](size_t idx, bool first_point) -> const Point& { return first_point ? polylines[idx].first_point() : polylines[idx].last_point(); };
 		std::vector<std::pair<size_t, bool>> ordered = chain_segments_greedy2<Point, decltype(segment_end_point)>(segment_end_point, polylines.size(), start_near);
+		if (params.refinement == ChainingParams::Refinement::TwoOpt && ordered.size() > 2) {
+			std::vector<std::pair<Point, Point>> end_points;
+			end_points.reserve(polylines.size());
+			for (const Polyline &pl : polylines)
+				end_points.emplace_back(pl.first_point(), pl.last_point());
+			improve_ordering_by_two_opt(ordered, end_points, {}, start_near != nullptr, params.time_budget);
+		}
 		out.reserve(polylines.size()); 
 		for (auto &segment_and_reversal : ordered) {
 			out.emplace_back(std::move(polylines[segment_and_reversal.first]));
 			if (segment_and_reversal.second)
 				out.back().reverse();
 		}
-		if (out.size() > 1 && start_near == nullptr) {
-			improve_ordering_by_two_exchanges_with_segment_flipping(out, start_near != nullptr);
-			//improve_ordering_by_segment_flipping(out, start_near != nullptr);
-		}
 	}
 
 #ifdef DEBUG_SVG_OUTPUT
@@ -1978,7 +1475,7 @@ ClipperLib::PolyNodes chain_clipper_polynodes(const Points &points, const Clippe
 }
 
 // BBS
-std::vector<const PrintInstance*> chain_print_object_instances(const std::vector<const PrintObject*>& print_objects, const Point* start_near)
+std::vector<const PrintInstance*> chain_print_object_instances(const std::vector<const PrintObject*>& print_objects, const Point* start_near, const ChainingParams &params)
 {
 	// Order objects using a nearest neighbor search.
 	Points object_reference_points;
@@ -1993,6 +1490,13 @@ std::vector<const PrintInstance*> chain_print_object_instances(const std::vector
 	}
 	auto segment_end_point = [&object_reference_points](size_t idx, bool /* first_point */) -> const Point& { return object_reference_points[idx]; };
 	std::vector<std::pair<size_t, bool>> ordered = chain_segments_greedy<Point, decltype(segment_end_point)>(segment_end_point, instances.size(), start_near);
+	if (params.refinement == ChainingParams::Refinement::TwoOpt && ordered.size() > 2) {
+		std::vector<std::pair<Point, Point>> end_points;
+		end_points.reserve(object_reference_points.size());
+		for (const Point &pt : object_reference_points)
+			end_points.emplace_back(pt, pt);
+		improve_ordering_by_two_opt(ordered, end_points, {}, start_near != nullptr, params.time_budget);
+	}
 	std::vector<const PrintInstance*> out;
 	out.reserve(instances.size());
 	for (auto& segment_and_reversal : ordered) {
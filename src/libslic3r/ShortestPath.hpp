@@ -12,19 +12,33 @@ namespace ClipperLib { class PolyNode; }
 
 namespace Slic3r {
 
+// Optional refinement of the greedy chaining, selected per call site.
+struct ChainingParams
+{
+    enum class Refinement {
+        // Greedy multi-fragment chaining only.
+        None,
+        // 2-opt with segment flipping over the closest end points of each connection, see improve_ordering_by_two_opt().
+        TwoOpt,
+    };
+    Refinement refinement  { Refinement::None };
+    // Time budget of the refinement in seconds, zero means until no improving move is found.
+    double     time_budget { 0. };
+};
+
 std::vector<size_t> 				 chain_points(const Points &points, Point *start_near = nullptr);
 std::vector<size_t> 				 chain_expolygons(const ExPolygons &input_exploy);
 
-std::vector<std::pair<size_t, bool>> chain_extrusion_entities(std::vector<ExtrusionEntity*> &entities, const Point *start_near = nullptr);
+std::vector<std::pair<size_t, bool>> chain_extrusion_entities(std::vector<ExtrusionEntity*> &entities, const Point *start_near = nullptr, const ChainingParams &params = {});
 void                                 reorder_extrusion_entities(std::vector<ExtrusionEntity*> &entities, const std::vector<std::pair<size_t, bool>> &chain);
-void                                 chain_and_reorder_extrusion_entities(std::vector<ExtrusionEntity*> &entities, const Point *start_near = nullptr);
+void                                 chain_and_reorder_extrusion_entities(std::vector<ExtrusionEntity*> &entities, const Point *start_near = nullptr, const ChainingParams &params = {});
 
 std::vector<std::pair<size_t, bool>> chain_extrusion_paths(std::vector<ExtrusionPath> &extrusion_paths, const Point *start_near = nullptr);
 void                                 reorder_extrusion_paths(std::vector<ExtrusionPath> &extrusion_paths, std::vector<std::pair<size_t, bool>> &chain);
 void                                 chain_and_reorder_extrusion_paths(std::vector<ExtrusionPath> &extrusion_paths, const Point *start_near = nullptr);
 
-Polylines 							 chain_polylines(Polylines &&src, const Point *start_near = nullptr);
-inline Polylines 					 chain_polylines(const Polylines& src, const Point* start_near = nullptr) { Polylines tmp(src); return chain_polylines(std::move(tmp), start_near); }
+Polylines 							 chain_polylines(Polylines &&src, const Point *start_near = nullptr, const ChainingParams &params = {});
+inline Polylines 					 chain_polylines(const Polylines& src, const Point* start_near = nullptr, const ChainingParams &params = {}) { Polylines tmp(src); return chain_polylines(std::move(tmp), start_near, params); }
 template<typename T> inline void reorder_by_shortest_traverse(std::vector<T> &polylines_out)
 {
     Points start_point;
@@ -47,9 +61,18 @@ class Print;
 struct PrintInstance;
 // BBS
 class PrintObject;
-std::vector<const PrintInstance*> chain_print_object_instances(const std::vector<const PrintObject*>& print_objects, const Point* start_near);
+std::vector<const PrintInstance*> chain_print_object_instances(const std::vector<const PrintObject*>& print_objects, const Point* start_near, const ChainingParams &params = {});
 std::vector<const PrintInstance*> 	 chain_print_object_instances(const Print &print);
 
+// Improve a chain of segments by 2-opt moves with segment flipping, trying only the moves connecting an end point to one of its closest
+// end points. A move reverses a run of the chain, it is rejected if the run contains a segment, which could not be reversed.
+// Stops when no improving move is found or after time_budget seconds, if time_budget is positive.
+void                                 improve_ordering_by_two_opt(std::vector<std::pair<size_t, bool>> &chain, const std::vector<std::pair<Point, Point>> &end_points,
+                                                                 const std::vector<char> &could_reverse, bool fixed_start, double time_budget);
+
+// Length of the travels connecting the chained segments.
+double                               chain_travel_length(const std::vector<std::pair<size_t, bool>> &chain, const std::vector<std::pair<Point, Point>> &end_points);
+
 // Chain lines into polylines.
 Polylines 							 chain_lines(const std::vector<Line> &lines, const double point_distance_epsilon);
 
@@ -1,7 +1,7 @@
 #pragma once
 
 #include <oneapi/tbb/scalable_allocator.h>
-#include <oneapi/tbb/spin_mutex.h>
+#include <oneapi/tbb/enumerable_thread_specific.h>
 #include "../PrintConfig.hpp"
 #include "../Slicing.hpp"
 #include "../Fill/FillBase.hpp"
@@ -123,31 +123,36 @@ namespace Slic3r {
 	};
 
 // Layers are allocated and owned by a deque. Once a layer is allocated, it is maintained
-// up to the end of a generate() method. The layer storage may be replaced by an allocator class in the future, 
-// which would allocate layers by multiple chunks.
+// up to the end of a generate() method. Each thread allocates from its own deque,
+// thus allocation from parallel loops does not contend on a lock. The layers are
+// referenced by pointers only, they are never iterated, therefore the per-thread deques
+// need not be merged.
 class SupportGeneratorLayerStorage {
 public:
-	SupportGeneratorLayer& allocate_unguarded(SupporLayerType layer_type) { 
-		m_storage.emplace_back();
-		m_storage.back().layer_type = layer_type;
-	    return m_storage.back();
-	}
+	SupportGeneratorLayer& allocate_unguarded(SupporLayerType layer_type) { return this->allocate(layer_type); }
 
 	SupportGeneratorLayer& allocate(SupporLayerType layer_type)
 	{ 
-		m_mutex.lock();
-		m_storage.emplace_back();
-	    SupportGeneratorLayer *layer_new = &m_storage.back();
-		m_mutex.unlock();
-	    layer_new->layer_type = layer_type;
-	    return *layer_new;
+		LayerDeque &storage = m_storage.local();
+		storage.emplace_back();
+		storage.back().layer_type = layer_type;
+	    return storage.back();
+	}
+
+	// Number of layers allocated by all threads.
+	size_t size() const
+	{
+		size_t n = 0;
+		for (const LayerDeque &storage : m_storage)
+			n += storage.size();
+		return n;
 	}
 
 private:
 	template<typename BaseType>
-	using Allocator = tbb::scalable_allocator<BaseType>;
-	Slic3r::deque<SupportGeneratorLayer, Allocator<SupportGeneratorLayer>> 		m_storage;
-	tbb::spin_mutex                         									m_mutex;
+	using Allocator  = tbb::scalable_allocator<BaseType>;
+	using LayerDeque = Slic3r::deque<SupportGeneratorLayer, Allocator<SupportGeneratorLayer>>;
+	tbb::enumerable_thread_specific<LayerDeque, tbb::cache_aligned_allocator<LayerDeque>, tbb::ets_key_per_instance> m_storage;
 };
 	using SupportGeneratorLayersPtr = std::vector<SupportGeneratorLayer*>;
 } // namespace Slic3r
\ No newline at end of file
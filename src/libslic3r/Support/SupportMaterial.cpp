@@ -15,7 +15,6 @@
 #include <boost/container/static_vector.hpp>
 
 #include <tbb/parallel_for.h>
-#include <tbb/spin_mutex.h>
 #include <tbb/task_group.h>
 
 #define SUPPORT_USE_AGG_RASTERIZER
@@ -338,29 +337,6 @@ PrintObjectSupportMaterial::PrintObjectSupportMaterial(const PrintObject *object
 {
 }
 
-// Using the std::deque as an allocator.
-inline SupportGeneratorLayer& layer_allocate(
-    std::deque<SupportGeneratorLayer> &layer_storage, 
-    SupporLayerType      layer_type)
-{ 
-    layer_storage.push_back(SupportGeneratorLayer());
-    layer_storage.back().layer_type = layer_type;
-    return layer_storage.back();
-}
-
-inline SupportGeneratorLayer& layer_allocate(
-    std::deque<SupportGeneratorLayer> &layer_storage,
-    tbb::spin_mutex                                 &layer_storage_mutex,
-    SupporLayerType      layer_type)
-{ 
-    layer_storage_mutex.lock();
-    layer_storage.push_back(SupportGeneratorLayer());
-    SupportGeneratorLayer *layer_new = &layer_storage.back();
-    layer_storage_mutex.unlock();
-    layer_new->layer_type = layer_type;
-    return *layer_new;
-}
-
 inline void layers_append(SupportGeneratorLayersPtr &dst, const SupportGeneratorLayersPtr &src)
 {
     dst.insert(dst.end(), src.begin(), src.end());
@@ -1475,7 +1451,7 @@ static inline ExPolygons detect_overhangs(
                         }
 
                         if (is_sharp_tail) {
-                            ExPolygons overhang = diff_ex({ expoly }, lower_layer_expolys);
+                            ExPolygons overhang = diff_ex_indexed(expoly, lower_layer_expolys);
                             layer.sharp_tails.push_back(expoly);
                             layer.sharp_tails_height.push_back(accum_height);
                             overhang = offset_ex(overhang, 0.05 * fw);
@@ -2168,7 +2144,7 @@ SupportGeneratorLayersPtr PrintObjectSupportMaterial::top_contact_layers(
                     // check whether this is above a sharp tail region.
 
                     // 2.1 If no sharp tail below, this is considered as common region.
-                    ExPolygons supported_by_lower = intersection_ex({ expoly }, lower_layer_sharptails);
+                    ExPolygons supported_by_lower = intersection_ex_indexed(expoly, lower_layer_sharptails);
                     if (supported_by_lower.empty()) {
                         is_sharp_tail = false;
                         break;
@@ -2203,7 +2179,7 @@ SupportGeneratorLayersPtr PrintObjectSupportMaterial::top_contact_layers(
 
                     // 2.4 if the area grows fast than threshold, it get connected to other part or
                     // it has a sharp slop and will be auto supported.
-                    ExPolygons new_overhang_expolys = diff_ex({ expoly }, lower_layer_sharptails);
+                    ExPolygons new_overhang_expolys = diff_ex_indexed(expoly, lower_layer_sharptails);
                     Point size_diff = get_extents(new_overhang_expolys).size() - get_extents(lower_layer_sharptails).size();
                     if (size_diff.both_comp(Point(scale_(5), scale_(5)), ">") || !offset_ex(new_overhang_expolys, -5.0 * extrusion_width_scaled).empty()) {
                         is_sharp_tail = false;
@@ -2215,7 +2191,7 @@ SupportGeneratorLayersPtr PrintObjectSupportMaterial::top_contact_layers(
                 } while (0);
 
                 if (is_sharp_tail) {
-                    ExPolygons overhang = diff_ex({ expoly }, lower_layer->lslices);
+                    ExPolygons overhang = diff_ex_indexed(expoly, lower_layer->lslices);
                     layer->sharp_tails.push_back(expoly);
                     layer->sharp_tails_height.push_back( accum_height );
                     append(overhangs_per_layers[layer_nr], overhang);
@@ -2394,7 +2370,7 @@ static inline SupportGeneratorLayer* detect_bottom_contacts(
     if (top.empty())
         return nullptr;
 
-    Polygons touching = intersection(top, supports_projected);
+    Polygons touching = intersection_indexed(top, supports_projected);
     if (touching.empty())
         return nullptr;
 
@@ -2482,7 +2458,7 @@ static inline SupportGeneratorLayer* detect_bottom_contacts(
                 { { { union_ex(touching) },              { "touching", "blue", 0.5f } },
                     { { union_safety_offset_ex(above) }, { "above",    "red", "black", "", scaled<coord_t>(0.1f), 0.5f } } });
 #endif /* SLIC3R_DEBUG */
-            above = diff(above, touching);
+            above = diff_indexed(above, touching);
 #ifdef SLIC3R_DEBUG
             Slic3r::SVG::export_expolygons(
                 debug_out_path("support-support-areas-raw-after-trimming-%d-with-%f-%lf.svg", iRun, layer.print_z, layer_above.print_z),
@@ -2505,7 +2481,8 @@ static inline std::pair<Polygons, Polygons> project_support_to_grid(const Layer
     // Remove the areas that touched from the projection that will continue on next, lower, top surfaces.
 //            Polygons trimming = union_(to_polygons(layer.slices), touching, true);
     Polygons trimming = layer_buildplate_covered ? std::move(*layer_buildplate_covered) : offset(layer.lslices, float(SCALED_EPSILON));
-    Polygons overhangs_projection = diff(overhangs, trimming);
+    // Only the object islands overlapping the projected support columns are passed to Clipper.
+    Polygons overhangs_projection = diff_indexed(overhangs, trimming);
 
 #ifdef SLIC3R_DEBUG
     SVG::export_expolygons(debug_out_path("support-support-areas-%s-raw-%d-%lf.svg", debug_name, iRun, layer.print_z),
@@ -2617,6 +2594,8 @@ SupportGeneratorLayersPtr PrintObjectSupportMaterial::bottom_contact_layers_and_
         Polygons polygons_new;
         Polygons enforcers_new;
 #endif // SLIC3R_DEBUG
+        // Were any contact areas added to the projection at this layer?
+        bool contacts_added = false;
         for (; contact_idx >= 0 && top_contacts[contact_idx]->print_z > layer.print_z - EPSILON; -- contact_idx) {
             SupportGeneratorLayer &top_contact = *top_contacts[contact_idx];
 #ifndef SLIC3R_DEBUG
@@ -2642,13 +2621,16 @@ SupportGeneratorLayersPtr PrintObjectSupportMaterial::bottom_contact_layers_and_
             polygons_append(polygons_new, expand(*top_contact.overhang_polygons, float(SCALED_EPSILON)));
             polygons_append(overhangs_projection, union_(polygons_new));
             polygons_append(enforcers_projection, enforcers_new);
+            contacts_added = true;
         }
         if (overhangs_projection.empty() && enforcers_projection.empty())
             continue;
 
         // Overhangs_projection will be filled in asynchronously, move it away.
-        Polygons overhangs_projection_raw = union_(std::move(overhangs_projection));
-        Polygons enforcers_projection_raw = union_(std::move(enforcers_projection));
+        // The projection propagated from the layer above is a set of disjoint islands extracted from the support grid,
+        // thus it only needs to be merged again if new contact areas were added to it.
+        Polygons overhangs_projection_raw = contacts_added ? union_(std::move(overhangs_projection)) : std::move(overhangs_projection);
+        Polygons enforcers_projection_raw = contacts_added ? union_(std::move(enforcers_projection)) : std::move(enforcers_projection);
 
         tbb::task_group task_group;
         const Polygons &overhangs_for_bottom_contacts = buildplate_only ? enforcers_projection_raw : overhangs_projection_raw;
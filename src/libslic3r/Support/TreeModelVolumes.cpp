@@ -19,6 +19,7 @@
 #include "../Utils.hpp"
 #include "../format.hpp"
 
+#include <cstdlib>
 #include <string_view>
 
 #include <boost/log/trivial.hpp>
@@ -66,6 +67,11 @@ TreeModelVolumes::TreeModelVolumes(
 #endif // SLIC3R_TREESUPPORTS_PROGRESS
     m_machine_border{ calculateMachineBorderCollision(build_volume.polygon()) }
 {
+    for (RadiusLayerPolygonCache *cache : { &m_collision_cache, &m_collision_cache_holefree, &m_avoidance_cache, &m_avoidance_cache_slow,
+            &m_avoidance_cache_to_model, &m_avoidance_cache_to_model_slow, &m_placeable_areas_cache, &m_avoidance_cache_holefree,
+            &m_avoidance_cache_holefree_to_model, &m_wall_restrictions_cache, &m_wall_restrictions_cache_min })
+        cache->set_memory(m_cache_memory);
+
     m_bed_area = build_volume.polygon();
     Polygons machine_borders;
     if (!m_bed_area.empty()) {
@@ -175,10 +181,97 @@ TreeModelVolumes::TreeModelVolumes(
 #endif
 }
 
+TreeModelVolumes::CacheLimits TreeModelVolumes::CacheLimits::from_config(const PrintObjectConfig &config)
+{
+    CacheLimits out;
+    if (int mb = config.tree_support_cache_budget.value; mb > 0) {
+        out.lazy          = true;
+        out.memory_budget = size_t(mb) << 20;
+    }
+    out.radius_exponential_factor = config.tree_support_cache_radius_factor.value;
+    if (const char *env = std::getenv("SLIC3R_TREE_SUPPORT_CACHE_MB"); env != nullptr) {
+        if (long long mb = std::atoll(env); mb > 0) {
+            out.lazy          = true;
+            out.memory_budget = size_t(mb) << 20;
+        }
+    }
+    if (const char *env = std::getenv("SLIC3R_TREE_SUPPORT_RADIUS_FACTOR"); env != nullptr) {
+        if (double factor = std::atof(env); factor > 1.)
+            out.radius_exponential_factor = factor;
+    }
+    return out;
+}
+
+void TreeModelVolumes::set_cache_limits(const CacheLimits &limits)
+{
+    m_cache_limits = limits;
+    // Only coarser radius quantizations than the default one are supported.
+    m_cache_limits.radius_exponential_factor = std::max(m_cache_limits.radius_exponential_factor, SUPPORT_TREE_EXPONENTIAL_FACTOR);
+    // Without a budget nothing is evicted, thus the accesses are not recorded.
+    m_cache_memory->track_access = m_cache_limits.memory_budget > 0;
+}
+
+void TreeModelVolumes::enforce_memory_budget(LayerIndex max_layer_in_use)
+{
+    if (m_cache_limits.memory_budget == 0 || this->memory_usage() <= m_cache_limits.memory_budget)
+        return;
+
+    // Collect the radii of the releasable caches, least recently used first.
+    struct Candidate {
+        uint64_t                 last_access;
+        coord_t                  radius;
+        RadiusLayerPolygonCache *cache;
+    };
+    std::vector<Candidate> candidates;
+    for (RadiusLayerPolygonCache *cache : { &m_avoidance_cache, &m_avoidance_cache_slow, &m_avoidance_cache_to_model, &m_avoidance_cache_to_model_slow,
+            &m_avoidance_cache_holefree, &m_avoidance_cache_holefree_to_model })
+        for (const std::pair<uint64_t, coord_t> &access : cache->last_accesses())
+            candidates.push_back({ access.first, access.second, cache });
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate &l, const Candidate &r) { return l.last_access < r.last_access; });
+
+    // Only the layers above max_layer_in_use are released, so that the areas of a radius stay contiguous from layer zero
+    // and the incremental calculation of the avoidances restarts at the topmost kept layer.
+    size_t released = 0;
+    for (const Candidate &candidate : candidates) {
+        if (this->memory_usage() <= m_cache_limits.memory_budget)
+            break;
+        released += candidate.cache->erase_above(candidate.radius, max_layer_in_use);
+    }
+    if (released > 0)
+        // Released areas will be recalculated on demand, which is expected now.
+        m_precalculated = false;
+    BOOST_LOG_TRIVIAL(debug) << "Tree support caches: released " << released << " bytes above layer " << max_layer_in_use << ", using " <<
+        this->memory_usage() << " bytes, peak " << this->peak_memory_usage() << " bytes.";
+}
+
+bool TreeModelVolumes::cache_compatible(const TreeModelVolumes &rhs) const
+{
+    auto settings_equal = [](const TreeSupportMeshGroupSettings &l, const TreeSupportMeshGroupSettings &r) {
+        return l.layer_height == r.layer_height && l.resolution == r.resolution &&
+               l.support_top_distance == r.support_top_distance && l.support_bottom_distance == r.support_bottom_distance &&
+               l.support_xy_distance == r.support_xy_distance && l.support_material_buildplate_only == r.support_material_buildplate_only;
+    };
+    if (m_max_move != rhs.m_max_move || m_max_move_slow != rhs.m_max_move_slow || m_min_resolution != rhs.m_min_resolution ||
+        m_current_outline_idx != rhs.m_current_outline_idx || m_current_min_xy_dist != rhs.m_current_min_xy_dist ||
+        m_current_min_xy_dist_delta != rhs.m_current_min_xy_dist_delta || m_support_rests_on_model != rhs.m_support_rests_on_model ||
+        m_increase_until_radius != rhs.m_increase_until_radius || m_radius_0 != rhs.m_radius_0 || m_raft_layers != rhs.m_raft_layers ||
+        // The cached radii are sampled with the radius factor.
+        m_cache_limits.radius_exponential_factor != rhs.m_cache_limits.radius_exponential_factor ||
+        m_machine_border != rhs.m_machine_border || m_anti_overhang != rhs.m_anti_overhang ||
+        m_layer_outlines.size() != rhs.m_layer_outlines.size())
+        return false;
+    for (size_t i = 0; i < m_layer_outlines.size(); ++ i)
+        if (! settings_equal(m_layer_outlines[i].first, rhs.m_layer_outlines[i].first) || m_layer_outlines[i].second != rhs.m_layer_outlines[i].second)
+            return false;
+    return true;
+}
+
 void TreeModelVolumes::precalculate(const PrintObject& print_object, const coord_t max_layer, std::function<void()> throw_on_cancel)
 {
     auto t_start = std::chrono::high_resolution_clock::now();
     m_precalculated = true;
+    // precalculate() may be called again on reused caches with different tip settings.
+    m_ignorable_radii.clear();
 
     // Get the config corresponding to one mesh that is in the current group. Which one has to be irrelevant.
     // Not the prettiest way to do this, but it ensures some calculations that may be a bit more complex
@@ -205,6 +298,12 @@ void TreeModelVolumes::precalculate(const PrintObject& print_object, const coord
     if (throw_on_cancel)
         throw_on_cancel();
 
+    if (m_cache_limits.lazy) {
+        // Demand driven mode: the (radius, layer) pairs are calculated as they are queried.
+        m_precalculated = false;
+        return;
+    }
+
     // it may seem that the required avoidance can be of a smaller radius when going to model (no initial layer diameter for to model branches)
     // but as for every branch going towards the bp, the to model avoidance is required to check for possible merges with to model branches, this assumption is in-fact wrong.
     std::unordered_map<coord_t, LayerIndex> radius_until_layer;
@@ -270,7 +369,8 @@ void TreeModelVolumes::precalculate(const PrintObject& print_object, const coord
     auto dur_avo = 0.001 * std::chrono::duration_cast<std::chrono::microseconds>(t_end - t_coll).count();
 
 //    m_precalculated = true;
-    BOOST_LOG_TRIVIAL(info) << "Precalculating collision took" << dur_col << " ms. Precalculating avoidance took " << dur_avo << " ms.";
+    BOOST_LOG_TRIVIAL(info) << "Precalculating collision took" << dur_col << " ms. Precalculating avoidance took " << dur_avo << " ms. Caches use " <<
+        this->memory_usage() << " bytes.";
 
 #if 0
     // Paint caches into SVGs:
@@ -603,13 +703,19 @@ void TreeModelVolumes::calculateCollisionHolefree(const std::vector<RadiusLayerP
     for (long long unsigned int i = 0; i < keys.size(); i++)
         max_layer = std::max(max_layer, keys[i].second);
 
+    // Layers already calculated by a previous call over the reused caches are skipped.
+    std::vector<LayerIndex> first_layer_to_calculate;
+    first_layer_to_calculate.reserve(keys.size());
+    for (const RadiusLayerPair &key : keys)
+        first_layer_to_calculate.emplace_back(m_collision_cache_holefree.getMaxCalculatedLayer(key.first) + 1);
+
     tbb::parallel_for(tbb::blocked_range<LayerIndex>(0, max_layer + 1, keys.size()),
         [&](const tbb::blocked_range<LayerIndex> &range) {
         std::vector<std::pair<RadiusLayerPair, Polygons>> data;
         data.reserve(range.size() * keys.size());
         for (LayerIndex layer_idx = range.begin(); layer_idx < range.end(); ++ layer_idx) {
-            for (RadiusLayerPair key : keys)
-                if (layer_idx <= key.second) {
+            for (size_t key_idx = 0; key_idx < keys.size(); ++ key_idx)
+                if (RadiusLayerPair key = keys[key_idx]; layer_idx >= first_layer_to_calculate[key_idx] && layer_idx <= key.second) {
                     // Logically increase the collision by m_increase_until_radius
                     coord_t radius = key.first;
                     assert(radius == this->ceilRadius(radius));
@@ -872,13 +978,27 @@ coord_t TreeModelVolumes::ceilRadius(const coord_t radius) const
         } else
             out += SUPPORT_TREE_COLLISION_RESOLUTION;
         while (out < radius || ignore(out)) {
-            assert(out * SUPPORT_TREE_EXPONENTIAL_FACTOR > out + SUPPORT_TREE_COLLISION_RESOLUTION);
-            out = out * SUPPORT_TREE_EXPONENTIAL_FACTOR;
+            assert(out * m_cache_limits.radius_exponential_factor > out + SUPPORT_TREE_COLLISION_RESOLUTION);
+            out = out * m_cache_limits.radius_exponential_factor;
         }
     }
     return out;
 }
 
+size_t TreeModelVolumes::RadiusLayerPolygonCache::erase_above(coord_t radius, LayerIndex layer_idx)
+{
+    std::lock_guard<std::mutex> guard(m_mutex);
+    size_t released = 0;
+    for (LayerIndex i = std::max<LayerIndex>(0, layer_idx + 1); i < LayerIndex(m_data.size()); ++ i)
+        if (auto it = m_data[i].find(radius); it != m_data[i].end()) {
+            released += CacheMemory::polygons_bytes(it->second);
+            m_data[i].erase(it);
+        }
+    if (m_memory)
+        m_memory->remove(released);
+    return released;
+}
+
 void TreeModelVolumes::RadiusLayerPolygonCache::allocate_layers(size_t num_layers)
 {
     if (num_layers > m_data.size()) {
@@ -9,6 +9,8 @@
 #ifndef slic3r_TreeModelVolumes_hpp
 #define slic3r_TreeModelVolumes_hpp
 
+#include <atomic>
+#include <memory>
 #include <mutex>
 #include <unordered_map>
 
@@ -51,6 +53,43 @@ public:
     TreeModelVolumes(const TreeModelVolumes&) = delete;
     TreeModelVolumes& operator=(const TreeModelVolumes&) = delete;
 
+    /*!
+     * \brief Limits of the memory held by the collision and avoidance caches.
+     */
+    struct CacheLimits {
+        // Calculate the (radius, layer) pairs on demand instead of precalculating all of them in precalculate().
+        bool    lazy { false };
+        // Growth factor of the sampled radii above SUPPORT_TREE_EXPONENTIAL_THRESHOLD. A coarser quantization
+        // caches fewer radii at the cost of branches being pushed further away from the model.
+        double  radius_exponential_factor { SUPPORT_TREE_EXPONENTIAL_FACTOR };
+        // Soft limit of the cache memory in bytes enforced by enforce_memory_budget(), zero for no limit.
+        size_t  memory_budget { 0 };
+
+        // Read from tree_support_cache_budget (memory budget in MB, enables the lazy mode) and tree_support_cache_radius_factor
+        // (radius_exponential_factor), overridden by the SLIC3R_TREE_SUPPORT_CACHE_MB and SLIC3R_TREE_SUPPORT_RADIUS_FACTOR environment variables.
+        static CacheLimits from_config(const PrintObjectConfig &config);
+    };
+    // To be called before precalculate().
+    void set_cache_limits(const CacheLimits &limits);
+    const CacheLimits& cache_limits() const { return m_cache_limits; }
+
+    // Memory held by all the caches in bytes, approximated by the size of the polygons, and its maximum over the lifetime of this object.
+    size_t memory_usage() const { return m_cache_memory->used.load(std::memory_order_relaxed); }
+    size_t peak_memory_usage() const { return m_cache_memory->peak.load(std::memory_order_relaxed); }
+    // Number of the areas calculated and inserted into the caches over the lifetime of this object.
+    size_t calculated_areas() const { return m_cache_memory->inserted.load(std::memory_order_relaxed); }
+
+    /*!
+     * \brief Release the avoidances above \p max_layer_in_use of the least recently used radii until the memory budget
+     * of the cache limits is met. Collisions, placeable areas and wall restrictions are kept, as they are queried
+     * for all layers by the final stages and some of them are calculated from each other.
+     *
+     * A negative \p max_layer_in_use releases all the layers, for example once the branches are drawn.
+     * Released areas are recalculated on demand. As the references returned by the getters are invalidated,
+     * this may only be called while no other thread queries this object, for example between layers of a top down pass.
+     */
+    void enforce_memory_budget(LayerIndex max_layer_in_use);
+
     void clear() { 
         this->clear_all_but_object_collision();
         m_collision_cache.clear();
@@ -69,6 +108,15 @@ public:
         m_wall_restrictions_cache_min.clear();
     }
 
+    /*!
+     * \brief Check whether the collision and avoidance caches of this instance are valid for \p rhs.
+     *
+     * This is the case if both were constructed from the same layer outlines, support blockers and settings,
+     * for example if only the support enforcers / blockers were painted in between. The precalculated areas
+     * of this instance may then be reused instead of those of \p rhs, precalculate() only fills in the missing ones.
+     */
+    bool cache_compatible(const TreeModelVolumes &rhs) const;
+
     enum class AvoidanceType : int8_t
     {
         Slow,
@@ -196,6 +244,31 @@ private:
      * \brief Convenience typedef for the keys to the caches
      */
     using RadiusLayerPair             = std::pair<coord_t, LayerIndex>;
+
+    // Memory accounting shared by all the caches of a TreeModelVolumes.
+    struct CacheMemory {
+        std::atomic<size_t>     used { 0 };
+        std::atomic<size_t>     peak { 0 };
+        std::atomic<size_t>     inserted { 0 };
+        // Logical clock of the last access to a radius, for the LRU eviction.
+        std::atomic<uint64_t>   clock { 0 };
+        // The last accesses are only recorded with a memory budget, see TreeModelVolumes::set_cache_limits().
+        bool                    track_access { false };
+
+        void add(size_t bytes) {
+            size_t now  = used.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+            size_t peak_old = peak.load(std::memory_order_relaxed);
+            while (now > peak_old && ! peak.compare_exchange_weak(peak_old, now, std::memory_order_relaxed)) ;
+        }
+        void remove(size_t bytes) { used.fetch_sub(bytes, std::memory_order_relaxed); }
+        static size_t polygons_bytes(const Polygons &polygons) {
+            size_t out = sizeof(Polygons) + polygons.size() * sizeof(Polygon);
+            for (const Polygon &polygon : polygons)
+                out += polygon.points.size() * sizeof(Point);
+            return out;
+        }
+    };
+
     class RadiusLayerPolygonCache {
         // Map from radius to Polygons. Cache of one layer collision regions.
         using LayerData = std::map<coord_t, Polygons>;
@@ -204,8 +277,10 @@ private:
         using Layers = std::vector<LayerData>;
     public:
         RadiusLayerPolygonCache() = default;
-        RadiusLayerPolygonCache(RadiusLayerPolygonCache &&rhs) : m_data(std::move(rhs.m_data)) {}
-        RadiusLayerPolygonCache& operator=(RadiusLayerPolygonCache &&rhs) { m_data = std::move(rhs.m_data); return *this; }
+        RadiusLayerPolygonCache(RadiusLayerPolygonCache &&rhs) : m_data(std::move(rhs.m_data)), m_memory(std::move(rhs.m_memory)), m_last_access(std::move(rhs.m_last_access)) {}
+        RadiusLayerPolygonCache& operator=(RadiusLayerPolygonCache &&rhs) { 
+            m_data = std::move(rhs.m_data); m_memory = std::move(rhs.m_memory); m_last_access = std::move(rhs.m_last_access); return *this;
+        }
 
         RadiusLayerPolygonCache(const RadiusLayerPolygonCache&) = delete;
         RadiusLayerPolygonCache& operator=(const RadiusLayerPolygonCache&) = delete;
@@ -213,26 +288,26 @@ private:
         void insert(std::vector<std::pair<RadiusLayerPair, Polygons>> &&in) {
             std::lock_guard<std::mutex> guard(m_mutex);
             for (auto &d : in)
-                this->get_allocate_layer_data(d.first.second).emplace(d.first.first, std::move(d.second));
+                this->emplace(this->get_allocate_layer_data(d.first.second), d.first.first, std::move(d.second));
         }
         // by layer
         void insert(std::vector<std::pair<coord_t, Polygons>> &&in, coord_t radius) {
             std::lock_guard<std::mutex> guard(m_mutex);
             for (auto &d : in)
-                this->get_allocate_layer_data(d.first).emplace(radius, std::move(d.second));
+                this->emplace(this->get_allocate_layer_data(d.first), radius, std::move(d.second));
         }
         void insert(std::vector<Polygons> &&in, coord_t first_layer_idx, coord_t radius) {
             std::lock_guard<std::mutex> guard(m_mutex);
             allocate_layers(first_layer_idx + in.size());
             for (auto &d : in)
-                m_data[first_layer_idx ++].emplace(radius, std::move(d));
+                this->emplace(m_data[first_layer_idx ++], radius, std::move(d));
         }
         void insert(LayerPolygonCache &&in, coord_t radius) {
             std::lock_guard<std::mutex> guard(m_mutex);
             LayerIndex i = in.begin();
             allocate_layers(i + LayerIndex(in.size()));
             for (auto &d : in.polygons_mutable())
-                m_data[i ++].emplace(radius, std::move(d));
+                this->emplace(m_data[i ++], radius, std::move(d));
         }
         /*!
          * \brief Checks a cache for a given RadiusLayerPair and returns it if it is found
@@ -243,6 +318,8 @@ private:
             std::lock_guard<std::mutex> guard(m_mutex);
             if (key.second >= m_data.size())
                 return std::optional<std::reference_wrapper<const Polygons>>{};
+            if (m_memory && m_memory->track_access)
+                m_last_access[key.first] = m_memory->clock.fetch_add(1, std::memory_order_relaxed);
             const auto &layer = m_data[key.second];
             auto it = layer.find(key.first);
             return it == layer.end() ? 
@@ -284,13 +361,34 @@ private:
         // For debugging purposes, sorted by layer index, then by radius.
         [[nodiscard]] std::vector<std::pair<RadiusLayerPair, std::reference_wrapper<const Polygons>>> sorted() const;
 
-        void clear() { m_data.clear(); }
+        // Account the memory of this cache into memory, which is shared by all caches of a TreeModelVolumes.
+        void set_memory(std::shared_ptr<CacheMemory> memory) { assert(m_data.empty()); m_memory = std::move(memory); }
+        // Radii cached together with the logical time of their last access.
+        std::vector<std::pair<uint64_t, coord_t>> last_accesses() const {
+            std::lock_guard<std::mutex> guard(m_mutex);
+            return { m_last_access.begin(), m_last_access.end() };
+        }
+        // Release the areas of a radius above layer_idx. Returns the number of bytes released.
+        size_t erase_above(coord_t radius, LayerIndex layer_idx);
+
+        void clear() {
+            if (m_memory)
+                for (const LayerData &l : m_data)
+                    for (const auto &radius_polygons : l)
+                        m_memory->remove(CacheMemory::polygons_bytes(radius_polygons.second));
+            m_data.clear();
+            m_last_access.clear();
+        }
         void clear_all_but_radius0() { 
             for (LayerData &l : m_data) {
                 auto begin = l.begin();
                 auto end = l.end();
-                if (begin != end && ++ begin != end)
+                if (begin != end && ++ begin != end) {
+                    if (m_memory)
+                        for (auto it = begin; it != end; ++ it)
+                            m_memory->remove(CacheMemory::polygons_bytes(it->second));
                     l.erase(begin, end);
+                }
             }
         }
 
@@ -300,8 +398,18 @@ private:
             return m_data[layer_idx];
         }
         void                allocate_layers(size_t num_layers);
+        void                emplace(LayerData &layer, coord_t radius, Polygons &&polygons) {
+            size_t bytes = m_memory ? CacheMemory::polygons_bytes(polygons) : 0;
+            if (layer.emplace(radius, std::move(polygons)).second && m_memory) {
+                m_memory->add(bytes);
+                m_memory->inserted.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
 
         Layers              m_data;
+        std::shared_ptr<CacheMemory> m_memory;
+        // Map of radius to the logical time of its last access, see CacheMemory::clock.
+        mutable std::unordered_map<coord_t, uint64_t> m_last_access;
         mutable std::mutex  m_mutex;
     };
 
@@ -429,6 +537,8 @@ private:
     coord_t m_min_resolution;
 
     bool m_precalculated = false;
+    CacheLimits m_cache_limits;
+    std::shared_ptr<CacheMemory> m_cache_memory { std::make_shared<CacheMemory>() };
     /*!
      * \brief The index to access the outline corresponding with the currently processing mesh
      */
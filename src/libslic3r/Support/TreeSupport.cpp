@@ -2004,7 +2004,15 @@ void TreeSupport::generate()
     std::transform(bedpts.begin(), bedpts.end(), std::back_inserter(bedptsf), [](const Point &p) { return unscale(p); });
     BuildVolume build_volume{bedptsf, m_print_config->printable_height, {}};
     TreeSupport3D::TreeSupportSettings tree_support_3d_config{ TreeSupport3D::TreeSupportMeshGroupSettings{ *m_object }, m_slicing_params };
-    m_model_volumes = std::make_unique<TreeSupport3D::TreeModelVolumes>( *m_object, build_volume, tree_support_3d_config.maximum_move_distance, tree_support_3d_config.maximum_move_distance_slow, 1);
+    m_model_volumes = std::make_shared<TreeSupport3D::TreeModelVolumes>( *m_object, build_volume, tree_support_3d_config.maximum_move_distance, tree_support_3d_config.maximum_move_distance_slow, 1);
+    m_model_volumes->set_cache_limits(TreeSupport3D::TreeModelVolumes::CacheLimits::from_config(m_object->config()));
+    // Reuse the collision / avoidance caches of the previous run if only the support painting or the tip placement changed.
+    if (std::shared_ptr<TreeSupport3D::TreeModelVolumes> cached = m_object->tree_support_model_volumes(); cached && cached->cache_compatible(*m_model_volumes)) {
+        BOOST_LOG_TRIVIAL(debug) << "tree support: reusing the cached collision and avoidance areas";
+        cached->set_cache_limits(m_model_volumes->cache_limits());
+        m_model_volumes = std::move(cached);
+    } else
+        m_object->set_tree_support_model_volumes(m_model_volumes);
     // ### Precalculate avoidances, collision etc.
     if (m_highest_overhang_layer <= tree_support_3d_config.z_distance_top_layers)
         return;
@@ -3031,16 +3039,18 @@ void TreeSupport::drop_nodes()
         //Create a MST for every part.
         profiler.tic();
         //std::vector<MinimumSpanningTree>& spanning_trees = m_spanning_trees[layer_nr];
-        std::vector<MinimumSpanningTree> spanning_trees;
-        for (const std::unordered_map<Point, SupportNode*, PointHash>& group : nodes_per_part)
-        {
-            std::vector<Point> points_to_buildplate;
-            for (const std::pair<const Point, SupportNode*>& entry : group)
-            {
-                points_to_buildplate.emplace_back(entry.first); //Just the position of the node.
+        std::vector<MinimumSpanningTree> spanning_trees(nodes_per_part.size());
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, nodes_per_part.size()), [&](const tbb::blocked_range<size_t> &range) {
+            for (size_t group_index = range.begin(); group_index < range.end(); ++ group_index) {
+                std::vector<Point> points_to_buildplate;
+                points_to_buildplate.reserve(nodes_per_part[group_index].size());
+                for (const std::pair<const Point, SupportNode*>& entry : nodes_per_part[group_index])
+                {
+                    points_to_buildplate.emplace_back(entry.first); //Just the position of the node.
+                }
+                spanning_trees[group_index] = MinimumSpanningTree(points_to_buildplate);
             }
-            spanning_trees.emplace_back(points_to_buildplate);
-        }
+        });
         profiler.stage_add(STAGE_MinimumSpanningTree);
 
         //for (size_t i = 0; i < layer_contact_nodes.size(); i++) {
@@ -3059,377 +3069,384 @@ void TreeSupport::drop_nodes()
         coordf_t max_y = std::numeric_limits<coordf_t>::min();
         draw_layer_mst(debug_out_path("mtree_%.2f.svg", print_z), spanning_trees, m_object->get_layer(obj_layer_nr)->lslices_extrudable);
 #endif
+        // The parts do not share any node, thus the nodes of all the parts of the layer are merged and moved by a single parallel loop
+        // per pass instead of a loop per part, which keeps all the threads busy on layers with many small parts.
+        std::vector<std::pair<size_t, SupportNode*>> layer_nodes;
         for (size_t group_index = 0; group_index < nodes_per_part.size(); group_index++)
-        {
-            auto& nodes_this_part = nodes_per_part[group_index];
-            const MinimumSpanningTree& mst = spanning_trees[group_index];
-            //In the first pass, merge all nodes that are close together.
-            std::vector<std::pair<const Point, SupportNode*>> nodes_vec(nodes_this_part.begin(), nodes_this_part.end());
-            tbb::parallel_for_each(nodes_vec.begin(), nodes_vec.end(), [&](const std::pair<const Point, SupportNode*>& entry) {
-                SupportNode* p_node = entry.second;
-                SupportNode& node = *p_node;
-                if (!p_node->valid)
-                {
-                    return; //Delete this node (don't create a new node for it on the next layer).
-                }
-                if (node.fading) return;
-                const std::vector<Point>& neighbours = mst.adjacent_nodes(node.position);
-                if (node.type == ePolygon) {
-                    // Remove all circle neighbours that are completely inside the polygon and merge them into this node.
-                    for (const Point &neighbour : neighbours) {
-                        SupportNode *neighbour_node = nodes_this_part[neighbour];
-                        bool         can_merge      = false;
-                        if (neighbour_node->valid == false) continue;
-                        if (neighbour_node->fading) continue;
-                        if (neighbour_node->type == ePolygon) {
-                            if ((node.distance_to_top < 0 && neighbour_node->distance_to_top < 0) ||
-                                (node.distance_to_top > m_support_params.num_top_interface_layers + 1 &&
-                                 neighbour_node->distance_to_top > m_support_params.num_top_interface_layers + 1)) {
-                                auto overhang_shrinked = shrink_ex({node.overhang}, scale_(support_extrusion_width));
-                                if (!overhang_shrinked.empty() && overlaps(overhang_shrinked, {neighbour_node->overhang})) {
-                                    auto tmp = union_ex({node.overhang}, {neighbour_node->overhang});
-                                    if (!tmp.empty() && tmp.size() == 1) {
-                                        Point        next_pt     = tmp[0].contour.centroid();
-                                        SupportNode *next_node   = m_ts_data->create_node(next_pt, std::max(node.distance_to_top, neighbour_node->distance_to_top) + 1,
-                                                                                          obj_layer_nr_next,
-                                                                                          std::max(node.support_roof_layers_below, neighbour_node->support_roof_layers_below) - 1,
-                                                                                          true, p_node, print_z_next, height_next);
-                                        next_node->max_move_dist = 0;
-                                        next_node->overhang      = std::move(tmp[0]);
-                                        next_node->origin_area   = next_node->overhang.area();
-                                        m_ts_data->m_mutex.lock();
-                                        contact_nodes[layer_nr_next].emplace_back(next_node);
-                                        p_node->valid = false;
-                                        neighbour_node->valid = false;
-                                        m_ts_data->m_mutex.unlock();
-                                        return;
-                                    }
+            for (const std::pair<const Point, SupportNode*>& entry : nodes_per_part[group_index])
+                layer_nodes.emplace_back(group_index, entry.second);
+
+        //In the first pass, merge all nodes that are close together.
+        tbb::parallel_for_each(layer_nodes.begin(), layer_nodes.end(), [&](const std::pair<size_t, SupportNode*>& entry) {
+            const size_t                group_index     = entry.first;
+            auto&                       nodes_this_part = nodes_per_part[group_index];
+            const MinimumSpanningTree&  mst             = spanning_trees[group_index];
+            SupportNode* p_node = entry.second;
+            SupportNode& node = *p_node;
+            if (!p_node->valid)
+            {
+                return; //Delete this node (don't create a new node for it on the next layer).
+            }
+            if (node.fading) return;
+            const std::vector<Point>& neighbours = mst.adjacent_nodes(node.position);
+            if (node.type == ePolygon) {
+                // Remove all circle neighbours that are completely inside the polygon and merge them into this node.
+                for (const Point &neighbour : neighbours) {
+                    SupportNode *neighbour_node = nodes_this_part[neighbour];
+                    bool         can_merge      = false;
+                    if (neighbour_node->valid == false) continue;
+                    if (neighbour_node->fading) continue;
+                    if (neighbour_node->type == ePolygon) {
+                        if ((node.distance_to_top < 0 && neighbour_node->distance_to_top < 0) ||
+                            (node.distance_to_top > m_support_params.num_top_interface_layers + 1 &&
+                             neighbour_node->distance_to_top > m_support_params.num_top_interface_layers + 1)) {
+                            auto overhang_shrinked = shrink_ex({node.overhang}, scale_(support_extrusion_width));
+                            if (!overhang_shrinked.empty() && overlaps(overhang_shrinked, {neighbour_node->overhang})) {
+                                auto tmp = union_ex({node.overhang}, {neighbour_node->overhang});
+                                if (!tmp.empty() && tmp.size() == 1) {
+                                    Point        next_pt     = tmp[0].contour.centroid();
+                                    SupportNode *next_node   = m_ts_data->create_node(next_pt, std::max(node.distance_to_top, neighbour_node->distance_to_top) + 1,
+                                                                                      obj_layer_nr_next,
+                                                                                      std::max(node.support_roof_layers_below, neighbour_node->support_roof_layers_below) - 1,
+                                                                                      true, p_node, print_z_next, height_next);
+                                    next_node->max_move_dist = 0;
+                                    next_node->overhang      = std::move(tmp[0]);
+                                    next_node->origin_area   = next_node->overhang.area();
+                                    m_ts_data->m_mutex.lock();
+                                    contact_nodes[layer_nr_next].emplace_back(next_node);
+                                    p_node->valid = false;
+                                    neighbour_node->valid = false;
+                                    m_ts_data->m_mutex.unlock();
+                                    return;
                                 }
                             }
-                        } else {
-                            coord_t neighbour_radius = scale_(neighbour_node->radius);
-                            Point   pt_north = neighbour + Point(0, neighbour_radius), pt_south = neighbour - Point(0, neighbour_radius),
-                                  pt_west = neighbour - Point(neighbour_radius, 0), pt_east = neighbour + Point(neighbour_radius, 0);
-                            can_merge = is_inside_ex(node.overhang, neighbour) && is_inside_ex(node.overhang, pt_north) && is_inside_ex(node.overhang, pt_south) &&
-                                is_inside_ex(node.overhang, pt_west) && is_inside_ex(node.overhang, pt_east);
-                            if (!can_merge && is_inside_ex(node.overhang, neighbour)) {
-                                //ExPolygon neighbor_circle(make_circle(neighbour_radius, scale_(0.1)));
-                                //neighbor_circle.translate(neighbour);
-                                //node.overhang = union_ex({node.overhang}, {neighbor_circle})[0];
-                                neighbour_node->fading = true;
-                            }
                         }
-                        if (p_node->valid && can_merge) {
-                            node.merged_neighbours.push_front(neighbour_node);
-                            node.merged_neighbours.insert(node.merged_neighbours.end(), neighbour_node->merged_neighbours.begin(), neighbour_node->merged_neighbours.end());
-                            neighbour_node->valid = false;
+                    } else {
+                        coord_t neighbour_radius = scale_(neighbour_node->radius);
+                        Point   pt_north = neighbour + Point(0, neighbour_radius), pt_south = neighbour - Point(0, neighbour_radius),
+                              pt_west = neighbour - Point(neighbour_radius, 0), pt_east = neighbour + Point(neighbour_radius, 0);
+                        can_merge = is_inside_ex(node.overhang, neighbour) && is_inside_ex(node.overhang, pt_north) && is_inside_ex(node.overhang, pt_south) &&
+                            is_inside_ex(node.overhang, pt_west) && is_inside_ex(node.overhang, pt_east);
+                        if (!can_merge && is_inside_ex(node.overhang, neighbour)) {
+                            //ExPolygon neighbor_circle(make_circle(neighbour_radius, scale_(0.1)));
+                            //neighbor_circle.translate(neighbour);
+                            //node.overhang = union_ex({node.overhang}, {neighbor_circle})[0];
+                            neighbour_node->fading = true;
                         }
                     }
-                } else if (neighbours.size() == 1 && vsize2_with_unscale(neighbours[0] - node.position) < get_max_move_dist(p_node, 2) &&
-                           mst.adjacent_nodes(neighbours[0]).size() == 1 &&
-                           nodes_this_part[neighbours[0]]->type!=ePolygon) // We have just two nodes left, and they're very close, and the only neighbor is not ePolygon
-                {
-                    //Insert a completely new node and let both original nodes fade.
-                    Point next_position = (node.position + neighbours[0]) / 2; //Average position of the two nodes.
-                    coordf_t next_radius = calc_radius(node.dist_mm_to_top+height_next);
-                    auto avoid_layer = get_avoidance(next_radius, obj_layer_nr_next);
-                    if (group_index == 0)
-                    {
-                        //Avoid collisions.
-                        const coordf_t max_move_between_samples = max_move_distance + radius_sample_resolution + EPSILON; //100 micron extra for rounding errors.
-                        move_out_expolys(avoid_layer, next_position, radius_sample_resolution + EPSILON, max_move_between_samples);
+                    if (p_node->valid && can_merge) {
+                        node.merged_neighbours.push_front(neighbour_node);
+                        node.merged_neighbours.insert(node.merged_neighbours.end(), neighbour_node->merged_neighbours.begin(), neighbour_node->merged_neighbours.end());
+                        neighbour_node->valid = false;
                     }
-
-                    SupportNode* neighbour = nodes_this_part[neighbours[0]];
-                    SupportNode* node_parent;
-                    if (p_node->parent && neighbour->parent)
-                        node_parent = (node.radius >= neighbour->radius) ? p_node : neighbour;
-                    else
-                        node_parent = p_node->parent ? p_node : neighbour;
-                    // Make sure the next pass doesn't drop down either of these (since that already happened).
-                    node_parent->merged_neighbours.push_front(node_parent == p_node ? neighbour : p_node);
-                    const bool to_buildplate = !is_inside_ex(get_collision(0, obj_layer_nr_next), next_position);
-                    SupportNode* next_node = m_ts_data->create_node(next_position, node_parent->distance_to_top + 1, obj_layer_nr_next, node_parent->support_roof_layers_below - 1, to_buildplate, node_parent,
-                        print_z_next, height_next);
-                    get_max_move_dist(next_node);
-                    m_ts_data->m_mutex.lock();
-                    contact_nodes[layer_nr_next].push_back(next_node);
-                    neighbour->valid = false;
-                    p_node->valid = false;
-                    m_ts_data->m_mutex.unlock();
                 }
-                else if (neighbours.size() > 1) //Don't merge leaf nodes because we would then incur movement greater than the maximum move distance.
+            } else if (neighbours.size() == 1 && vsize2_with_unscale(neighbours[0] - node.position) < get_max_move_dist(p_node, 2) &&
+                       mst.adjacent_nodes(neighbours[0]).size() == 1 &&
+                       nodes_this_part[neighbours[0]]->type!=ePolygon) // We have just two nodes left, and they're very close, and the only neighbor is not ePolygon
+            {
+                //Insert a completely new node and let both original nodes fade.
+                Point next_position = (node.position + neighbours[0]) / 2; //Average position of the two nodes.
+                coordf_t next_radius = calc_radius(node.dist_mm_to_top+height_next);
+                auto avoid_layer = get_avoidance(next_radius, obj_layer_nr_next);
+                if (group_index == 0)
+                {
+                    //Avoid collisions.
+                    const coordf_t max_move_between_samples = max_move_distance + radius_sample_resolution + EPSILON; //100 micron extra for rounding errors.
+                    move_out_expolys(avoid_layer, next_position, radius_sample_resolution + EPSILON, max_move_between_samples);
+                }
+
+                SupportNode* neighbour = nodes_this_part[neighbours[0]];
+                SupportNode* node_parent;
+                if (p_node->parent && neighbour->parent)
+                    node_parent = (node.radius >= neighbour->radius) ? p_node : neighbour;
+                else
+                    node_parent = p_node->parent ? p_node : neighbour;
+                // Make sure the next pass doesn't drop down either of these (since that already happened).
+                node_parent->merged_neighbours.push_front(node_parent == p_node ? neighbour : p_node);
+                const bool to_buildplate = !is_inside_ex(get_collision(0, obj_layer_nr_next), next_position);
+                SupportNode* next_node = m_ts_data->create_node(next_position, node_parent->distance_to_top + 1, obj_layer_nr_next, node_parent->support_roof_layers_below - 1, to_buildplate, node_parent,
+                    print_z_next, height_next);
+                get_max_move_dist(next_node);
+                m_ts_data->m_mutex.lock();
+                contact_nodes[layer_nr_next].push_back(next_node);
+                neighbour->valid = false;
+                p_node->valid = false;
+                m_ts_data->m_mutex.unlock();
+            }
+            else if (neighbours.size() > 1) //Don't merge leaf nodes because we would then incur movement greater than the maximum move distance.
+            {
+                //Remove all neighbours that are too close and merge them into this node.
+                for (const Point& neighbour : neighbours)
                 {
-                    //Remove all neighbours that are too close and merge them into this node.
-                    for (const Point& neighbour : neighbours)
+                    if (vsize2_with_unscale(neighbour - node.position) < get_max_move_dist(&node,2))
                     {
-                        if (vsize2_with_unscale(neighbour - node.position) < get_max_move_dist(&node,2))
-                        {
-                            SupportNode* neighbour_node = nodes_this_part[neighbour];
-                            if (neighbour_node->type == ePolygon) continue;
-                            // only allow bigger node to merge smaller nodes. See STUDIO-6326
-                            if(node.radius < neighbour_node->radius) continue;
-
-                            m_ts_data->m_mutex.lock();
-                            if (p_node->valid)
-                            {  // since we are processing all nodes in parallel, p_node may have been deleted by another thread. In this case, we should not delete neighbour_node.
-                                node.merged_neighbours.push_front(neighbour_node);
-                                node.merged_neighbours.insert(node.merged_neighbours.end(), neighbour_node->merged_neighbours.begin(), neighbour_node->merged_neighbours.end());
-                                neighbour_node->valid = false;
-                            }
-                            m_ts_data->m_mutex.unlock();
+                        SupportNode* neighbour_node = nodes_this_part[neighbour];
+                        if (neighbour_node->type == ePolygon) continue;
+                        // only allow bigger node to merge smaller nodes. See STUDIO-6326
+                        if(node.radius < neighbour_node->radius) continue;
+
+                        m_ts_data->m_mutex.lock();
+                        if (p_node->valid)
+                        {  // since we are processing all nodes in parallel, p_node may have been deleted by another thread. In this case, we should not delete neighbour_node.
+                            node.merged_neighbours.push_front(neighbour_node);
+                            node.merged_neighbours.insert(node.merged_neighbours.end(), neighbour_node->merged_neighbours.begin(), neighbour_node->merged_neighbours.end());
+                            neighbour_node->valid = false;
                         }
+                        m_ts_data->m_mutex.unlock();
                     }
                 }
             }
-            );
+        }
+        );
 
-            //In the second pass, move all middle nodes.
-            tbb::parallel_for_each(nodes_vec.begin(), nodes_vec.end(), [&](const std::pair<const Point, SupportNode*>& entry) {
+        //In the second pass, move all middle nodes.
+        tbb::parallel_for_each(layer_nodes.begin(), layer_nodes.end(), [&](const std::pair<size_t, SupportNode*>& entry) {
+            const size_t                group_index     = entry.first;
+            auto&                       nodes_this_part = nodes_per_part[group_index];
+            const MinimumSpanningTree&  mst             = spanning_trees[group_index];
 
-                SupportNode* p_node = entry.second;
-                const SupportNode& node = *p_node;
-                if (!p_node->valid)
-                {
+            SupportNode* p_node = entry.second;
+            const SupportNode& node = *p_node;
+            if (!p_node->valid)
+            {
+                return;
+            }
+            if (node.fading) {
+                coordf_t     next_radius = node.radius - max_move_distance;
+                if (next_radius < EPSILON) return;
+                SupportNode *next_node = m_ts_data->create_node(node.position, p_node->distance_to_top + 1, obj_layer_nr_next, p_node->support_roof_layers_below - 1, node.to_buildplate,
+                                                                p_node, print_z_next, height_next);
+                next_node->max_move_dist = 0;
+                next_node->radius        = next_radius;
+                next_node->fading        = true;
+                m_ts_data->m_mutex.lock();
+                contact_nodes[layer_nr_next].emplace_back(next_node);
+                m_ts_data->m_mutex.unlock();
+                return;
+            }
+            if (node.type == ePolygon) {
+                // polygon node do not merge or move
+                if (node.overhang.empty()) {
+                    p_node->valid = false;
                     return;
                 }
-                if (node.fading) {
-                    coordf_t     next_radius = node.radius - max_move_distance;
-                    if (next_radius < EPSILON) return;
-                    SupportNode *next_node = m_ts_data->create_node(node.position, p_node->distance_to_top + 1, obj_layer_nr_next, p_node->support_roof_layers_below - 1, node.to_buildplate,
-                                                                    p_node, print_z_next, height_next);
-                    next_node->max_move_dist = 0;
-                    next_node->radius        = next_radius;
-                    next_node->fading        = true;
-                    m_ts_data->m_mutex.lock();
-                    contact_nodes[layer_nr_next].emplace_back(next_node);
-                    m_ts_data->m_mutex.unlock();
-                    return;
+                const bool to_buildplate = true;
+                // keep only the part that won't be removed by the next layer
+                ExPolygons overhangs_next = diff_clipped({ node.overhang }, get_collision(0, obj_layer_nr_next));
+                if (node.distance_to_top == 0) {
+                    overhangs_next      = offset2_ex(overhangs_next, scale_(max_move_distance), -scale_(max_move_distance));
+                    p_node->origin_area = node.overhang.area();
+                    densify_polygon(p_node->overhang.contour, 2.);
                 }
-                if (node.type == ePolygon) {
-                    // polygon node do not merge or move
-                    if (node.overhang.empty()) {
-                        p_node->valid = false;
-                        return;
-                    }
-                    const bool to_buildplate = true;
-                    // keep only the part that won't be removed by the next layer
-                    ExPolygons overhangs_next = diff_clipped({ node.overhang }, get_collision(0, obj_layer_nr_next));
-                    if (node.distance_to_top == 0) {
-                        overhangs_next      = offset2_ex(overhangs_next, scale_(max_move_distance), -scale_(max_move_distance));
-                        p_node->origin_area = node.overhang.area();
-                        densify_polygon(p_node->overhang.contour, 2.);
+                if (m_support_params.num_top_interface_layers > 0 && obj_layer_nr_next > 0 && node.support_roof_layers_below == 1 &&
+                    node.distance_to_top >= m_support_params.num_top_interface_layers)
+                    overhangs_next = safe_offset_inc(overhangs_next, scale_(max_move_distance), get_collision(0, obj_layer_nr_next), scale_(MIN_BRANCH_RADIUS * 1.75), 0, 1);
+                for(auto& overhang:overhangs_next) {
+                    if (overhang.empty()) continue;
+                    if (overhang.area() > node.origin_area / 2. && overhang.area() > SQ(scale_(10.))) {
+                        Polygon contour = overhang.contour;
+                        std::unordered_map<Point, Point, PointHash> movements;
+                        smooth_filter(overhang.contour, 2, movements, max_move_distance / 2.);
+                        for (auto &pt : overhang.contour.points) {
+                            auto tmp = pt + movements.at(pt);
+                            if (!is_inside_ex(to_expolygons({contour}), tmp) && !is_inside_ex(m_ts_data->m_layer_outlines_below[obj_layer_nr], tmp))
+                                pt = tmp;
+                        }
                     }
-                    if (m_support_params.num_top_interface_layers > 0 && obj_layer_nr_next > 0 && node.support_roof_layers_below == 1 &&
-                        node.distance_to_top >= m_support_params.num_top_interface_layers)
-                        overhangs_next = safe_offset_inc(overhangs_next, scale_(max_move_distance), get_collision(0, obj_layer_nr_next), scale_(MIN_BRANCH_RADIUS * 1.75), 0, 1);
-                    for(auto& overhang:overhangs_next) {
-                        if (overhang.empty()) continue;
-                        if (overhang.area() > node.origin_area / 2. && overhang.area() > SQ(scale_(10.))) {
-                            Polygon contour = overhang.contour;
-                            std::unordered_map<Point, Point, PointHash> movements;
-                            smooth_filter(overhang.contour, 2, movements, max_move_distance / 2.);
-                            for (auto &pt : overhang.contour.points) {
-                                auto tmp = pt + movements.at(pt);
-                                if (!is_inside_ex(to_expolygons({contour}), tmp) && !is_inside_ex(m_ts_data->m_layer_outlines_below[obj_layer_nr], tmp))
-                                    pt = tmp;
-                            }
+                    // if the part would fall straight to th buildplate, shrink it a little
+                    if (node.support_roof_layers_below<0 && overhang.area() > node.origin_area / 2. &&
+                        overhang.area() > double(SQ(scale_(10.)))) {
+                        ExPolygons shrink_overhangs = union_ex(shrink_ex(safe_union({overhang}), double(scale_(max_move_distance / 2.))));
+                        if (shrink_overhangs.size() == 1 && shrink_overhangs[0].area() > double(SQ(scale_(10.))) &&
+                            !overlaps({overhang}, m_ts_data->m_layer_outlines_below[obj_layer_nr_next])) {
+                            if (diff_ex({overhang}, offset_ex(shrink_overhangs[0],scale_(max_move_distance))).empty())
+                                overhang = shrink_overhangs[0];
                         }
-                        // if the part would fall straight to th buildplate, shrink it a little
-                        if (node.support_roof_layers_below<0 && overhang.area() > node.origin_area / 2. &&
-                            overhang.area() > double(SQ(scale_(10.)))) {
-                            ExPolygons shrink_overhangs = union_ex(shrink_ex(safe_union({overhang}), double(scale_(max_move_distance / 2.))));
-                            if (shrink_overhangs.size() == 1 && shrink_overhangs[0].area() > double(SQ(scale_(10.))) &&
-                                !overlaps({overhang}, m_ts_data->m_layer_outlines_below[obj_layer_nr_next])) {
-                                if (diff_ex({overhang}, offset_ex(shrink_overhangs[0],scale_(max_move_distance))).empty())
-                                    overhang = shrink_overhangs[0];
-                            }
-                            Point        next_pt     = overhang.contour.centroid();
-                            SupportNode *next_node   = m_ts_data->create_node(next_pt, p_node->distance_to_top + 1, obj_layer_nr_next, p_node->support_roof_layers_below - 1,
-                                                                              to_buildplate, p_node, print_z_next, height_next);
-                            next_node->max_move_dist = 0;
-                            next_node->overhang      = std::move(overhang);
-                            next_node->origin_area   = node.origin_area;
-                            m_ts_data->m_mutex.lock();
-                            contact_nodes[layer_nr_next].emplace_back(next_node);
-                            m_ts_data->m_mutex.unlock();
+                        Point        next_pt     = overhang.contour.centroid();
+                        SupportNode *next_node   = m_ts_data->create_node(next_pt, p_node->distance_to_top + 1, obj_layer_nr_next, p_node->support_roof_layers_below - 1,
+                                                                          to_buildplate, p_node, print_z_next, height_next);
+                        next_node->max_move_dist = 0;
+                        next_node->overhang      = std::move(overhang);
+                        next_node->origin_area   = node.origin_area;
+                        m_ts_data->m_mutex.lock();
+                        contact_nodes[layer_nr_next].emplace_back(next_node);
+                        m_ts_data->m_mutex.unlock();
 
-                        } else {
-                            Point        next_pt     = overhang.contour.centroid();
-                            SupportNode *next_node   = m_ts_data->create_node(next_pt, p_node->distance_to_top + 1, obj_layer_nr_next, p_node->support_roof_layers_below - 1,
-                                                                              to_buildplate, p_node, print_z_next, height_next);
-                            next_node->max_move_dist = 0;
-                            next_node->overhang      = std::move(overhang);
-                            next_node->origin_area   = node.origin_area;
-                            m_ts_data->m_mutex.lock();
-                            contact_nodes[layer_nr_next].emplace_back(next_node);
-                            m_ts_data->m_mutex.unlock();
-                        }
+                    } else {
+                        Point        next_pt     = overhang.contour.centroid();
+                        SupportNode *next_node   = m_ts_data->create_node(next_pt, p_node->distance_to_top + 1, obj_layer_nr_next, p_node->support_roof_layers_below - 1,
+                                                                          to_buildplate, p_node, print_z_next, height_next);
+                        next_node->max_move_dist = 0;
+                        next_node->overhang      = std::move(overhang);
+                        next_node->origin_area   = node.origin_area;
+                        m_ts_data->m_mutex.lock();
+                        contact_nodes[layer_nr_next].emplace_back(next_node);
+                        m_ts_data->m_mutex.unlock();
                     }
-                    return;
                 }
+                return;
+            }
 
-                //If the branch falls completely inside a collision area (the entire branch would be removed by the X/Y offset), delete it.
-                if (group_index > 0 && is_inside_ex(get_collision(0, obj_layer_nr), node.position))
+            //If the branch falls completely inside a collision area (the entire branch would be removed by the X/Y offset), delete it.
+            if (group_index > 0 && is_inside_ex(get_collision(0, obj_layer_nr), node.position))
+            {
+                std::scoped_lock lock(m_ts_data->m_mutex);
+                const coordf_t branch_radius_node = get_radius(p_node);
+                Point to_outside = projection_onto(get_collision(0, obj_layer_nr), node.position);
+                double dist2_to_outside = vsize2_with_unscale(node.position - to_outside);
+                if (dist2_to_outside >= branch_radius_node * branch_radius_node) //Too far inside.
                 {
-                    std::scoped_lock lock(m_ts_data->m_mutex);
-                    const coordf_t branch_radius_node = get_radius(p_node);
-                    Point to_outside = projection_onto(get_collision(0, obj_layer_nr), node.position);
-                    double dist2_to_outside = vsize2_with_unscale(node.position - to_outside);
-                    if (dist2_to_outside >= branch_radius_node * branch_radius_node) //Too far inside.
+                    if (support_on_buildplate_only)
                     {
-                        if (support_on_buildplate_only)
-                        {
-                            unsupported_branch_leaves.push_front({ layer_nr, p_node });
-                        }
-                        else {
-                            p_node->valid = false;
-                        }
-                        return;
+                        unsupported_branch_leaves.push_front({ layer_nr, p_node });
                     }
-                    // if the link between parent and current is cut by contours, mark current as bottom contact node
-                    if (p_node->parent && intersection_ln({p_node->position, p_node->parent->position}, layer_contours).empty()==false)
-                    {
+                    else {
                         p_node->valid = false;
-                        return;
                     }
+                    return;
                 }
-                Point next_layer_vertex = node.position;
-                Point move_to_neighbor_center;
-                std::vector<Point>       moves;
-                std::vector<float>       weights;
-                const std::vector<Point>& neighbours = mst.adjacent_nodes(node.position);
-                // 1. do not merge neighbors under 5mm
-                // 2. Only merge node with single neighbor in distance between [max_move_distance, 10mm/layer_height]
-                float dist2_to_first_neighbor = neighbours.empty() ? 0 : vsize2_with_unscale(neighbours[0] - node.position);
-                if (node.print_z > DO_NOT_MOVER_UNDER_MM &&
-                    (neighbours.size() > 1 ||
-                     (neighbours.size() == 1/* && nodes_this_part[neighbours[0]]->type != ePolygon */&& dist2_to_first_neighbor >= get_max_move_dist(p_node, 2))/* ||
-                     (neighbours.size() == 1 && nodes_this_part[neighbours[0]]->type == ePolygon)*/)) // Only nodes that aren't about to collapse.
+                // if the link between parent and current is cut by contours, mark current as bottom contact node
+                if (p_node->parent && intersection_ln({p_node->position, p_node->parent->position}, layer_contours).empty()==false)
                 {
-                    // Move towards the average position of all neighbours.
-                    Point sum_direction(0, 0);
-                    for (const Point &neighbour : neighbours) {
-                        // do not move to the neighbor to be deleted
-                        SupportNode *neighbour_node = nodes_this_part[neighbour];
-                        if (!neighbour_node->valid) continue;
-                        Point direction;
-                        if (neighbour_node->type == ePolygon && neighbour_node->overhang.is_valid()) {
-                            Point contact_point = projection_onto({neighbour_node->overhang}, node.position);
-                            direction     = contact_point - node.position;
-                        } else {
-                            direction = neighbour - node.position;
-                        }
-                        // do not move to neighbor that's too far away (即使以最大速度移动，在接触热床之前都无法汇聚)
-                        float dist2_to_neighbor = vsize2_with_unscale(direction);
-
-                        coordf_t branch_bottom_radius = calc_radius(node.dist_mm_to_top + node.print_z);
-                        coordf_t neighbour_bottom_radius = calc_radius(neighbour_node->dist_mm_to_top + neighbour_node->print_z);
-                        double max_converge_distance = tan_angle * (p_node->print_z - DO_NOT_MOVER_UNDER_MM) + std::max(branch_bottom_radius, neighbour_bottom_radius);
-                        if (dist2_to_neighbor > max_converge_distance * max_converge_distance) continue;
+                    p_node->valid = false;
+                    return;
+                }
+            }
+            Point next_layer_vertex = node.position;
+            Point move_to_neighbor_center;
+            std::vector<Point>       moves;
+            std::vector<float>       weights;
+            const std::vector<Point>& neighbours = mst.adjacent_nodes(node.position);
+            // 1. do not merge neighbors under 5mm
+            // 2. Only merge node with single neighbor in distance between [max_move_distance, 10mm/layer_height]
+            float dist2_to_first_neighbor = neighbours.empty() ? 0 : vsize2_with_unscale(neighbours[0] - node.position);
+            if (node.print_z > DO_NOT_MOVER_UNDER_MM &&
+                (neighbours.size() > 1 ||
+                 (neighbours.size() == 1/* && nodes_this_part[neighbours[0]]->type != ePolygon */&& dist2_to_first_neighbor >= get_max_move_dist(p_node, 2))/* ||
+                 (neighbours.size() == 1 && nodes_this_part[neighbours[0]]->type == ePolygon)*/)) // Only nodes that aren't about to collapse.
+            {
+                // Move towards the average position of all neighbours.
+                Point sum_direction(0, 0);
+                for (const Point &neighbour : neighbours) {
+                    // do not move to the neighbor to be deleted
+                    SupportNode *neighbour_node = nodes_this_part[neighbour];
+                    if (!neighbour_node->valid) continue;
+                    Point direction;
+                    if (neighbour_node->type == ePolygon && neighbour_node->overhang.is_valid()) {
+                        Point contact_point = projection_onto({neighbour_node->overhang}, node.position);
+                        direction     = contact_point - node.position;
+                    } else {
+                        direction = neighbour - node.position;
+                    }
+                    // do not move to neighbor that's too far away (即使以最大速度移动，在接触热床之前都无法汇聚)
+                    float dist2_to_neighbor = vsize2_with_unscale(direction);
 
-                        if (is_line_cut_by_contour(node.position, neighbour)) continue;
+                    coordf_t branch_bottom_radius = calc_radius(node.dist_mm_to_top + node.print_z);
+                    coordf_t neighbour_bottom_radius = calc_radius(neighbour_node->dist_mm_to_top + neighbour_node->print_z);
+                    double max_converge_distance = tan_angle * (p_node->print_z - DO_NOT_MOVER_UNDER_MM) + std::max(branch_bottom_radius, neighbour_bottom_radius);
+                    if (dist2_to_neighbor > max_converge_distance * max_converge_distance) continue;
 
-                        if (!is_strong)
-                            sum_direction += direction * (1 / dist2_to_neighbor);
-                        else
-                            sum_direction += direction;
-                    }
+                    if (is_line_cut_by_contour(node.position, neighbour)) continue;
 
                     if (!is_strong)
+                        sum_direction += direction * (1 / dist2_to_neighbor);
+                    else
+                        sum_direction += direction;
+                }
+
+                if (!is_strong)
+                    move_to_neighbor_center = sum_direction;
+                else {
+                    if (vsize2_with_unscale(sum_direction) <= get_max_move_dist(p_node, 2)) {
                         move_to_neighbor_center = sum_direction;
-                    else {
-                        if (vsize2_with_unscale(sum_direction) <= get_max_move_dist(p_node, 2)) {
-                            move_to_neighbor_center = sum_direction;
-                        } else {
-                            move_to_neighbor_center = normal(sum_direction, scale_(get_max_move_dist(p_node)));
-                        }
+                    } else {
+                        move_to_neighbor_center = normal(sum_direction, scale_(get_max_move_dist(p_node)));
                     }
                 }
+            }
 
 #ifdef SUPPORT_TREE_DEBUG_TO_SVG
-                if (node.position(1) > max_y) {
-                    max_y              = node.position(1);
-                    branch_radius_temp = get_radius(p_node);
-                }
+            if (node.position(1) > max_y) {
+                max_y              = node.position(1);
+                branch_radius_temp = get_radius(p_node);
+            }
 #endif
-                coordf_t next_radius = calc_radius(node.dist_mm_to_top + height_next);
-                auto avoidance_next = get_avoidance(next_radius, obj_layer_nr_next);
-                
-                Point  to_outside         = projection_onto(avoidance_next, node.position);
-                Point  direction_to_outer = to_outside - node.position;
-                if (node.skin_direction != Point(0, 0) && node.dist_mm_to_top < 3) {
-                    direction_to_outer = move_to_neighbor_center = normal(node.skin_direction, scale_(max_move_distance));
-                }
-                double dist2_to_outer     = vsize2_with_unscale(direction_to_outer);
-                // don't move if
-                // 1) line of node and to_outside is cut by contour (means supports may intersect with object)
-                // 2) it's impossible to move to build plate
-                if (is_line_cut_by_contour(node.position, to_outside) || dist2_to_outer > max_move_distance2 * SQ(obj_layer_nr) ||
-                    !is_inside_ex(avoidance_next, node.position)) {
-                    // try move to outside of lower layer instead
-                    Point candidate_vertex = node.position;
-                    const coordf_t max_move_between_samples = max_move_distance + radius_sample_resolution + EPSILON; // 100 micron extra for rounding errors.
-                    // use get_collision instead of get_avoidance here (See STUDIO-4252)
-                    bool           is_outside               = move_out_expolys(get_collision(next_radius,obj_layer_nr_next), candidate_vertex, max_move_between_samples, max_move_between_samples);
-                    if (is_outside) {
-                        direction_to_outer = candidate_vertex - node.position;
-                        dist2_to_outer    = vsize2_with_unscale(direction_to_outer);
-                    } else {
-                        direction_to_outer = Point(0, 0);
-                        dist2_to_outer     = 0;
-                    }
-                }
-                // move to the averaged direction of neighbor center and contour edge if they are roughly same direction
-                Point movement;
-                if (support_on_buildplate_only)
-                    movement = move_to_neighbor_center + direction_to_outer * 2;
-                else if (!is_strong)
-                    movement = move_to_neighbor_center*2 + (dist2_to_outer > EPSILON ? direction_to_outer * (1 / dist2_to_outer) : Point(0, 0));
-                else {
-                    if (movement.dot(move_to_neighbor_center) >= 0.2 || move_to_neighbor_center == Point(0, 0))
-                        movement = direction_to_outer + move_to_neighbor_center;
-                    else
-                        movement = move_to_neighbor_center; // otherwise move to neighbor center first
+            coordf_t next_radius = calc_radius(node.dist_mm_to_top + height_next);
+            auto avoidance_next = get_avoidance(next_radius, obj_layer_nr_next);
+            
+            Point  to_outside         = projection_onto(avoidance_next, node.position);
+            Point  direction_to_outer = to_outside - node.position;
+            if (node.skin_direction != Point(0, 0) && node.dist_mm_to_top < 3) {
+                direction_to_outer = move_to_neighbor_center = normal(node.skin_direction, scale_(max_move_distance));
+            }
+            double dist2_to_outer     = vsize2_with_unscale(direction_to_outer);
+            // don't move if
+            // 1) line of node and to_outside is cut by contour (means supports may intersect with object)
+            // 2) it's impossible to move to build plate
+            if (is_line_cut_by_contour(node.position, to_outside) || dist2_to_outer > max_move_distance2 * SQ(obj_layer_nr) ||
+                !is_inside_ex(avoidance_next, node.position)) {
+                // try move to outside of lower layer instead
+                Point candidate_vertex = node.position;
+                const coordf_t max_move_between_samples = max_move_distance + radius_sample_resolution + EPSILON; // 100 micron extra for rounding errors.
+                // use get_collision instead of get_avoidance here (See STUDIO-4252)
+                bool           is_outside               = move_out_expolys(get_collision(next_radius,obj_layer_nr_next), candidate_vertex, max_move_between_samples, max_move_between_samples);
+                if (is_outside) {
+                    direction_to_outer = candidate_vertex - node.position;
+                    dist2_to_outer    = vsize2_with_unscale(direction_to_outer);
+                } else {
+                    direction_to_outer = Point(0, 0);
+                    dist2_to_outer     = 0;
                 }
+            }
+            // move to the averaged direction of neighbor center and contour edge if they are roughly same direction
+            Point movement;
+            if (support_on_buildplate_only)
+                movement = move_to_neighbor_center + direction_to_outer * 2;
+            else if (!is_strong)
+                movement = move_to_neighbor_center*2 + (dist2_to_outer > EPSILON ? direction_to_outer * (1 / dist2_to_outer) : Point(0, 0));
+            else {
+                if (movement.dot(move_to_neighbor_center) >= 0.2 || move_to_neighbor_center == Point(0, 0))
+                    movement = direction_to_outer + move_to_neighbor_center;
+                else
+                    movement = move_to_neighbor_center; // otherwise move to neighbor center first
+            }
 
-                //if (node.is_sharp_tail && node.dist_mm_to_top < 3) {
-                //    movement = normal(node.skin_direction, scale_(get_max_move_dist(&node)));
-                //}
-                //else if (dist2_to_outer > 0)
-                //    movement = normal(direction_to_outer, scale_(get_max_move_dist(&node)));
-                //else
-                //    movement = normal(move_to_neighbor_center, scale_(get_max_move_dist(&node)));
-                if (vsize2_with_unscale(movement) > get_max_move_dist(&node, 2)) movement = normal(movement, scale_(get_max_move_dist(&node)));
-
-                next_layer_vertex += movement;
-
-                if (group_index == 0 && 0) {
-                    // Avoid collisions.
-                    const coordf_t max_move_between_samples = get_max_move_dist(&node, 1) + radius_sample_resolution + EPSILON; // 100 micron extra for rounding errors.
-                    bool           is_outside               = move_out_expolys(avoidance_next, next_layer_vertex, radius_sample_resolution + EPSILON, max_move_between_samples);
-                    if (!is_outside) {
-                        Point candidate_vertex = node.position;
-                        is_outside             = move_out_expolys(avoidance_next, candidate_vertex, radius_sample_resolution + EPSILON, max_move_between_samples);
-                        if (is_outside) { next_layer_vertex = candidate_vertex; }
-                    }
+            //if (node.is_sharp_tail && node.dist_mm_to_top < 3) {
+            //    movement = normal(node.skin_direction, scale_(get_max_move_dist(&node)));
+            //}
+            //else if (dist2_to_outer > 0)
+            //    movement = normal(direction_to_outer, scale_(get_max_move_dist(&node)));
+            //else
+            //    movement = normal(move_to_neighbor_center, scale_(get_max_move_dist(&node)));
+            if (vsize2_with_unscale(movement) > get_max_move_dist(&node, 2)) movement = normal(movement, scale_(get_max_move_dist(&node)));
+
+            next_layer_vertex += movement;
+
+            if (group_index == 0 && 0) {
+                // Avoid collisions.
+                const coordf_t max_move_between_samples = get_max_move_dist(&node, 1) + radius_sample_resolution + EPSILON; // 100 micron extra for rounding errors.
+                bool           is_outside               = move_out_expolys(avoidance_next, next_layer_vertex, radius_sample_resolution + EPSILON, max_move_between_samples);
+                if (!is_outside) {
+                    Point candidate_vertex = node.position;
+                    is_outside             = move_out_expolys(avoidance_next, candidate_vertex, radius_sample_resolution + EPSILON, max_move_between_samples);
+                    if (is_outside) { next_layer_vertex = candidate_vertex; }
                 }
-                auto              next_collision = get_collision(0, obj_layer_nr_next);
-                const bool   to_buildplate  = !is_inside_ex(m_ts_data->m_layer_outlines[obj_layer_nr_next], next_layer_vertex);
-                SupportNode *     next_node     = m_ts_data->create_node(next_layer_vertex, node.distance_to_top + 1, obj_layer_nr_next, node.support_roof_layers_below - 1, to_buildplate, p_node,
-                    print_z_next, height_next);
-                // don't increase radius if next node will collide partially with the object (STUDIO-7883)
-                to_outside             = projection_onto(next_collision, next_node->position);
-                direction_to_outer     = to_outside - node.position;
-                double dist_to_outer   = unscale_(direction_to_outer.cast<double>().norm());
-                next_node->radius      = std::max(node.radius, std::min(next_node->radius, dist_to_outer));
-                get_max_move_dist(next_node);
-                m_ts_data->m_mutex.lock();
-                contact_nodes[layer_nr_next].push_back(next_node);
-                m_ts_data->m_mutex.unlock();
             }
-            );
+            auto              next_collision = get_collision(0, obj_layer_nr_next);
+            const bool   to_buildplate  = !is_inside_ex(m_ts_data->m_layer_outlines[obj_layer_nr_next], next_layer_vertex);
+            SupportNode *     next_node     = m_ts_data->create_node(next_layer_vertex, node.distance_to_top + 1, obj_layer_nr_next, node.support_roof_layers_below - 1, to_buildplate, p_node,
+                print_z_next, height_next);
+            // don't increase radius if next node will collide partially with the object (STUDIO-7883)
+            to_outside             = projection_onto(next_collision, next_node->position);
+            direction_to_outer     = to_outside - node.position;
+            double dist_to_outer   = unscale_(direction_to_outer.cast<double>().norm());
+            next_node->radius      = std::max(node.radius, std::min(next_node->radius, dist_to_outer));
+            get_max_move_dist(next_node);
+            m_ts_data->m_mutex.lock();
+            contact_nodes[layer_nr_next].push_back(next_node);
+            m_ts_data->m_mutex.unlock();
         }
+        );
 
         if (layer_nr_next == 0 && support_on_buildplate_only && !contact_nodes[layer_nr_next].empty()) {
             for (SupportNode *node : contact_nodes[layer_nr_next]) {
@@ -3494,6 +3511,9 @@ void TreeSupport::drop_nodes()
                 layer_contact_nodes.erase(std::remove_if(layer_contact_nodes.begin(), layer_contact_nodes.end(), [](SupportNode *node) { return node->is_processed; }),
                                           layer_contact_nodes.end());
         }
+        // The layers above are done, their avoidances may be released if the caches are over budget.
+        if (m_model_volumes)
+            m_model_volumes->enforce_memory_budget(obj_layer_nr_next);
     }
 
     BOOST_LOG_TRIVIAL(debug) << "after m_avoidance_cache.size()=" << m_ts_data->m_avoidance_cache.size();
@@ -4195,12 +4215,8 @@ Polygons TreeSupportData::get_contours_with_holes(size_t layer_nr) const
 
 SupportNode* TreeSupportData::create_node(const Point position, const int distance_to_top, const int obj_layer_nr, const int support_roof_layers_below, const bool to_buildplate, SupportNode* parent, coordf_t print_z_, coordf_t height_, coordf_t dist_mm_to_top_, coordf_t radius_)
 {
-    // this function may be called from multiple threads, need to lock
-    m_mutex.lock();
-    std::unique_ptr<SupportNode> node = std::make_unique<SupportNode>(position, distance_to_top, obj_layer_nr, support_roof_layers_below, to_buildplate, parent, print_z_, height_, dist_mm_to_top_, radius_);
-    SupportNode* raw_ptr = node.get();
-    contact_nodes.emplace_back(std::move(node));
-    m_mutex.unlock();
+    // this function may be called from multiple threads, each thread allocates from its own pool
+    SupportNode* raw_ptr = &m_node_pools.local().emplace_back(position, distance_to_top, obj_layer_nr, support_roof_layers_below, to_buildplate, parent, print_z_, height_, dist_mm_to_top_, radius_);
     if (parent)
         raw_ptr->movement = position - parent->position;
     return raw_ptr;
@@ -4209,7 +4225,7 @@ SupportNode* TreeSupportData::create_node(const Point position, const int distan
 void TreeSupportData::clear_nodes()
 {
     tbb::spin_mutex::scoped_lock guard(m_mutex);
-    contact_nodes.clear();
+    m_node_pools.clear();
 }
 
 coordf_t TreeSupportData::ceil_radius(coordf_t radius) const
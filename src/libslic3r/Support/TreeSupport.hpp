@@ -1,9 +1,12 @@
 #ifndef TREESUPPORT_H
 #define TREESUPPORT_H
 
+#include <deque>
 #include <forward_list>
 #include <unordered_set>
 #include "tbb/concurrent_unordered_map.h"
+#include "tbb/enumerable_thread_specific.h"
+#include "tbb/spin_mutex.h"
 #include "../ExPolygon.hpp"
 #include "../Point.hpp"
 #include "../Slicing.hpp"
@@ -252,7 +255,6 @@ public:
     void clear_nodes();
     std::vector<LayerHeightData> layer_heights;
 
-    std::vector<std::unique_ptr<SupportNode>> contact_nodes;
     // ExPolygon                  m_machine_border;
 
 private:
@@ -301,6 +303,10 @@ private:
 
     tbb::spin_mutex  m_mutex;
 
+    // Nodes are allocated from per-thread pools, so that create_node() does not serialize the threads of drop_nodes().
+    // std::deque never relocates its elements when growing, thus the returned pointers stay valid until clear_nodes().
+    tbb::enumerable_thread_specific<std::deque<SupportNode>> m_node_pools;
+
 public:
     bool is_slim = false;
     /*!
@@ -427,7 +433,7 @@ private:
      */
     std::vector<std::vector<SupportNode*>> contact_nodes;
     std::shared_ptr<TreeSupportData> m_ts_data;
-    std::unique_ptr<TreeSupport3D::TreeModelVolumes> m_model_volumes;
+    std::shared_ptr<TreeSupport3D::TreeModelVolumes> m_model_volumes;
     PrintObject    *m_object;
     const PrintObjectConfig* m_object_config;
     SlicingParameters        m_slicing_params;
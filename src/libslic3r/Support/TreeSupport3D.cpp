@@ -2291,7 +2291,7 @@ static void merge_influence_areas(
  *
  * \param move_bounds[in,out] All currently existing influence areas
  */
-void create_layer_pathing(const TreeModelVolumes &volumes, const TreeSupportSettings &config, std::vector<SupportElements> &move_bounds, std::function<void()> throw_on_cancel)
+void create_layer_pathing(TreeModelVolumes &volumes, const TreeSupportSettings &config, std::vector<SupportElements> &move_bounds, std::function<void()> throw_on_cancel)
 {
 #ifdef SLIC3R_TREESUPPORTS_PROGRESS
     const double data_size_inverse = 1 / double(move_bounds.size());
@@ -2383,6 +2383,8 @@ void create_layer_pathing(const TreeModelVolumes &volumes, const TreeSupportSett
             Progress::messageProgress(Progress::Stage::SUPPORT, progress_total * m_progress_multiplier + m_progress_offset, TREE_PROGRESS_TOTAL);
     #endif
             throw_on_cancel();
+            // The layers above are done, their avoidances may be released if the caches are over budget.
+            volumes.enforce_memory_budget(layer_idx - 1);
         }
 
     BOOST_LOG_TRIVIAL(info) << "Time spent with creating influence areas' subtasks: Increasing areas " << dur_inc.count() / 1000000 <<
@@ -4048,11 +4050,21 @@ static void generate_support_areas(Print &print, TreeSupport* tree_support, cons
 #endif // SLIC3R_TREESUPPORT_PROGRESS
         PrintObject &print_object = *print.get_object(processing.second.front());
         // Generator for model collision, avoidance and internal guide volumes.
-        TreeModelVolumes volumes{ print_object, build_volume, config.maximum_move_distance, config.maximum_move_distance_slow, processing.second.front(),
+        std::shared_ptr<TreeModelVolumes> volumes_ptr = std::make_shared<TreeModelVolumes>(
+            print_object, build_volume, config.maximum_move_distance, config.maximum_move_distance_slow, processing.second.front(),
 #ifdef SLIC3R_TREESUPPORTS_PROGRESS
             m_progress_multiplier, m_progress_offset,
 #endif // SLIC3R_TREESUPPORTS_PROGRESS
-            /* additional_excluded_areas */{} };
+            /* additional_excluded_areas */std::vector<Polygons>{});
+        volumes_ptr->set_cache_limits(TreeModelVolumes::CacheLimits::from_config(print_object.config()));
+        // Reuse the collision / avoidance caches of the previous run if only the support painting or the tip placement changed.
+        if (std::shared_ptr<TreeModelVolumes> cached = print_object.tree_support_model_volumes(); cached && cached->cache_compatible(*volumes_ptr)) {
+            BOOST_LOG_TRIVIAL(debug) << "Tree support: reusing the cached collision and avoidance areas.";
+            cached->set_cache_limits(volumes_ptr->cache_limits());
+            volumes_ptr = std::move(cached);
+        } else
+            print_object.set_tree_support_model_volumes(volumes_ptr);
+        TreeModelVolumes &volumes = *volumes_ptr;
 
         //FIXME generating overhangs just for the first mesh of the group.
         assert(processing.second.size() == 1);
@@ -4236,6 +4248,7 @@ static void generate_support_areas(Print &print, TreeSupport* tree_support, cons
 
         auto t_end = std::chrono::high_resolution_clock::now();
         BOOST_LOG_TRIVIAL(info) << "Total time of organic tree support: " << 0.001 * std::chrono::duration_cast<std::chrono::microseconds>(t_end - t_start).count() << " ms";
+        BOOST_LOG_TRIVIAL(info) << "Organic tree support caches: " << volumes.memory_usage() << " bytes, peak " << volumes.peak_memory_usage() << " bytes";
  #if 0
 //#ifdef SLIC3R_DEBUG
         {
@@ -4361,8 +4374,10 @@ void organic_draw_branches(
     }
         
 
-    // Reduce memory footprint. After this point only finalize_interface_and_support_areas() will use volumes and from that only collisions with zero radius will be used.
-    volumes.clear_all_but_object_collision();
+    // After this point only finalize_interface_and_support_areas() will use volumes and from that only collisions with zero radius will be used.
+    // The avoidances are kept on the PrintObject for the next regeneration of the supports, see PrintObject::tree_support_model_volumes(),
+    // they are only released to meet the memory budget.
+    volumes.enforce_memory_budget(-1);
 
     // Unmark all nodes.
     for (SupportElements& elements : move_bounds)
@@ -1863,6 +1863,21 @@ std::vector<Vec3f> its_face_normals(const indexed_triangle_set &its)
     return normals;
 }
 
+void its_flat_shading_interleaved(const indexed_triangle_set &its, std::vector<float> &out)
+{
+    const size_t offset = out.size();
+    out.resize(offset + 3 * 6 * its.indices.size());
+    float *dst = out.data() + offset;
+    for (const stl_triangle_vertex_indices &face : its.indices) {
+        const stl_vertex vertex[3] { its.vertices[face[0]], its.vertices[face[1]], its.vertices[face[2]] };
+        const stl_vertex n = face_normal(vertex);
+        for (const stl_vertex &v : vertex) {
+            *dst ++ = n.x(); *dst ++ = n.y(); *dst ++ = n.z();
+            *dst ++ = v.x(); *dst ++ = v.y(); *dst ++ = v.z();
+        }
+    }
+}
+
 #if BOOST_ENDIAN_LITTLE_BYTE
 static inline void big_endian_reverse_quads(char*, size_t) {}
 #else // BOOST_ENDIAN_LITTLE_BYTE
@@ -334,6 +334,9 @@ inline Vec3f its_face_normal(const indexed_triangle_set &its, const stl_triangle
     { const stl_vertex vertices[3] { its.vertices[face[0]], its.vertices[face[1]], its.vertices[face[2]] }; return face_normal_normalized(vertices); }
 inline Vec3f its_face_normal(const indexed_triangle_set &its, const int face_idx)
     { return its_face_normal(its, its.indices[face_idx]); }
+// Append the three corners of each triangle with the normal of the triangle, interleaved as normal followed by position
+// as expected by glInterleavedArrays(GL_N3F_V3F). Flat shading needs the vertices unshared.
+void its_flat_shading_interleaved(const indexed_triangle_set &its, std::vector<float> &out);
 
 indexed_triangle_set    its_make_xoy_center_rect(float width,float height,float depth =0.f);
 indexed_triangle_set    its_make_cube(double x, double y, double z);
@@ -386,10 +389,17 @@ namespace cereal {
     template<class Archive> void load(Archive &archive, Slic3r::TriangleMesh &mesh) {
         archive.loadBinary(reinterpret_cast<char*>(const_cast<Slic3r::TriangleMeshStats*>(&mesh.stats())), sizeof(Slic3r::TriangleMeshStats));
         archive(mesh.its.indices, mesh.its.vertices);
+        // Face types, which are stored into 3MF.
+        uint64_t num_properties;
+        archive(num_properties);
+        mesh.its.properties.resize(num_properties);
+        archive.loadBinary(reinterpret_cast<char*>(mesh.its.properties.data()), sizeof(FaceProperty) * num_properties);
     }
     template<class Archive> void save(Archive &archive, const Slic3r::TriangleMesh &mesh) {
         archive.saveBinary(reinterpret_cast<const char*>(&mesh.stats()), sizeof(Slic3r::TriangleMeshStats));
         archive(mesh.its.indices, mesh.its.vertices);
+        archive(uint64_t(mesh.its.properties.size()));
+        archive.saveBinary(reinterpret_cast<const char*>(mesh.its.properties.data()), sizeof(FaceProperty) * mesh.its.properties.size());
     }
 }
 
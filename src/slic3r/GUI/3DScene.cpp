@@ -37,6 +37,8 @@
 
 #include <boost/log/trivial.hpp>
 
+#include <tbb/parallel_for.h>
+
 #include <boost/filesystem/operations.hpp>
 #include <boost/algorithm/string/predicate.hpp>
 
@@ -186,17 +188,18 @@ void GLIndexedVertexArray::load_mesh_full_shading(const TriangleMesh& mesh)
 
 void GLIndexedVertexArray::load_its_flat_shading(const indexed_triangle_set &its)
 {
-    this->vertices_and_normals_interleaved.reserve(this->vertices_and_normals_interleaved.size() + 3 * 3 * 2 * its.indices.size());
-    unsigned int vertices_count = 0;
-    for (int i = 0; i < int(its.indices.size()); ++ i) {
-        stl_triangle_vertex_indices face        = its.indices[i];
-        stl_vertex                  vertex[3]   = { its.vertices[face[0]], its.vertices[face[1]], its.vertices[face[2]] };
-        stl_vertex                  n           = face_normal_normalized(vertex);
-        for (int j = 0; j < 3; ++j)
-            this->push_geometry(vertex[j](0), vertex[j](1), vertex[j](2), n(0), n(1), n(2));
-        this->push_triangle(vertices_count, vertices_count + 1, vertices_count + 2);
-        vertices_count += 3;
-    }
+    assert(this->vertices_and_normals_interleaved_VBO_id == 0);
+    assert(this->vertices_and_normals_interleaved.size() % 6 == 0);
+    const size_t first_vertex = this->vertices_and_normals_interleaved.size() / 6;
+    its_flat_shading_interleaved(its, this->vertices_and_normals_interleaved);
+    const size_t num_vertices = this->vertices_and_normals_interleaved.size() / 6;
+    for (size_t i = first_vertex; i < num_vertices; ++ i)
+        m_bounding_box.extend(Vec3f(this->vertices_and_normals_interleaved.data() + i * 6 + 3));
+    this->triangle_indices.reserve(this->triangle_indices.size() + num_vertices - first_vertex);
+    for (size_t i = first_vertex; i < num_vertices; ++ i)
+        this->triangle_indices.emplace_back(int(i));
+    this->vertices_and_normals_interleaved_size = this->vertices_and_normals_interleaved.size();
+    this->triangle_indices_size                 = this->triangle_indices.size();
     BOOST_LOG_TRIVIAL(debug) << __FUNCTION__<< boost::format(", this %1%, indices size %2%, vertices %3%, triangles %4% ")
             %this %its.indices.size() %this->vertices_and_normals_interleaved.size() %this->triangle_indices.size() ;
 }
@@ -1303,12 +1306,43 @@ std::vector<int> GLVolumeCollection::load_object(
     bool                    lod_enabled)
 {
     std::vector<int> volumes_idx;
+    PreparedMeshes   prepared_meshes;
+    if (! instance_idxs.empty())
+        prepared_meshes = prepare_meshes(std::vector<const ModelVolume*>(model_object->volumes.begin(), model_object->volumes.end()));
     for (int volume_idx = 0; volume_idx < int(model_object->volumes.size()); ++volume_idx)
         for (int instance_idx : instance_idxs)
-            volumes_idx.emplace_back(this->GLVolumeCollection::load_object_volume(model_object, obj_idx, volume_idx, instance_idx, color_by, opengl_initialized, false, lod_enabled));
+            volumes_idx.emplace_back(this->GLVolumeCollection::load_object_volume(model_object, obj_idx, volume_idx, instance_idx, color_by, opengl_initialized, false, lod_enabled, &prepared_meshes));
     return volumes_idx;
 }
 
+GLVolumeCollection::PreparedMeshes GLVolumeCollection::prepare_meshes(const std::vector<const ModelVolume*> &model_volumes)
+{
+    std::vector<const TriangleMesh*> meshes;
+    for (const ModelVolume *model_volume : model_volumes) {
+        auto it = g_mesh_volumes_map.find(model_volume->mesh_ptr());
+        if (it == g_mesh_volumes_map.end() || it->second.empty())
+            meshes.emplace_back(model_volume->mesh_ptr());
+    }
+    sort_remove_duplicates(meshes);
+
+    std::vector<GLIndexedVertexArray> vertex_arrays(meshes.size());
+    tbb::parallel_for(tbb::blocked_range<size_t>(0, meshes.size(), 1), [&meshes, &vertex_arrays](const tbb::blocked_range<size_t> &range) {
+        for (size_t i = range.begin(); i < range.end(); ++ i) {
+#if ENABLE_SMOOTH_NORMALS
+            vertex_arrays[i].load_mesh(*meshes[i], true);
+#else
+            vertex_arrays[i].load_mesh(*meshes[i]);
+#endif // ENABLE_SMOOTH_NORMALS
+            vertex_arrays[i].shrink_to_fit();
+        }
+    });
+
+    PreparedMeshes out;
+    for (size_t i = 0; i < meshes.size(); ++ i)
+        out.emplace(meshes[i], std::move(vertex_arrays[i]));
+    return out;
+}
+
 int GLVolumeCollection::load_object_volume(
     const ModelObject   *model_object,
     int                  obj_idx,
@@ -1318,7 +1352,8 @@ int GLVolumeCollection::load_object_volume(
     bool 				 opengl_initialized,
     bool                 in_assemble_view,
     bool                 use_loaded_id,
-    bool                 lod_enabled)
+    bool                 lod_enabled,
+    PreparedMeshes      *prepared_meshes)
 {
     const ModelVolume   *model_volume = model_object->volumes[volume_idx];
     const int            extruder_id  = model_volume->extruder_id();
@@ -1361,8 +1396,22 @@ int GLVolumeCollection::load_object_volume(
         g_mesh_volumes_map.emplace(mesh_ptr, std::move(volume_set));
     }
     if (need_create_mesh) {
+        // Move in the vertex array prepared in parallel if available, otherwise calculate it here.
+        auto load_mesh = [&v, &mesh, mesh_ptr, prepared_meshes]() {
+            if (prepared_meshes != nullptr)
+                if (auto it = prepared_meshes->find(mesh_ptr); it != prepared_meshes->end()) {
+                    *v.indexed_vertex_array = std::move(it->second);
+                    prepared_meshes->erase(it);
+                    return;
+                }
 #if ENABLE_SMOOTH_NORMALS
-        v.indexed_vertex_array->load_mesh(mesh, true);
+            v.indexed_vertex_array->load_mesh(mesh, true);
+#else
+            v.indexed_vertex_array->load_mesh(mesh);
+#endif // ENABLE_SMOOTH_NORMALS
+        };
+#if ENABLE_SMOOTH_NORMALS
+        load_mesh();
 #else
         if (lod_enabled) {
             if (v.indexed_vertex_array_middle == nullptr)
@@ -1379,7 +1428,7 @@ int GLVolumeCollection::load_object_volume(
             v.simplify_mesh(mesh, v.indexed_vertex_array_small, LOD_LEVEL::SMALL);
         }
 
-        v.indexed_vertex_array->load_mesh(mesh);
+        load_mesh();
 #endif // ENABLE_SMOOTH_NORMALS
         v.indexed_vertex_array->finalize_geometry(opengl_initialized);
     }
@@ -95,6 +95,9 @@ public:
         vertices_and_normals_interleaved(std::move(rhs.vertices_and_normals_interleaved)),
         triangle_indices(std::move(rhs.triangle_indices)),
         quad_indices(std::move(rhs.quad_indices)),
+        vertices_and_normals_interleaved_size(rhs.vertices_and_normals_interleaved_size),
+        triangle_indices_size(rhs.triangle_indices_size),
+        quad_indices_size(rhs.quad_indices_size),
         m_bounding_box(rhs.m_bounding_box)
         { assert(! rhs.has_VBOs()); }
 
@@ -723,6 +726,13 @@ public:
         bool 					 opengl_initialized,
         bool                    lod_enabled);
 
+    // Vertex arrays of meshes not yet loaded to the GPU, prepared in parallel by prepare_meshes().
+    using PreparedMeshes = std::map<const TriangleMesh*, GLIndexedVertexArray>;
+    // Prepare the vertex arrays of the meshes of the model volumes, which are not shared with an already loaded GLVolume.
+    // The normals and vertex packing are calculated for all the meshes in parallel, so that load_object_volume()
+    // called with the result is left with just uploading the prepared vertex arrays to the GPU.
+    static PreparedMeshes prepare_meshes(const std::vector<const ModelVolume*> &model_volumes);
+
     int load_object_volume(
         const ModelObject *model_object,
         int                obj_idx,
@@ -732,7 +742,9 @@ public:
         bool 			   opengl_initialized,
         bool               in_assemble_view = false,
         bool               use_loaded_id = false,
-        bool               lod_enabled = true);
+        bool               lod_enabled = true,
+        // Vertex arrays prepared by prepare_meshes(). The vertex array used by the new GLVolume is moved out.
+        PreparedMeshes    *prepared_meshes = nullptr);
 
     // Load SLA auxiliary GLVolumes (for support trees or pad).
     void load_object_auxiliary(
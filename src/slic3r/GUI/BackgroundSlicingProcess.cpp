@@ -25,6 +25,7 @@
 #include "libslic3r/libslic3r.h"
 
 #include <cassert>
+#include <thread>
 #include <stdexcept>
 #include <cctype>
 
@@ -113,6 +114,9 @@ BackgroundSlicingProcess::BackgroundSlicingProcess()
     temp_path /= (boost::format(".%1%.gcode") % get_current_pid()).str();
 	m_temp_output_path = temp_path.string();
 #endif
+	// Rasterize the SLA layers while writing the archive, keeping only a few encoded layers in memory.
+	// Up to 512 MB of the encoded layers are kept, so that an export followed by an upload rasterizes once.
+	m_sla_archive.set_max_layers_in_flight(std::max<size_t>(4, 2 * std::thread::hardware_concurrency()), size_t(512) << 20);
 }
 
 BackgroundSlicingProcess::~BackgroundSlicingProcess()
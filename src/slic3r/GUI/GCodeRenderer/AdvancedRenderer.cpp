@@ -175,9 +175,9 @@ namespace
     }
 
     void add_segment(const Slic3r::GUI::gcode::Segment& t_seg, const std::vector<Slic3r::GUI::gcode::SegmentVertex>& segment_vertex, std::vector<float>& segment_index_list, uint32_t& prev_seg_index, bool flag = false) {
-        const auto& t_seg_vertex_first = segment_vertex.at(t_seg.m_first_mid);
-        const auto& t_seg_vertex_second = segment_vertex.at(t_seg.m_second_mid);
-        const auto first_pos_index = t_seg_vertex_first.m_indices[t_seg_vertex_first.m_indices.size() - 1];
+        const auto& t_seg_vertex_first = segment_vertex.at(t_seg.first_vertex);
+        const auto& t_seg_vertex_second = segment_vertex.at(t_seg.second_vertex);
+        const auto first_pos_index = t_seg_vertex_first.positions[t_seg_vertex_first.positions.size() - 1];
         uint32_t prev_first_pos_index = 0;
         bool has_prev = false;
         if (flag) {
@@ -190,15 +190,15 @@ namespace
             }
         }
         segment_index_list.emplace_back(first_pos_index);
-        segment_index_list.emplace_back(t_seg_vertex_second.m_indices[0]);
+        segment_index_list.emplace_back(t_seg_vertex_second.positions[0]);
         segment_index_list.emplace_back(float(has_prev));
         segment_index_list.emplace_back(float(prev_first_pos_index));
         if (flag) {
             prev_seg_index = segment_index_list.size() / 4 - 1;
         }
-        for (size_t k_index = 1; k_index < t_seg_vertex_second.m_indices.size(); ++k_index) {
-            segment_index_list.emplace_back(t_seg_vertex_second.m_indices[k_index - 1]);
-            segment_index_list.emplace_back(t_seg_vertex_second.m_indices[k_index]);
+        for (size_t k_index = 1; k_index < t_seg_vertex_second.positions.size(); ++k_index) {
+            segment_index_list.emplace_back(t_seg_vertex_second.positions[k_index - 1]);
+            segment_index_list.emplace_back(t_seg_vertex_second.positions[k_index]);
             segment_index_list.emplace_back(float(has_prev));
             if (flag) {
                 segment_index_list.emplace_back(segment_index_list[prev_seg_index * 4 + 0]);
@@ -475,9 +475,9 @@ namespace Slic3r
                         const auto& startPos_mid = position_data_list[t_seg_start_index];
                         const auto& endPos_mid = position_data_list[t_seg_end_index];
 
-                        const int t_segment_vertex_index = int(endPos_mid.m_segment_vertex_index);
+                        const int t_segment_vertex_index = int(endPos_mid.vertex);
                         const auto& t_segment_vertex = segment_vertex_list[t_segment_vertex_index];
-                        const auto& t_move = m_gcode_result->moves[t_segment_vertex.m_move_id];
+                        const auto& t_move = m_gcode_result->moves[t_segment_vertex.move_id];
                         if (t_move.type != EMoveType::Extrude) {
                             continue;
                         }
@@ -492,7 +492,7 @@ namespace Slic3r
                             }
                         }
 
-                        Vec3f line = endPos_mid.m_position - startPos_mid.m_position;
+                        Vec3f line = endPos_mid.position - startPos_mid.position;
                         Vec3f line_dir = Vec3f(1.0, 0.0, 0.0);
                         float line_len = line.norm();
                         line_dir = line / std::max(line_len, 1e-6f);
@@ -512,7 +512,7 @@ namespace Slic3r
                         Vec3f d_left = half_width * left_dir;
 
                         //start side
-                        const auto position_start_center = startPos_mid.m_position - half_height * up;
+                        const auto position_start_center = startPos_mid.position - half_height * up;
                         auto position_start_up = position_start_center + d_up;
                         out_vertices.emplace_back(std::move(position_start_up));
                         out_normals.emplace_back(up);
@@ -534,7 +534,7 @@ namespace Slic3r
                         out_uvs.emplace_back(uv);
 
                         // end side
-                        const auto position_end_center = endPos_mid.m_position - half_height * up;
+                        const auto position_end_center = endPos_mid.position - half_height * up;
                         auto position_end_up = position_end_center + d_up;
                         out_vertices.emplace_back(std::move(position_end_up));
                         out_normals.emplace_back(up);
@@ -559,7 +559,7 @@ namespace Slic3r
                         const int prev_index = seg_list[4 * i + 3];
                         if (has_prev) {
                             const auto& prevPos_mid = position_data_list[prev_index];
-                            Vec3f prev_dir = startPos_mid.m_position - prevPos_mid.m_position;
+                            Vec3f prev_dir = startPos_mid.position - prevPos_mid.position;
                             prev_dir = prev_dir / std::max(prev_dir.norm(), 1e-6f);
                             prev_dir.normalize();
                             Vec3f prev_right_dir = Vec3f(prev_dir.y(), -prev_dir.x(), 0.0);
@@ -567,7 +567,7 @@ namespace Slic3r
                             Vec3f prev_left_dir = -prev_right_dir;
                             Vec3f prev_up = prev_right_dir.cross(prev_dir);
 
-                            Vec3f prev_end_pos_center = startPos_mid.m_position - half_height * prev_up;
+                            Vec3f prev_end_pos_center = startPos_mid.position - half_height * prev_up;
 
                             auto prev_end_left = prev_end_pos_center + half_width * prev_left_dir;
                             out_vertices.emplace_back(std::move(prev_end_left));
@@ -889,8 +889,7 @@ namespace Slic3r
                     return;
                 }
                 const auto& p_sequential_view = get_sequential_view();
-                // layers zs / roles / extruder ids -> extract from result
-                size_t last_travel_s_id = 0;
+                // roles / extruder ids -> extract from result
                 m_extruder_ids.clear();
                 size_t seams_count = 0;
                 std::vector<std::vector<size_t>> t_sid_to_seamMoveIds;
@@ -934,38 +933,12 @@ namespace Slic3r
                             }
                         }
 
-                        // layers zs
-                        const double z = static_cast<double>(move.position.z());
-                        bool needs_new_layer = p_layer_manager->empty();
-                        if (!needs_new_layer) {
-                            const auto& last_layer = p_layer_manager->get_layer(p_layer_manager->size() - 1);
-                            const auto last_z = last_layer.get_z();
-                            needs_new_layer = std::abs(z - last_z) > EPSILON;
-                        }
-                        if (needs_new_layer) {
-                            Layer t_layer;
-                            t_layer.set_start(last_travel_s_id)
-                                .set_end(move_id)
-                                .set_z(z);
-                            p_layer_manager->add_layer(t_layer);
-                        }
-                        else {
-                            auto& last_layer = p_layer_manager->get_layer(p_layer_manager->size() - 1);
-                            last_layer.set_end(move_id);
-                        }
                         // extruder ids
                         m_extruder_ids.emplace_back(move.extruder_id);
                         // roles
                         if (i > 0)
                             m_roles.emplace_back(move.extrusion_role);
                     }
-                    else if (move.type == EMoveType::Travel) {
-                        if (move_id - last_travel_s_id > 0 && !p_layer_manager->empty()) {
-                            auto& last_layer = p_layer_manager->get_layer(p_layer_manager->size() - 1);
-                            last_layer.set_end(move_id);
-                        }
-                        last_travel_s_id = move_id;
-                    }
                     else if (move.type == EMoveType::Unretract && move.extrusion_role == ExtrusionRole::erFlush) {
                         m_roles.emplace_back(move.extrusion_role);
                     }
@@ -1051,16 +1024,14 @@ namespace Slic3r
                 }
                 m_plater_extruder = plater_extruder;
 
-                // replace layers for spiral vase mode
-                if (!gcode_result.spiral_vase_layers.empty()) {
-                    p_layer_manager->clear();
-                    for (const auto& layer : gcode_result.spiral_vase_layers) {
-                        Layer t_layer;
-                        t_layer.set_start(layer.second.first)
-                            .set_end(layer.second.second)
-                            .set_z(layer.first);
-                        p_layer_manager->add_layer(std::move(t_layer));
-                    }
+                // layers zs, the layers of a spiral vase are taken from the G-code processor
+                const std::vector<ToolpathLayer> t_toolpath_layers = toolpath_layers(gcode_result);
+                for (const ToolpathLayer& toolpath_layer : t_toolpath_layers) {
+                    Layer t_layer;
+                    t_layer.set_start(toolpath_layer.first_sid)
+                        .set_end(toolpath_layer.last_sid)
+                        .set_z(toolpath_layer.z);
+                    p_layer_manager->add_layer(std::move(t_layer));
                 }
 
                 // set layers z range
@@ -1068,11 +1039,14 @@ namespace Slic3r
                     return;
                 }
 
+                // the geometry of the layers is built on the CPU in parallel, then handed over to the layers
+                std::vector<ToolpathLayerGeometry> t_geometries = build_toolpath_geometry(gcode_result, t_toolpath_layers, m_ssid_to_moveid_map, t_sid_to_seamMoveIds);
+
                 last_progress = 0;
                 const auto t_layer_count = p_layer_manager->size();
                 for (size_t i = 0; i < t_layer_count; ++i) {
                     auto& t_layer = (*p_layer_manager)[i];
-                    t_layer.init_sgments(m_ssid_to_moveid_map, t_sid_to_seamMoveIds, gcode_result);
+                    t_layer.init_sgments(std::move(t_geometries[i]));
                     if (progress_dialog != nullptr) {
                         float progress_value = 100.0f * float(i + 1) / float(t_layer_count);
                         if (int(progress_value) != last_progress && int(progress_value) % 10 == 0) {
@@ -1838,85 +1812,21 @@ namespace Slic3r
                 return m_zs;
             }
 
-            void Layer::init_sgments(const std::vector<size_t>& sid_to_mid, const std::vector<std::vector<size_t>>& sid_to_seamMoveIds, const GCodeProcessorResult& gcode_result)
+            void Layer::init_sgments(ToolpathLayerGeometry&& geometry)
             {
                 if (!is_valid()) {
                     return;
                 }
 
-                std::vector<uint32_t> t_sid_to_index;
-                std::vector<std::vector<uint32_t>> m_seam_to_index;
-                m_seam_to_index.resize(m_end_sid - m_start_sid + 1);
-                t_sid_to_index.resize(m_end_sid - m_start_sid + 1);
-                uint32_t t_count = 0;
-                bool b_has_custom_options = false;
-
-                for (uint32_t sid = m_start_sid; sid <= m_end_sid; ++sid)
-                {
-                    size_t move_id = sid_to_mid[sid];
-                    const auto& curr_move = gcode_result.moves[move_id];
-                    if (curr_move.type == EMoveType::Pause_Print || curr_move.type == EMoveType::Custom_GCode) {
-                        b_has_custom_options = true;
-                    }
-                    const uint32_t index = add_segment_vertex(move_id, curr_move);
-                    t_sid_to_index[t_count] = index;
-
-                    if (sid_to_seamMoveIds[sid].size()) {
-                        std::vector<uint32_t> indices;
-                        for (size_t j = 0; j < sid_to_seamMoveIds[sid].size(); ++j) {
-                            const auto seam_mid = sid_to_seamMoveIds[sid][j];
-                            const auto& curr_seam = gcode_result.moves[seam_mid];
-                            const uint32_t seam_index = add_segment_vertex(seam_mid, curr_seam);
-                            indices.emplace_back(seam_index);
-                        }
-                        m_seam_to_index[t_count] = std::move(indices);
-                    }
-                    ++t_count;
-                }
-
-                if (b_has_custom_options) {
+                if (geometry.has_custom_options) {
                     const auto p_color_effect = std::make_shared<render::ColorEffect>();
                     p_color_effect->set_color(0.8f, 0.8f, 0.8f, 1.0f);
                     add_effect(p_color_effect);
                 }
 
-                m_segments.clear();
-                m_segments.reserve(m_end_sid - m_start_sid + 1);
-                t_count = 1;
-                for (uint32_t sid = m_start_sid + 1; sid <= m_end_sid; ++sid) {
-                    size_t prev_move_index = t_sid_to_index[t_count - 1];
-                    SegmentVertex t_perv_vertex = m_segment_vertices[prev_move_index];
-                    const auto& prev_move = gcode_result.moves[t_perv_vertex.m_move_id];
-
-                    size_t curr_move_index = t_sid_to_index[t_count];
-                    SegmentVertex t_curr_vertex = m_segment_vertices[curr_move_index];
-                    const auto& curr_move = gcode_result.moves[t_curr_vertex.m_move_id];
-
-                    Segment t_seg;
-                    t_seg.m_first_mid = prev_move_index;
-                    t_seg.m_second_mid = curr_move_index;
-                    t_seg.m_type = curr_move.type;
-                    t_seg.m_role = curr_move.extrusion_role;
-                    t_seg.m_extruder_id = curr_move.extruder_id;
-                    m_segments.emplace_back(std::move(t_seg));
-
-                    if (sid_to_seamMoveIds[sid].size()) {
-                        const std::vector<uint32_t>& indices = m_seam_to_index[t_count];
-                        for (size_t i = 0; i < sid_to_seamMoveIds[sid].size(); ++i) {
-
-                            const auto seam_mid = sid_to_seamMoveIds[sid][i];
-                            const auto& curr_seam = gcode_result.moves[seam_mid];
-                            Segment t_seg;
-                            t_seg.m_first_mid = indices[i];
-                            t_seg.m_second_mid = t_seg.m_first_mid;
-                            t_seg.m_type = curr_seam.type;
-                            t_seg.m_role = curr_seam.extrusion_role;
-                            t_seg.m_extruder_id = curr_seam.extruder_id;
-                            m_segments.emplace_back(std::move(t_seg));
-                        }
-                    }
-                    ++t_count;
-                }
+                m_segment_vertices = std::move(geometry.vertices);
+                m_position_data = std::move(geometry.positions);
+                m_segments = std::move(geometry.segments);
             }
 
             bool Layer::is_valid() const
@@ -1989,21 +1899,21 @@ namespace Slic3r
                 const auto t_view_type = t_layer_manager.get_view_type();
                 for (int i_seg = t_start_seg_index; i_seg <= t_end_seg_index; ++i_seg) {
                     const auto& t_seg = m_segments[i_seg];
-                    if (!t_layer_manager.is_move_type_visible(t_seg.m_type)) {
+                    if (!t_layer_manager.is_move_type_visible(t_seg.type)) {
                         continue;
                     }
-                    if (t_seg.m_type == EMoveType::Extrude) {
-                        if (!t_layer_manager.is_extrusion_role_visible(t_seg.m_role)) {
+                    if (t_seg.type == EMoveType::Extrude) {
+                        if (!t_layer_manager.is_extrusion_role_visible(t_seg.role)) {
                             continue;
                         }
                     }
 
-                    if (t_view_type == EViewType::ColorPrint && !filament_visible_flags[t_seg.m_extruder_id]) {
+                    if (t_view_type == EViewType::ColorPrint && !filament_visible_flags[t_seg.extruder_id]) {
                         continue;
                     }
                     m_visible_segment_list.emplace_back(i_seg);
 
-                    switch (t_seg.m_type) {
+                    switch (t_seg.type) {
                     case EMoveType::Tool_change:
                     case EMoveType::Color_change:
                     case EMoveType::Pause_Print:
@@ -2064,10 +1974,10 @@ namespace Slic3r
                     memset(t_buffer_data.data(), 0, t_buffer_data.size() * sizeof(float));
                     for (size_t i = 0; i < m_position_data.size(); ++i) {
                         const auto& t_pos_data = m_position_data[i];
-                        t_buffer_data[4 * i] = t_pos_data.m_position[0];
-                        t_buffer_data[4 * i + 1] = t_pos_data.m_position[1];
-                        t_buffer_data[4 * i + 2] = t_pos_data.m_position[2];
-                        t_buffer_data[4 * i + 3] = float(t_pos_data.m_segment_vertex_index);
+                        t_buffer_data[4 * i] = t_pos_data.position[0];
+                        t_buffer_data[4 * i + 1] = t_pos_data.position[1];
+                        t_buffer_data[4 * i + 2] = t_pos_data.position[2];
+                        t_buffer_data[4 * i + 3] = float(t_pos_data.vertex);
                     }
                     const bool rt = m_p_position_texture->set_buffer(t_buffer_data);
                     if (rt) {
@@ -2104,7 +2014,7 @@ namespace Slic3r
                     std::vector<float> t_segment_width_height;
                     for (auto iter = m_segment_vertices.begin(); iter != m_segment_vertices.end(); ++iter)
                     {
-                        const auto& t_move = gcode_result.moves[iter->m_move_id];
+                        const auto& t_move = gcode_result.moves[iter->move_id];
                         float width = t_move.width;
                         float height = t_move.height;
                         if (t_move.type == EMoveType::Travel) {
@@ -2134,7 +2044,7 @@ namespace Slic3r
                 m_per_move_data_list.reserve(4 * m_segment_vertices.size());
                 for (auto iter = m_segment_vertices.begin(); iter != m_segment_vertices.end(); ++iter)
                 {
-                    const auto& t_move = gcode_result.moves[iter->m_move_id];
+                    const auto& t_move = gcode_result.moves[iter->move_id];
                     m_per_move_data_list.emplace_back(float(t_move.type));
                     const float t_move_range_data = get_move_data_from_view_type(t_view_type, t_move);
                     m_per_move_data_list.emplace_back(t_move_range_data);
@@ -2272,12 +2182,12 @@ namespace Slic3r
                 const auto& t_visibile_segments = get_visible_segment_list();
                 if (seg_index >= 1) {
                     const auto& t_seg = t_segments[t_visibile_segments[seg_index - 1]];
-                    return m_segment_vertices[t_seg.m_second_mid].m_move_id;
+                    return m_segment_vertices[t_seg.second_vertex].move_id;
                 }
                 else
                 {
                     const auto& t_seg = t_segments[t_visibile_segments[0]];
-                    return m_segment_vertices[t_seg.m_first_mid].m_move_id;
+                    return m_segment_vertices[t_seg.first_vertex].move_id;
                 }
             }
 
@@ -2286,42 +2196,6 @@ namespace Slic3r
                 return m_position_data;
             }
 
-            uint32_t Layer::add_segment_vertex(uint32_t move_id, const GCodeProcessorResult::MoveVertex& t_move)
-            {
-                uint32_t t_index = m_segment_vertices.size();
-                SegmentVertex t_seg_vertex;
-                t_seg_vertex.m_move_id = move_id;
-                t_seg_vertex.m_indices.clear();
-                t_seg_vertex.m_indices.reserve(10);
-                float hight_offset = 0.0f;
-                if (t_move.type == EMoveType::Wipe) {
-                    hight_offset = 0.5f * GCodeProcessor::Wipe_Height;
-                }
-                uint32_t pos_index = m_position_data.size();
-                if (t_move.is_arc_move_with_interpolation_points()) {
-                    const size_t loop_num = t_move.interpolation_points.size();
-                    for (size_t i = 0; i < loop_num; ++i) {
-                        PositionData t_pos_data;
-                        t_pos_data.m_position = t_move.interpolation_points[i];
-                        t_pos_data.m_position.z() += hight_offset;
-                        t_pos_data.m_segment_vertex_index = t_index;
-                        m_position_data.emplace_back(std::move(t_pos_data));
-                        t_seg_vertex.m_indices.push_back(pos_index);
-                        ++pos_index;
-                    }
-                }
-
-                PositionData t_pos_data;
-                t_pos_data.m_position = t_move.position;
-                t_pos_data.m_position.z() += hight_offset;
-                t_pos_data.m_segment_vertex_index = t_index;
-                m_position_data.emplace_back(std::move(t_pos_data));
-                t_seg_vertex.m_indices.push_back(pos_index);
-                m_segment_vertices.emplace_back(std::move(t_seg_vertex));
-
-                return t_index;
-            }
-
             LayerManager::LayerManager()
             {
                 for (unsigned int i = 0; i < erCount; ++i) {
@@ -2624,7 +2498,7 @@ namespace Slic3r
                     }
                     const auto& t_seg = t_segments[t_segments_indices[j_seg - 1]];
                 
-                    switch (t_seg.m_type) {
+                    switch (t_seg.type) {
                     case EMoveType::Tool_change:
                     case EMoveType::Color_change:
                     case EMoveType::Pause_Print:
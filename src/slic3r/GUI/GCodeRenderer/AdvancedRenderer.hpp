@@ -1,6 +1,7 @@
 #pragma once
 #include "slic3r/GUI/GCodeRenderer/BaseRenderer.hpp"
 #include "slic3r/GUI/GLModel.hpp"
+#include "libslic3r/GCode/ToolpathGeometry.hpp"
 #include <memory>
 #include <vector>
 #include <unordered_map>
@@ -132,26 +133,9 @@ namespace Slic3r {
                 bool m_b_loading{false};
             };
 
-            struct SegmentVertex
-            {
-                uint32_t m_move_id{ -1u };
-                std::vector<uint32_t> m_indices;
-            };
-
-            struct Segment
-            {
-                uint32_t m_first_mid{ -1u };
-                uint32_t m_second_mid{ -1u };
-                EMoveType m_type{ EMoveType::Count };
-                ExtrusionRole m_role{ ExtrusionRole::erCount };
-                uint16_t m_extruder_id{ UINT16_MAX };
-            };
-
-            struct PositionData
-            {
-                Vec3f m_position;
-                uint32_t m_segment_vertex_index{ 0 };
-            };
+            using SegmentVertex = ToolpathVertex;
+            using Segment = ToolpathSegment;
+            using PositionData = ToolpathPosition;
 
             class Layer: public render::EffectContainer
             {
@@ -168,7 +152,7 @@ namespace Slic3r {
                 Layer& set_z(float z);
                 float get_z() const;
 
-                void init_sgments(const std::vector<size_t>& sid_to_mid, const std::vector<std::vector<size_t>>& sid_to_seamMoveId, const GCodeProcessorResult& gcode_result);
+                void init_sgments(ToolpathLayerGeometry&& geometry);
 
                 bool is_valid() const;
                 void set_vaild(bool is_valid);
@@ -10,6 +10,7 @@
 #include "libslic3r/PresetBundle.hpp"
 //BBS: add convex hull logic for toolpath check
 #include "libslic3r/Geometry/ConvexHull.hpp"
+#include "libslic3r/GCode/ToolpathGeometry.hpp"
 #include "slic3r/GUI/OpenGLManager.hpp"
 #include "slic3r/GUI/GUI_App.hpp"
 #include "slic3r/GUI/MainFrame.hpp"
@@ -1691,34 +1692,20 @@ namespace Slic3r {
                 log_memory_usage("Loaded G-code generated indices buffers ", vertices, indices);
                 // dismiss indices data, no more needed
                 std::vector<MultiIndexBuffer>().swap(indices);
-                // layers zs / roles / extruder ids -> extract from result
-                size_t last_travel_s_id = 0;
-                seams_count = 0;
+                // layers zs, the layers of a spiral vase are taken from the G-code processor
+                for (const ToolpathLayer& layer : toolpath_layers(gcode_result))
+                    m_layers.append(layer.z, { layer.first_sid, layer.last_sid });
+                // roles / extruder ids -> extract from result
                 m_extruder_ids.clear();
                 for (size_t i = 0; i < m_moves_count; ++i) {
                     const GCodeProcessorResult::MoveVertex& move = gcode_result.moves[i];
-                    if (move.type == EMoveType::Seam)
-                        ++seams_count;
-                    size_t move_id = i - seams_count;
                     if (move.type == EMoveType::Extrude) {
-                        // layers zs
-                        const double* const last_z = m_layers.empty() ? nullptr : &m_layers.get_zs().back();
-                        const double z = static_cast<double>(move.position.z());
-                        if (last_z == nullptr || z < *last_z - EPSILON || *last_z + EPSILON < z)
-                            m_layers.append(z, { last_travel_s_id, move_id });
-                        else
-                            m_layers.get_endpoints().back().last = move_id;
                         // extruder ids
                         m_extruder_ids.emplace_back(move.extruder_id);
                         // roles
                         if (i > 0)
                             m_roles.emplace_back(move.extrusion_role);
                     }
-                    else if (move.type == EMoveType::Travel) {
-                        if (move_id - last_travel_s_id > 0 && !m_layers.empty())
-                            m_layers.get_endpoints().back().last = move_id;
-                        last_travel_s_id = move_id;
-                    }
                     else if (move.type == EMoveType::Unretract && move.extrusion_role == ExtrusionRole::erFlush) {
                         m_roles.emplace_back(move.extrusion_role);
                     }
@@ -1735,13 +1722,6 @@ namespace Slic3r {
                     plater_extruder.push_back(++eid);
                 }
                 m_plater_extruder = plater_extruder;
-                // replace layers for spiral vase mode
-                if (!gcode_result.spiral_vase_layers.empty()) {
-                    m_layers.reset();
-                    for (const auto& layer : gcode_result.spiral_vase_layers) {
-                        m_layers.append(layer.first, { layer.second.first, layer.second.second });
-                    }
-                }
                 // set layers z range
                 if (!m_layers.empty())
                     m_layers_z_range = { 0, static_cast<unsigned int>(m_layers.size() - 1) };
@@ -3218,6 +3218,25 @@ void GLCanvas3D::reload_scene(bool refresh_immediately, bool force_full_scene_re
     }
     m_volumes.volumes = std::move(glvolumes_new);
     bool enable_lod   = GUI::wxGetApp().app_config->get_bool("enable_lod") ;
+    // Prepare the vertex arrays of all the new volumes in parallel, the loop below just uploads them.
+    GLVolumeCollection::PreparedMeshes prepared_meshes;
+    {
+        std::vector<const ModelVolume*> new_model_volumes;
+        for (const ModelObject *model_object : m_model->objects)
+            for (const ModelVolume *model_volume : model_object->volumes) {
+                if (m_canvas_type == ECanvasType::CanvasAssembleView && !model_volume->is_model_part())
+                    continue;
+                for (const ModelInstance *model_instance : model_object->instances) {
+                    ModelVolumeState key(model_volume->id(), model_instance->id());
+                    auto it = std::lower_bound(model_volume_state.begin(), model_volume_state.end(), key, model_volume_state_lower);
+                    if (it != model_volume_state.end() && it->geometry_id == key.geometry_id && it->new_geometry()) {
+                        new_model_volumes.emplace_back(model_volume);
+                        break;
+                    }
+                }
+            }
+        prepared_meshes = GLVolumeCollection::prepare_meshes(new_model_volumes);
+    }
     for (unsigned int obj_idx = 0; obj_idx < (unsigned int)m_model->objects.size(); ++ obj_idx) {
         const ModelObject &model_object = *m_model->objects[obj_idx];
         for (int volume_idx = 0; volume_idx < (int)model_object.volumes.size(); ++ volume_idx) {
@@ -3246,7 +3265,7 @@ void GLCanvas3D::reload_scene(bool refresh_immediately, bool force_full_scene_re
                         enable_lod = false;
                     }
 #endif
-                    m_volumes.load_object_volume(&model_object, obj_idx, volume_idx, instance_idx, m_color_by, m_initialized, m_canvas_type == ECanvasType::CanvasAssembleView, false, enable_lod);
+                    m_volumes.load_object_volume(&model_object, obj_idx, volume_idx, instance_idx, m_color_by, m_initialized, m_canvas_type == ECanvasType::CanvasAssembleView, false, enable_lod, &prepared_meshes);
                     m_volumes.volumes.back()->geometry_id = key.geometry_id;
                     update_object_list = true;
                 } else {
@@ -2859,6 +2859,8 @@ void TabPrint::build()
         optgroup->append_single_option_line("raft_first_layer_density");   // not only for raft, but for support too
         optgroup->append_single_option_line("raft_first_layer_expansion"); // not only for raft, but for support too
         optgroup->append_single_option_line("tree_support_wall_count");
+        optgroup->append_single_option_line("tree_support_cache_budget");
+        optgroup->append_single_option_line("tree_support_cache_radius_factor");
         optgroup->append_single_option_line("support_top_z_distance", "support#top-z-distance");
         optgroup->append_single_option_line("support_bottom_z_distance", "support#bottom-z-distance");
         optgroup->append_single_option_line("support_base_pattern", "support#base-pattern");
@@ -7945,6 +7947,7 @@ void TabSLAPrint::build()
 //    optgroup->append_single_option_line("hollowing_min_thickness");
 //    optgroup->append_single_option_line("hollowing_quality");
 //    optgroup->append_single_option_line("hollowing_closing_distance");
+//    optgroup->append_single_option_line("hollowing_tile_size");
 //
 //    page = add_options_page(L("Advanced"), "advanced");
 //    optgroup = page->new_optgroup(L("Slicing"));
@@ -17,6 +17,7 @@
 #define CEREAL_FUTURE_EXPERIMENTAL
 #include <cereal/archives/adapters.hpp>
 
+#include <libslic3r/ChunkStore.hpp>
 #include <libslic3r/PrintConfig.hpp>
 #include <libslic3r/ObjectID.hpp>
 #include <libslic3r/Utils.hpp>
@@ -113,6 +114,9 @@ public:
 	virtual size_t release_optional() = 0;
 	// Restore optional data possibly released by release_optional.
 	virtual void   restore_optional() = 0;
+	// Serialize an immutable object into the chunk store of the Undo / Redo stack and release the object
+	// if it is referenced by the Undo / Redo stack only. Return true if the object was serialized.
+	virtual bool   serialize_unshared(StackImpl &/* stack */) { return false; }
 
 	// Estimated size in memory, to be used to drop least recently used snapshots.
 	virtual size_t memsize() const = 0;
@@ -244,7 +248,7 @@ public:
 	size_t memsize() const override {
 		size_t memsize = sizeof(*this);
 		if (this->is_serialized())
-			memsize += m_serialized.size();
+			memsize += m_serialized.memsize();
 		else if (m_shared_object.use_count() == 1)
 			// Only count the shared object's memsize into the total Undo / Redo stack memsize if it is referenced from the Undo / Redo stack only.
 			memsize += m_shared_object->memsize();
@@ -280,8 +284,8 @@ public:
 		if (m_optional) {
 			bool released = false;
 			if (this->is_serialized()) {
-				mem_released += m_serialized.size();
-				m_serialized.clear();
+				mem_released += m_serialized.memsize();
+				m_serialized.reset();
 				released = true;
 			} else if (m_shared_object.use_count() == 1) {
 				mem_released += m_shared_object->memsize();
@@ -305,8 +309,9 @@ public:
 			const_cast<T*>(m_shared_object.get())->restore_optional();
 	}
 
+	bool 						serialize_unshared(StackImpl &stack) override;
+
 	bool 						is_serialized() const { return m_shared_object.get() == nullptr; }
-	const std::string&			serialized_data() const { return m_serialized; }
 	std::shared_ptr<const T>& 	shared_ptr(StackImpl &stack);
 
 #ifdef SLIC3R_UNDOREDO_DEBUG
@@ -331,7 +336,8 @@ private:
 	std::shared_ptr<const T>	m_shared_object;
 	// If this object is optional, then it may be deleted from the Undo / Redo stack and recalculated from other data (for example mesh convex hull).
 	bool 						m_optional;
-	std::string 				m_serialized;
+	// Serialized object stored in the chunk store of the Undo / Redo stack.
+	ChunkStore::Blob			m_serialized;
 };
 
 struct MutableHistoryInterval
@@ -339,29 +345,32 @@ struct MutableHistoryInterval
 private:
 	struct Data
 	{
+		Data(ChunkStore &store, const std::string &input_data, size_t time) : refcnt(1), blob(store.store(input_data, time)) {
+			if (input_data.size() >= 8)
+				memcpy(&this->timestamp, input_data.data(), 8);
+		}
+
 		// Reference counter of this data chunk. We may have used shared_ptr, but the shared_ptr is thread safe
 		// with the associated cost of CPU cache invalidation on refcount change.
-		size_t		refcnt;
-		size_t		size;
-		char 		data[1];
+		size_t				refcnt;
+		// First 8 bytes of the serialized data, holding the timestamp of the objects serializing their timestamp first.
+		uint64_t			timestamp { 0 };
+		// The serialized data split into chunks, which are shared with the other snapshots and possibly compressed.
+		ChunkStore::Blob	blob;
 
 		// The serialized data matches the data stored here.
-		bool 		matches(const std::string& rhs) { return this->size == rhs.size() && memcmp(this->data, rhs.data(), this->size) == 0; }
+		bool 		matches(const ChunkStore &store, const std::string& rhs) const { return store.equals(this->blob, rhs); }
 
 		// The timestamp matches the timestamp serialized in the data stored here.
-		bool 		matches_timestamp(uint64_t timestamp) { assert(timestamp > 0);  assert(this->size > 8); return memcmp(this->data, &timestamp, 8) == 0; }
+		bool 		matches_timestamp(uint64_t timestamp) const { assert(timestamp > 0); assert(this->blob.size() > 8); return this->timestamp == timestamp; }
 	};
 
 	Interval    m_interval;
 	Data	   *m_data;
 
 public:
-	MutableHistoryInterval(const Interval &interval, const std::string &input_data) : m_interval(interval), m_data(nullptr) {
-		m_data = (Data*)new char[offsetof(Data, data) + input_data.size()];
-		m_data->refcnt = 1;
-		m_data->size = input_data.size();
-		memcpy(m_data->data, input_data.data(), input_data.size());
-	}
+	MutableHistoryInterval(const Interval &interval, ChunkStore &store, const std::string &input_data, size_t time) :
+		m_interval(interval), m_data(new Data(store, input_data, time)) {}
 
 	MutableHistoryInterval(const Interval &interval, MutableHistoryInterval &other) : m_interval(interval), m_data(other.m_data) {
 		++ m_data->refcnt;
@@ -371,13 +380,19 @@ public:
 	MutableHistoryInterval(const size_t begin, const size_t end) : m_interval(begin, end), m_data(nullptr) {}
 
 	MutableHistoryInterval(MutableHistoryInterval&& rhs) : m_interval(rhs.m_interval), m_data(rhs.m_data) { rhs.m_data = nullptr; }
-	MutableHistoryInterval& operator=(MutableHistoryInterval&& rhs) { m_interval = rhs.m_interval; m_data = rhs.m_data; rhs.m_data = nullptr; return *this; }
-
-	~MutableHistoryInterval() {
-		if (m_data != nullptr && -- m_data->refcnt == 0)
-			delete[] (char*)m_data;
+	MutableHistoryInterval& operator=(MutableHistoryInterval&& rhs) {
+		if (this != &rhs) {
+			// Release the data being overwritten, for example when erasing from a vector of intervals.
+			this->release();
+			m_interval = rhs.m_interval;
+			m_data = rhs.m_data;
+			rhs.m_data = nullptr;
+		}
+		return *this;
 	}
 
+	~MutableHistoryInterval() { this->release(); }
+
 	const Interval& interval() const { return m_interval; }
 	size_t		begin() const { return m_interval.begin(); }
 	size_t		end()   const { return m_interval.end(); }
@@ -389,20 +404,30 @@ public:
 	bool		operator<(const MutableHistoryInterval& rhs) const { return m_interval < rhs.m_interval; }
 	bool 		operator==(const MutableHistoryInterval& rhs) const { return m_interval == rhs.m_interval; }
 
-	const char* data() const { return m_data->data; }
-	size_t  	size() const { return m_data->size; }
+	// Identifies the data shared by multiple intervals.
+	const void* data() const { return m_data; }
+	size_t  	size() const { return m_data->blob.size(); }
 	size_t		refcnt() const { return m_data->refcnt; }
-	bool		matches(const std::string& data) { return m_data->matches(data); }
-	bool		matches_timestamp(uint64_t timestamp) { return m_data->matches_timestamp(timestamp); }
+	std::string	load(ChunkStore &store, size_t time) const { return store.load(m_data->blob, time); }
+	bool		matches(const ChunkStore &store, const std::string& data) const { return m_data->matches(store, data); }
+	bool		matches_timestamp(uint64_t timestamp) const { return m_data->matches_timestamp(timestamp); }
 	size_t 		memsize() const {
+		// The chunks of the snapshot data shared with other snapshots are accounted by the blob proportionally.
+		size_t memsize = sizeof(Data) + m_data->blob.memsize();
 		return m_data->refcnt == 1 ?
 			// Count just the size of the snapshot data.
-			m_data->size :
+			memsize :
 			// Count the size of the snapshot data divided by the number of references, rounded up.
-			(m_data->size + m_data->refcnt - 1) / m_data->refcnt;
+			(memsize + m_data->refcnt - 1) / m_data->refcnt;
 	}
 
 private:
+	void 		release() {
+		if (m_data != nullptr && -- m_data->refcnt == 0)
+			delete m_data;
+		m_data = nullptr;
+	}
+
 	MutableHistoryInterval(const MutableHistoryInterval &rhs);
 	MutableHistoryInterval& operator=(const MutableHistoryInterval &rhs);
 };
@@ -454,28 +479,29 @@ public:
 		return false;
 	}
 
-	void save(size_t active_snapshot_time, size_t current_time, const std::string &data) {
+	// New data is stored into the chunk store, sharing the chunks with the data of other snapshots.
+	void save(ChunkStore &store, size_t active_snapshot_time, size_t current_time, const std::string &data) {
 		assert(m_history.empty() || m_history.back().end() <= active_snapshot_time);
 		if (m_history.empty() || m_history.back().end() < active_snapshot_time) {
-			if (! m_history.empty() && m_history.back().matches(data))
+			if (! m_history.empty() && m_history.back().matches(store, data))
 				// Share the previous data by reference counting.
 				m_history.emplace_back(Interval(current_time, current_time + 1), m_history.back());
 			else
 				// Allocate new data.
-				m_history.emplace_back(Interval(current_time, current_time + 1), data);
+				m_history.emplace_back(Interval(current_time, current_time + 1), store, data, current_time);
 		} else {
 			assert(! m_history.empty());
 			assert(m_history.back().end() == active_snapshot_time);
-			if (m_history.back().matches(data))
+			if (m_history.back().matches(store, data))
 				// Just extend the last interval using the old data.
 				m_history.back().extend_end(current_time + 1);
 			else
 				// Allocate new data time continuous with the previous data.
-				m_history.emplace_back(Interval(active_snapshot_time, current_time + 1), data);
+				m_history.emplace_back(Interval(active_snapshot_time, current_time + 1), store, data, current_time);
 		}
 	}
 
-	std::string load(size_t timestamp) const {
+	std::string load(ChunkStore &store, size_t timestamp, size_t current_time) const {
 		assert(! m_history.empty());
 		auto it = std::lower_bound(m_history.begin(), m_history.end(), MutableHistoryInterval(timestamp, timestamp));
 		if (it == m_history.end() || it->begin() > timestamp) {
@@ -484,7 +510,7 @@ public:
 				--it;
 		}
 		//assert(timestamp >= it->begin() && timestamp < it->end());
-		return std::string(it->data(), it->data() + it->size());
+		return it->load(store, current_time);
 	}
 
 	// Currently all mutable snapshots are mandatory.
@@ -511,7 +537,7 @@ template<typename T>
 bool ImmutableObjectHistory<T>::valid()
 {
 	// The immutable object content is captured either by a shared object, or by its serialization, but not both.
-	assert(! m_shared_object == ! m_serialized.empty());
+	assert(! m_shared_object == m_serialized.valid());
 	// Verify that the history intervals are sorted and do not overlap.
 	if (! m_history.empty())
 		for (size_t i = 1; i < m_history.size(); ++ i)
@@ -526,7 +552,7 @@ bool MutableObjectHistory<T>::valid()
 {
 	// Verify that the history intervals are sorted and do not overlap, and that the data reference counters are correct.
 	if (! m_history.empty()) {
-		std::map<const char*, size_t> refcntrs;
+		std::map<const void*, size_t> refcntrs;
 		assert(m_history.front().data() != nullptr);
 		++ refcntrs[m_history.front().data()];
 		for (size_t i = 1; i < m_history.size(); ++ i) {
@@ -615,6 +641,7 @@ public:
 	template<typename T> T* load_mutable_object(const Slic3r::ObjectID id);
 	template<typename T> std::shared_ptr<const T> load_immutable_object(const Slic3r::ObjectID id, bool optional);
 	template<typename T> void load_mutable_object(const Slic3r::ObjectID id, T &target);
+	ChunkStore& 			 chunk_store() { return m_chunk_store; }
 
 #ifdef SLIC3R_UNDOREDO_DEBUG
 	std::string format() const {
@@ -678,6 +705,8 @@ private:
 	// Maximum memory allowed to be occupied by the Undo / Redo stack. If the limit is exceeded,
 	// least recently used snapshots will be released.
 	size_t 													m_memory_limit;
+	// Serialized snapshot data of all the objects, shared by their content. Declared before m_objects to outlive them.
+	ChunkStore 												m_chunk_store;
 	// Each individual object (Model, ModelObject, ModelInstance, ModelVolume, Selection, TriangleMesh)
 	// is stored with its own history, referenced by the ObjectID. Immutable objects do not provide
 	// their own IDs, therefore there are temporary IDs generated for them and stored to m_shared_ptr_to_object_id.
@@ -815,9 +844,9 @@ namespace UndoRedo {
 
 template<typename T> std::shared_ptr<const T>& 	ImmutableObjectHistory<T>::shared_ptr(StackImpl &stack)
 {
-	if (m_shared_object.get() == nullptr && ! m_serialized.empty()) {
+	if (m_shared_object.get() == nullptr && m_serialized.valid()) {
 		// Deserialize the object.
-		std::istringstream iss(m_serialized);
+		std::istringstream iss(stack.chunk_store().load(m_serialized, 0));
 		{
 			Slic3r::UndoRedo::InputArchive archive(stack, iss);
 			typedef typename std::remove_const<T>::type Type;
@@ -825,10 +854,28 @@ template<typename T> std::shared_ptr<const T>& 	ImmutableObjectHistory<T>::share
 			archive(*mesh.get());
 			m_shared_object = std::move(mesh);
 		}
+		// The object is shared with the scene now, it will be serialized again once it is referenced by the Undo / Redo stack only.
+		m_serialized.reset();
 	}
 	return m_shared_object;
 }
 
+template<typename T> bool ImmutableObjectHistory<T>::serialize_unshared(StackImpl &stack)
+{
+	// Optional objects are rather released by release_optional().
+	if (m_optional || m_shared_object.use_count() != 1)
+		return false;
+	std::ostringstream oss;
+	{
+		Slic3r::UndoRedo::OutputArchive archive(stack, oss);
+		archive(*m_shared_object);
+	}
+	// Store with zero access time, so that the serialized object is compressed as cold data.
+	m_serialized = stack.chunk_store().store(oss.str(), 0);
+	m_shared_object.reset();
+	return true;
+}
+
 template<typename T> ObjectID StackImpl::save_mutable_object(const T &object)
 {
 	// First find or allocate a history stack for the ObjectID of this object instance.
@@ -851,7 +898,7 @@ template<typename T> ObjectID StackImpl::save_mutable_object(const T &object)
 			Slic3r::UndoRedo::OutputArchive archive(*this, oss);
 			archive(object);
 		}
-		object_history->save(m_active_snapshot_time, m_current_time, oss.str());
+		object_history->save(m_chunk_store, m_active_snapshot_time, m_current_time, oss.str());
 	}
 	return object.id();
 }
@@ -896,7 +943,12 @@ template<typename T> std::shared_ptr<const T> StackImpl::load_immutable_object(c
 	auto *object_history = static_cast<ImmutableObjectHistory<T>*>(it_object_history->second.get());
 	assert(object_history->has_snapshot(m_active_snapshot_time));
 	object_history->restore_optional();
-	return object_history->shared_ptr(*this);
+	bool 						was_serialized = object_history->is_serialized();
+	std::shared_ptr<const T> 	object 		   = object_history->shared_ptr(*this);
+	if (was_serialized && object)
+		// The object was deserialized into a new memory location, map it to its history.
+		m_shared_ptr_to_object_id[(const void*)object.get()] = id;
+	return object;
 }
 
 template<typename T> void StackImpl::load_mutable_object(const Slic3r::ObjectID id, T &target)
@@ -906,7 +958,7 @@ template<typename T> void StackImpl::load_mutable_object(const Slic3r::ObjectID
 	assert(it_object_history != m_objects.end());
 	auto *object_history = static_cast<const MutableObjectHistory<T>*>(it_object_history->second.get());
 	// Then get the data associated with the object history and m_active_snapshot_time.
-	std::istringstream iss(object_history->load(m_active_snapshot_time));
+	std::istringstream iss(object_history->load(m_chunk_store, m_active_snapshot_time, m_current_time));
 	Slic3r::UndoRedo::InputArchive archive(*this, iss);
 	target.m_id = id;
 	archive(target);
@@ -1206,6 +1258,18 @@ void StackImpl::release_least_recently_used()
 		else
 			current_memsize = 0;
 	}
+	// Then serialize the meshes referenced by the Undo / Redo stack only and compress the snapshot data
+	// not accessed by the last snapshot taken or loaded, before releasing the least recently used snapshots.
+	if (current_memsize > m_memory_limit) {
+		for (auto &kvp : m_objects) {
+			const void *ptr = kvp.second->immutable_object_ptr();
+			if (kvp.second->serialize_unshared(*this))
+				// The immutable object was released, its memory may be reused by another object.
+				m_shared_ptr_to_object_id.erase(ptr);
+		}
+		m_chunk_store.compress_cold(m_current_time > 0 ? m_current_time - 1 : 0);
+		current_memsize = this->memsize();
+	}
 	while (current_memsize > m_memory_limit && m_snapshots.size() >= 3) {
 		// From which side to remove a snapshot?
 		assert(m_snapshots.front().timestamp < m_active_snapshot_time);
@@ -2,6 +2,7 @@
 
 #include "libslic3r/GCodeReader.hpp"
 #include "libslic3r/Layer.hpp"
+#include "libslic3r/Support/TreeModelVolumes.hpp"
 
 #include "test_data.hpp" // get access to init_print, etc
 
@@ -119,6 +120,40 @@ SCENARIO("SupportMaterial: support_layers_z and contact_distance", "[SupportMate
     }
 }
 
+TEST_CASE("SupportMaterial: tree support caches are reused by the next regeneration", "[SupportMaterial]")
+{
+    // Box h = 20mm, hole bottom at 5mm, the top of the hole is supported by a tree.
+    TriangleMesh mesh = Slic3r::Test::mesh(Slic3r::Test::TestMesh::cube_with_hole);
+    mesh.rotate_x(float(M_PI / 2));
+
+    DynamicPrintConfig config = DynamicPrintConfig::full_print_config();
+    config.set_deserialize_strict({
+        { "enable_support",                 1 },
+        { "support_type",                   "tree(auto)" },
+        { "support_style",                  "tree_organic" },
+        { "support_base_pattern_spacing",   2.5 }
+    });
+    Slic3r::Print print;
+    Slic3r::Model model;
+    Slic3r::Test::init_print({ mesh }, print, model, config);
+    print.process();
+
+    const PrintObject &object = *print.objects().front();
+    std::shared_ptr<TreeSupport3D::TreeModelVolumes> volumes = object.tree_support_model_volumes();
+    REQUIRE(volumes);
+    const size_t calculated_first = volumes->calculated_areas();
+    REQUIRE(calculated_first > 0);
+
+    // Only the support step is invalidated by the base pattern spacing.
+    config.set("support_base_pattern_spacing", 3.5);
+    print.apply(model, config);
+    print.process();
+    REQUIRE(! object.support_layers().empty());
+    // The same caches were used, the layers calculated by the first run were not calculated again.
+    REQUIRE(object.tree_support_model_volumes() == volumes);
+    REQUIRE(volumes->calculated_areas() - calculated_first < calculated_first / 10);
+}
+
 #if 0
 // Test 8.
 TEST_CASE("SupportMaterial: forced support is generated", "[SupportMaterial]")
@@ -0,0 +1,124 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/ChunkStore.hpp"
+#include "libslic3r/TriangleMesh.hpp"
+
+#include <cstring>
+#include <random>
+#include <sstream>
+
+#include <cereal/archives/binary.hpp>
+#include <cereal/types/vector.hpp>
+
+using namespace Slic3r;
+
+// Resembles the serialized painting of a triangle mesh: pairs of increasing triangle IDs and small values.
+static std::string make_blob(size_t num_pairs, unsigned int seed)
+{
+    std::mt19937                       rng(seed);
+    std::uniform_int_distribution<int> step(1, 4);
+    std::uniform_int_distribution<int> value(0, 3);
+    std::string                        out(num_pairs * 2 * sizeof(int), 0);
+    int                                triangle_id = 0;
+    for (size_t i = 0; i < num_pairs; ++ i) {
+        int pair[2] = { triangle_id += step(rng), value(rng) };
+        memcpy(out.data() + i * sizeof(pair), pair, sizeof(pair));
+    }
+    return out;
+}
+
+TEST_CASE("Chunk store shares and compresses chunks", "[ChunkStore]") {
+    ChunkStore store;
+    std::string data = make_blob(200000, 1);
+
+    ChunkStore::Blob blob = store.store(data, 0);
+    REQUIRE(blob.valid());
+    REQUIRE(blob.size() == data.size());
+    REQUIRE(store.num_chunks() > 1);
+    REQUIRE(store.load(blob, 0) == data);
+    REQUIRE(store.equals(blob, data));
+
+    SECTION("Locally modified blob shares the unmodified chunks") {
+        std::string modified = data;
+        modified.insert(modified.size() / 2, make_blob(100, 2));
+        size_t           memsize_before = store.memsize();
+        ChunkStore::Blob blob_modified  = store.store(modified, 1);
+        REQUIRE(! store.equals(blob, modified));
+        REQUIRE(store.equals(blob_modified, modified));
+        REQUIRE(store.load(blob_modified, 1) == modified);
+        // Only the chunks around the modification are added.
+        REQUIRE(store.memsize() - memsize_before < data.size() / 4);
+
+        // Storing the same data again does not add any chunk, the chunks are accounted to both blobs.
+        size_t           num_chunks       = store.num_chunks();
+        size_t           memsize_modified = blob_modified.memsize();
+        ChunkStore::Blob blob_copy        = store.store(modified, 1);
+        REQUIRE(store.num_chunks() == num_chunks);
+        REQUIRE(blob_modified.memsize() < memsize_modified);
+        REQUIRE(blob_copy.memsize() == blob_modified.memsize());
+    }
+
+    SECTION("Cold chunks are compressed") {
+        ChunkStore::Blob blob_small = store.store("small blob", 1);
+        size_t           memsize    = store.memsize();
+        size_t           saved      = store.compress_cold(1);
+        REQUIRE(saved > 0);
+        REQUIRE(store.memsize() == memsize - saved);
+        REQUIRE(store.memsize() < data.size() / 2);
+        REQUIRE(store.num_compressed_chunks() > 0);
+        REQUIRE(store.load(blob, 2) == data);
+        REQUIRE(store.equals(blob, data));
+        REQUIRE(store.load(blob_small, 2) == "small blob");
+
+        // Storing the compressed chunks again decompresses them.
+        ChunkStore::Blob blob_again = store.store(data, 2);
+        REQUIRE(store.num_compressed_chunks() == 0);
+        REQUIRE(store.load(blob_again, 2) == data);
+    }
+
+    SECTION("Released blobs release their chunks") {
+        ChunkStore::Blob blob_empty = store.store(std::string(), 0);
+        REQUIRE(blob_empty.valid());
+        REQUIRE(store.load(blob_empty, 0).empty());
+        ChunkStore::Blob blob_moved = std::move(blob);
+        REQUIRE(! blob.valid());
+        blob_moved.reset();
+        REQUIRE(store.num_chunks() == 0);
+        REQUIRE(store.memsize() == 0);
+    }
+}
+
+// The Undo / Redo stack serializes the triangle meshes referenced by the stack only into its chunk store
+// and deserializes them when undoing.
+TEST_CASE("Triangle mesh round trip through the Undo / Redo chunk store", "[ChunkStore]") {
+    TriangleMesh mesh = make_sphere(10., PI / 32.);
+    for (size_t i = 0; i < mesh.its.indices.size(); i += 3)
+        mesh.its.get_property(int(i)) = FaceProperty{ eExteriorAppearance, double(i) };
+
+    ChunkStore         store;
+    ChunkStore::Blob   blob;
+    {
+        std::ostringstream oss;
+        {
+            cereal::BinaryOutputArchive archive(oss);
+            archive(mesh);
+        }
+        blob = store.store(oss.str(), 0);
+    }
+    store.compress_cold(1);
+
+    TriangleMesh loaded;
+    {
+        std::istringstream iss(store.load(blob, 1));
+        cereal::BinaryInputArchive archive(iss);
+        archive(loaded);
+    }
+    REQUIRE(loaded.its.indices == mesh.its.indices);
+    REQUIRE(loaded.its.vertices == mesh.its.vertices);
+    REQUIRE(loaded.facets_count() == mesh.facets_count());
+    REQUIRE(loaded.its.properties.size() == mesh.its.properties.size());
+    for (size_t i = 0; i < mesh.its.properties.size(); ++ i) {
+        REQUIRE(loaded.its.properties[i].type == mesh.its.properties[i].type);
+        REQUIRE(loaded.its.properties[i].area == mesh.its.properties[i].area);
+    }
+}
@@ -7,6 +7,10 @@
 #include "libslic3r/ClipperUtils.hpp"
 #include "libslic3r/ExPolygon.hpp"
 #include "libslic3r/SVG.hpp"
+#include "libslic3r/MTUtils.hpp"
+#include "libslic3r/TriangleMesh.hpp"
+#include "libslic3r/TriangleMeshSlicer.hpp"
+#include "libslic3r/Format/OBJ.hpp"
 
 using namespace Slic3r;
 
@@ -299,3 +303,160 @@ TEST_CASE("Traversing Clipper PolyTree", "[ClipperUtils]") {
         REQUIRE(count_polys(output) == reference.size());
     }
 }
+
+TEST_CASE("Clipper2 backend matches ClipperLib", "[ClipperUtils]") {
+    Slic3r::Polygon   square{ { 200, 100 }, { 200, 200 }, { 100, 200 }, { 100, 100 } };
+    Slic3r::Polygon   hole_in_square{ { 160, 140 }, { 140, 140 }, { 140, 160 }, { 160, 160 } };
+    Slic3r::ExPolygon square_with_hole(square, hole_in_square);
+    Slic3r::Polygon   square2 = square;
+    square2.translate(50, 50);
+    Polylines         lines { Polyline{ { 0, 150 }, { 300, 150 } } };
+
+    auto run = [&](ClipperBackend backend) {
+        ClipperBackend old_backend = clipper_backend();
+        set_clipper_backend(backend);
+        std::vector<double> out {
+            area(offset(square_with_hole, 5.f)),
+            area(offset_ex(ExPolygons{ square_with_hole }, 5.f)),
+            area(offset_ex(ExPolygons{ square_with_hole }, -5.f)),
+            area(offset2_ex({ square_with_hole }, 5.f, -2.f)),
+            area(diff_ex(ExPolygons{ square_with_hole }, Polygons{ square2 })),
+            area(intersection_ex(ExPolygons{ square_with_hole }, Polygons{ square2 })),
+            area(union_ex(Polygons{ square, square2 })),
+            area(opening(Polygons{ square }, 10.f)),
+            area(closing_ex(Polygons{ square, square2 }, 10.f)),
+            total_length(intersection_pl(lines, ExPolygons{ square_with_hole })),
+            total_length(diff_pl(lines, ExPolygons{ square_with_hole }))
+        };
+        set_clipper_backend(old_backend);
+        return out;
+    };
+
+    std::vector<double> clipperlib = run(ClipperBackend::ClipperLib);
+    std::vector<double> clipper2   = run(ClipperBackend::Clipper2);
+    REQUIRE(clipperlib.size() == clipper2.size());
+    for (size_t i = 0; i < clipperlib.size(); ++ i)
+        REQUIRE(clipper2[i] == Approx(clipperlib[i]));
+}
+
+TEST_CASE("Clipper2 backend matches ClipperLib on sliced layers", "[ClipperUtils]") {
+    std::vector<ExPolygons> layers;
+    for (const char *model : { "extruder_idler.obj", "frog_legs.obj", "cube_with_concave_hole.obj", "ipadstand.obj" }) {
+        TriangleMesh mesh;
+        ObjInfo      obj_info;
+        std::string  message;
+        REQUIRE(load_obj((std::string(TEST_DATA_DIR) + "/" + model).c_str(), &mesh, obj_info, message));
+        BoundingBoxf3 bb = mesh.bounding_box();
+        append(layers, slice_mesh_ex(mesh.its, grid(float(bb.min.z()) + 0.1f, float(bb.max.z()), float(bb.size().z() / 10.))));
+    }
+
+    // Offsets of the perimeter generator and of the infill: Half an extrusion width, miter and round joins.
+    auto run = [&layers](ClipperBackend backend) {
+        ClipperBackend old_backend = clipper_backend();
+        set_clipper_backend(backend);
+        std::vector<ExPolygons> out;
+        for (const ExPolygons &layer : layers) {
+            out.emplace_back(offset_ex(layer, - float(scale_(0.225)), ClipperLib::jtMiter, 3.));
+            out.emplace_back(offset_ex(layer, float(scale_(0.225)), ClipperLib::jtMiter, 3.));
+            out.emplace_back(offset_ex(layer, - float(scale_(0.45)), ClipperLib::jtRound, scale_(0.01)));
+            out.emplace_back(offset2_ex(layer, - float(scale_(0.6)), float(scale_(0.4))));
+            out.emplace_back(union_ex(offset(layer, float(scale_(0.1)))));
+        }
+        set_clipper_backend(old_backend);
+        return out;
+    };
+
+    std::vector<ExPolygons> clipperlib = run(ClipperBackend::ClipperLib);
+    std::vector<ExPolygons> clipper2   = run(ClipperBackend::Clipper2);
+    REQUIRE(clipperlib.size() == clipper2.size());
+    size_t points_clipperlib = 0;
+    size_t points_clipper2   = 0;
+    for (size_t i = 0; i < clipperlib.size(); ++ i) {
+        REQUIRE(clipper2[i].size() == clipperlib[i].size());
+        REQUIRE(area(clipper2[i]) == Approx(area(clipperlib[i])).epsilon(0.001));
+        points_clipperlib += count_points(clipperlib[i]);
+        points_clipper2   += count_points(clipper2[i]);
+    }
+    // The joins of the two backends differ, the number of points of a single layer may differ by tens of percent.
+    REQUIRE(double(points_clipper2) == Approx(double(points_clipperlib)).epsilon(0.05));
+}
+
+TEST_CASE("Clipper buffers reused between calls", "[ClipperUtils]") {
+    Slic3r::Polygon   square{ { 200, 100 }, { 200, 200 }, { 100, 200 }, { 100, 100 } };
+    Slic3r::Polygon   hole_in_square{ { 160, 140 }, { 140, 140 }, { 140, 160 }, { 160, 160 } };
+    Slic3r::ExPolygon square_with_hole(square, hole_in_square);
+    Slic3r::Polygon   square2 = square;
+    square2.translate(50, 50);
+
+    // A negative offset sets the reversed solution flag of the reused Clipper, which must not leak into the following calls.
+    auto run = [&]() {
+        return std::vector<double> {
+            area(offset_ex(square_with_hole, -5.f)),
+            area(diff_ex(square_with_hole, Polygons{ square2 }, ApplySafetyOffset::Yes)),
+            area(offset(Polygons{ square, square2 }, -3.f)),
+            area(union_ex(Polygons{ square, square2 }))
+        };
+    };
+    std::vector<double> first = run();
+    std::vector<double> second = run();
+    REQUIRE(first == second);
+    REQUIRE(area(offset2_ex(square_with_hole, 5.f, -2.f)) == Approx(area(offset2_ex(ExPolygons{ square_with_hole }, 5.f, -2.f))));
+}
+
+SCENARIO("Index accelerated boolean operations", "[ClipperUtils]") {
+    Slic3r::Polygon   square{ { 200, 100 }, { 200, 200 }, { 100, 200 }, { 100, 100 } };
+    Slic3r::Polygon   hole_in_square{ { 160, 140 }, { 140, 140 }, { 140, 160 }, { 160, 160 } };
+    Slic3r::ExPolygon square_with_hole(square, hole_in_square);
+    Slic3r::Polygon   square2 = square;
+    square2.translate(50, 50);
+    // Clipping polygons covering a whole "layer", most of them far from the subject,
+    // one of them 5 units right of the subject, touched by the safety offset only.
+    Polygons clip { square2 };
+    for (coord_t i = 0; i < 20; ++ i)
+        for (coord_t j = 0; j < 20; ++ j) {
+            Slic3r::Polygon p = hole_in_square;
+            p.reverse();
+            p.translate(1000 + 100 * i, 1000 + 100 * j);
+            clip.emplace_back(std::move(p));
+        }
+    clip.push_back({ { 205, 120 }, { 230, 120 }, { 230, 180 }, { 205, 180 } });
+    ExPolygons clip_ex = union_ex(clip);
+    // Many subject islands to exercise the AABB tree.
+    ExPolygons subject_many;
+    for (coord_t i = 0; i < 20; ++ i) {
+        subject_many.push_back(square_with_hole);
+        subject_many.back().translate(1000 + 100 * i, 1000);
+    }
+    Polylines lines { Polyline{ { 0, 150 }, { 300, 150 } }, Polyline{ { 1000, 1000 }, { 3000, 3000 } } };
+
+    auto same_area = [](const auto &a, const auto &b) { return a.size() == b.size() && area(a) == Approx(area(b)); };
+    const ApplySafetyOffset safety_offsets[] = { ApplySafetyOffset::No, ApplySafetyOffset::Yes };
+    THEN("diff matches") {
+        for (ApplySafetyOffset safety_offset : safety_offsets) {
+            REQUIRE(same_area(diff_indexed(to_polygons(square_with_hole), clip, safety_offset), diff(to_polygons(square_with_hole), clip, safety_offset)));
+            REQUIRE(same_area(diff_ex_indexed(square_with_hole, clip, safety_offset), diff_ex(square_with_hole, clip, safety_offset)));
+            REQUIRE(same_area(diff_ex_indexed(square_with_hole, clip_ex, safety_offset), diff_ex(square_with_hole, clip_ex, safety_offset)));
+            REQUIRE(same_area(diff_ex_indexed(subject_many, clip, safety_offset), diff_ex(subject_many, clip, safety_offset)));
+            REQUIRE(same_area(diff_ex_indexed(subject_many, clip_ex, safety_offset), diff_ex(subject_many, clip_ex, safety_offset)));
+        }
+    }
+    THEN("intersection matches") {
+        for (ApplySafetyOffset safety_offset : safety_offsets) {
+            REQUIRE(same_area(intersection_indexed(to_polygons(square_with_hole), clip, safety_offset), intersection(to_polygons(square_with_hole), clip, safety_offset)));
+            REQUIRE(same_area(intersection_ex_indexed(square_with_hole, clip, safety_offset), intersection_ex(square_with_hole, clip, safety_offset)));
+            REQUIRE(same_area(intersection_ex_indexed(square_with_hole, clip_ex, safety_offset), intersection_ex(square_with_hole, clip_ex, safety_offset)));
+            REQUIRE(same_area(intersection_ex_indexed(subject_many, clip, safety_offset), intersection_ex(subject_many, clip, safety_offset)));
+            REQUIRE(same_area(intersection_ex_indexed(subject_many, clip_ex, safety_offset), intersection_ex(subject_many, clip_ex, safety_offset)));
+        }
+    }
+    THEN("polylines match") {
+        REQUIRE(total_length(diff_pl_indexed(lines, clip)) == Approx(total_length(diff_pl(lines, clip))));
+        REQUIRE(total_length(diff_pl_indexed(lines, clip_ex)) == Approx(total_length(diff_pl(lines, clip_ex))));
+        REQUIRE(total_length(intersection_pl_indexed(lines, clip)) == Approx(total_length(intersection_pl(lines, clip))));
+        REQUIRE(total_length(intersection_pl_indexed(lines, clip_ex)) == Approx(total_length(intersection_pl(lines, clip_ex))));
+    }
+    THEN("empty subject") {
+        REQUIRE(diff_ex_indexed(ExPolygons(), clip).empty());
+        REQUIRE(intersection_ex_indexed(ExPolygons(), clip).empty());
+    }
+}
@@ -332,6 +332,19 @@ SCENARIO("Path chaining", "[Geometry]") {
 			}
 			REQUIRE(connection_length < 85206000.);
 		}
+		THEN("Refining by 2-opt keeps all the polylines and does not make the path longer") {
+			auto connection_length = [](const Polylines &chained) {
+				double length = 0.;
+				for (size_t i = 1; i < chained.size(); ++i)
+					length += (chained[i].first_point() - chained[i - 1].last_point()).cast<double>().norm();
+				return length;
+			};
+			ChainingParams params;
+			params.refinement = ChainingParams::Refinement::TwoOpt;
+			Polylines refined = chain_polylines(polylines, nullptr, params);
+			REQUIRE(refined.size() == polylines.size());
+			REQUIRE(connection_length(refined) <= connection_length(chained) + EPSILON);
+		}
 	}
 	GIVEN("Loop pieces") {
 		Point a { 2185796, 19058485 };
@@ -19,3 +19,31 @@ TEST_CASE("Hollow two overlapping spheres") {
     sphere1.WriteOBJFile("twospheres.obj");
 }
 
+
+TEST_CASE("Tiled hollowing matches hollowing with a single grid") {
+    using namespace Slic3r;
+
+    TriangleMesh sphere = make_sphere(20., 2 * PI / 40.);
+
+    sla::HollowingConfig cfg;
+    sla::InteriorPtr interior = sla::generate_interior(sphere, cfg);
+    REQUIRE(interior);
+
+    cfg.tile_size = 15.;
+    sla::InteriorPtr interior_tiled = sla::generate_interior(sphere, cfg);
+    REQUIRE(interior_tiled);
+
+    const indexed_triangle_set &its       = sla::get_mesh(*interior);
+    const indexed_triangle_set &its_tiled = sla::get_mesh(*interior_tiled);
+    REQUIRE(! its_tiled.empty());
+    REQUIRE(std::abs(its_volume(its_tiled) - its_volume(its)) < 0.01 * std::abs(its_volume(its)));
+
+    // The grids of the tiles are merged into a grid of the whole interior, which measures the distances
+    // of the triangles to be removed inside the cavity.
+    for (float t = -19.f; t <= 19.f; t += 0.5f)
+        for (const Vec3f &p : { Vec3f(t, 0.f, 0.f), Vec3f(t, t, t) / std::sqrt(3.f), Vec3f(1.f, t, 0.5f * t) }) {
+            double d       = sla::get_distance(p, *interior);
+            double d_tiled = sla::get_distance(p, *interior_tiled);
+            REQUIRE(std::abs(d_tiled - d) < 0.2);
+        }
+}
@@ -1,6 +1,7 @@
 #include <iostream>
 #include <fstream>
 #include <catch2/catch.hpp>
+#include <tbb/task_arena.h>
 
 #include "libslic3r/TriangleMesh.hpp"
 
@@ -301,6 +302,56 @@ TEST_CASE("Simplify trouble case", "[its]")
     CHECK(!exist_triangle_with_twice_vertices(tm.its.indices));
 }
 
+TEST_CASE("Simplify large mesh by partitions in parallel", "[its]")
+{
+    // Above the triangle count simplified by partitions.
+    indexed_triangle_set its = its_make_sphere(1., 2. * PI / 800.);
+    REQUIRE(its.indices.size() > 500000);
+    double   original_volume = its_volume(its);
+    uint32_t wanted_count    = its.indices.size() / 50;
+    // The result does not depend on the number of threads.
+    indexed_triangle_set its_single_thread = its;
+    tbb::task_arena arena(4);
+    arena.execute([&its, wanted_count]() { its_quadric_edge_collapse(its, wanted_count); });
+    tbb::task_arena arena_single_thread(1);
+    arena_single_thread.execute([&its_single_thread, wanted_count]() { its_quadric_edge_collapse(its_single_thread, wanted_count); });
+    CHECK(its.indices == its_single_thread.indices);
+    CHECK(its.vertices == its_single_thread.vertices);
+    CHECK(its.indices.size() <= wanted_count);
+    CHECK(its_volume(its) == Approx(original_volume).epsilon(0.01));
+    CHECK(!exist_triangle_with_twice_vertices(its.indices));
+    // The partitions are stitched back into a single closed mesh.
+    CHECK(its_num_open_edges(its) == 0);
+    CHECK(its_number_of_patches(its) == 1);
+
+    // The seams of the partitions are simplified by the final pass, they do not stay dense. The area of a sphere
+    // between two parallel planes only depends on their distance, thus slabs of the same thickness get about
+    // the same number of triangles.
+    const int num_slabs = 100;
+    for (int axis = 0; axis < 3; ++ axis) {
+        std::vector<size_t> slab_triangles(num_slabs, 0);
+        for (const Vec3i &t : its.indices) {
+            float center = (its.vertices[t[0]][axis] + its.vertices[t[1]][axis] + its.vertices[t[2]][axis]) / 3.f;
+            ++ slab_triangles[std::clamp(int((center + 1.f) * 0.5f * num_slabs), 0, num_slabs - 1)];
+        }
+        CHECK(*std::max_element(slab_triangles.begin(), slab_triangles.end()) < 3 * its.indices.size() / num_slabs);
+    }
+
+    // The distance from the sphere is comparable to the simplification of the whole mesh by a single thread.
+    indexed_triangle_set its_serial = its_make_sphere(1., 2. * PI / 800.);
+    its_quadric_edge_collapse(its_serial, wanted_count, nullptr, nullptr, nullptr, false);
+    CHECK(its_serial.indices.size() <= wanted_count);
+    auto max_distance_from_sphere = [](const indexed_triangle_set &its) {
+        double out = 0.;
+        for (const Vec3f &v : its.vertices)
+            out = std::max(out, std::abs(v.cast<double>().norm() - 1.));
+        for (const Vec3i &t : its.indices)
+            out = std::max(out, std::abs(((its.vertices[t[0]] + its.vertices[t[1]] + its.vertices[t[2]]).cast<double>() / 3.).norm() - 1.));
+        return out;
+    };
+    CHECK(max_distance_from_sphere(its) < 1.5 * max_distance_from_sphere(its_serial));
+}
+
 TEST_CASE("Simplified cube should not be empty.", "[its]")
 {
     auto its = its_make_cube(1, 2, 3);
@@ -309,3 +360,17 @@ TEST_CASE("Simplified cube should not be empty.", "[its]")
     its_quadric_edge_collapse(its, wanted_count, &max_error);
     CHECK(!its.indices.empty());
 }
+
+TEST_CASE("Flat shading interleaves face normals with unshared vertices", "[its]")
+{
+    const indexed_triangle_set cube = its_make_cube(1., 2., 3.);
+    std::vector<float>         data { 1.f, 2.f };
+    its_flat_shading_interleaved(cube, data);
+    REQUIRE(data.size() == 2 + cube.indices.size() * 3 * 6);
+    for (size_t i = 0; i < cube.indices.size(); ++ i)
+        for (int j = 0; j < 3; ++ j) {
+            const float *vertex = data.data() + 2 + (i * 3 + j) * 6;
+            CHECK(Vec3f(vertex).isApprox(its_face_normal(cube, int(i))));
+            CHECK(Vec3f(vertex + 3) == cube.vertices[cube.indices[i][j]]);
+        }
+}
@@ -1,8 +1,10 @@
 #include <catch2/catch.hpp>
 #include <test_utils.hpp>
 
+#include <libslic3r/Exception.hpp>
 #include <libslic3r/TriangleMesh.hpp>
 #include <libslic3r/MeshBoolean.hpp>
+#include <libslic3r/CSGMesh/SliceCSGMesh.hpp>
 
 using namespace Slic3r;
 
@@ -23,3 +25,83 @@ TEST_CASE("CGAL and TriangleMesh conversions", "[MeshBoolean]") {
     
     REQUIRE(! MeshBoolean::cgal::does_self_intersect(M));
 }
+
+TEST_CASE("Booleans of meshes with multiple parts", "[MeshBoolean]") {
+    // Two cubes far apart and a cube overlapping the first one only.
+    TriangleMesh A = make_cube(10., 10., 10.);
+    TriangleMesh A2 = make_cube(10., 10., 10.);
+    A2.translate(100.f, 0.f, 0.f);
+    A.merge(A2);
+    TriangleMesh B = make_cube(10., 10., 10.);
+    B.translate(5.f, 0.f, 0.f);
+
+    SECTION("Difference keeps the part not touched by the tool") {
+        MeshBoolean::cgal::minus(A, B);
+        REQUIRE(A.volume() == Approx(500. + 1000.));
+        REQUIRE(A.its.indices.size() > 0);
+    }
+    SECTION("Union merges the overlapping parts only") {
+        MeshBoolean::cgal::plus(A, B);
+        REQUIRE(A.volume() == Approx(1500. + 1000.));
+    }
+    SECTION("Intersection drops the part not touched by the tool") {
+        MeshBoolean::cgal::intersect(A, B);
+        REQUIRE(A.volume() == Approx(500.));
+    }
+    SECTION("Tool not overlapping the mesh") {
+        TriangleMesh C = make_cube(10., 10., 10.);
+        C.translate(0.f, 100.f, 0.f);
+        TriangleMesh D = A;
+        MeshBoolean::cgal::minus(D, C);
+        REQUIRE(D.its.indices.size() == A.its.indices.size());
+        D = A;
+        MeshBoolean::cgal::intersect(D, C);
+        REQUIRE(D.empty());
+    }
+    SECTION("Self intersecting tool not overlapping the mesh is refused") {
+        // Two overlapping cubes stored in a single mesh intersect each other.
+        TriangleMesh C = make_cube(10., 10., 10.);
+        TriangleMesh C2 = make_cube(10., 10., 10.);
+        C2.translate(5.f, 5.f, 5.f);
+        C.merge(C2);
+        C.translate(0.f, 100.f, 0.f);
+        REQUIRE(MeshBoolean::cgal::does_self_intersect(C));
+        REQUIRE_THROWS_AS(MeshBoolean::cgal::minus(A, C), Slic3r::RuntimeError);
+        REQUIRE_THROWS_AS(MeshBoolean::cgal::plus(A, C), Slic3r::RuntimeError);
+    }
+}
+
+TEST_CASE("Slice based CSG evaluation", "[MeshBoolean]") {
+    indexed_triangle_set cube = its_make_cube(10., 10., 10.);
+    std::vector<float> slicegrid;
+    for (float z = 0.5f; z < 30.f; z += 1.f)
+        slicegrid.emplace_back(z);
+
+    std::vector<csg::CSGPart> parts;
+    parts.emplace_back(&cube, csg::CSGType::Union);
+    // Removes half of the cube.
+    parts.emplace_back(&cube, csg::CSGType::Difference, Transform3f(Eigen::Translation3f(5.f, 0.f, 0.f)));
+    // Outside of the slicing grid, not sliced at all.
+    parts.emplace_back(&cube, csg::CSGType::Difference, Transform3f(Eigen::Translation3f(0.f, 0.f, 100.f)));
+    // A second cube above the first one.
+    parts.emplace_back(&cube, csg::CSGType::Union, Transform3f(Eigen::Translation3f(0.f, 0.f, 15.f)));
+
+    SECTION("Union and difference") {
+        std::vector<ExPolygons> slices = csg::slice_csgmesh_ex(Range{ parts.begin(), parts.end() }, slicegrid, MeshSlicingParamsEx{});
+        REQUIRE(slices.size() == slicegrid.size());
+        for (size_t i = 0; i < slicegrid.size(); ++ i) {
+            double area = 0.;
+            for (const ExPolygon &expoly : slices[i])
+                area += expoly.area();
+            double expected = slicegrid[i] < 10.f ? 50. : slicegrid[i] > 15.f && slicegrid[i] < 25.f ? 100. : 0.;
+            REQUIRE(unscaled<double>(unscaled<double>(area)) == Approx(expected));
+        }
+    }
+
+    SECTION("Intersection clears the slices outside of the part") {
+        parts.emplace_back(&cube, csg::CSGType::Intersection, Transform3f(Eigen::Translation3f(0.f, 0.f, 12.f)));
+        std::vector<ExPolygons> slices = csg::slice_csgmesh_ex(Range{ parts.begin(), parts.end() }, slicegrid, MeshSlicingParamsEx{});
+        for (size_t i = 0; i < slicegrid.size(); ++ i)
+            REQUIRE(slices[i].empty() == ! (slicegrid[i] > 15.f && slicegrid[i] < 22.f));
+    }
+}
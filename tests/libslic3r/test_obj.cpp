@@ -0,0 +1,95 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/Format/objparser.hpp"
+
+#include <fstream>
+#include <random>
+#include <sstream>
+
+#include <boost/filesystem/operations.hpp>
+
+// Generates an OBJ file large enough to be split into multiple chunks by objparse(path), with faces referencing
+// the vertices both by absolute and by relative indices, and with materials and groups spanning the chunk boundaries.
+static std::string make_large_obj(size_t num_blocks)
+{
+    std::mt19937                          rng(42);
+    std::uniform_real_distribution<float> coord(-100.f, 100.f);
+    std::ostringstream                    out;
+    out << "# region: eu\n# ml_name: test\n# ml_file_id: 42\n";
+    out << "mtllib test.mtl\n";
+    size_t num_vertices = 0;
+    for (size_t block = 0; block < num_blocks; ++ block) {
+        if (block % 7 == 0)
+            out << "o object" << block << "\n";
+        if (block % 3 == 0)
+            out << "g group" << block << "\r\n";
+        if (block % 5 == 0)
+            out << "usemtl material" << (block % 4) << "\n";
+        for (int i = 0; i < 8; ++ i)
+            out << "v " << coord(rng) << " " << coord(rng) << " " << coord(rng) << "\n";
+        for (int i = 0; i < 4; ++ i)
+            out << "vn 0 0 1\nvt 0.5 0.5\n";
+        num_vertices += 8;
+        // Triangles and quads with absolute indices.
+        out << "f " << num_vertices - 7 << " " << num_vertices - 6 << " " << num_vertices - 5 << "\n";
+        out << "f " << num_vertices - 7 << " " << num_vertices - 6 << " " << num_vertices - 5 << " " << num_vertices - 4 << "\r\n";
+        // Triangles and quads with relative indices.
+        out << "f -1/-1/-1 -2/-2/-2 -3/-3/-3\n";
+        out << "f -5//-1 -6//-2 -7//-3 -8//-4\n";
+        // Relative indices reaching back to the preceding blocks.
+        if (block > 0)
+            out << "f -9 -10 -11\n";
+    }
+    // Last line without a line end.
+    out << "f 1 2 3";
+    return out.str();
+}
+
+TEST_CASE("Parsing of an OBJ file in chunks", "[OBJ]") {
+    // Over 2 MB, so that the file is parsed in multiple chunks.
+    std::string obj = make_large_obj(20000);
+    REQUIRE(obj.size() > (2 << 20));
+
+    boost::filesystem::path path = boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("test_obj-%%%%-%%%%.obj");
+    {
+        std::ofstream file(path.string(), std::ios::binary);
+        file << obj;
+    }
+
+    ObjParser::ObjData data_file;
+    bool               ok_file = ObjParser::objparse(path.string().c_str(), data_file);
+    boost::filesystem::remove(path);
+
+    ObjParser::ObjData data_stream;
+    std::istringstream stream(obj);
+    bool               ok_stream = ObjParser::objparse(stream, data_stream);
+
+    REQUIRE(ok_file);
+    REQUIRE(ok_stream);
+    REQUIRE(data_file.vertices.size() > 0);
+    REQUIRE(ObjParser::objequal(data_file, data_stream));
+    REQUIRE(data_file.usemtls.size() == data_stream.usemtls.size());
+    for (size_t i = 0; i < data_file.usemtls.size(); ++ i) {
+        REQUIRE(data_file.usemtls[i].vertexIdxEnd == data_stream.usemtls[i].vertexIdxEnd);
+        REQUIRE(data_file.usemtls[i].face_start == data_stream.usemtls[i].face_start);
+        REQUIRE(data_file.usemtls[i].face_end == data_stream.usemtls[i].face_end);
+    }
+    REQUIRE(data_file.has_vertex_color == data_stream.has_vertex_color);
+    REQUIRE(data_file.ml_name == "test");
+    REQUIRE(data_file.ml_id == "42");
+}
+
+TEST_CASE("Parsing of the OBJ numbers", "[OBJ]") {
+    std::istringstream stream("v 1.5 -2e-1 +3\nv 0x1p3 -0x1.8p1 0X0p+0\nf 1 2 1\n");
+    ObjParser::ObjData data;
+    REQUIRE(ObjParser::objparse(stream, data));
+    // 7 coordinates per vertex: x, y, z and the vertex color.
+    REQUIRE(data.coordinates.size() == 2 * 7);
+    REQUIRE(data.coordinates[0] == 1.5f);
+    REQUIRE(data.coordinates[1] == -0.2f);
+    REQUIRE(data.coordinates[2] == 3.f);
+    // Hexadecimal floats, as accepted by strtod().
+    REQUIRE(data.coordinates[7] == 8.f);
+    REQUIRE(data.coordinates[8] == -3.f);
+    REQUIRE(data.coordinates[9] == 0.f);
+}
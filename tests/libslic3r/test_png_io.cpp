@@ -53,3 +53,26 @@ TEST_CASE("PNG read", "[PNG]") {
         REQUIRE(sum == rstsum);
     }
 }
+
+TEST_CASE("PNG encoded in parallel strips", "[PNG]") {
+    // Large enough to be split into several strips.
+    const size_t width = 1000, height = 700;
+    std::vector<uint8_t> pixels(width * height);
+    for (size_t r = 0; r < height; ++r)
+        for (size_t c = 0; c < width; ++c)
+            pixels[r * width + c] = uint8_t((r * 7 + c * 13) % 251);
+
+    for (png::Compression compression : { png::Compression::Fast, png::Compression::Default })
+        for (bool flip : { false, true }) {
+            std::vector<uint8_t> encoded = png::encode_png(pixels.data(), width, height, 1, compression, flip);
+            REQUIRE(png::is_png({encoded.data(), encoded.size()}));
+
+            png::ImageGreyscale img;
+            REQUIRE(png::decode_png({encoded.data(), encoded.size()}, img));
+            REQUIRE(img.rows == height);
+            REQUIRE(img.cols == width);
+            for (size_t r = 0; r < height; ++r)
+                REQUIRE(std::equal(img.buf.begin() + r * width, img.buf.begin() + (r + 1) * width,
+                                   pixels.begin() + (flip ? height - 1 - r : r) * width));
+        }
+}
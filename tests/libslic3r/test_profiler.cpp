@@ -0,0 +1,72 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/Profiler.hpp"
+
+#include <atomic>
+#include <thread>
+
+#include <tbb/parallel_for.h>
+
+using namespace Slic3r;
+
+static size_t count_occurrences(const std::string &str, const std::string &pattern)
+{
+    size_t cnt = 0;
+    for (size_t pos = str.find(pattern); pos != std::string::npos; pos = str.find(pattern, pos + pattern.size()))
+        ++ cnt;
+    return cnt;
+}
+
+TEST_CASE("Profiler records zones of all threads", "[Profiler]") {
+    // Tracing may have been enabled by the SLIC3R_TRACE_FILE environment variable.
+    Profiler::stop_tracing();
+    Profiler::clear();
+
+    SECTION("No zones are recorded unless tracing") {
+        REQUIRE(! Profiler::is_tracing());
+        {
+            SLIC3R_PROFILE_ZONE("test_zone_not_traced");
+        }
+        REQUIRE(count_occurrences(Profiler::chrome_trace(), "test_zone_not_traced") == 0);
+    }
+
+    SECTION("Nested zones in parallel tasks") {
+        Profiler::start_tracing();
+        REQUIRE(Profiler::is_tracing());
+        std::atomic<int> sum { 0 };
+        {
+            SLIC3R_PROFILE_ZONE_CAT("test_zone_outer", "test");
+            tbb::parallel_for(0, 100, [&sum](int i) {
+                SLIC3R_PROFILE_ZONE("test_zone_inner");
+                sum += i;
+            });
+        }
+        Profiler::stop_tracing();
+        REQUIRE(sum == 4950);
+
+        std::string trace = Profiler::chrome_trace();
+        REQUIRE(trace.front() == '{');
+        REQUIRE(count_occurrences(trace, "\"name\":\"test_zone_outer\",\"cat\":\"test\",\"ph\":\"X\"") == 1);
+        REQUIRE(count_occurrences(trace, "\"name\":\"test_zone_inner\"") == 100);
+        REQUIRE(count_occurrences(trace, "\"ph\":\"M\"") >= 1);
+
+        Profiler::clear();
+        REQUIRE(count_occurrences(Profiler::chrome_trace(), "test_zone_inner") == 0);
+    }
+
+    SECTION("Ring buffer keeps the last zones") {
+        Profiler::start_tracing(16);
+        std::thread thread([]() {
+            for (int i = 0; i < 100; ++ i) {
+                SLIC3R_PROFILE_ZONE("test_zone_ring");
+            }
+        });
+        thread.join();
+        Profiler::stop_tracing();
+        REQUIRE(count_occurrences(Profiler::chrome_trace(), "test_zone_ring") == 16);
+        Profiler::start_tracing();
+        Profiler::stop_tracing();
+    }
+
+    Profiler::clear();
+}
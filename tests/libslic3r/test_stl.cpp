@@ -2,6 +2,11 @@
 
 #include "libslic3r/Model.hpp"
 #include "libslic3r/Format/STL.hpp"
+#include "libslic3r/TriangleMesh.hpp"
+
+#include <array>
+#include <deque>
+#include <map>
 
 using namespace Slic3r;
 
@@ -55,3 +60,123 @@ SCENARIO("Reading an STL file", "[stl]") {
 		}
 	}
 }
+
+static stl_file stl_from_its(const indexed_triangle_set &its)
+{
+	stl_file stl;
+	for (const stl_triangle_vertex_indices &face : its.indices) {
+		stl_facet facet;
+		for (int i = 0; i < 3; ++ i)
+			facet.vertex[i] = its.vertices[face[i]];
+		facet.normal = stl_normal::Zero();
+		facet.extra[0] = facet.extra[1] = 0;
+		stl.facet_start.emplace_back(facet);
+	}
+	stl.stats.type = inmemory;
+	stl.stats.number_of_facets = stl.stats.original_num_facets = uint32_t(stl.facet_start.size());
+	stl.neighbors_start.assign(stl.facet_start.size(), stl_neighbors());
+	stl_get_size(&stl);
+	return stl;
+}
+
+static bool stl_neighbors_symmetric(const stl_file &stl)
+{
+	for (size_t i = 0; i < stl.facet_start.size(); ++ i)
+		for (int j = 0; j < 3; ++ j)
+			if (int neighbor = stl.neighbors_start[i].neighbor[j]; neighbor != -1) {
+				const stl_neighbors &other = stl.neighbors_start[neighbor];
+				if (std::count(other.neighbor, other.neighbor + 3, int(i)) == 0)
+					return false;
+			}
+	return true;
+}
+
+// Serial reference of the former admesh exact matching: an edge is paired with the first preceding unpaired equal edge
+// of another facet, edges are visited in the order of the facets.
+static std::vector<stl_neighbors> reference_exact_neighbors(const stl_file &stl)
+{
+	std::vector<stl_neighbors> out(stl.stats.number_of_facets, stl_neighbors());
+	// Sorted vertices of an edge. Floats compare negative zeros equal to positive zeros.
+	std::map<std::array<float, 6>, std::deque<std::pair<int, int>>> unpaired;
+	for (int i = 0; i < int(stl.stats.number_of_facets); ++ i)
+		for (int j = 0; j < 3; ++ j) {
+			stl_vertex a = stl.facet_start[i].vertex[j];
+			stl_vertex b = stl.facet_start[i].vertex[(j + 1) % 3];
+			int which_edge = j;
+			if (! std::lexicographical_compare(a.data(), a.data() + 3, b.data(), b.data() + 3)) {
+				std::swap(a, b);
+				which_edge += 3;
+			}
+			std::deque<std::pair<int, int>> &edges = unpaired[{ a.x(), a.y(), a.z(), b.x(), b.y(), b.z() }];
+			auto it = std::find_if(edges.begin(), edges.end(), [i](const std::pair<int, int> &edge) { return edge.first != i; });
+			if (it == edges.end()) {
+				edges.emplace_back(i, which_edge);
+				continue;
+			}
+			auto [other_facet, other_edge] = *it;
+			edges.erase(it);
+			out[i].neighbor[j] = other_facet;
+			out[i].which_vertex_not[j] = (other_edge + 2) % 3;
+			out[other_facet].neighbor[other_edge % 3] = i;
+			out[other_facet].which_vertex_not[other_edge % 3] = (which_edge + 2) % 3;
+			if ((which_edge < 3) == (other_edge < 3)) {
+				// Facets oriented in opposite directions.
+				out[i].which_vertex_not[j] += 3;
+				out[other_facet].which_vertex_not[other_edge % 3] += 3;
+			}
+		}
+	return out;
+}
+
+TEST_CASE("Exact matching of the facet edges", "[stl]") {
+	SECTION("Large closed mesh, matched in parallel") {
+		stl_file stl = stl_from_its(its_make_sphere(10., 0.01));
+		REQUIRE(stl.stats.number_of_facets > 100000);
+		stl_check_facets_exact(&stl);
+		REQUIRE(stl.stats.connected_facets_3_edge == int(stl.stats.number_of_facets));
+		REQUIRE(stl.stats.connected_edges == 3 * int(stl.stats.number_of_facets));
+		REQUIRE(stl_neighbors_symmetric(stl));
+	}
+	SECTION("Non-manifold edges are paired in the order of the facets") {
+		indexed_triangle_set cube = its_make_cube(10., 10., 10.);
+		// Duplicate the first facet, its copy is left unconnected as the edges of the original were paired already.
+		cube.indices.emplace_back(cube.indices.front());
+		stl_file stl = stl_from_its(cube);
+		stl_check_facets_exact(&stl);
+		REQUIRE(stl.stats.connected_facets_1_edge == 12);
+		REQUIRE(stl.stats.connected_facets_3_edge == 12);
+		REQUIRE(stl.neighbors_start.back().num_neighbors() == 0);
+		REQUIRE(stl_neighbors_symmetric(stl));
+	}
+	SECTION("Parallel matching pairs the same edges as the serial hash table") {
+		indexed_triangle_set sphere = its_make_sphere(10., 0.01);
+		const size_t num_faces = sphere.indices.size();
+		// Duplicated facets make non-manifold edges, some duplicates are flipped. Some facets are made degenerate
+		// to open holes, the degenerate facets are removed before matching.
+		for (size_t i = 0; i < num_faces; i += 7) {
+			stl_triangle_vertex_indices face = sphere.indices[i];
+			if (i % 13 == 0)
+				std::swap(face[1], face[2]);
+			sphere.indices.emplace_back(face);
+		}
+		int num_degenerate = 0;
+		for (size_t i = 0; i < num_faces; i += 101, ++ num_degenerate)
+			sphere.indices[i][1] = sphere.indices[i][0];
+		stl_file stl = stl_from_its(sphere);
+		stl_check_facets_exact(&stl);
+		REQUIRE(stl.stats.degenerate_facets == num_degenerate);
+		std::vector<stl_neighbors> reference = reference_exact_neighbors(stl);
+		int connected_edges = 0;
+		int num_different   = 0;
+		for (size_t i = 0; i < reference.size(); ++ i) {
+			for (int j = 0; j < 3; ++ j)
+				if (stl.neighbors_start[i].neighbor[j] != reference[i].neighbor[j] ||
+					stl.neighbors_start[i].which_vertex_not[j] != reference[i].which_vertex_not[j])
+					++ num_different;
+			connected_edges += reference[i].num_neighbors();
+		}
+		REQUIRE(num_different == 0);
+		REQUIRE(stl.stats.connected_edges == connected_edges);
+		REQUIRE(stl.stats.connected_edges < 3 * int(stl.stats.number_of_facets));
+	}
+}
@@ -0,0 +1,144 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/GCode/ToolpathGeometry.hpp"
+
+#include <numeric>
+
+using namespace Slic3r;
+
+using MoveVertex = GCodeProcessorResult::MoveVertex;
+
+static void add_move(GCodeProcessorResult &result, EMoveType type, const Vec3f &position)
+{
+    MoveVertex move;
+    move.type           = type;
+    move.extrusion_role = erExternalPerimeter;
+    move.position       = position;
+    if (type == EMoveType::Extrude) {
+        move.width  = 0.45f;
+        move.height = 0.2f;
+    }
+    result.moves.emplace_back(move);
+}
+
+// Square loops of 10 mm, one per layer. The travel to the first corner of a loop is lifted by a z hop.
+static void make_square_loops(GCodeProcessorResult &result, size_t num_layers)
+{
+    add_move(result, EMoveType::Noop, Vec3f::Zero());
+    for (size_t layer = 0; layer < num_layers; ++ layer) {
+        const float z = 0.2f * float(layer + 1);
+        add_move(result, EMoveType::Travel,  { 5.f,  5.f,  z + 0.4f });
+        add_move(result, EMoveType::Travel,  { 0.f,  0.f,  z });
+        add_move(result, EMoveType::Extrude, { 10.f, 0.f,  z });
+        add_move(result, EMoveType::Extrude, { 10.f, 10.f, z });
+        add_move(result, EMoveType::Extrude, { 0.f,  10.f, z });
+        add_move(result, EMoveType::Extrude, { 0.f,  0.f,  z });
+    }
+}
+
+static std::vector<size_t> identity_sids(const GCodeProcessorResult &result)
+{
+    std::vector<size_t> out(result.moves.size());
+    std::iota(out.begin(), out.end(), 0);
+    return out;
+}
+
+TEST_CASE("Toolpath layers", "[GCode]") {
+    GCodeProcessorResult result;
+    make_square_loops(result, 10);
+
+    SECTION("Travels lifted by a z hop stay in their layer") {
+        std::vector<ToolpathLayer> layers = toolpath_layers(result);
+        REQUIRE(layers.size() == 10);
+        for (size_t i = 0; i < layers.size(); ++ i) {
+            REQUIRE(layers[i].z == Approx(0.2 * double(i + 1)));
+            // The layer starts with the travel down from the z hop and ends with the travels to the next layer.
+            REQUIRE(layers[i].first_sid == 2 + 6 * i);
+            REQUIRE(layers[i].last_sid == (i + 1 < layers.size() ? 8 + 6 * i : 6 + 6 * i));
+        }
+    }
+
+    SECTION("Seams are not counted by the sequential ids") {
+        MoveVertex seam;
+        seam.type     = EMoveType::Seam;
+        seam.position = result.moves[4].position;
+        result.moves.insert(result.moves.begin() + 4, seam);
+        std::vector<ToolpathLayer> layers = toolpath_layers(result);
+        REQUIRE(layers.size() == 10);
+        REQUIRE(layers[1].first_sid == 8);
+    }
+
+    SECTION("Spiral vase layers are taken from the G-code processor") {
+        GCodeProcessorResult vase;
+        add_move(vase, EMoveType::Noop, Vec3f::Zero());
+        add_move(vase, EMoveType::Travel, { 0.f, 0.f, 0.2f });
+        // The height rises with every extrusion.
+        for (size_t i = 1; i <= 40; ++ i)
+            add_move(vase, EMoveType::Extrude, { (i % 4 == 1 || i % 4 == 2) ? 10.f : 0.f, (i % 4 == 2 || i % 4 == 3) ? 10.f : 0.f, 0.2f + 0.05f * float(i) });
+        REQUIRE(toolpath_layers(vase).size() == 40);
+        for (size_t i = 0; i < 10; ++ i)
+            vase.spiral_vase_layers.push_back({ 0.4f + 0.2f * float(i), { i == 0 ? 1 : 2 + 4 * i, 1 + 4 * (i + 1) } });
+        std::vector<ToolpathLayer> layers = toolpath_layers(vase);
+        REQUIRE(layers.size() == 10);
+        REQUIRE(layers.front().first_sid == 1);
+        REQUIRE(layers.back().last_sid == 41);
+    }
+}
+
+TEST_CASE("Toolpath layer geometry", "[GCode]") {
+    GCodeProcessorResult result;
+    make_square_loops(result, 3);
+    // An arc interpolated by three points, a wipe and a seam at the end of the last layer.
+    MoveVertex arc = result.moves.back();
+    arc.position             = { 10.f, 0.f, 0.6f };
+    arc.move_path_type       = EMovePathType::Arc_move_ccw;
+    arc.interpolation_points = { { 3.f, -2.f, 0.6f }, { 5.f, -3.f, 0.6f }, { 7.f, -2.f, 0.6f } };
+    result.moves.emplace_back(arc);
+    add_move(result, EMoveType::Wipe, { 8.f, 0.f, 0.6f });
+    add_move(result, EMoveType::Seam, { 8.f, 0.f, 0.6f });
+
+    std::vector<size_t>              sid_to_move_id = identity_sids(result);
+    std::vector<std::vector<size_t>> sid_to_seam_move_ids(result.moves.size());
+    // The seam is attached to the move preceding it, it has no sequential id of its own.
+    sid_to_move_id.pop_back();
+    sid_to_seam_move_ids[sid_to_move_id.size() - 1].emplace_back(result.moves.size() - 1);
+
+    std::vector<ToolpathLayer> layers = toolpath_layers(result);
+    REQUIRE(layers.size() == 3);
+    layers.back().last_sid = sid_to_move_id.size() - 1;
+
+    SECTION("A vertex per move, a position per arc point") {
+        ToolpathLayerGeometry geometry = build_toolpath_layer_geometry(result, layers.back(), sid_to_move_id, sid_to_seam_move_ids);
+        // Travel, 4 extrusions, the arc, the wipe and the seam.
+        REQUIRE(geometry.vertices.size() == 8);
+        REQUIRE(geometry.positions.size() == 8 + 3);
+        // A segment ends at each move but the first one, the seam is a single point.
+        REQUIRE(geometry.segments.size() == 7);
+        const ToolpathSegment &seam = geometry.segments.back();
+        REQUIRE(seam.type == EMoveType::Seam);
+        REQUIRE(seam.first_vertex == seam.second_vertex);
+        const ToolpathVertex &arc_vertex = geometry.vertices[5];
+        REQUIRE(arc_vertex.positions.size() == 4);
+        REQUIRE(geometry.positions[arc_vertex.positions.front()].position == Vec3f(3.f, -2.f, 0.6f));
+        REQUIRE(geometry.positions[arc_vertex.positions.back()].position == Vec3f(10.f, 0.f, 0.6f));
+        for (const ToolpathPosition &position : geometry.positions)
+            REQUIRE(geometry.vertices[position.vertex].positions.size() >= 1);
+        // The wipe is shown half of its height up.
+        const ToolpathVertex &wipe_vertex = geometry.vertices[6];
+        REQUIRE(geometry.positions[wipe_vertex.positions.front()].position.z() == Approx(0.6f + 0.5f * GCodeProcessor::Wipe_Height));
+        REQUIRE(! geometry.has_custom_options);
+    }
+
+    SECTION("The layers built in parallel match the layers built one by one") {
+        std::vector<ToolpathLayerGeometry> geometries = build_toolpath_geometry(result, layers, sid_to_move_id, sid_to_seam_move_ids);
+        REQUIRE(geometries.size() == layers.size());
+        for (size_t i = 0; i < layers.size(); ++ i) {
+            ToolpathLayerGeometry geometry = build_toolpath_layer_geometry(result, layers[i], sid_to_move_id, sid_to_seam_move_ids);
+            REQUIRE(geometries[i].vertices.size() == geometry.vertices.size());
+            REQUIRE(geometries[i].positions.size() == geometry.positions.size());
+            REQUIRE(geometries[i].segments.size() == geometry.segments.size());
+            for (size_t j = 0; j < geometry.vertices.size(); ++ j)
+                REQUIRE(geometries[i].vertices[j].move_id == geometry.vertices[j].move_id);
+        }
+    }
+}
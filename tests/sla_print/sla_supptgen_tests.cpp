@@ -120,6 +120,30 @@ TEST_CASE("Hollowed cube should be supported from the inside", "[SupGen][Hollowe
     REQUIRE(!pts.empty());
 }
 
+TEST_CASE("Tiled hollowing matches hollowing with a single grid", "[Hollowed]") {
+    // Larger than the tiles along each axis.
+    TriangleMesh mesh = make_cube(60., 40., 30.);
+
+    HollowingConfig cfg;
+    InteriorPtr interior = generate_interior(mesh, cfg);
+    cfg.tile_size = 25.;
+    InteriorPtr interior_tiled = generate_interior(mesh, cfg);
+    REQUIRE(interior);
+    REQUIRE(interior_tiled);
+
+    const indexed_triangle_set &its       = get_mesh(*interior);
+    const indexed_triangle_set &its_tiled = get_mesh(*interior_tiled);
+    REQUIRE(! its_tiled.empty());
+    // The interiors of the tiles are welded into a single closed surface.
+    REQUIRE(its_num_open_edges(its_tiled) == 0);
+    REQUIRE(its_number_of_patches(its_tiled) == 1);
+    REQUIRE(std::abs(its_volume(its_tiled)) == Approx(std::abs(its_volume(its))).epsilon(0.01));
+    BoundingBoxf3 bb       = bounding_box(its);
+    BoundingBoxf3 bb_tiled = bounding_box(its_tiled);
+    REQUIRE((bb_tiled.min - bb.min).norm() < 0.1);
+    REQUIRE((bb_tiled.max - bb.max).norm() < 0.1);
+}
+
 TEST_CASE("Two parallel plates should be supported", "[SupGen][Hollowed]")
 {
     double width = 20., depth = 20., height = 1.;
@@ -0,0 +1,33 @@
+#include <catch2/catch.hpp>
+
+#include "libslic3r/TriangleMesh.hpp"
+#include "slic3r/GUI/3DScene.hpp"
+
+using namespace Slic3r;
+
+TEST_CASE("Moved vertex array keeps its geometry", "[3DScene]") {
+    indexed_triangle_set its = its_make_cube(10., 10., 10.);
+    GLIndexedVertexArray array;
+    array.load_its_flat_shading(its);
+    const size_t vertices_size  = array.vertices_and_normals_interleaved_size;
+    const size_t triangles_size = array.triangle_indices_size;
+    REQUIRE(vertices_size == its.indices.size() * 3 * 6);
+    REQUIRE(triangles_size == its.indices.size() * 3);
+
+    SECTION("Move construction") {
+        GLIndexedVertexArray moved(std::move(array));
+        REQUIRE(! moved.empty());
+        REQUIRE(moved.vertices_and_normals_interleaved_size == vertices_size);
+        REQUIRE(moved.triangle_indices_size == triangles_size);
+        REQUIRE(moved.quad_indices_size == 0);
+        REQUIRE(moved.triangle_indices.size() == triangles_size);
+    }
+
+    SECTION("Move assignment") {
+        GLIndexedVertexArray moved;
+        moved = std::move(array);
+        REQUIRE(! moved.empty());
+        REQUIRE(moved.vertices_and_normals_interleaved_size == vertices_size);
+        REQUIRE(moved.triangle_indices_size == triangles_size);
+    }
+}